@@ -1,11 +1,18 @@
 #include "array.h"
 
 namespace nx::core {
+    static void invalidate_freed_view(ArrayData &data, const std::unordered_set<uint8_t *> &freed_ptrs) {
+        if (data.is_buffer_valid() && data.get_buffer().is_view() && freed_ptrs.contains(data.get_buffer().get_block()->get_ptr())) {
+            data.invalidate_buffer();
+        }
+    }
+
     Array::~Array() {
         if (m_graph) {
             RuntimeContextPtr runtime_ctx = get_runtime_context();
             MemoryPtr memory = runtime_ctx->get_memory();
             MemoryProfilerPtr memory_profiler = runtime_ctx->get_memory_profiler();
+            std::unordered_set<uint8_t *> freed_ptrs;
 
             // Free non-parameter buffers on the forward tape
             for (auto iter = m_graph->fw_begin(); iter != m_graph->fw_end(); ++iter) {
@@ -15,6 +22,7 @@ namespace nx::core {
                     const ArrayBuffer &buffer = data.get_buffer();
 
                     if (!buffer.is_view()) {
+                        freed_ptrs.insert(buffer.get_block()->get_ptr());
                         memory->free_block(buffer.get_block());
                         data.invalidate_buffer();
 
@@ -34,6 +42,7 @@ namespace nx::core {
                     const ArrayBuffer &buffer = data.get_buffer();
 
                     if (!buffer.is_view()) {
+                        freed_ptrs.insert(buffer.get_block()->get_ptr());
                         memory->free_block(buffer.get_block());
                         data.invalidate_buffer();
 
@@ -44,6 +53,15 @@ namespace nx::core {
                 }
             }
 
+            // Invalidate views into the freed buffers, e.g. operands placed inside a concat's output, so they are recomputed rather than read from the pool
+            for (auto iter = m_graph->fw_begin(); iter != m_graph->fw_end(); ++iter) {
+                invalidate_freed_view((*iter)->get_data(), freed_ptrs);
+            }
+
+            for (auto iter = m_graph->bw_begin(); iter != m_graph->bw_end(); ++iter) {
+                invalidate_freed_view((*iter)->get_data(), freed_ptrs);
+            }
+
             m_graph->clear_grad();
         }
     }
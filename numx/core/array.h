@@ -172,6 +172,11 @@ namespace nx::core {
         Array recip(bool in_place = false) const { return Array(nx::graph::recip(m_op, in_place)); }
         Array sin(bool in_place = false) const { return Array(nx::graph::sin(m_op, in_place)); }
         Array cos(bool in_place = false) const { return Array(nx::graph::cos(m_op, in_place)); }
+        Array abs(bool in_place = false) const { return Array(nx::graph::abs(m_op, in_place)); }
+        Array sign(bool in_place = false) const { return Array(nx::graph::sign(m_op, in_place)); }
+        Array clamp(std::optional<double> min, std::optional<double> max) const { return Array(nx::graph::clamp(m_op, min, max)); }
+        Array pow(const Array &rhs) const { return Array(nx::graph::pow(m_op, rhs.m_op)); }
+        Array fmod(const Array &rhs) const { return Array(nx::graph::fmod(m_op, rhs.m_op)); }
         Array operator==(const Array &rhs) const { return Array(nx::graph::eq(m_op, rhs.m_op)); }
         Array operator!=(const Array &rhs) const { return Array(nx::graph::neq(m_op, rhs.m_op)); }
         Array operator<(const Array &rhs) const { return Array(nx::graph::lt(m_op, rhs.m_op)); }
@@ -205,14 +210,35 @@ namespace nx::core {
         template <NumericType T>
         Array maximum(T constant) const { return Array(nx::graph::maximum(m_op, constant)); }
 
+        template <NumericType T>
+        Array pow(T exponent) const { return Array(nx::graph::pow(m_op, exponent)); }
+
+        template <NumericType T>
+        Array fmod(T constant) const { return Array(nx::graph::fmod(m_op, constant)); }
+
         // Reduction operations
-        Array sum(const ShapeDims &dims = {}) const { return Array(nx::graph::sum(m_op, dims)); }
-        Array mean(const ShapeDims &dims = {}) const { return Array(nx::graph::mean(m_op, dims)); }
+        // Precise reductions compensate the f32 accumulator, close to what an f64 accumulator gives
+        Array sum(const ShapeDims &dims = {}, bool precise = false) const { return Array(nx::graph::sum(m_op, dims, precise)); }
+        Array mean(const ShapeDims &dims = {}, bool precise = false) const { return Array(nx::graph::mean(m_op, dims, precise)); }
+        Array var(const ShapeDims &dims = {}, float correction = 1.0f) const { return Array(nx::graph::var(m_op, dims, correction)); }
+        Array std(const ShapeDims &dims = {}, float correction = 1.0f) const { return Array(nx::graph::std_dev(m_op, dims, correction)); }
+        Array norm(const ShapeDims &dims = {}, NormOrd ord = NormOrd::L2) const { return Array(nx::graph::vector_norm(m_op, dims, ord)); }
         Array max(const ShapeDims &dims = {}) const { return Array(nx::graph::max(m_op, dims)); }
         Array min(const ShapeDims &dims = {}) const { return Array(nx::graph::min(m_op, dims)); }
         Array argmax(const ShapeDims &dims = {}) const { return Array(nx::graph::argmax(m_op, dims)); }
         Array argmin(const ShapeDims &dims = {}) const { return Array(nx::graph::argmin(m_op, dims)); }
 
+        // Scan operations
+        Array cumsum(isize dim) const { return Array(nx::graph::cumsum(m_op, dim)); }
+        Array cumprod(isize dim) const { return Array(nx::graph::cumprod(m_op, dim)); }
+        Array cummax(isize dim) const { return Array(nx::graph::cummax(m_op, dim)); }
+
+        // Sorting operations
+        Array sort(isize dim, bool descending = false) const { return Array(nx::graph::sort(m_op, dim, descending)); }
+        Array argsort(isize dim, bool descending = false) const { return Array(nx::graph::argsort(m_op, dim, descending)); }
+        Array topk(isize k, isize dim, bool largest = true) const { return Array(nx::graph::topk(m_op, k, dim, largest)); }
+        Array argtopk(isize k, isize dim, bool largest = true) const { return Array(nx::graph::argtopk(m_op, k, dim, largest)); }
+
         // Shape operations
         Array broadcast(const ShapeView &view) const { return Array(nx::graph::broadcast(m_op, view)); }
         Array broadcast_to(const ShapeView &view) const { return Array(nx::graph::broadcast_to(m_op, view)); }
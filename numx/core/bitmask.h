@@ -0,0 +1,62 @@
+#pragma once
+
+#include "array.h"
+
+namespace nx::core {
+    // Boolean array packed into i32 words with one bit per element along the last dimension, every row starts at a new word
+    // so a mask of shape (..., n) takes (..., ceil(n / 32)) words instead of n bytes per row
+    class BitMask {
+    private:
+        Array m_words;
+        ShapeView m_view;
+
+    public:
+        BitMask(const Array &words, const ShapeView &view) : m_words(words), m_view(view) {
+            ShapeView words_view = view.empty() ? ShapeView{1} : view;
+            words_view.back() = view.empty() ? 1 : num_mask_words(view.back());
+
+            if (*words.get_dtype() != i32 || words.get_view() != words_view) {
+                throw std::invalid_argument(std::format("Mask of shape ({}) cannot be packed into {} words of shape ({}).", join_nums(view), words.get_dtype()->str(), join_nums(words.get_view())));
+            }
+        }
+
+        BitMask(const BitMask &) = default;
+        BitMask(BitMask &&) noexcept = default;
+        ~BitMask() = default;
+        BitMask &operator=(const BitMask &) = default;
+        BitMask &operator=(BitMask &&) noexcept = default;
+        const Array &get_words() const { return m_words; }
+        const ShapeView &get_view() const { return m_view; }
+        isize get_nbytes() const { return m_words.get_nbytes(); }
+
+        // Set bits of every row, the output drops the last dimension
+        Array count_rows() const { return Array(nx::graph::count_bits(m_words.get_op())); }
+        Array count() const { return count_rows().sum(); }
+
+        // Values are broadcasted to the shape of the mask, gradients flow to both of them
+        Array where(const Array &lhs, const Array &rhs) const { return Array(nx::graph::where_bits(m_words.get_op(), m_view, lhs.get_op(), rhs.get_op())); }
+
+        template <NumericOrBoolType T>
+        Array masked_fill(const Array &x, T value) const { return Array(nx::graph::where_bits(m_words.get_op(), m_view, value, x.get_op())); }
+
+        Array to_bool() const {
+            OpPtr false_op = nx::graph::full({1}, false, &b8, m_words.get_device());
+            return Array(nx::graph::where_bits(m_words.get_op(), m_view, true, false_op));
+        }
+    };
+
+    inline BitMask cmp_bits(const Array &lhs, const Array &rhs, BitCmp cmp) {
+        OpPtr words_op = nx::graph::cmp_bits(lhs.get_op(), rhs.get_op(), cmp);
+        // The compared operands are broadcasted to the shape of the mask
+        const ShapeView &view = std::static_pointer_cast<CmpBitsOp>(words_op)->get_operands()[0]->get_data().get_view();
+        return BitMask(Array(words_op), view);
+    }
+
+    inline BitMask pack_bits(const Array &x) { return BitMask(Array(nx::graph::pack_bits(x.get_op())), x.get_view()); }
+    inline BitMask eq_bits(const Array &lhs, const Array &rhs) { return cmp_bits(lhs, rhs, BitCmp::EQ); }
+    inline BitMask neq_bits(const Array &lhs, const Array &rhs) { return cmp_bits(lhs, rhs, BitCmp::NEQ); }
+    inline BitMask lt_bits(const Array &lhs, const Array &rhs) { return cmp_bits(lhs, rhs, BitCmp::LT); }
+    inline BitMask gt_bits(const Array &lhs, const Array &rhs) { return cmp_bits(lhs, rhs, BitCmp::GT); }
+    inline BitMask leq_bits(const Array &lhs, const Array &rhs) { return cmp_bits(lhs, rhs, BitCmp::LEQ); }
+    inline BitMask geq_bits(const Array &lhs, const Array &rhs) { return cmp_bits(lhs, rhs, BitCmp::GEQ); }
+} // namespace nx::core
@@ -0,0 +1,606 @@
+#include "einsum.h"
+#include "functional.h"
+
+namespace nx::core {
+    // Paths over up to this many operands are searched exhaustively over all subsets, longer ones are built greedily
+    static constexpr isize s_max_optimal_operands = 8;
+    static constexpr size_t s_max_cached_plans = 256;
+
+    using LabelMask = uint64_t;
+
+    struct EinsumSubscript {
+        std::string head;
+        std::string tail;
+        bool ellipsis = false;
+    };
+
+    struct EinsumTerm {
+        Array array;
+        // A term without labels is a single element of view (1)
+        ShapeDims labels;
+    };
+
+    static bool is_letter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+    static EinsumSubscript parse_subscript(const std::string &subscript, const std::string &spec) {
+        EinsumSubscript parsed;
+        size_t ellipsis_pos = subscript.find("...");
+        parsed.ellipsis = ellipsis_pos != std::string::npos;
+        parsed.head = parsed.ellipsis ? subscript.substr(0, ellipsis_pos) : subscript;
+        parsed.tail = parsed.ellipsis ? subscript.substr(ellipsis_pos + 3) : "";
+
+        if (!std::all_of(parsed.head.begin(), parsed.head.end(), is_letter) || !std::all_of(parsed.tail.begin(), parsed.tail.end(), is_letter)) {
+            throw std::invalid_argument(std::format("Invalid subscripts {} in einsum spec {}, only letters and a single ellipsis are allowed.", subscript, spec));
+        }
+
+        return parsed;
+    }
+
+    // Splits "ab,bc->ac" into the subscripts of every operand and of the output if given
+    static std::pair<std::vector<std::string>, std::optional<std::string>> split_spec(const std::string &spec) {
+        std::string compact;
+        std::copy_if(spec.begin(), spec.end(), std::back_inserter(compact), [](char c) { return c != ' '; });
+        std::optional<std::string> output;
+        size_t arrow_pos = compact.find("->");
+
+        if (arrow_pos != std::string::npos) {
+            output = compact.substr(arrow_pos + 2);
+            compact = compact.substr(0, arrow_pos);
+        }
+
+        std::vector<std::string> inputs;
+        size_t start = 0;
+
+        for (size_t comma_pos = compact.find(','); comma_pos != std::string::npos; comma_pos = compact.find(',', start)) {
+            inputs.push_back(compact.substr(start, comma_pos - start));
+            start = comma_pos + 1;
+        }
+
+        inputs.push_back(compact.substr(start));
+        return {inputs, output};
+    }
+
+    static double label_volume(LabelMask mask, const ShapeView &label_sizes) {
+        double volume = 1.0;
+
+        for (; mask != 0; mask &= mask - 1) {
+            volume *= label_sizes[std::countr_zero(mask)];
+        }
+
+        return volume;
+    }
+
+    // Dynamic programming over subsets of operands, the cost of a subset is the multiply-adds of its cheapest contraction
+    // tree with the total size of its intermediates breaking ties
+    static EinsumPath optimal_path(const std::vector<LabelMask> &masks, LabelMask output_mask, const ShapeView &label_sizes) {
+        const isize n = masks.size();
+        const isize full = (1ll << n) - 1;
+        std::vector<LabelMask> unions(full + 1, 0);
+        std::vector<std::pair<double, double>> costs(full + 1, {0.0, 0.0});
+        std::vector<isize> splits(full + 1, 0);
+
+        for (isize subset = 1; subset <= full; subset++) {
+            isize low = subset & -subset;
+            unions[subset] = unions[subset ^ low] | masks[std::countr_zero(static_cast<uint64_t>(low))];
+        }
+
+        // Labels of the result of contracting a subset are those still needed by the output or by the other operands
+        auto kept = [&](isize subset) { return unions[subset] & (output_mask | unions[full ^ subset]); };
+
+        for (isize subset = 1; subset <= full; subset++) {
+            if (std::popcount(static_cast<uint64_t>(subset)) == 1) {
+                continue;
+            }
+
+            costs[subset] = {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+            const double out_size = label_volume(kept(subset), label_sizes);
+
+            // Every split is visited once by requiring the left part to hold the lowest operand
+            for (isize left = (subset - 1) & subset; left > 0; left = (left - 1) & subset) {
+                const isize right = subset ^ left;
+
+                if ((left & (subset & -subset)) == 0) {
+                    continue;
+                }
+
+                const double flops = costs[left].first + costs[right].first + label_volume(kept(left) | kept(right), label_sizes);
+                const double size = costs[left].second + costs[right].second + out_size;
+
+                if (std::make_pair(flops, size) < costs[subset]) {
+                    costs[subset] = {flops, size};
+                    splits[subset] = left;
+                }
+            }
+        }
+
+        EinsumPath path;
+        isize next_id = n;
+        std::function<isize(isize)> build = [&](isize subset) -> isize {
+            if (std::popcount(static_cast<uint64_t>(subset)) == 1) {
+                return std::countr_zero(static_cast<uint64_t>(subset));
+            }
+
+            const isize left_id = build(splits[subset]);
+            const isize right_id = build(subset ^ splits[subset]);
+            path.emplace_back(std::min(left_id, right_id), std::max(left_id, right_id));
+            return next_id++;
+        };
+
+        build(full);
+        return path;
+    }
+
+    // Repeatedly contracts the pair whose result shrinks the total size the most, with fewer multiply-adds breaking ties
+    static EinsumPath greedy_path(std::vector<LabelMask> masks, LabelMask output_mask, const ShapeView &label_sizes) {
+        std::vector<isize> ids(masks.size());
+        std::iota(ids.begin(), ids.end(), 0);
+        isize next_id = masks.size();
+        EinsumPath path;
+
+        while (masks.size() > 1) {
+            std::tuple<double, double, size_t, size_t> best = {std::numeric_limits<double>::infinity(), 0.0, 0, 0};
+
+            for (size_t i = 0; i < masks.size(); i++) {
+                for (size_t j = i + 1; j < masks.size(); j++) {
+                    LabelMask others = output_mask;
+
+                    for (size_t k = 0; k < masks.size(); k++) {
+                        others |= k != i && k != j ? masks[k] : 0;
+                    }
+
+                    const double size_change = label_volume((masks[i] | masks[j]) & others, label_sizes) - label_volume(masks[i], label_sizes) - label_volume(masks[j], label_sizes);
+                    const double flops = label_volume(masks[i] | masks[j], label_sizes);
+                    best = std::min(best, std::make_tuple(size_change, flops, i, j));
+                }
+            }
+
+            auto [size_change, flops, i, j] = best;
+            LabelMask others = output_mask;
+
+            for (size_t k = 0; k < masks.size(); k++) {
+                others |= k != i && k != j ? masks[k] : 0;
+            }
+
+            path.emplace_back(std::min(ids[i], ids[j]), std::max(ids[i], ids[j]));
+            masks.push_back((masks[i] | masks[j]) & others);
+            ids.push_back(next_id++);
+            // j > i so erasing j first keeps i valid
+            masks.erase(masks.begin() + j);
+            masks.erase(masks.begin() + i);
+            ids.erase(ids.begin() + j);
+            ids.erase(ids.begin() + i);
+        }
+
+        return path;
+    }
+
+    static EinsumPlan make_plan(const std::string &spec, const std::vector<ShapeView> &views) {
+        auto [subscripts, output_subscript] = split_spec(spec);
+
+        if (subscripts.size() != views.size()) {
+            throw std::invalid_argument(std::format("Einsum spec {} has {} operands but {} arrays were given.", spec, subscripts.size(), views.size()));
+        }
+
+        // An ellipsis covers the dimensions without letters, aligned to the right across operands
+        const isize noperand = views.size();
+        std::vector<EinsumSubscript> parsed;
+        ShapeView ellipsis_ndims(noperand, 0);
+        std::vector<bool> scalars(noperand, false);
+        isize ellipsis_ndim = 0;
+
+        for (isize i = 0; i < noperand; i++) {
+            parsed.push_back(parse_subscript(subscripts[i], spec));
+            const isize nletter = parsed[i].head.size() + parsed[i].tail.size();
+            const isize ndim = views[i].size();
+            // Arrays have at least one dimension, so a lone dimension of size 1 may be left without a label
+            scalars[i] = !parsed[i].ellipsis && nletter == 0 && views[i] == ShapeView{1};
+
+            if (!scalars[i] && (parsed[i].ellipsis ? nletter > ndim : nletter != ndim)) {
+                throw std::invalid_argument(std::format("Subscripts {} of einsum spec {} do not match an array of shape ({}).", subscripts[i], spec, join_nums(views[i])));
+            }
+
+            ellipsis_ndims[i] = parsed[i].ellipsis ? ndim - nletter : 0;
+            ellipsis_ndim = std::max(ellipsis_ndim, ellipsis_ndims[i]);
+        }
+
+        // Ellipsis labels come first so they lead the implicit output
+        EinsumPlan plan;
+        plan.label_sizes.assign(ellipsis_ndim, 1);
+        std::array<isize, 128> letter_ids;
+        letter_ids.fill(-1);
+
+        for (isize i = 0; i < noperand; i++) {
+            const isize offset = ellipsis_ndim - ellipsis_ndims[i];
+
+            for (isize d = 0; d < ellipsis_ndims[i]; d++) {
+                const isize size = views[i][parsed[i].head.size() + d];
+                isize &label_size = plan.label_sizes[offset + d];
+
+                if (size != 1 && label_size != 1 && size != label_size) {
+                    throw std::invalid_argument(std::format("Ellipsis dimensions of sizes {} and {} cannot be broadcasted in einsum spec {}.", label_size, size, spec));
+                }
+
+                label_size = std::max(label_size, size);
+            }
+        }
+
+        auto letter_id = [&](char letter, isize size) {
+            isize &id = letter_ids[letter];
+
+            if (id < 0) {
+                id = plan.label_sizes.size();
+                plan.label_sizes.push_back(size);
+            } else if (plan.label_sizes[id] != size) {
+                throw std::invalid_argument(std::format("Label {} has sizes {} and {} in einsum spec {}.", letter, plan.label_sizes[id], size, spec));
+            }
+
+            return id;
+        };
+
+        std::array<isize, 128> letter_counts{};
+
+        for (isize i = 0; i < noperand; i++) {
+            ShapeDims labels;
+
+            if (scalars[i]) {
+                plan.inputs.push_back({EinsumPlan::s_squeeze_label});
+                continue;
+            }
+
+            for (char letter : parsed[i].head) {
+                labels.push_back(letter_id(letter, views[i][labels.size()]));
+                letter_counts[letter]++;
+            }
+
+            for (isize d = 0; d < ellipsis_ndims[i]; d++) {
+                // Size-1 dimensions broadcasted against larger ones are dropped
+                const isize id = ellipsis_ndim - ellipsis_ndims[i] + d;
+                labels.push_back(views[i][labels.size()] == plan.label_sizes[id] ? id : EinsumPlan::s_squeeze_label);
+            }
+
+            for (char letter : parsed[i].tail) {
+                labels.push_back(letter_id(letter, views[i][labels.size()]));
+                letter_counts[letter]++;
+            }
+
+            plan.inputs.push_back(labels);
+        }
+
+        if (plan.label_sizes.size() > std::numeric_limits<LabelMask>::digits) {
+            throw std::invalid_argument(std::format("Einsum spec {} has {} labels, more than the supported {}.", spec, plan.label_sizes.size(), std::numeric_limits<LabelMask>::digits));
+        }
+
+        if (output_subscript) {
+            EinsumSubscript output = parse_subscript(*output_subscript, spec);
+            std::string letters = output.head + output.tail;
+
+            for (char letter : letters) {
+                if (letter_ids[letter] < 0 || std::count(letters.begin(), letters.end(), letter) > 1) {
+                    throw std::invalid_argument(std::format("Output label {} of einsum spec {} is repeated or missing from the operands.", letter, spec));
+                }
+            }
+
+            std::transform(output.head.begin(), output.head.end(), std::back_inserter(plan.output), [&](char letter) { return letter_ids[letter]; });
+
+            for (isize id = 0; output.ellipsis && id < ellipsis_ndim; id++) {
+                plan.output.push_back(id);
+            }
+
+            std::transform(output.tail.begin(), output.tail.end(), std::back_inserter(plan.output), [&](char letter) { return letter_ids[letter]; });
+        } else {
+            plan.output.resize(ellipsis_ndim);
+            std::iota(plan.output.begin(), plan.output.end(), 0);
+
+            for (int letter = 0; letter < 128; letter++) {
+                if (letter_counts[letter] == 1) {
+                    plan.output.push_back(letter_ids[letter]);
+                }
+            }
+        }
+
+        // Labels found in a single operand and not in the output are summed before any contraction
+        std::vector<LabelMask> masks(noperand, 0);
+        LabelMask output_mask = 0;
+
+        for (isize i = 0; i < noperand; i++) {
+            for (isize label : plan.inputs[i]) {
+                masks[i] |= label >= 0 ? LabelMask(1) << label : 0;
+            }
+        }
+
+        for (isize label : plan.output) {
+            output_mask |= LabelMask(1) << label;
+        }
+
+        std::vector<LabelMask> reduced_masks(masks);
+
+        for (isize i = 0; i < noperand; i++) {
+            LabelMask others = output_mask;
+
+            for (isize j = 0; j < noperand; j++) {
+                others |= j != i ? masks[j] : 0;
+            }
+
+            reduced_masks[i] &= others;
+        }
+
+        if (noperand <= s_max_optimal_operands) {
+            plan.path = optimal_path(reduced_masks, output_mask, plan.label_sizes);
+        } else {
+            plan.path = greedy_path(reduced_masks, output_mask, plan.label_sizes);
+        }
+
+        return plan;
+    }
+
+    EinsumPlan einsum_plan(const std::string &spec, const std::vector<ShapeView> &views) {
+        // Cached per thread like the autocast dtype so lookups take no lock
+        static thread_local std::unordered_map<std::string, EinsumPlan> plans;
+        std::string key = spec;
+
+        for (auto &view : views) {
+            key += std::format(";{}", join_nums(view));
+        }
+
+        auto iter = plans.find(key);
+
+        if (iter != plans.end()) {
+            return iter->second;
+        }
+
+        if (plans.size() >= s_max_cached_plans) {
+            plans.clear();
+        }
+
+        return plans.emplace(key, make_plan(spec, views)).first->second;
+    }
+
+    EinsumPath einsum_path(const std::string &spec, const std::vector<ShapeView> &views) { return einsum_plan(spec, views).path; }
+
+    static ShapeView label_view(const ShapeDims &labels, const ShapeView &label_sizes) {
+        ShapeView view;
+        std::transform(labels.begin(), labels.end(), std::back_inserter(view), [&](isize label) { return label_sizes[label]; });
+        return view.empty() ? ShapeView{1} : view;
+    }
+
+    static isize label_pos(const ShapeDims &labels, isize label) { return std::find(labels.begin(), labels.end(), label) - labels.begin(); }
+
+    static EinsumTerm sum_labels(const EinsumTerm &term, const ShapeDims &labels, const ShapeView &label_sizes) {
+        if (labels.empty()) {
+            return term;
+        }
+
+        ShapeDims dims;
+        ShapeDims remaining;
+        std::transform(labels.begin(), labels.end(), std::back_inserter(dims), [&](isize label) { return label_pos(term.labels, label); });
+        std::copy_if(term.labels.begin(), term.labels.end(), std::back_inserter(remaining), [&](isize label) { return std::find(labels.begin(), labels.end(), label) == labels.end(); });
+        // Sums keep a trailing dimension of size 1 which a reshape of the contiguous result drops
+        return {term.array.sum(dims).reshape(label_view(remaining, label_sizes)), remaining};
+    }
+
+    // Keeps the elements where two dimensions of the same label have equal indices and sums over the second one
+    static EinsumTerm take_diagonal(const EinsumTerm &term, isize first, isize second, const ShapeView &label_sizes) {
+        const isize ndim = term.labels.size();
+        const isize size = label_sizes[term.labels[first]];
+        ShapeView first_view(ndim, 1), second_view(ndim, 1);
+        first_view[first] = size;
+        second_view[second] = size;
+        OpPtr first_index = nx::graph::arange(first_view, 0, 1, &i32, term.array.get_device());
+        OpPtr second_index = nx::graph::arange(second_view, 0, 1, &i32, term.array.get_device());
+        Array diagonal = where(Array(nx::graph::eq(first_index, second_index)), term.array, 0);
+        ShapeDims labels = term.labels;
+        labels[second] = -2;
+        return sum_labels({diagonal, labels}, {-2}, label_sizes);
+    }
+
+    // Lays out a term as one dimension per group of labels for a matmul. Merging several labels into one dimension takes
+    // a reshape which copies unless the term is contiguous in group order, and empty groups become dimensions of size 1.
+    static Array group_view(const EinsumTerm &term, const std::vector<ShapeDims> &groups, const ShapeView &label_sizes) {
+        ShapeDims dims;
+        ShapeView group_sizes;
+        bool merged = term.labels.empty();
+
+        for (auto &group : groups) {
+            const ShapeView &view = label_view(group, label_sizes);
+            std::transform(group.begin(), group.end(), std::back_inserter(dims), [&](isize label) { return label_pos(term.labels, label); });
+            group_sizes.push_back(std::accumulate(view.begin(), view.end(), 1ll, std::multiplies<>()));
+            merged |= group.size() > 1;
+        }
+
+        ShapeDims identity(dims.size());
+        std::iota(identity.begin(), identity.end(), 0);
+        const bool in_order = dims == identity;
+        Array array = in_order || term.labels.empty() ? term.array : term.array.permute(dims);
+
+        if (merged || (in_order && term.array.is_contiguous())) {
+            return array.reshape(group_sizes.empty() ? ShapeView{1} : group_sizes);
+        }
+
+        // Every group has at most one label so the layout stays a view of the term
+        for (size_t i = 0; i < groups.size(); i++) {
+            array = groups[i].empty() ? array.unsqueeze({static_cast<isize>(i)}) : array;
+        }
+
+        return array;
+    }
+
+    static ShapeDims concat_labels(std::initializer_list<ShapeDims> groups) {
+        ShapeDims labels;
+
+        for (auto &group : groups) {
+            labels.insert(labels.end(), group.begin(), group.end());
+        }
+
+        return labels;
+    }
+
+    // Contracts two terms into one holding the kept labels. Labels of both terms are either batch dimensions when kept or
+    // contracted otherwise, labels of a single term are kept since single-operand labels are summed beforehand.
+    static EinsumTerm contract(const EinsumTerm &lhs, const EinsumTerm &rhs, LabelMask kept_mask, const ShapeView &label_sizes) {
+        auto in = [](const ShapeDims &labels, isize label) { return std::find(labels.begin(), labels.end(), label) != labels.end(); };
+        auto is_kept = [&](isize label) { return (kept_mask >> label) & 1; };
+        ShapeDims batch, contracted, lhs_free, rhs_free;
+
+        for (isize label : lhs.labels) {
+            (in(rhs.labels, label) ? (is_kept(label) ? batch : contracted) : lhs_free).push_back(label);
+        }
+
+        std::copy_if(rhs.labels.begin(), rhs.labels.end(), std::back_inserter(rhs_free), [&](isize label) { return !in(lhs.labels, label); });
+
+        // Outer and element-wise products need no matmul, both terms are laid out as broadcastable views
+        if (contracted.empty()) {
+            ShapeDims labels = concat_labels({batch, lhs_free, rhs_free});
+            std::vector<ShapeDims> lhs_groups, rhs_groups;
+
+            for (isize label : labels) {
+                lhs_groups.push_back(in(lhs.labels, label) ? ShapeDims{label} : ShapeDims{});
+                rhs_groups.push_back(in(rhs.labels, label) ? ShapeDims{label} : ShapeDims{});
+            }
+
+            Array product = group_view(lhs, lhs_groups, label_sizes) * group_view(rhs, rhs_groups, label_sizes);
+            return {product, labels};
+        }
+
+        // Batch and contracted labels follow whichever term is laid out in that order so its reshape is a view
+        auto grouped = [&](const EinsumTerm &term, const ShapeDims &first, const ShapeDims &second) {
+            return term.array.is_contiguous() && term.labels == concat_labels({batch, first, second});
+        };
+
+        auto order_by = [&](ShapeDims &labels, const EinsumTerm &term) {
+            std::sort(labels.begin(), labels.end(), [&](isize a, isize b) { return label_pos(term.labels, a) < label_pos(term.labels, b); });
+        };
+
+        if (!grouped(lhs, lhs_free, contracted) && !grouped(lhs, contracted, lhs_free)) {
+            const ShapeDims lhs_batch = batch, lhs_contracted = contracted;
+            order_by(batch, rhs);
+            order_by(contracted, rhs);
+
+            if (!grouped(rhs, contracted, rhs_free) && !grouped(rhs, rhs_free, contracted)) {
+                batch = lhs_batch;
+                contracted = lhs_contracted;
+            }
+        }
+
+        // A term that cannot be reshaped as a view keeps all but its last free label as batch dimensions, unless several
+        // contracted labels force a copy anyway
+        auto split_free = [&](const ShapeDims &free, bool natural, bool transposed) -> std::pair<ShapeDims, ShapeDims> {
+            if (natural || transposed || contracted.size() > 1 || free.size() <= 1) {
+                return {{}, free};
+            }
+
+            return {ShapeDims(free.begin(), free.end() - 1), ShapeDims{free.back()}};
+        };
+
+        const bool lhs_natural = grouped(lhs, lhs_free, contracted), lhs_transposed = !lhs_natural && grouped(lhs, contracted, lhs_free);
+        const bool rhs_natural = grouped(rhs, contracted, rhs_free), rhs_transposed = !rhs_natural && grouped(rhs, rhs_free, contracted);
+        auto [lhs_extra, rows] = split_free(lhs_free, lhs_natural, lhs_transposed);
+        auto [rhs_extra, cols] = split_free(rhs_free, rhs_natural, rhs_transposed);
+        std::vector<ShapeDims> lhs_groups, rhs_groups;
+
+        for (isize label : concat_labels({batch, lhs_extra, rhs_extra})) {
+            lhs_groups.push_back(in(lhs.labels, label) ? ShapeDims{label} : ShapeDims{});
+            rhs_groups.push_back(in(rhs.labels, label) ? ShapeDims{label} : ShapeDims{});
+        }
+
+        const isize ndim = lhs_groups.size() + 2;
+        lhs_groups.push_back(lhs_transposed ? contracted : rows);
+        lhs_groups.push_back(lhs_transposed ? rows : contracted);
+        rhs_groups.push_back(rhs_transposed ? cols : contracted);
+        rhs_groups.push_back(rhs_transposed ? contracted : cols);
+        Array lhs_matrix = group_view(lhs, lhs_groups, label_sizes);
+        Array rhs_matrix = group_view(rhs, rhs_groups, label_sizes);
+        lhs_matrix = lhs_transposed ? lhs_matrix.transpose(ndim - 2, ndim - 1) : lhs_matrix;
+        rhs_matrix = rhs_transposed ? rhs_matrix.transpose(ndim - 2, ndim - 1) : rhs_matrix;
+
+        // The product is contiguous so splitting the merged rows and columns back into labels is a view
+        ShapeDims labels = concat_labels({batch, lhs_extra, rhs_extra, rows, cols});
+        return {lhs_matrix.matmul(rhs_matrix).reshape(label_view(labels, label_sizes)), labels};
+    }
+
+    Array einsum(const std::string &spec, const ArrayVector &operands) {
+        std::vector<ShapeView> views;
+        std::transform(operands.begin(), operands.end(), std::back_inserter(views), [](const Array &array) { return array.get_view(); });
+        const EinsumPlan plan = einsum_plan(spec, views);
+        const ShapeView &label_sizes = plan.label_sizes;
+        std::vector<EinsumTerm> terms;
+
+        for (size_t i = 0; i < operands.size(); i++) {
+            EinsumTerm term{operands[i], plan.inputs[i]};
+            ShapeDims squeeze_dims;
+
+            for (size_t d = 0; d < term.labels.size(); d++) {
+                if (term.labels[d] == EinsumPlan::s_squeeze_label) {
+                    squeeze_dims.push_back(d);
+                }
+            }
+
+            if (!squeeze_dims.empty()) {
+                std::erase(term.labels, EinsumPlan::s_squeeze_label);
+                term.array = term.labels.empty() ? term.array.reshape({1}) : term.array.squeeze(squeeze_dims);
+            }
+
+            // Repeated labels select a diagonal, a label repeated more than twice is taken again at the same position
+            for (size_t d = 0; d < term.labels.size();) {
+                auto iter = std::find(term.labels.begin() + d + 1, term.labels.end(), term.labels[d]);
+
+                if (iter == term.labels.end()) {
+                    d++;
+                } else {
+                    term = take_diagonal(term, d, iter - term.labels.begin(), label_sizes);
+                }
+            }
+
+            terms.push_back(term);
+        }
+
+        LabelMask output_mask = 0;
+
+        for (isize label : plan.output) {
+            output_mask |= LabelMask(1) << label;
+        }
+
+        auto mask_of = [](const EinsumTerm &term) {
+            LabelMask mask = 0;
+
+            for (isize label : term.labels) {
+                mask |= LabelMask(1) << label;
+            }
+
+            return mask;
+        };
+
+        // Labels only found in one operand are summed before any contraction
+        for (size_t i = 0; i < terms.size(); i++) {
+            LabelMask others = output_mask;
+
+            for (size_t j = 0; j < terms.size(); j++) {
+                others |= j != i ? mask_of(terms[j]) : 0;
+            }
+
+            ShapeDims summed;
+            std::copy_if(terms[i].labels.begin(), terms[i].labels.end(), std::back_inserter(summed), [&](isize label) { return ((others >> label) & 1) == 0; });
+            terms[i] = sum_labels(terms[i], summed, label_sizes);
+        }
+
+        std::vector<bool> alive(terms.size(), true);
+
+        for (auto [lhs_id, rhs_id] : plan.path) {
+            LabelMask others = output_mask;
+            alive[lhs_id] = alive[rhs_id] = false;
+
+            for (size_t k = 0; k < terms.size(); k++) {
+                others |= alive[k] ? mask_of(terms[k]) : 0;
+            }
+
+            terms.push_back(contract(terms[lhs_id], terms[rhs_id], others, label_sizes));
+            alive.push_back(true);
+        }
+
+        const EinsumTerm &result = terms.back();
+        ShapeDims dims;
+        std::transform(plan.output.begin(), plan.output.end(), std::back_inserter(dims), [&](isize label) { return label_pos(result.labels, label); });
+        ShapeDims identity(dims.size());
+        std::iota(identity.begin(), identity.end(), 0);
+        return dims == identity || dims.empty() ? result.array : result.array.permute(dims);
+    }
+} // namespace nx::core
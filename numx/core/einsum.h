@@ -0,0 +1,32 @@
+#pragma once
+
+#include "array.h"
+
+namespace nx::core {
+    // Operands are contracted pairwise, each step contracts two terms given by their ids and appends the result as a new
+    // term, the operands taking ids 0 to n - 1 in order
+    using EinsumPath = std::vector<std::pair<isize, isize>>;
+
+    struct EinsumPlan {
+        // Labels of every dimension of every operand, broadcasted size-1 dimensions of an ellipsis are labeled
+        // s_squeeze_label and dropped before contracting
+        static constexpr isize s_squeeze_label = -1;
+        std::vector<ShapeDims> inputs;
+        ShapeDims output;
+        ShapeView label_sizes;
+        EinsumPath path;
+    };
+
+    // Plans are cached by spec and operand views
+    EinsumPlan einsum_plan(const std::string &spec, const std::vector<ShapeView> &views);
+    EinsumPath einsum_path(const std::string &spec, const std::vector<ShapeView> &views);
+
+    // Einstein summation over operands such as "bij,bjk->bik", with "..." for broadcasted dimensions and the sorted labels
+    // appearing once as the output when "->" is omitted. Every pairwise contraction is lowered to a batched matmul over
+    // views of its operands.
+    Array einsum(const std::string &spec, const ArrayVector &operands);
+
+    template <class... Arrays>
+        requires(std::same_as<std::remove_cvref_t<Arrays>, Array> && ...)
+    Array einsum(const std::string &spec, const Arrays &...operands) { return einsum(spec, ArrayVector{operands...}); }
+} // namespace nx::core
@@ -1,6 +1,48 @@
 #include "functional.h"
 
 namespace nx::core {
+    static std::vector<OpPtr> ops_from_arrays(const ArrayVector &arrays) {
+        std::vector<OpPtr> ops;
+        std::transform(arrays.begin(), arrays.end(), std::back_inserter(ops), [](const Array &array) { return array.get_op(); });
+        return ops;
+    }
+
+    static ArrayVector arrays_from_ops(const std::vector<OpPtr> &ops) {
+        ArrayVector arrays;
+        std::transform(ops.begin(), ops.end(), std::back_inserter(arrays), [](OpPtr op) { return Array(op); });
+        return arrays;
+    }
+
+    Array concat(const ArrayVector &arrays, isize dim) { return Array(nx::graph::concat(ops_from_arrays(arrays), dim)); }
+    Array stack(const ArrayVector &arrays, isize dim) { return Array(nx::graph::stack(ops_from_arrays(arrays), dim)); }
+    ArrayVector split(const Array &array, const ShapeView &sizes, isize dim) { return arrays_from_ops(nx::graph::split(array.get_op(), sizes, dim)); }
+
+    ArrayVector split(const Array &array, isize section_size, isize dim) {
+        if (section_size <= 0) {
+            throw std::invalid_argument(std::format("Section size must be positive but got {}.", section_size));
+        }
+
+        if (dim < 0 || dim >= array.get_ndim()) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during split.", dim, array.get_ndim()));
+        }
+
+        // The last section holds the remainder when the dimension is not divisible by the section size
+        isize dim_size = array.get_view()[dim];
+        ShapeView sizes(dim_size / section_size, section_size);
+
+        if (dim_size % section_size != 0) {
+            sizes.push_back(dim_size % section_size);
+        }
+
+        return split(array, sizes, dim);
+    }
+
+    std::pair<Array, Array> topk(const Array &array, isize k, isize dim, bool largest) {
+        // The values are gathered at the indices, so both come out of a single sort
+        OpPtr values_op = nx::graph::topk(array.get_op(), k, dim, largest);
+        return std::make_pair(Array(values_op), Array(std::static_pointer_cast<TopkOp>(values_op)->get_indices()));
+    }
+
     std::pair<isize, isize> compute_fan_in_and_fan_out(const ShapeView &view) {
         if (view.size() < 2) {
             throw std::invalid_argument(std::format("Fan-in and fan-out cannot be computed for a view of {} dimensions, which is fewer than 2.", view.size()));
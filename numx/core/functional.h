@@ -15,6 +15,20 @@ namespace nx::core {
     template <NumericType T>
     Array operator/(T constant, const Array &array) { return array.recip() * constant; }
 
+    inline Array where(const Array &cond, const Array &lhs, const Array &rhs) { return Array(nx::graph::where(cond.get_op(), lhs.get_op(), rhs.get_op())); }
+
+    template <NumericOrBoolType T>
+    Array where(const Array &cond, const Array &lhs, T constant) { return Array(nx::graph::where(cond.get_op(), lhs.get_op(), constant)); }
+
+    template <NumericOrBoolType T>
+    Array where(const Array &cond, T constant, const Array &rhs) { return Array(nx::graph::where(cond.get_op(), constant, rhs.get_op())); }
+
+    Array concat(const ArrayVector &arrays, isize dim = 0);
+    Array stack(const ArrayVector &arrays, isize dim = 0);
+    ArrayVector split(const Array &array, const ShapeView &sizes, isize dim = 0);
+    ArrayVector split(const Array &array, isize section_size, isize dim = 0);
+    std::pair<Array, Array> topk(const Array &array, isize k, isize dim, bool largest = true);
+
     inline Array from_buffer(uint8_t *ptr, isize size, const Shape &shape, DtypePtr dtype = &f32, const std::string &device_name = default_device_name) {
         DevicePtr device = get_device(device_name);
         return Array(nx::graph::from_buffer(ptr, size, shape, dtype, device));
@@ -68,6 +82,19 @@ namespace nx::core {
     }
 
     inline Array empty_like(const Array &array) { return Array(nx::graph::empty_like(array.get_op())); }
+
+    // Counts integer values in [0, num_bins), the number of bins is fixed upfront since shapes are known before evaluation
+    inline Array bincount(const Array &x, isize num_bins) { return Array(nx::graph::bincount(x.get_op(), nullptr, num_bins)); }
+    inline Array bincount_with_weight(const Array &x, const Array &weight, isize num_bins) { return Array(nx::graph::bincount(x.get_op(), weight.get_op(), num_bins)); }
+    inline Array histogram(const Array &x, isize num_bins, float min, float max) { return Array(nx::graph::histogram(x.get_op(), nullptr, num_bins, min, max)); }
+    inline Array histogram_with_weight(const Array &x, const Array &weight, isize num_bins, float min, float max) { return Array(nx::graph::histogram(x.get_op(), weight.get_op(), num_bins, min, max)); }
+    // Real FFT of the last dimension, spectra keep the real and imaginary parts in a trailing dimension of 2.
+    // The signal is cropped or zero padded to n, which irfft takes as the output size and defaults to 2 * (bins - 1).
+    inline Array rfft(const Array &x, std::optional<isize> n = std::nullopt) { return Array(nx::graph::rfft(x.get_op(), n)); }
+    inline Array irfft(const Array &x, std::optional<isize> n = std::nullopt) { return Array(nx::graph::irfft(x.get_op(), n)); }
+    // Matmuls, convolutions and arithmetic built within the returned guard's scope run in the low-precision dtype,
+    // sums, softmax and losses stay in f32 and gradients follow the dtypes of the forward ops
+    [[nodiscard]] inline AutocastGuard autocast(DtypePtr dtype = &bf16) { return AutocastGuard(dtype); }
     std::pair<isize, isize> compute_fan_in_and_fan_out(const ShapeView &view);
     std::pair<isize, isize> compute_fan_in_and_fan_out(const Array &array);
 } // namespace nx::core
\ No newline at end of file
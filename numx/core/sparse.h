@@ -0,0 +1,68 @@
+#pragma once
+
+#include "array.h"
+
+namespace nx::core {
+    // Sparse matrix of f32 nonzeros with i32 indices in compressed row (CSR) or coordinate (COO) format,
+    // the components are regular arrays so they can share memory with host buffers through from_buffer
+    class SparseArray {
+    private:
+        SparseFormat m_format;
+        isize m_nrow;
+        isize m_ncol;
+        Array m_rows;
+        Array m_cols;
+        Array m_values;
+
+    public:
+        // CSR rows are the (rows + 1) offsets into the nonzeros, COO rows are one row index per nonzero
+        SparseArray(SparseFormat format, const Array &rows, const Array &cols, const Array &values, isize nrow, isize ncol) : m_format(format), m_nrow(nrow), m_ncol(ncol), m_rows(rows), m_cols(cols), m_values(values) {
+            const isize nnz = values.get_numel();
+            const isize nrow_index = format == SparseFormat::CSR ? nrow + 1 : nnz;
+
+            if (nrow < 0 || ncol < 0 || values.get_ndim() != 1 || cols.get_ndim() != 1 || rows.get_ndim() != 1 || cols.get_numel() != nnz || rows.get_numel() != nrow_index) {
+                throw std::invalid_argument(std::format("Sparse array of shape ({}, {}) cannot have {} row indices, {} column indices and {} values.", nrow, ncol, rows.get_numel(), cols.get_numel(), nnz));
+            }
+        }
+
+        SparseArray(const SparseArray &) = default;
+        SparseArray(SparseArray &&) noexcept = default;
+        ~SparseArray() = default;
+        SparseArray &operator=(const SparseArray &) = default;
+        SparseArray &operator=(SparseArray &&) noexcept = default;
+        SparseFormat get_format() const { return m_format; }
+        ShapeView get_view() const { return {m_nrow, m_ncol}; }
+        isize get_nnz() const { return m_values.get_numel(); }
+        const Array &get_rows() const { return m_rows; }
+        const Array &get_cols() const { return m_cols; }
+        const Array &get_values() const { return m_values; }
+        float get_density() const { return m_nrow * m_ncol > 0 ? static_cast<float>(get_nnz()) / (m_nrow * m_ncol) : 0.0f; }
+
+        // Gradients flow to the dense operand, the product with the transpose is the backward of the plain product
+        Array matmul(const Array &dense, bool transposed = false) const { return Array(nx::graph::spmm(m_rows.get_op(), m_cols.get_op(), m_values.get_op(), dense.get_op(), m_format, m_nrow, m_ncol, transposed)); }
+
+        // The product keeps the sparsity pattern, gradients flow to both the nonzeros and the dense operand
+        SparseArray mul(const Array &dense) const {
+            Array values(nx::graph::sparse_mul(m_rows.get_op(), m_cols.get_op(), m_values.get_op(), dense.get_op(), m_format, m_nrow, m_ncol));
+            return SparseArray(m_format, m_rows, m_cols, values, m_nrow, m_ncol);
+        }
+
+        Array to_dense() const { return Array(nx::graph::sparse_to_dense(m_rows.get_op(), m_cols.get_op(), m_values.get_op(), m_format, m_nrow, m_ncol)); }
+    };
+
+    inline SparseArray sparse_csr(const Array &indptr, const Array &indices, const Array &values, const ShapeView &view) {
+        if (view.size() != 2) {
+            throw std::invalid_argument(std::format("Sparse arrays must be 2D but got shape ({}).", join_nums(view)));
+        }
+
+        return SparseArray(SparseFormat::CSR, indptr, indices, values, view[0], view[1]);
+    }
+
+    inline SparseArray sparse_coo(const Array &rows, const Array &cols, const Array &values, const ShapeView &view) {
+        if (view.size() != 2) {
+            throw std::invalid_argument(std::format("Sparse arrays must be 2D but got shape ({}).", join_nums(view)));
+        }
+
+        return SparseArray(SparseFormat::COO, rows, cols, values, view[0], view[1]);
+    }
+} // namespace nx::core
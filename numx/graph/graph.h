@@ -10,6 +10,7 @@ namespace nx::graph {
     protected:
         OpPtr m_output;
         std::unordered_set<ArrayId> m_marked;
+        std::unordered_map<ArrayId, size_t> m_num_consumers;
         std::vector<OpPtr> m_fw_tape;
         std::vector<OpPtr> m_bw_tape;
         size_t m_num_fw_edges = 0;
@@ -17,6 +18,7 @@ namespace nx::graph {
 
         void fw_toposort(OpPtr op);
         void bw_toposort(OpPtr op);
+        void add_consumer(OpPtr operand) { m_num_consumers[operand->get_data().get_id()]++; }
 
     public:
         explicit Graph(OpPtr output) : m_output(output) {}
@@ -30,6 +32,13 @@ namespace nx::graph {
         size_t bw_tape_size() const { return m_bw_tape.size(); }
         size_t count_fw_edges() const { return m_num_fw_edges; }
         size_t count_bw_edges() const { return m_num_bw_edges; }
+
+        // Counts the edges into an op from both tapes, an operand listed twice by the same op counts twice
+        size_t count_consumers(OpPtr op) const {
+            auto iter = m_num_consumers.find(op->get_data().get_id());
+            return iter == m_num_consumers.end() ? 0 : iter->second;
+        }
+
         void forward();
         void backward();
         void clear_grad();
@@ -41,12 +41,48 @@ namespace nx::graph {
             stream << "[\"" << id << "\", \"" << rhs->get_data().get_id() << "\"]";
             return true;
         }
+        case Optype::TERNARY: {
+            TernaryOpPtr ternary_op = std::static_pointer_cast<TernaryOp>(op);
+            OpPtr first = ternary_op->get_first();
+            OpPtr second = ternary_op->get_second();
+            OpPtr third = ternary_op->get_third();
+            stream << "[\"" << id << "\", \"" << first->get_data().get_id() << "\"],";
+            stream << "[\"" << id << "\", \"" << second->get_data().get_id() << "\"],";
+            stream << "[\"" << id << "\", \"" << third->get_data().get_id() << "\"]";
+            return true;
+        }
+        case Optype::NARY: {
+            NaryOpPtr nary_op = std::static_pointer_cast<NaryOp>(op);
+            const std::vector<OpPtr> &operands = nary_op->get_operands();
+
+            for (size_t i = 0; i < operands.size(); i++) {
+                stream << "[\"" << id << "\", \"" << operands[i]->get_data().get_id() << "\"]";
+
+                if (i + 1 < operands.size()) {
+                    stream << ",";
+                }
+            }
+
+            return true;
+        }
         case Optype::TRANSFORM: {
             TransformOpPtr transform_op = std::static_pointer_cast<TransformOp>(op);
             OpPtr operand = transform_op->get_operand();
             stream << "[\"" << id << "\", \"" << operand->get_data().get_id() << "\"]";
             return true;
         }
+        case Optype::SCAN: {
+            ScanOpPtr scan_op = std::static_pointer_cast<ScanOp>(op);
+            OpPtr operand = scan_op->get_operand();
+            stream << "[\"" << id << "\", \"" << operand->get_data().get_id() << "\"]";
+            return true;
+        }
+        case Optype::SORT: {
+            SortingOpPtr sorting_op = std::static_pointer_cast<SortingOp>(op);
+            OpPtr operand = sorting_op->get_operand();
+            stream << "[\"" << id << "\", \"" << operand->get_data().get_id() << "\"]";
+            return true;
+        }
         default: {
             ReduceOpPtr reduce_op = std::static_pointer_cast<ReduceOp>(op);
             OpPtr operand = reduce_op->get_operand();
@@ -19,6 +19,7 @@ namespace nx::graph {
             UnaryOpPtr unary_op = std::static_pointer_cast<UnaryOp>(op);
             OpPtr operand = unary_op->get_operand();
             fw_toposort(operand);
+            add_consumer(operand);
             m_fw_tape.push_back(op);
             m_num_fw_edges++;
             break;
@@ -28,15 +29,63 @@ namespace nx::graph {
             OpPtr lhs = binary_op->get_lhs();
             OpPtr rhs = binary_op->get_rhs();
             fw_toposort(lhs);
+            add_consumer(lhs);
             fw_toposort(rhs);
+            add_consumer(rhs);
             m_fw_tape.push_back(op);
             m_num_fw_edges += 2;
             break;
         }
+        case Optype::TERNARY: {
+            TernaryOpPtr ternary_op = std::static_pointer_cast<TernaryOp>(op);
+            OpPtr first = ternary_op->get_first();
+            OpPtr second = ternary_op->get_second();
+            OpPtr third = ternary_op->get_third();
+            fw_toposort(first);
+            add_consumer(first);
+            fw_toposort(second);
+            add_consumer(second);
+            fw_toposort(third);
+            add_consumer(third);
+            m_fw_tape.push_back(op);
+            m_num_fw_edges += 3;
+            break;
+        }
+        case Optype::NARY: {
+            NaryOpPtr nary_op = std::static_pointer_cast<NaryOp>(op);
+
+            for (auto &operand : nary_op->get_operands()) {
+                fw_toposort(operand);
+                add_consumer(operand);
+            }
+
+            m_fw_tape.push_back(op);
+            m_num_fw_edges += nary_op->get_operands().size();
+            break;
+        }
         case Optype::TRANSFORM: {
             TransformOpPtr transform_op = std::static_pointer_cast<TransformOp>(op);
             OpPtr operand = transform_op->get_operand();
             fw_toposort(operand);
+            add_consumer(operand);
+            m_fw_tape.push_back(op);
+            m_num_fw_edges++;
+            break;
+        }
+        case Optype::SCAN: {
+            ScanOpPtr scan_op = std::static_pointer_cast<ScanOp>(op);
+            OpPtr operand = scan_op->get_operand();
+            fw_toposort(operand);
+            add_consumer(operand);
+            m_fw_tape.push_back(op);
+            m_num_fw_edges++;
+            break;
+        }
+        case Optype::SORT: {
+            SortingOpPtr sorting_op = std::static_pointer_cast<SortingOp>(op);
+            OpPtr operand = sorting_op->get_operand();
+            fw_toposort(operand);
+            add_consumer(operand);
             m_fw_tape.push_back(op);
             m_num_fw_edges++;
             break;
@@ -46,6 +95,7 @@ namespace nx::graph {
             ReduceOpPtr reduce_op = std::static_pointer_cast<ReduceOp>(op);
             OpPtr operand = reduce_op->get_operand();
             fw_toposort(operand);
+            add_consumer(operand);
             m_fw_tape.push_back(op);
             m_num_fw_edges++;
             break;
@@ -71,6 +121,7 @@ namespace nx::graph {
             UnaryOpPtr unary_op = std::static_pointer_cast<UnaryOp>(op);
             OpPtr operand = unary_op->get_operand();
             bw_toposort(operand);
+            add_consumer(operand);
             m_bw_tape.push_back(op);
             m_num_bw_edges++;
             break;
@@ -80,15 +131,63 @@ namespace nx::graph {
             OpPtr lhs = binary_op->get_lhs();
             OpPtr rhs = binary_op->get_rhs();
             bw_toposort(lhs);
+            add_consumer(lhs);
             bw_toposort(rhs);
+            add_consumer(rhs);
             m_bw_tape.push_back(op);
             m_num_bw_edges += 2;
             break;
         }
+        case Optype::TERNARY: {
+            TernaryOpPtr ternary_op = std::static_pointer_cast<TernaryOp>(op);
+            OpPtr first = ternary_op->get_first();
+            OpPtr second = ternary_op->get_second();
+            OpPtr third = ternary_op->get_third();
+            bw_toposort(first);
+            add_consumer(first);
+            bw_toposort(second);
+            add_consumer(second);
+            bw_toposort(third);
+            add_consumer(third);
+            m_bw_tape.push_back(op);
+            m_num_bw_edges += 3;
+            break;
+        }
+        case Optype::NARY: {
+            NaryOpPtr nary_op = std::static_pointer_cast<NaryOp>(op);
+
+            for (auto &operand : nary_op->get_operands()) {
+                bw_toposort(operand);
+                add_consumer(operand);
+            }
+
+            m_bw_tape.push_back(op);
+            m_num_bw_edges += nary_op->get_operands().size();
+            break;
+        }
         case Optype::TRANSFORM: {
             TransformOpPtr transform_op = std::static_pointer_cast<TransformOp>(op);
             OpPtr operand = transform_op->get_operand();
             bw_toposort(operand);
+            add_consumer(operand);
+            m_bw_tape.push_back(op);
+            m_num_bw_edges++;
+            break;
+        }
+        case Optype::SCAN: {
+            ScanOpPtr scan_op = std::static_pointer_cast<ScanOp>(op);
+            OpPtr operand = scan_op->get_operand();
+            bw_toposort(operand);
+            add_consumer(operand);
+            m_bw_tape.push_back(op);
+            m_num_bw_edges++;
+            break;
+        }
+        case Optype::SORT: {
+            SortingOpPtr sorting_op = std::static_pointer_cast<SortingOp>(op);
+            OpPtr operand = sorting_op->get_operand();
+            bw_toposort(operand);
+            add_consumer(operand);
             m_bw_tape.push_back(op);
             m_num_bw_edges++;
             break;
@@ -98,6 +197,7 @@ namespace nx::graph {
             ReduceOpPtr reduce_op = std::static_pointer_cast<ReduceOp>(op);
             OpPtr operand = reduce_op->get_operand();
             bw_toposort(operand);
+            add_consumer(operand);
             m_bw_tape.push_back(op);
             m_num_bw_edges++;
             break;
@@ -128,6 +228,9 @@ namespace nx::graph {
 
             // Initialize gradient structure without allocating buffer memory
             // This traverses forward tape in reverse direction
+            // Gradients keep the dtypes of the forward ops rather than the current autocast dtype
+            AutocastGuard guard(nullptr);
+
             for (auto &op : std::views::reverse(m_fw_tape)) {
                 if (op->is_grad_enabled()) {
                     op->grad_fn();
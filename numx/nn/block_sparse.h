@@ -0,0 +1,130 @@
+#pragma once
+
+#include "functional.h"
+#include "linear.h"
+
+namespace nx::nn {
+    // Packs the (block_rows, block_cols) blocks of a 2D weight that hold any element above the threshold in magnitude,
+    // returns the i32 offsets of every block row into the packed blocks, the i32 block column of every packed block
+    // and the f32 packed blocks of shape (blocks, block_rows, block_cols), all of them evaluated
+    inline std::tuple<Array, Array, Array> block_sparsify(const Array &weight, isize block_rows = 16, isize block_cols = 16, float threshold = 0.0f) {
+        if (weight.get_ndim() != 2 || block_rows <= 0 || block_cols <= 0 || weight.get_size(0) % block_rows != 0 || weight.get_size(1) % block_cols != 0) {
+            throw std::invalid_argument(std::format("Weight of shape ({}) cannot be split into ({}, {}) blocks.", join_nums(weight.get_view()), block_rows, block_cols));
+        }
+
+        // The blocks are selected on the host which shares memory with the device
+        Array dense(nx::graph::copy(weight.astype(&f32).get_op()));
+        dense.eval();
+        const float *ptr = reinterpret_cast<const float *>(dense.get_ptr());
+        const isize nrow = weight.get_size(0);
+        const isize ncol = weight.get_size(1);
+        const isize block_size = block_rows * block_cols;
+        std::vector<int32_t> block_ptr = {0};
+        std::vector<int32_t> block_col;
+        std::vector<float> block_values;
+
+        for (isize block_row = 0; block_row < nrow / block_rows; ++block_row) {
+            for (isize col = 0; col < ncol / block_cols; ++col) {
+                const float *block = ptr + block_row * block_rows * ncol + col * block_cols;
+                bool nonzero = false;
+
+                for (isize i = 0; i < block_rows && !nonzero; ++i) {
+                    for (isize j = 0; j < block_cols && !nonzero; ++j) {
+                        nonzero = std::abs(block[i * ncol + j]) > threshold;
+                    }
+                }
+
+                if (!nonzero) {
+                    continue;
+                }
+
+                block_col.push_back(static_cast<int32_t>(col));
+
+                for (isize i = 0; i < block_rows; ++i) {
+                    block_values.insert(block_values.end(), block + i * ncol, block + i * ncol + block_cols);
+                }
+            }
+
+            block_ptr.push_back(static_cast<int32_t>(block_col.size()));
+        }
+
+        // A fully pruned weight keeps one block of zeros so that no array is empty
+        if (block_col.empty()) {
+            block_col.push_back(0);
+            block_values.resize(block_size, 0.0f);
+            std::fill(block_ptr.begin() + 1, block_ptr.end(), 1);
+        }
+
+        // Host vectors are copied into device arrays before they go out of scope
+        auto to_array = [&weight](void *data, isize nbytes, const ShapeView &view, DtypePtr dtype) {
+            Array array(nx::graph::copy(nx::graph::from_buffer(static_cast<uint8_t *>(data), nbytes, Shape(view), dtype, weight.get_device())));
+            array.eval();
+            return array;
+        };
+
+        const isize nblock = static_cast<isize>(block_col.size());
+        Array block_ptr_array = to_array(block_ptr.data(), block_ptr.size() * sizeof(int32_t), {static_cast<isize>(block_ptr.size())}, &i32);
+        Array block_col_array = to_array(block_col.data(), nblock * sizeof(int32_t), {nblock}, &i32);
+        Array block_value_array = to_array(block_values.data(), nblock * block_size * sizeof(float), {nblock, block_rows, block_cols}, &f32);
+        return {std::move(block_ptr_array), std::move(block_col_array), std::move(block_value_array)};
+    }
+
+    // Multiplies x with the transpose of the block-sparse weight of shape (out, in_features), the work is proportional to the packed blocks
+    inline Array block_sparse_linear(const Array &x, const Array &block_ptr, const Array &block_col, const Array &block_values, isize in_features) {
+        return Array(nx::graph::block_sparse_matmul(x.get_op(), block_ptr.get_op(), block_col.get_op(), block_values.get_op(), nullptr, in_features));
+    }
+
+    inline Array block_sparse_linear_with_bias(const Array &x, const Array &block_ptr, const Array &block_col, const Array &block_values, const Array &bias, isize in_features) {
+        return Array(nx::graph::block_sparse_matmul(x.get_op(), block_ptr.get_op(), block_col.get_op(), block_values.get_op(), bias.get_op(), in_features));
+    }
+
+    // Inference-only copy of a pruned linear layer that keeps the weight blocks with any element above the threshold,
+    // the forward API is that of the linear layer and the cost scales with the fraction of kept blocks
+    class BlockSparseLinear : public Module {
+    private:
+        ArrayPtr m_block_ptr_holder;
+        ArrayPtr m_block_col_holder;
+        ArrayPtr m_block_value_holder;
+        ArrayPtr m_bias_holder;
+        ArrayPtr m_block_ptr;
+        ArrayPtr m_block_col;
+        ArrayPtr m_block_values;
+        ArrayPtr m_bias;
+        isize m_in_features;
+        isize m_out_features;
+
+    public:
+        BlockSparseLinear(Linear &linear, isize block_rows = 16, isize block_cols = 16, float threshold = 0.0f) {
+            if (threshold < 0) {
+                throw std::invalid_argument(std::format("Pruning threshold {} of a block-sparse linear layer cannot be negative.", threshold));
+            }
+
+            const Array &weight = *linear.get_weight();
+            m_out_features = weight.get_size(0);
+            m_in_features = weight.get_size(1);
+            auto [block_ptr, block_col, block_values] = block_sparsify(weight, block_rows, block_cols, threshold);
+            m_block_ptr_holder = std::make_shared<Array>(std::move(block_ptr));
+            m_block_col_holder = std::make_shared<Array>(std::move(block_col));
+            m_block_value_holder = std::make_shared<Array>(std::move(block_values));
+            m_block_ptr = std::make_shared<Array>(m_block_ptr_holder->detach());
+            m_block_col = std::make_shared<Array>(m_block_col_holder->detach());
+            m_block_values = std::make_shared<Array>(m_block_value_holder->detach());
+
+            if (linear.get_bias()) {
+                Array bias(nx::graph::copy(linear.get_bias()->get_op()));
+                bias.eval();
+                m_bias_holder = std::make_shared<Array>(std::move(bias));
+                m_bias = std::make_shared<Array>(m_bias_holder->detach());
+            }
+        }
+
+        ~BlockSparseLinear() = default;
+        const Array &get_block_ptr() const { return *m_block_ptr; }
+        const Array &get_block_col() const { return *m_block_col; }
+        const Array &get_block_values() const { return *m_block_values; }
+        isize get_block_rows() const { return m_block_values->get_size(1); }
+        isize get_block_cols() const { return m_block_values->get_size(2); }
+        float get_density() const { return static_cast<float>(m_block_values->get_numel()) / (m_in_features * m_out_features); }
+        Array forward(const Array &x) override { return m_bias ? block_sparse_linear_with_bias(x, *m_block_ptr, *m_block_col, *m_block_values, *m_bias, m_in_features) : block_sparse_linear(x, *m_block_ptr, *m_block_col, *m_block_values, m_in_features); }
+    };
+} // namespace nx::nn
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../random/random.h"
+#include "functional.h"
+#include "module.h"
+
+namespace nx::nn {
+    using namespace nx::random;
+
+    class Conv2d : public Module {
+    private:
+        ArrayPtr m_weight_holder;
+        ArrayPtr m_bias_holder;
+        ParameterPtr m_weight;
+        ParameterPtr m_bias;
+        ShapeView m_stride;
+        ShapeView m_padding;
+        ShapeView m_dilation;
+        ConvLayout m_layout;
+
+    public:
+        Conv2d(isize in_channels, isize out_channels, const ShapeView &kernel_size, const ShapeView &stride = {1, 1}, const ShapeView &padding = {0, 0}, const ShapeView &dilation = {1, 1}, bool has_bias = true, ConvLayout layout = ConvLayout::NCHW) : m_stride(stride), m_padding(padding), m_dilation(dilation), m_layout(layout) {
+            if (kernel_size.size() != 2) {
+                throw std::invalid_argument("Kernel size of Conv2d must have 2 values.");
+            }
+
+            // Weight is (out_channels, in_channels, kernel_h, kernel_w) in both layouts
+            Array weight = kaiming_uniform({out_channels, in_channels, kernel_size[0], kernel_size[1]});
+            weight.eval();
+            m_weight_holder = std::make_shared<Array>(std::move(weight));
+            m_weight = std::make_shared<Parameter>(*m_weight_holder);
+            add_parameter(m_weight);
+
+            if (has_bias) {
+                auto [fan_in, fan_out] = compute_fan_in_and_fan_out(*m_weight);
+                float bound = 1.0f / std::sqrt(fan_in);
+                Array bias = uniform({out_channels}, -bound, bound);
+                bias.eval();
+                m_bias_holder = std::make_shared<Array>(std::move(bias));
+                m_bias = std::make_shared<Parameter>(*m_bias_holder);
+                add_parameter(m_bias);
+            }
+        }
+
+        ~Conv2d() = default;
+        ParameterPtr get_weight() { return m_weight; }
+        ParameterPtr get_bias() { return m_bias; }
+
+        void set_weight(Array &&weight) {
+            m_weight_holder = std::make_shared<Array>(std::move(weight));
+            ParameterPtr param = std::make_shared<Parameter>(*m_weight_holder);
+            replace_parameter(m_weight, param);
+            m_weight = param;
+        }
+
+        void set_bias(Array &&bias) {
+            m_bias_holder = std::make_shared<Array>(std::move(bias));
+            ParameterPtr param = std::make_shared<Parameter>(*m_bias_holder);
+            replace_parameter(m_bias, param);
+            m_bias = param;
+        }
+
+        Array forward(const Array &x) override {
+            return m_bias ? conv2d_with_bias(x, *m_weight, *m_bias, m_stride, m_padding, m_dilation, m_layout) : conv2d(x, *m_weight, m_stride, m_padding, m_dilation, m_layout);
+        }
+    };
+} // namespace nx::nn
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "functional.h"
+#include "module.h"
+
+namespace nx::nn {
+    class Dropout : public Module {
+    private:
+        float m_p;
+
+    public:
+        Dropout(float p = 0.5f) : m_p(p) {}
+        ~Dropout() = default;
+        float get_p() const { return m_p; }
+        Array forward(const Array &x) override { return dropout(x, m_p, m_training); }
+    };
+} // namespace nx::nn
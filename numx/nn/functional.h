@@ -1,12 +1,35 @@
 #pragma once
 
+#include "../core/einsum.h"
 #include "../core/functional.h"
+#include "../random/random.h"
 
 namespace nx::nn {
     using namespace nx::core;
 
     inline Array relu(const Array &x) {
-        return x.maximum(0);
+        return Array(nx::graph::relu(x.get_op()));
+    }
+
+    inline Array sigmoid(const Array &x) {
+        return Array(nx::graph::sigmoid(x.get_op()));
+    }
+
+    inline Array tanh(const Array &x) {
+        return Array(nx::graph::tanh(x.get_op()));
+    }
+
+    // The approximate variant uses the tanh formulation instead of erf
+    inline Array gelu(const Array &x, bool approximate = false) {
+        return Array(nx::graph::gelu(x.get_op(), approximate));
+    }
+
+    inline Array silu(const Array &x) {
+        return Array(nx::graph::silu(x.get_op()));
+    }
+
+    inline Array softplus(const Array &x) {
+        return Array(nx::graph::softplus(x.get_op()));
     }
 
     inline Array linear(const Array &x, const Array &weight) {
@@ -18,6 +41,205 @@ namespace nx::nn {
         return linear(x, weight) + bias;
     }
 
+    inline Array conv2d(const Array &x, const Array &weight, const ShapeView &stride = {1, 1}, const ShapeView &padding = {0, 0}, const ShapeView &dilation = {1, 1}, ConvLayout layout = ConvLayout::NCHW) {
+        if (stride.size() != 2 || padding.size() != 2 || dilation.size() != 2) {
+            throw std::invalid_argument("Stride, padding and dilation of conv2d must each have 2 values.");
+        }
+
+        // Kernel size is taken from the weight of shape (out_channels, in_channels, kernel_h, kernel_w)
+        Conv2dParams params;
+        params.stride_h = stride[0];
+        params.stride_w = stride[1];
+        params.padding_h = padding[0];
+        params.padding_w = padding[1];
+        params.dilation_h = dilation[0];
+        params.dilation_w = dilation[1];
+        params.layout = layout;
+        return Array(nx::graph::conv2d(x.get_op(), weight.get_op(), params));
+    }
+
+    inline Array conv2d_with_bias(const Array &x, const Array &weight, const Array &bias, const ShapeView &stride = {1, 1}, const ShapeView &padding = {0, 0}, const ShapeView &dilation = {1, 1}, ConvLayout layout = ConvLayout::NCHW) {
+        Array out = conv2d(x, weight, stride, padding, dilation, layout);
+        // Channels are the last dimension in NHWC so the bias broadcasts as is
+        return layout == ConvLayout::NHWC ? out + bias : out + bias.reshape({bias.get_size(0), 1, 1});
+    }
+
+    // Direct convolution takes N * O * C * L_out * K multiply-adds. The FFT path transforms N * C signals, O * C kernels
+    // and N * O outputs at about 2.5 S log2(S) each and multiplies N * C * O spectra of S / 2 + 1 complex bins, it is
+    // weighted 4x since the transforms and per-frequency products are memory bound unlike the tiled GEMM.
+    inline bool prefer_fft_conv1d(isize batch, isize in_channels, isize out_channels, isize length, isize kernel_size) {
+        const double nfft = static_cast<double>(std::bit_ceil(static_cast<uint64_t>(length)));
+        const double direct_cost = static_cast<double>(batch * out_channels * in_channels) * static_cast<double>((length - kernel_size + 1) * kernel_size);
+        const double transform_cost = 2.5 * nfft * std::log2(nfft) * static_cast<double>(batch * in_channels + out_channels * in_channels + batch * out_channels);
+        const double product_cost = 4.0 * static_cast<double>(batch * in_channels * out_channels) * (nfft / 2.0 + 1.0);
+        return 4.0 * (transform_cost + product_cost) < direct_cost;
+    }
+
+    // Cross-correlation of x (N, C, L) with a weight (O, C, K) like conv1d with unit stride. Long kernels go through the
+    // spectra of both padded to a power of two, short ones through conv2d, use_fft forces either path.
+    inline Array fft_conv1d(const Array &x, const Array &weight, isize padding = 0, std::optional<bool> use_fft = std::nullopt) {
+        const ShapeView &x_view = x.get_view();
+        const ShapeView &weight_view = weight.get_view();
+
+        if (x.get_ndim() != 3 || weight.get_ndim() != 3 || x_view[1] != weight_view[1] || padding < 0 || x_view[2] + 2 * padding < weight_view[2]) {
+            throw std::invalid_argument(std::format("Cannot run fft_conv1d on input of shape ({}) and weight of shape ({}) with padding {}.", join_nums(x_view), join_nums(weight_view), padding));
+        }
+
+        const isize batch = x_view[0];
+        const isize in_channels = x_view[1];
+        const isize out_channels = weight_view[0];
+        const isize kernel_size = weight_view[2];
+        const isize length = x_view[2] + 2 * padding;
+        const isize out_length = length - kernel_size + 1;
+
+        if (!use_fft.value_or(prefer_fft_conv1d(batch, in_channels, out_channels, length, kernel_size))) {
+            Array y = conv2d(x.reshape({batch, in_channels, 1, x_view[2]}), weight.reshape({out_channels, in_channels, 1, kernel_size}), {1, 1}, {0, padding});
+            return y.reshape({batch, out_channels, out_length});
+        }
+
+        Array signal = x;
+
+        if (padding > 0) {
+            Array pad(nx::graph::zeros({batch, in_channels, padding}, x.get_dtype(), x.get_device()));
+            signal = concat({pad, x, pad}, 2);
+        }
+
+        // Outputs never reach past the padded signal, so a transform of at least its length has no wraparound
+        const isize nfft = static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(length)));
+        ArrayVector weight_parts = split(rfft(weight, nfft), ShapeView{1, 1}, 3);
+        Array weight_re = weight_parts[0].squeeze({3});
+        Array weight_im = weight_parts[1].squeeze({3});
+        // Correlation multiplies by the conjugate kernel spectrum, (a + bi)(c - di) = (ac + bd) + (bc - ad)i, which is a
+        // single contraction over the input channels and parts of x against the (part of x, part of y) kernel blocks
+        Array blocks = stack({stack({weight_re, -weight_im}), stack({weight_im, weight_re})});
+        Array y = irfft(einsum("ncfr,rpocf->nofp", rfft(signal, nfft), blocks), nfft);
+        return y.slice({Range(0, batch), Range(0, out_channels), Range(0, out_length)});
+    }
+
+    inline Pool2dParams make_pool2d_params(const ShapeView &kernel_size, const ShapeView &stride, const ShapeView &padding, ConvLayout layout) {
+        // An empty stride defaults to the kernel size
+        if (kernel_size.size() != 2 || (!stride.empty() && stride.size() != 2) || padding.size() != 2) {
+            throw std::invalid_argument("Kernel size, stride and padding of 2D pooling must each have 2 values.");
+        }
+
+        Pool2dParams params;
+        params.kernel_h = kernel_size[0];
+        params.kernel_w = kernel_size[1];
+        params.stride_h = stride.empty() ? kernel_size[0] : stride[0];
+        params.stride_w = stride.empty() ? kernel_size[1] : stride[1];
+        params.padding_h = padding[0];
+        params.padding_w = padding[1];
+        params.layout = layout;
+        return params;
+    }
+
+    inline Array max_pool2d(const Array &x, const ShapeView &kernel_size, const ShapeView &stride = {}, const ShapeView &padding = {0, 0}, ConvLayout layout = ConvLayout::NCHW) {
+        return Array(nx::graph::maxpool2d(x.get_op(), make_pool2d_params(kernel_size, stride, padding, layout)));
+    }
+
+    inline Array avg_pool2d(const Array &x, const ShapeView &kernel_size, const ShapeView &stride = {}, const ShapeView &padding = {0, 0}, ConvLayout layout = ConvLayout::NCHW) {
+        return Array(nx::graph::avgpool2d(x.get_op(), make_pool2d_params(kernel_size, stride, padding, layout)));
+    }
+
+    inline Array adaptive_avg_pool2d(const Array &x, const ShapeView &output_size, ConvLayout layout = ConvLayout::NCHW) {
+        if (output_size.size() != 2) {
+            throw std::invalid_argument("Output size of adaptive 2D pooling must have 2 values.");
+        }
+
+        Pool2dParams params;
+        params.adaptive = true;
+        params.out_h = output_size[0];
+        params.out_w = output_size[1];
+        params.layout = layout;
+        return Array(nx::graph::avgpool2d(x.get_op(), params));
+    }
+
+    inline Array dropout(const Array &x, float p = 0.5f, bool training = true) {
+        // Inference keeps every element so no op is added
+        if (!training || p == 0) {
+            return x;
+        }
+
+        uint64_t key = nx::random::get_random_key_generator(x.get_data().get_device_name())->next();
+        return Array(nx::graph::dropout(x.get_op(), key, p));
+    }
+
+    inline Array layer_norm(const Array &x, const Array &weight, const Array &bias, float eps = 1e-5f) {
+        return Array(nx::graph::layer_norm(x.get_op(), weight.get_op(), bias.get_op(), eps));
+    }
+
+    inline Array rms_norm(const Array &x, const Array &weight, float eps = 1e-6f) {
+        return Array(nx::graph::rms_norm(x.get_op(), weight.get_op(), eps));
+    }
+
+    inline Array batch_norm(const Array &x, const Array &weight, const Array &bias, const Array &running_mean, const Array &running_var, bool training, float momentum = 0.1f, float eps = 1e-5f, ConvLayout layout = ConvLayout::NCHW) {
+        // Channels are the second dimension in NCHW and the last one in NHWC
+        BatchNormParams params;
+        params.channel_dim = layout == ConvLayout::NHWC ? x.get_ndim() - 1 : 1;
+        params.eps = eps;
+        params.momentum = momentum;
+        params.training = training;
+        return Array(nx::graph::batch_norm(x.get_op(), weight.get_op(), bias.get_op(), running_mean.get_op(), running_var.get_op(), params));
+    }
+
+    inline Array scaled_dot_product_attention(const Array &q, const Array &k, const Array &v, bool causal = false, std::optional<float> scale = std::nullopt) {
+        // Scale defaults to the inverse square root of the head size
+        const float attn_scale = scale.value_or(1.0f / std::sqrt(static_cast<float>(q.get_view().back())));
+        return Array(nx::graph::sdpa(q.get_op(), k.get_op(), v.get_op(), attn_scale, causal));
+    }
+
+    // Gate weights are packed as (4 * hidden, input) and (4 * hidden, hidden) with the input, forget, cell and output gates in that order
+    // so each projection is one GEMM for all gates, returns the next hidden and cell states
+    inline std::pair<Array, Array> lstm_cell(const Array &x, const Array &h, const Array &c, const Array &weight_ih, const Array &weight_hh, const Array &bias_ih, const Array &bias_hh) {
+        Array gi = linear_with_bias(x, weight_ih, bias_ih);
+        Array gh = linear_with_bias(h, weight_hh, bias_hh);
+        // The next states are packed as (batch, 2 * hidden) by the fused epilogue
+        Array state(nx::graph::lstm_cell(gi.get_op(), gh.get_op(), c.get_op()));
+        const isize nbatch = c.get_size(0);
+        const isize nhidden = c.get_size(1);
+        return {state.slice({Range(0, nbatch), Range(0, nhidden)}), state.slice({Range(0, nbatch), Range(nhidden, 2 * nhidden)})};
+    }
+
+    // Gate weights are packed as (3 * hidden, input) and (3 * hidden, hidden) with the reset, update and new gates in that order,
+    // returns the next hidden state
+    inline Array gru_cell(const Array &x, const Array &h, const Array &weight_ih, const Array &weight_hh, const Array &bias_ih, const Array &bias_hh) {
+        Array gi = linear_with_bias(x, weight_ih, bias_ih);
+        Array gh = linear_with_bias(h, weight_hh, bias_hh);
+        return Array(nx::graph::gru_cell(gi.get_op(), gh.get_op(), h.get_op()));
+    }
+
+    // The kernels read the hidden weight transposed so consecutive threads read consecutive gate columns
+    inline Array recurrent_hidden_weight(const Array &weight_hh) {
+        return Array(nx::graph::copy(weight_hh.transpose(0, 1).get_op()));
+    }
+
+    // Runs an LSTM over a (steps, batch, input) sequence with the time loop inside one kernel after one GEMM for the input projections of all steps,
+    // returns the hidden states of every step and the final hidden and cell states
+    inline std::tuple<Array, Array, Array> lstm(const Array &x, const Array &h0, const Array &c0, const Array &weight_ih, const Array &weight_hh, const Array &bias_ih, const Array &bias_hh) {
+        Array gi = linear_with_bias(x, weight_ih, bias_ih + bias_hh);
+        Array weight = recurrent_hidden_weight(weight_hh);
+        // Hidden and cell states of every step are packed as (steps, batch, 2 * hidden)
+        Array state(nx::graph::lstm(gi.get_op(), weight.get_op(), h0.get_op(), c0.get_op()));
+        const isize nstep = x.get_size(0);
+        const isize nbatch = h0.get_size(0);
+        const isize nhidden = h0.get_size(1);
+        Array y = state.slice({Range(0, nstep), Range(0, nbatch), Range(0, nhidden)});
+        Array h_n = state.slice({Range(nstep - 1, nstep), Range(0, nbatch), Range(0, nhidden)}).squeeze({0});
+        Array c_n = state.slice({Range(nstep - 1, nstep), Range(0, nbatch), Range(nhidden, 2 * nhidden)}).squeeze({0});
+        return {y, h_n, c_n};
+    }
+
+    // Runs a GRU over a (steps, batch, input) sequence with the time loop inside one kernel after one GEMM for the input projections of all steps,
+    // returns the hidden states of every step and the final hidden state
+    inline std::pair<Array, Array> gru(const Array &x, const Array &h0, const Array &weight_ih, const Array &weight_hh, const Array &bias_ih, const Array &bias_hh) {
+        Array gi = linear_with_bias(x, weight_ih, bias_ih);
+        Array weight = recurrent_hidden_weight(weight_hh);
+        Array y(nx::graph::gru(gi.get_op(), weight.get_op(), bias_hh.get_op(), h0.get_op()));
+        const isize nstep = x.get_size(0);
+        Array h_n = y.slice({Range(nstep - 1, nstep), Range(0, h0.get_size(0)), Range(0, h0.get_size(1))}).squeeze({0});
+        return {y, h_n};
+    }
+
     inline Array onehot(const Array &x, isize num_classes) {
         if (!x.get_dtype()->is_int()) {
             throw std::invalid_argument(std::format("Array {} is not of type int.", x.get_id().str()));
@@ -32,6 +254,12 @@ namespace nx::nn {
     }
 
     inline Array softmax(const Array &x, isize dim) {
+        // Exponentials and their sums are too coarse in 16 bits so autocast runs softmax in f32
+        if (get_autocast_dtype() && x.get_dtype()->is_float()) {
+            AutocastGuard guard(nullptr);
+            return softmax(x.astype(&f32), dim);
+        }
+
         ShapeDims dims;
         isize ndim = x.get_ndim();
 
@@ -69,6 +297,11 @@ namespace nx::nn {
         target_onehot * x: (*, N)
         loss: (1)
         */
+        if (get_autocast_dtype() && x.get_dtype()->is_float()) {
+            AutocastGuard guard(nullptr);
+            return cross_entropy_loss(x.astype(&f32), y);
+        }
+
         isize ndim = x.get_ndim();
         Array max = x.max({ndim - 1});
         Array exp = (x - max).exp();
@@ -36,6 +36,20 @@ namespace nx::nn {
         ~Linear() = default;
         ParameterPtr get_weight() { return m_weight; }
         ParameterPtr get_bias() { return m_bias; }
+
+        void set_weight(Array &&weight) {
+            m_weight_holder = std::make_shared<Array>(std::move(weight));
+            ParameterPtr param = std::make_shared<Parameter>(*m_weight_holder);
+            replace_parameter(m_weight, param);
+            m_weight = param;
+        }
+
+        void set_bias(Array &&bias) {
+            m_bias_holder = std::make_shared<Array>(std::move(bias));
+            ParameterPtr param = std::make_shared<Parameter>(*m_bias_holder);
+            replace_parameter(m_bias, param);
+            m_bias = param;
+        }
         Array forward(const Array &x) override { return m_bias ? linear_with_bias(x, *m_weight, *m_bias) : linear(x, *m_weight); }
     };
 } // namespace nx::nn
\ No newline at end of file
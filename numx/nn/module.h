@@ -6,9 +6,21 @@ namespace nx::nn {
     class Module {
     protected:
         ParameterPtrVector m_params;
+        bool m_training = true;
 
         void add_parameter(ParameterPtr param) { m_params.push_back(param); }
 
+        // Swaps a registered parameter for another in place, a missing parameter is added
+        void replace_parameter(ParameterPtr old_param, ParameterPtr new_param) {
+            auto it = std::find(m_params.begin(), m_params.end(), old_param);
+
+            if (it == m_params.end()) {
+                add_parameter(new_param);
+            } else {
+                *it = new_param;
+            }
+        }
+
     public:
         Module() = default;
         Module(const Module &) = delete;
@@ -19,6 +31,10 @@ namespace nx::nn {
         const ParameterPtrVector &get_parameters() const { return m_params; }
         ParameterPtrVector::const_iterator begin() const { return m_params.cbegin(); }
         ParameterPtrVector::const_iterator end() const { return m_params.cend(); }
+        // Modules such as batch normalization behave differently during training and inference
+        void train(bool mode = true) { m_training = mode; }
+        void eval() { m_training = false; }
+        bool is_training() const { return m_training; }
         virtual Array forward(const Array &x) = 0;
         Array operator()(const Array &x) { return forward(x); }
     };
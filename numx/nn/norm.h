@@ -0,0 +1,144 @@
+#pragma once
+
+#include "conv.h"
+#include "functional.h"
+#include "linear.h"
+#include "module.h"
+
+namespace nx::nn {
+    class LayerNorm : public Module {
+    private:
+        ArrayPtr m_weight_holder;
+        ArrayPtr m_bias_holder;
+        ParameterPtr m_weight;
+        ParameterPtr m_bias;
+        float m_eps;
+
+    public:
+        LayerNorm(isize normalized_size, float eps = 1e-5f) : m_eps(eps) {
+            Array weight = ones({normalized_size});
+            weight.eval();
+            m_weight_holder = std::make_shared<Array>(std::move(weight));
+            m_weight = std::make_shared<Parameter>(*m_weight_holder);
+            add_parameter(m_weight);
+            Array bias = zeros({normalized_size});
+            bias.eval();
+            m_bias_holder = std::make_shared<Array>(std::move(bias));
+            m_bias = std::make_shared<Parameter>(*m_bias_holder);
+            add_parameter(m_bias);
+        }
+
+        ~LayerNorm() = default;
+        ParameterPtr get_weight() { return m_weight; }
+        ParameterPtr get_bias() { return m_bias; }
+        Array forward(const Array &x) override { return layer_norm(x, *m_weight, *m_bias, m_eps); }
+    };
+
+    class RMSNorm : public Module {
+    private:
+        ArrayPtr m_weight_holder;
+        ParameterPtr m_weight;
+        float m_eps;
+
+    public:
+        RMSNorm(isize normalized_size, float eps = 1e-6f) : m_eps(eps) {
+            Array weight = ones({normalized_size});
+            weight.eval();
+            m_weight_holder = std::make_shared<Array>(std::move(weight));
+            m_weight = std::make_shared<Parameter>(*m_weight_holder);
+            add_parameter(m_weight);
+        }
+
+        ~RMSNorm() = default;
+        ParameterPtr get_weight() { return m_weight; }
+        Array forward(const Array &x) override { return rms_norm(x, *m_weight, m_eps); }
+    };
+
+    class BatchNorm : public Module {
+    private:
+        ArrayPtr m_weight_holder;
+        ArrayPtr m_bias_holder;
+        ArrayPtr m_running_mean_holder;
+        ArrayPtr m_running_var_holder;
+        ParameterPtr m_weight;
+        ParameterPtr m_bias;
+        // Running statistics are updated by the kernel but never trained
+        ParameterPtr m_running_mean;
+        ParameterPtr m_running_var;
+        float m_momentum;
+        float m_eps;
+        ConvLayout m_layout;
+        bool m_folded = false;
+
+        static ParameterPtr make_parameter(ArrayPtr &holder, Array &&array) {
+            array.eval();
+            holder = std::make_shared<Array>(std::move(array));
+            return std::make_shared<Parameter>(*holder);
+        }
+
+    public:
+        BatchNorm(isize num_features, float momentum = 0.1f, float eps = 1e-5f, ConvLayout layout = ConvLayout::NCHW) : m_momentum(momentum), m_eps(eps), m_layout(layout) {
+            m_weight = make_parameter(m_weight_holder, ones({num_features}));
+            add_parameter(m_weight);
+            m_bias = make_parameter(m_bias_holder, zeros({num_features}));
+            add_parameter(m_bias);
+            m_running_mean = make_parameter(m_running_mean_holder, zeros({num_features}));
+            m_running_mean->enable_grad(false);
+            m_running_var = make_parameter(m_running_var_holder, ones({num_features}));
+            m_running_var->enable_grad(false);
+        }
+
+        ~BatchNorm() = default;
+        ParameterPtr get_weight() { return m_weight; }
+        ParameterPtr get_bias() { return m_bias; }
+        ParameterPtr get_running_mean() { return m_running_mean; }
+        ParameterPtr get_running_var() { return m_running_var; }
+        float get_eps() const { return m_eps; }
+        bool is_folded() const { return m_folded; }
+        // The affine transform now lives in the preceding layer so the forward pass is the identity
+        void set_folded() { m_folded = true; }
+
+        Array forward(const Array &x) override {
+            return m_folded ? x : batch_norm(x, *m_weight, *m_bias, *m_running_mean, *m_running_var, m_training, m_momentum, m_eps, m_layout);
+        }
+    };
+
+    // Per output channel scale and shift of an inference batch normalization
+    inline std::pair<Array, Array> batch_norm_scale_and_shift(BatchNorm &bn, const Array &bias) {
+        if (bn.is_training() || bn.is_folded()) {
+            throw std::invalid_argument("BatchNorm must be in inference mode and not yet folded to be folded.");
+        }
+
+        Array scale = *bn.get_weight() * (*bn.get_running_var() + bn.get_eps()).sqrt().recip();
+        Array shift = (bias - *bn.get_running_mean()) * scale + *bn.get_bias();
+        return {scale, shift};
+    }
+
+    // Folds an inference batch normalization that follows a linear layer into the layer's weight and bias
+    inline void fold_batch_norm(Linear &linear, BatchNorm &bn) {
+        const Array &weight = *linear.get_weight();
+        const isize out_features = weight.get_size(0);
+        Array bias = linear.get_bias() ? Array(*linear.get_bias()) : zeros({out_features});
+        auto [scale, shift] = batch_norm_scale_and_shift(bn, bias);
+        Array folded_weight = weight * scale.reshape({out_features, 1});
+        folded_weight.eval();
+        shift.eval();
+        linear.set_weight(std::move(folded_weight));
+        linear.set_bias(std::move(shift));
+        bn.set_folded();
+    }
+
+    // Folds an inference batch normalization that follows a convolution into the convolution's weight and bias
+    inline void fold_batch_norm(Conv2d &conv, BatchNorm &bn) {
+        const Array &weight = *conv.get_weight();
+        const isize out_channels = weight.get_size(0);
+        Array bias = conv.get_bias() ? Array(*conv.get_bias()) : zeros({out_channels});
+        auto [scale, shift] = batch_norm_scale_and_shift(bn, bias);
+        Array folded_weight = weight * scale.reshape({out_channels, 1, 1, 1});
+        folded_weight.eval();
+        shift.eval();
+        conv.set_weight(std::move(folded_weight));
+        conv.set_bias(std::move(shift));
+        bn.set_folded();
+    }
+} // namespace nx::nn
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "functional.h"
+#include "module.h"
+
+namespace nx::nn {
+    class MaxPool2d : public Module {
+    private:
+        ShapeView m_kernel_size;
+        ShapeView m_stride;
+        ShapeView m_padding;
+        ConvLayout m_layout;
+
+    public:
+        MaxPool2d(const ShapeView &kernel_size, const ShapeView &stride = {}, const ShapeView &padding = {0, 0}, ConvLayout layout = ConvLayout::NCHW) : m_kernel_size(kernel_size), m_stride(stride), m_padding(padding), m_layout(layout) {}
+        ~MaxPool2d() = default;
+        Array forward(const Array &x) override { return max_pool2d(x, m_kernel_size, m_stride, m_padding, m_layout); }
+    };
+
+    class AvgPool2d : public Module {
+    private:
+        ShapeView m_kernel_size;
+        ShapeView m_stride;
+        ShapeView m_padding;
+        ConvLayout m_layout;
+
+    public:
+        AvgPool2d(const ShapeView &kernel_size, const ShapeView &stride = {}, const ShapeView &padding = {0, 0}, ConvLayout layout = ConvLayout::NCHW) : m_kernel_size(kernel_size), m_stride(stride), m_padding(padding), m_layout(layout) {}
+        ~AvgPool2d() = default;
+        Array forward(const Array &x) override { return avg_pool2d(x, m_kernel_size, m_stride, m_padding, m_layout); }
+    };
+
+    class AdaptiveAvgPool2d : public Module {
+    private:
+        ShapeView m_output_size;
+        ConvLayout m_layout;
+
+    public:
+        AdaptiveAvgPool2d(const ShapeView &output_size, ConvLayout layout = ConvLayout::NCHW) : m_output_size(output_size), m_layout(layout) {}
+        ~AdaptiveAvgPool2d() = default;
+        Array forward(const Array &x) override { return adaptive_avg_pool2d(x, m_output_size, m_layout); }
+    };
+} // namespace nx::nn
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "functional.h"
+#include "linear.h"
+
+namespace nx::nn {
+    // Symmetric int8 quantization over the last dimension, returns the quantized array and its per-row f32 scales
+    inline std::pair<Array, Array> quantize(const Array &x, float clip = 0.0f) {
+        OpPtr out_op = nx::graph::quantize(x.get_op(), clip);
+        return {Array(out_op), Array(nx::graph::quantize_scale(out_op))};
+    }
+
+    // Activations are quantized per row on the fly, the output keeps the dtype of x
+    inline Array quantized_linear(const Array &x, const Array &weight, const Array &weight_scale, QuantizedActivation activation = QuantizedActivation::NONE, float clip = 0.0f) {
+        return Array(nx::graph::quantized_matmul(x.get_op(), weight.get_op(), weight_scale.get_op(), nullptr, activation, clip));
+    }
+
+    inline Array quantized_linear_with_bias(const Array &x, const Array &weight, const Array &weight_scale, const Array &bias, QuantizedActivation activation = QuantizedActivation::NONE, float clip = 0.0f) {
+        return Array(nx::graph::quantized_matmul(x.get_op(), weight.get_op(), weight_scale.get_op(), bias.get_op(), activation, clip));
+    }
+
+    // Tracks the largest absolute activation over calibration batches, the result is the clipping range of a quantized layer
+    class AbsMaxObserver {
+    private:
+        float m_absmax = 0.0f;
+
+    public:
+        void observe(const Array &x) {
+            Array absmax = x.abs().max().astype(&f32);
+            m_absmax = std::max(m_absmax, std::bit_cast<float>(static_cast<int32_t>(absmax.item())));
+        }
+
+        float get_absmax() const { return m_absmax; }
+        void reset() { m_absmax = 0.0f; }
+    };
+
+    // Inference-only int8 copy of a linear layer with per-output-channel weight scales, the activation that follows the layer
+    // can be fused into the dequantization epilogue and a positive clip bounds the per-token activation ranges
+    class QuantizedLinear : public Module {
+    private:
+        ArrayPtr m_weight_holder;
+        ArrayPtr m_bias_holder;
+        ArrayPtr m_weight;
+        ArrayPtr m_weight_scale;
+        ArrayPtr m_bias;
+        QuantizedActivation m_activation;
+        float m_clip;
+
+    public:
+        QuantizedLinear(Linear &linear, QuantizedActivation activation = QuantizedActivation::NONE, float clip = 0.0f) : m_activation(activation), m_clip(clip) {
+            if (clip < 0) {
+                throw std::invalid_argument(std::format("Clipping range {} of a quantized linear layer cannot be negative.", clip));
+            }
+
+            // Evaluating the scales runs the quantization, so their holder keeps the quantized weight alive as well
+            // Nothing refers to the float layer afterwards so it can be released
+            auto [weight, weight_scale] = quantize(*linear.get_weight());
+            weight_scale.eval();
+            m_weight_holder = std::make_shared<Array>(std::move(weight_scale));
+            m_weight = std::make_shared<Array>(weight.detach());
+            m_weight_scale = std::make_shared<Array>(m_weight_holder->detach());
+
+            if (linear.get_bias()) {
+                Array bias(nx::graph::copy(linear.get_bias()->get_op()));
+                bias.eval();
+                m_bias_holder = std::make_shared<Array>(std::move(bias));
+                m_bias = std::make_shared<Array>(m_bias_holder->detach());
+            }
+        }
+
+        ~QuantizedLinear() = default;
+        const Array &get_weight() const { return *m_weight; }
+        const Array &get_weight_scale() const { return *m_weight_scale; }
+        QuantizedActivation get_activation() const { return m_activation; }
+        float get_clip() const { return m_clip; }
+        Array forward(const Array &x) override { return m_bias ? quantized_linear_with_bias(x, *m_weight, *m_weight_scale, *m_bias, m_activation, m_clip) : quantized_linear(x, *m_weight, *m_weight_scale, m_activation, m_clip); }
+    };
+} // namespace nx::nn
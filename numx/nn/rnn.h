@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../random/random.h"
+#include "functional.h"
+#include "module.h"
+
+namespace nx::nn {
+    using namespace nx::random;
+
+    // Gate-packed weights and biases shared by the recurrent layers, initialized uniformly within 1 / sqrt(hidden)
+    class RecurrentModule : public Module {
+    private:
+        ArrayPtr m_weight_ih_holder;
+        ArrayPtr m_weight_hh_holder;
+        ArrayPtr m_bias_ih_holder;
+        ArrayPtr m_bias_hh_holder;
+
+        ParameterPtr make_parameter(ArrayPtr &holder, const ShapeView &view) {
+            const float bound = 1.0f / std::sqrt(static_cast<float>(m_hidden_size));
+            Array array = uniform(view, -bound, bound);
+            array.eval();
+            holder = std::make_shared<Array>(std::move(array));
+            ParameterPtr param = std::make_shared<Parameter>(*holder);
+            add_parameter(param);
+            return param;
+        }
+
+    protected:
+        isize m_hidden_size;
+        ParameterPtr m_weight_ih;
+        ParameterPtr m_weight_hh;
+        ParameterPtr m_bias_ih;
+        ParameterPtr m_bias_hh;
+
+        // Zero state for inputs without an initial state
+        Array zero_state(const Array &x, isize batch_dim) const { return zeros({x.get_size(batch_dim), m_hidden_size}, x.get_dtype(), x.get_data().get_device_name()); }
+
+    public:
+        RecurrentModule(isize input_size, isize hidden_size, isize ngate) : m_hidden_size(hidden_size) {
+            m_weight_ih = make_parameter(m_weight_ih_holder, {ngate * hidden_size, input_size});
+            m_weight_hh = make_parameter(m_weight_hh_holder, {ngate * hidden_size, hidden_size});
+            m_bias_ih = make_parameter(m_bias_ih_holder, {ngate * hidden_size});
+            m_bias_hh = make_parameter(m_bias_hh_holder, {ngate * hidden_size});
+        }
+
+        isize get_hidden_size() const { return m_hidden_size; }
+        ParameterPtr get_weight_ih() { return m_weight_ih; }
+        ParameterPtr get_weight_hh() { return m_weight_hh; }
+        ParameterPtr get_bias_ih() { return m_bias_ih; }
+        ParameterPtr get_bias_hh() { return m_bias_hh; }
+    };
+
+    class LSTMCell : public RecurrentModule {
+    public:
+        LSTMCell(isize input_size, isize hidden_size) : RecurrentModule(input_size, hidden_size, 4) {}
+        ~LSTMCell() = default;
+        std::pair<Array, Array> forward(const Array &x, const Array &h, const Array &c) { return lstm_cell(x, h, c, *m_weight_ih, *m_weight_hh, *m_bias_ih, *m_bias_hh); }
+        // Starts from zero states and returns the next hidden state
+        Array forward(const Array &x) override { return forward(x, zero_state(x, 0), zero_state(x, 0)).first; }
+    };
+
+    class GRUCell : public RecurrentModule {
+    public:
+        GRUCell(isize input_size, isize hidden_size) : RecurrentModule(input_size, hidden_size, 3) {}
+        ~GRUCell() = default;
+        Array forward(const Array &x, const Array &h) { return gru_cell(x, h, *m_weight_ih, *m_weight_hh, *m_bias_ih, *m_bias_hh); }
+        Array forward(const Array &x) override { return forward(x, zero_state(x, 0)); }
+    };
+
+    // Inputs are (steps, batch, input)
+    class LSTM : public RecurrentModule {
+    public:
+        LSTM(isize input_size, isize hidden_size) : RecurrentModule(input_size, hidden_size, 4) {}
+        ~LSTM() = default;
+        std::tuple<Array, Array, Array> forward(const Array &x, const Array &h0, const Array &c0) { return lstm(x, h0, c0, *m_weight_ih, *m_weight_hh, *m_bias_ih, *m_bias_hh); }
+        // Starts from zero states and returns the hidden states of every step
+        Array forward(const Array &x) override { return std::get<0>(forward(x, zero_state(x, 1), zero_state(x, 1))); }
+    };
+
+    // Inputs are (steps, batch, input)
+    class GRU : public RecurrentModule {
+    public:
+        GRU(isize input_size, isize hidden_size) : RecurrentModule(input_size, hidden_size, 3) {}
+        ~GRU() = default;
+        std::pair<Array, Array> forward(const Array &x, const Array &h0) { return gru(x, h0, *m_weight_ih, *m_weight_hh, *m_bias_ih, *m_bias_hh); }
+        Array forward(const Array &x) override { return forward(x, zero_state(x, 1)).first; }
+    };
+} // namespace nx::nn
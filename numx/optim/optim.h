@@ -22,7 +22,10 @@ namespace nx::optim {
         Optimizer &operator=(Optimizer &&) noexcept = delete;
         virtual void forward() = 0;
 
-        void update(const ParameterPtrVector &params) {
+        // Gradients of a loss scaled by grad_scale are unscaled before the step
+        void update(const ParameterPtrVector &params, float grad_scale = 1.0f) {
+            // Parameter updates are never rounded to the autocast dtype
+            AutocastGuard guard(nullptr);
             m_params.clear();
             m_grads.clear();
             m_params.reserve(params.size());
@@ -39,7 +42,7 @@ namespace nx::optim {
 
                 // Store detached gradient and parameters
                 m_params.push_back(param->detach());
-                m_grads.push_back(grad.value().detach());
+                m_grads.push_back(grad_scale == 1.0f ? grad.value().detach() : grad.value().detach() * (1.0f / grad_scale));
             }
 
             forward();
@@ -61,4 +64,63 @@ namespace nx::optim {
             }
         }
     };
+
+    // Dynamic loss scaling keeps small 16-bit gradients from flushing to zero.
+    // Steps with inf or nan gradients are skipped and the scale backs off,
+    // the scale grows again after growth_interval consecutive finite steps.
+    class GradScaler {
+    private:
+        float m_scale;
+        float m_growth_factor;
+        float m_backoff_factor;
+        isize m_growth_interval;
+        isize m_growth_tracker = 0;
+
+    public:
+        explicit GradScaler(float init_scale = 65536.0f, float growth_factor = 2.0f, float backoff_factor = 0.5f, isize growth_interval = 2000) : m_scale(init_scale), m_growth_factor(growth_factor), m_backoff_factor(backoff_factor), m_growth_interval(growth_interval) {
+            if (init_scale <= 0.0f || growth_factor <= 1.0f || backoff_factor <= 0.0f || backoff_factor >= 1.0f || growth_interval <= 0) {
+                throw std::invalid_argument("Invalid gradient scaler configuration.");
+            }
+        }
+
+        float get_scale() const { return m_scale; }
+
+        Array scale(const Array &loss) const {
+            AutocastGuard guard(nullptr);
+            return loss * m_scale;
+        }
+
+        // Returns whether the optimizer step was taken
+        bool step(Optimizer &optimizer, const ParameterPtrVector &params) {
+            AutocastGuard guard(nullptr);
+            std::optional<Array> found;
+
+            // inf * 0 and nan * 0 are nan, so one fused sum over all gradients and a single sync detect overflow
+            for (auto &param : params) {
+                auto grad = param->get_grad();
+
+                if (!grad) {
+                    throw std::invalid_argument(std::format("Array {} has no gradient for gradient scaler.", param->get_id().str()));
+                }
+
+                Array grad_sum = (grad.value() * 0.0f).sum().astype(&f32);
+                found = found ? found.value() + grad_sum : grad_sum;
+            }
+
+            if (found && !std::isfinite(std::bit_cast<float>(static_cast<int32_t>(found.value().item())))) {
+                m_scale *= m_backoff_factor;
+                m_growth_tracker = 0;
+                return false;
+            }
+
+            optimizer.update(params, m_scale);
+
+            if (++m_growth_tracker == m_growth_interval) {
+                m_scale *= m_growth_factor;
+                m_growth_tracker = 0;
+            }
+
+            return true;
+        }
+    };
 } // namespace nx::optim
\ No newline at end of file
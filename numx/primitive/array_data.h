@@ -34,6 +34,8 @@ namespace nx::primitive {
         ArrayData &operator=(ArrayData &&) noexcept = default;
         const ArrayId &get_id() const { return m_id; }
         const Shape &get_shape() const { return m_shape; }
+        // Only valid before the buffer is allocated, used to place an array inside another array's buffer
+        void set_shape(const Shape &shape) { m_shape = shape; }
         isize get_offset() const { return m_shape.get_offset(); }
         const ShapeView &get_view() const { return m_shape.get_view(); }
         const ShapeStride &get_stride() const { return m_shape.get_stride(); }
@@ -7,6 +7,8 @@ namespace nx::primitive {
 
     enum struct DtypeName {
         F32,
+        F16,
+        BF16,
         I8,
         I16,
         I32,
@@ -59,18 +61,85 @@ namespace nx::primitive {
 
     using DtypePtr = const Dtype *;
 
+    template <class T>
+    std::string float_value_str(T val) {
+        if (0 < val && val <= 1e-5) {
+            return std::format("{:.4e}", val);
+        }
+        return std::format("{:.4f}", val);
+    }
+
+    // Round-to-nearest-even conversions between float and the bits of the 16-bit float formats
+    inline uint16_t f32_to_f16_bits(float val) {
+        uint32_t bits = std::bit_cast<uint32_t>(val);
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+        uint32_t out;
+
+        if (bits >= 0x47800000u) {
+            // Overflow saturates to infinity, NaN stays quiet
+            out = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+        } else if (bits < 0x38800000u) {
+            // Subnormals are rounded by the float adder after aligning the mantissa with a magic number
+            const float magic = std::bit_cast<float>(0x3f000000u);
+            out = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + magic) - 0x3f000000u;
+        } else {
+            const uint32_t mantissa_odd = (bits >> 13) & 1;
+            bits += 0xc8000fffu + mantissa_odd;
+            out = bits >> 13;
+        }
+
+        return static_cast<uint16_t>(out | (sign >> 16));
+    }
+
+    inline float f16_bits_to_f32(uint16_t bits) {
+        const uint32_t sign = static_cast<uint32_t>(bits & 0x8000) << 16;
+        const uint32_t exponent = (bits >> 10) & 0x1f;
+        const uint32_t mantissa = bits & 0x3ff;
+
+        if (exponent == 0x1f) {
+            return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+        } else if (exponent != 0) {
+            return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+        }
+
+        const float magnitude = static_cast<float>(mantissa) * 0x1p-24f;
+        return sign ? -magnitude : magnitude;
+    }
+
+    inline uint16_t f32_to_bf16_bits(float val) {
+        uint32_t bits = std::bit_cast<uint32_t>(val);
+
+        if ((bits & 0x7fffffffu) > 0x7f800000u) {
+            return static_cast<uint16_t>((bits >> 16) | 0x40);
+        }
+
+        bits += 0x7fffu + ((bits >> 16) & 1);
+        return static_cast<uint16_t>(bits >> 16);
+    }
+
+    inline float bf16_bits_to_f32(uint16_t bits) { return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16); }
+
     template <class T>
     struct FloatDtype : public Dtype {
     public:
         FloatDtype(DtypeName name, isize size) : Dtype(name, DtypeCategory::Float, size) {}
+        std::string value_str(uint8_t *ptr) const override { return float_value_str(*reinterpret_cast<T *>(ptr)); }
+    };
 
-        std::string value_str(uint8_t *ptr) const override {
-            T val = *reinterpret_cast<T *>(ptr);
-            if (0 < val && val <= 1e-5) {
-                return std::format("{:.4e}", val);
-            }
-            return std::format("{:.4f}", val);
-        }
+    // 16-bit floats are storage dtypes without a host arithmetic type, their bits go through float on the host
+    // and kernels load them into float registers
+    struct HalfFloatDtype : public Dtype {
+    public:
+        explicit HalfFloatDtype(DtypeName name) : Dtype(name, DtypeCategory::Float, 2) {}
+        virtual float to_float(uint16_t bits) const = 0;
+        virtual uint16_t from_float(float val) const = 0;
+        std::string value_str(uint8_t *ptr) const override { return float_value_str(to_float(*reinterpret_cast<uint16_t *>(ptr))); }
+        std::string value_str(isize val) const override { return std::to_string(to_float(static_cast<uint16_t>(val))); }
+        isize bit_cast(uint8_t *ptr) const override { return *reinterpret_cast<uint16_t *>(ptr); }
+        isize one() const override { return from_float(1.0f); }
+        isize max() const override { return from_float(std::numeric_limits<float>::infinity()); }
+        isize min() const override { return from_float(-std::numeric_limits<float>::infinity()); }
     };
 
     template <class T>
@@ -96,6 +165,22 @@ namespace nx::primitive {
         isize min() const override { return std::bit_cast<int>(-std::numeric_limits<float>::infinity()); }
     };
 
+    struct F16 : public HalfFloatDtype {
+    public:
+        F16() : HalfFloatDtype(DtypeName::F16) {}
+        const std::string get_name_str() const override { return "f16"; }
+        float to_float(uint16_t bits) const override { return f16_bits_to_f32(bits); }
+        uint16_t from_float(float val) const override { return f32_to_f16_bits(val); }
+    };
+
+    struct BF16 : public HalfFloatDtype {
+    public:
+        BF16() : HalfFloatDtype(DtypeName::BF16) {}
+        const std::string get_name_str() const override { return "bf16"; }
+        float to_float(uint16_t bits) const override { return bf16_bits_to_f32(bits); }
+        uint16_t from_float(float val) const override { return f32_to_bf16_bits(val); }
+    };
+
     struct I8 : public IntDtype<int8_t> {
     public:
         I8() : IntDtype<int8_t>(DtypeName::I8, 1) {}
@@ -133,26 +218,36 @@ namespace nx::primitive {
     };
 
     inline const F32 f32;
+    inline const F16 f16;
+    inline const BF16 bf16;
     inline const I8 i8;
     inline const I16 i16;
     inline const I32 i32;
     inline const I64 i64;
     inline const BoolDtype b8;
 
-    inline std::vector<DtypePtr> all_dtypes = {&b8, &i32, &f32};
+    inline std::vector<DtypePtr> all_dtypes = {&b8, &i32, &f32, &f16, &bf16};
 
     inline DtypePtr float_dtype_by_dtype(DtypePtr dtype) {
         if (!dtype->is_numeric()) {
             return nullptr;
         }
 
-        return &f32;
+        // Floats keep their precision, 16-bit floats are computed in f32 by the kernels anyway
+        return dtype->is_float() ? dtype : &f32;
     }
 
+    // Dtype in which values are accumulated across elements, 16-bit floats would lose too much precision
+    inline DtypePtr accum_dtype_by_dtype(DtypePtr dtype) { return dtype->is_float() && dtype->get_size() < f32.get_size() ? &f32 : dtype; }
+
     template <NumericOrBoolType T>
     isize dtype_bitcast_numeric(DtypePtr dtype, T constant) {
         if (dtype->is_float()) {
-            switch (dtype->get_size()) {
+            switch (dtype->get_name()) {
+            case DtypeName::F16:
+                return f32_to_f16_bits(static_cast<float>(constant));
+            case DtypeName::BF16:
+                return f32_to_bf16_bits(static_cast<float>(constant));
             default:
                 return std::bit_cast<int>(static_cast<float>(constant));
             }
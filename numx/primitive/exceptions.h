@@ -11,6 +11,11 @@ namespace nx::primitive {
         IncompatShapesForOp(std::string_view opname, std::string_view l_view_str, std::string_view r_view_str) : std::invalid_argument(std::format("Cannot run operator {} on incompatible shapes {} and {}.", opname, l_view_str, r_view_str)) {}
     };
 
+    class IncompatShapeForOp : public std::invalid_argument {
+    public:
+        IncompatShapeForOp(std::string_view opname, std::string_view view_str) : std::invalid_argument(std::format("Cannot run operator {} on incompatible shape {}.", opname, view_str)) {}
+    };
+
     class IncompatDtypesForOp : public std::invalid_argument {
     public:
         IncompatDtypesForOp(std::string_view opname, std::string_view l_dtype_str, std::string_view r_dtype_str) : std::invalid_argument(std::format("Cannot run operator {} on incompatible data types {} and {}.", opname, l_dtype_str, r_dtype_str)) {}
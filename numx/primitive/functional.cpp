@@ -1,6 +1,24 @@
 #include "functional.h"
 
 namespace nx::primitive {
+    static thread_local DtypePtr autocast_dtype = nullptr;
+
+    DtypePtr get_autocast_dtype() { return autocast_dtype; }
+
+    void set_autocast_dtype(DtypePtr dtype) {
+        if (dtype && !dtype->is_float()) {
+            throw std::invalid_argument(std::format("Cannot autocast to non-floating-point dtype {}.", dtype->str()));
+        }
+
+        autocast_dtype = dtype;
+    }
+
+    // Float operands of eligible ops are rounded to the autocast dtype, astype keeps the f32 master copy for backward
+    static OpPtr autocast(OpPtr op) {
+        DtypePtr dtype = op->get_data().get_dtype();
+        return autocast_dtype && dtype->is_float() ? astype(op, autocast_dtype) : op;
+    }
+
     isize item(OpPtr op) {
         const ArrayData &data = op->get_data();
 
@@ -110,12 +128,229 @@ namespace nx::primitive {
         return std::make_shared<SqueezeOp>(out_data, in_op, dims);
     }
 
-    OpPtr add(OpPtr l_op, OpPtr r_op) { return elmwise_binary<AddOp>(l_op, r_op); }
-    OpPtr sub(OpPtr l_op, OpPtr r_op) { return elmwise_binary<SubOp>(l_op, r_op); }
-    OpPtr mul(OpPtr l_op, OpPtr r_op) { return elmwise_binary<MulOp>(l_op, r_op); }
-    OpPtr div(OpPtr l_op, OpPtr r_op) { return elmwise_binary<DivOp>(l_op, r_op); }
+    OpPtr concat(const std::vector<OpPtr> &in_ops, isize dim) {
+        if (in_ops.empty()) {
+            throw std::invalid_argument("Cannot concatenate an empty list of arrays.");
+        }
+
+        const ArrayData &first_data = in_ops[0]->get_data();
+        const ShapeView &first_view = first_data.get_view();
+        DtypePtr first_dtype = first_data.get_dtype();
+        DevicePtr first_device = first_data.get_device();
+        isize ndim = first_data.get_ndim();
+
+        if (dim < 0 || dim >= ndim) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during concatenation.", dim, ndim));
+        }
+
+        if (in_ops.size() == 1) {
+            return in_ops[0];
+        }
+
+        ShapeView out_view = first_view;
+        out_view[dim] = 0;
+        std::vector<RangeVector> ranges;
+
+        for (auto &in_op : in_ops) {
+            const ArrayData &in_data = in_op->get_data();
+            const ShapeView &in_view = in_data.get_view();
+            DtypePtr in_dtype = in_data.get_dtype();
+            DevicePtr in_device = in_data.get_device();
+
+            // All dimensions except the concatenated one must match
+            bool compat_view = in_view.size() == first_view.size();
+
+            for (isize i = 0; compat_view && i < ndim; i++) {
+                compat_view = i == dim || in_view[i] == first_view[i];
+            }
+
+            if (!compat_view) {
+                throw IncompatShapesForOp(ConcatOp::s_opname, join_nums(first_view), join_nums(in_view));
+            }
+
+            if (*in_dtype != *first_dtype) {
+                throw IncompatDtypesForOp(ConcatOp::s_opname, first_dtype->str(), in_dtype->str());
+            }
+
+            if (in_device != first_device) {
+                throw IncompatDevicesForOp(ConcatOp::s_opname, first_device->str(), in_device->str());
+            }
+
+            // Each operand occupies a contiguous range along the concatenated dimension
+            RangeVector in_ranges;
+
+            for (isize i = 0; i < ndim; i++) {
+                if (i == dim) {
+                    in_ranges.emplace_back(out_view[dim], out_view[dim] + in_view[dim], 1);
+                } else {
+                    in_ranges.emplace_back(0, in_view[i], 1);
+                }
+            }
+
+            ranges.push_back(in_ranges);
+            out_view[dim] += in_view[dim];
+        }
+
+        const ArrayData out_data(Shape(out_view), first_dtype, first_device);
+        return std::make_shared<ConcatOp>(out_data, in_ops, dim, ranges);
+    }
+
+    OpPtr stack(const std::vector<OpPtr> &in_ops, isize dim) {
+        if (in_ops.empty()) {
+            throw std::invalid_argument("Cannot stack an empty list of arrays.");
+        }
+
+        const ShapeView &first_view = in_ops[0]->get_data().get_view();
+        std::vector<OpPtr> unsqueezed_ops;
+
+        for (auto &in_op : in_ops) {
+            const ShapeView &in_view = in_op->get_data().get_view();
+
+            if (in_view != first_view) {
+                throw IncompatShapesForOp("stack", join_nums(first_view), join_nums(in_view));
+            }
+
+            unsqueezed_ops.push_back(unsqueeze(in_op, {dim}));
+        }
+
+        // Stacking is concatenation along a new dimension of size one
+        return concat(unsqueezed_ops, dim);
+    }
+
+    std::vector<OpPtr> split(OpPtr in_op, const ShapeView &sizes, isize dim) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        isize ndim = in_data.get_ndim();
+
+        if (dim < 0 || dim >= ndim) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during split.", dim, ndim));
+        }
+
+        isize total_size = std::accumulate(sizes.begin(), sizes.end(), 0ll);
+
+        if (total_size != in_view[dim] || std::any_of(sizes.begin(), sizes.end(), [](isize size) { return size <= 0; })) {
+            throw std::invalid_argument(std::format("Cannot split dimension {} of size {} into sections of sizes ({}).", dim, in_view[dim], join_nums(sizes)));
+        }
+
+        // Every section is a view into the input so no data is copied
+        std::vector<OpPtr> out_ops;
+        isize start = 0;
+
+        for (auto &size : sizes) {
+            RangeVector ranges;
+
+            for (isize i = 0; i < ndim; i++) {
+                if (i == dim) {
+                    ranges.emplace_back(start, start + size, 1);
+                } else {
+                    ranges.emplace_back(0, in_view[i], 1);
+                }
+            }
+
+            out_ops.push_back(slice(in_op, ranges));
+            start += size;
+        }
+
+        return out_ops;
+    }
+
+    OpPtr flip(OpPtr in_op, isize dim) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        RangeVector ranges;
+
+        // Reversal is a view with a negative stride along dim
+        for (isize i = 0; i < in_data.get_ndim(); i++) {
+            if (i == dim) {
+                ranges.emplace_back(in_view[i] - 1, -1, -1);
+            } else {
+                ranges.emplace_back(0, in_view[i], 1);
+            }
+        }
+
+        return slice(in_op, ranges);
+    }
+
+    OpPtr gather(OpPtr in_op, OpPtr index_op, isize dim) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &index_data = index_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        const ShapeView &index_view = index_data.get_view();
+        DtypePtr index_dtype = index_data.get_dtype();
+        DevicePtr in_device = in_data.get_device(), index_device = index_data.get_device();
+        isize ndim = in_data.get_ndim();
+
+        if (dim < 0 || dim >= ndim) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during gather.", dim, ndim));
+        }
+
+        // Indices cannot reach outside of the input along the other dimensions
+        bool compat_view = index_data.get_ndim() == ndim;
+
+        for (isize i = 0; compat_view && i < ndim; i++) {
+            compat_view = i == dim || index_view[i] <= in_view[i];
+        }
+
+        if (!compat_view) {
+            throw IncompatShapesForOp(GatherOp::s_opname, join_nums(in_view), join_nums(index_view));
+        }
+
+        if (*index_dtype != i32) {
+            throw IncompatDtypeForOp(GatherOp::s_opname, index_dtype->str());
+        }
+
+        if (in_device != index_device) {
+            throw IncompatDevicesForOp(GatherOp::s_opname, in_device->str(), index_device->str());
+        }
+
+        const ArrayData out_data(Shape(index_view), in_data.get_dtype(), in_device);
+        return std::make_shared<GatherOp>(out_data, in_op, index_op, dim);
+    }
+
+    OpPtr scatter(OpPtr in_op, OpPtr index_op, isize dim, const ShapeView &view) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &index_data = index_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        const ShapeView &index_view = index_data.get_view();
+        DtypePtr index_dtype = index_data.get_dtype();
+        DevicePtr in_device = in_data.get_device(), index_device = index_data.get_device();
+        isize ndim = static_cast<isize>(view.size());
+
+        if (dim < 0 || dim >= ndim) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during scatter.", dim, ndim));
+        }
+
+        // Every input element needs an index and the indices cannot reach outside of the output along the other dimensions
+        bool compat_view = in_view == index_view && index_data.get_ndim() == ndim;
+
+        for (isize i = 0; compat_view && i < ndim; i++) {
+            compat_view = i == dim || index_view[i] <= view[i];
+        }
+
+        if (!compat_view) {
+            throw IncompatShapesForOp(ScatterOp::s_opname, join_nums(in_view), join_nums(index_view));
+        }
+
+        if (*index_dtype != i32) {
+            throw IncompatDtypeForOp(ScatterOp::s_opname, index_dtype->str());
+        }
+
+        if (in_device != index_device) {
+            throw IncompatDevicesForOp(ScatterOp::s_opname, in_device->str(), index_device->str());
+        }
+
+        const ArrayData out_data(Shape(view), in_data.get_dtype(), in_device);
+        return std::make_shared<ScatterOp>(out_data, in_op, index_op, dim);
+    }
+
+    OpPtr add(OpPtr l_op, OpPtr r_op) { return elmwise_binary<AddOp>(autocast(l_op), autocast(r_op)); }
+    OpPtr sub(OpPtr l_op, OpPtr r_op) { return elmwise_binary<SubOp>(autocast(l_op), autocast(r_op)); }
+    OpPtr mul(OpPtr l_op, OpPtr r_op) { return elmwise_binary<MulOp>(autocast(l_op), autocast(r_op)); }
+    OpPtr div(OpPtr l_op, OpPtr r_op) { return elmwise_binary<DivOp>(autocast(l_op), autocast(r_op)); }
 
     OpPtr matmul(OpPtr l_op, OpPtr r_op) {
+        l_op = autocast(l_op);
+        r_op = autocast(r_op);
         const ArrayData &l_data = l_op->get_data();
         const ArrayData &r_data = r_op->get_data();
         const ShapeView &l_view = l_data.get_view();
@@ -155,83 +390,1289 @@ namespace nx::primitive {
         return std::make_shared<MatmulOp>(out_data, broadcast_l_op, broadcast_r_op);
     }
 
-    OpPtr iadd(OpPtr l_op, OpPtr r_op) { return in_place_binary<AddOp>(l_op, r_op); }
-    OpPtr isub(OpPtr l_op, OpPtr r_op) { return in_place_binary<SubOp>(l_op, r_op); }
-    OpPtr imul(OpPtr l_op, OpPtr r_op) { return in_place_binary<MulOp>(l_op, r_op); }
-    OpPtr idiv(OpPtr l_op, OpPtr r_op) { return in_place_binary<DivOp>(l_op, r_op); }
-    OpPtr eq(OpPtr l_op, OpPtr r_op) { return cmp<EqOp>(l_op, r_op, DtypeCategory::All); }
-    OpPtr neq(OpPtr l_op, OpPtr r_op) { return cmp<NeqOp>(l_op, r_op, DtypeCategory::All); }
-    OpPtr lt(OpPtr l_op, OpPtr r_op) { return cmp<LtOp>(l_op, r_op, DtypeCategory::Numeric); }
-    OpPtr gt(OpPtr l_op, OpPtr r_op) { return cmp<GtOp>(l_op, r_op, DtypeCategory::Numeric); }
-    OpPtr leq(OpPtr l_op, OpPtr r_op) { return cmp<LeqOp>(l_op, r_op, DtypeCategory::Numeric); }
-    OpPtr geq(OpPtr l_op, OpPtr r_op) { return cmp<GeqOp>(l_op, r_op, DtypeCategory::Numeric); }
-    OpPtr minimum(OpPtr l_op, OpPtr r_op) { return elmwise_binary<MinimumOp>(l_op, r_op); }
-    OpPtr maximum(OpPtr l_op, OpPtr r_op) { return elmwise_binary<MaximumOp>(l_op, r_op); }
-    OpPtr sq(OpPtr in_op, bool in_place) { return unary<SqOp>(in_op, in_place); }
-    OpPtr sqrt(OpPtr in_op, bool in_place) { return unary_float<SqrtOp>(in_op, in_place); }
-    OpPtr neg(OpPtr in_op, bool in_place) { return unary<NegOp>(in_op, in_place); }
+    static ShapeView im2col_view(const ShapeView &image_view, const Conv2dParams &params) {
+        // Images are (N, C, H, W) for NCHW and (N, H, W, C) for NHWC
+        const bool channels_last = params.channels_last();
+        const isize nchannel = channels_last ? image_view[3] : image_view[1];
+        const isize height = channels_last ? image_view[1] : image_view[2];
+        const isize width = channels_last ? image_view[2] : image_view[3];
+        const isize out_height = Conv2dParams::out_size(height, params.kernel_h, params.stride_h, params.padding_h, params.dilation_h);
+        const isize out_width = Conv2dParams::out_size(width, params.kernel_w, params.stride_w, params.padding_w, params.dilation_w);
+        const isize patch_size = nchannel * params.kernel_h * params.kernel_w;
+        const isize npatch = out_height * out_width;
+        return channels_last ? ShapeView{image_view[0], npatch, patch_size} : ShapeView{image_view[0], patch_size, npatch};
+    }
 
-    OpPtr copy(OpPtr in_op) {
+    OpPtr conv2d(OpPtr in_op, OpPtr weight_op, const Conv2dParams &params) {
+        in_op = autocast(in_op);
+        weight_op = autocast(weight_op);
         const ArrayData &in_data = in_op->get_data();
-        const ArrayData out_data(Shape(in_data.get_view()), in_data.get_dtype(), in_data.get_device());
-        return std::make_shared<CopyOp>(out_data, in_op);
+        const ArrayData &weight_data = weight_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        const ShapeView &weight_view = weight_data.get_view();
+        DtypePtr in_dtype = in_data.get_dtype(), weight_dtype = weight_data.get_dtype();
+        DevicePtr in_device = in_data.get_device(), weight_device = weight_data.get_device();
+
+        // Weights are (out channels, in channels, kernel height, kernel width) for both layouts
+        if (in_data.get_ndim() != 4 || weight_data.get_ndim() != 4 || (params.channels_last() ? in_view[3] : in_view[1]) != weight_view[1]) {
+            throw IncompatShapesForOp(Conv2dOp::s_opname, join_nums(in_view), join_nums(weight_view));
+        }
+
+        if (!in_dtype->is_numeric() || *in_dtype != *weight_dtype) {
+            throw IncompatDtypesForOp(Conv2dOp::s_opname, in_dtype->str(), weight_dtype->str());
+        }
+
+        if (in_device != weight_device) {
+            throw IncompatDevicesForOp(Conv2dOp::s_opname, in_device->str(), weight_device->str());
+        }
+
+        if (params.stride_h < 1 || params.stride_w < 1 || params.dilation_h < 1 || params.dilation_w < 1 || params.padding_h < 0 || params.padding_w < 0) {
+            throw std::invalid_argument(std::format("Invalid parameters ({}) during {}.", params.str(), Conv2dOp::s_opname));
+        }
+
+        Conv2dParams conv_params = params;
+        conv_params.kernel_h = weight_view[2];
+        conv_params.kernel_w = weight_view[3];
+        const bool channels_last = conv_params.channels_last();
+        const isize out_height = Conv2dParams::out_size(channels_last ? in_view[1] : in_view[2], conv_params.kernel_h, conv_params.stride_h, conv_params.padding_h, conv_params.dilation_h);
+        const isize out_width = Conv2dParams::out_size(channels_last ? in_view[2] : in_view[3], conv_params.kernel_w, conv_params.stride_w, conv_params.padding_w, conv_params.dilation_w);
+
+        if (out_height <= 0 || out_width <= 0) {
+            throw IncompatShapesForOp(Conv2dOp::s_opname, join_nums(in_view), join_nums(weight_view));
+        }
+
+        const isize out_nchannel = weight_view[0];
+        const isize patch_size = weight_view[1] * weight_view[2] * weight_view[3];
+        OpPtr flat_weight_op = reshape(weight_op, {out_nchannel, patch_size});
+        ShapeView out_view = channels_last ? ShapeView{in_view[0], out_height, out_width, out_nchannel} : ShapeView{in_view[0], out_nchannel, out_height, out_width};
+        const ArrayData out_data(Shape(out_view), in_dtype, in_device);
+        return std::make_shared<Conv2dOp>(out_data, in_op, flat_weight_op, conv_params);
     }
 
-    OpPtr exp(OpPtr in_op, bool in_place) { return unary_float<ExpOp>(in_op, in_place); }
-    OpPtr log(OpPtr in_op, bool in_place) { return unary_float<LogOp>(in_op, in_place); }
-    OpPtr recip(OpPtr in_op, bool in_place) { return unary_float<RecipOp>(in_op, in_place); }
-    OpPtr sin(OpPtr in_op, bool in_place) { return unary_float<SinOp>(in_op, in_place); }
-    OpPtr cos(OpPtr in_op, bool in_place) { return unary_float<CosOp>(in_op, in_place); }
+    OpPtr im2col(OpPtr in_op, const Conv2dParams &params) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(Shape(im2col_view(in_data.get_view(), params)), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<Im2colOp>(out_data, in_op, params);
+    }
 
-    OpPtr reshape(OpPtr in_op, const ShapeView &view) {
+    OpPtr col2im(OpPtr in_op, const ShapeView &image_view, const Conv2dParams &params) {
         const ArrayData &in_data = in_op->get_data();
 
-        if (in_data.get_view() == view) {
-            return in_op;
+        if (in_data.get_view() != im2col_view(image_view, params)) {
+            throw IncompatShapesForOp(Col2imOp::s_opname, join_nums(in_data.get_view()), join_nums(image_view));
         }
 
-        const ArrayData out_data(in_data.get_shape().reshape(view), in_data.get_dtype(), in_data.get_device());
-        return std::make_shared<ReshapeOp>(out_data, in_op);
+        const ArrayData out_data(Shape(image_view), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<Col2imOp>(out_data, in_op, params);
     }
 
-    OpPtr permute(OpPtr in_op, const ShapeDims &dims) {
+    static ShapeView pool2d_view(const ShapeView &image_view, const Pool2dParams &params) {
+        const bool channels_last = params.channels_last();
+        isize out_height = params.out_h, out_width = params.out_w;
+
+        if (!params.adaptive) {
+            out_height = Conv2dParams::out_size(channels_last ? image_view[1] : image_view[2], params.kernel_h, params.stride_h, params.padding_h, 1);
+            out_width = Conv2dParams::out_size(channels_last ? image_view[2] : image_view[3], params.kernel_w, params.stride_w, params.padding_w, 1);
+        }
+
+        return channels_last ? ShapeView{image_view[0], out_height, out_width, image_view[3]} : ShapeView{image_view[0], image_view[1], out_height, out_width};
+    }
+
+    template <class O>
+    static OpPtr pool2d(OpPtr in_op, const Pool2dParams &params) {
         const ArrayData &in_data = in_op->get_data();
-        const ArrayData out_data(in_data.get_shape().permute(dims), in_data.get_dtype(), in_data.get_device());
-        return std::make_shared<PermuteOp>(out_data, in_op, dims);
+        const ShapeView &in_view = in_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+
+        if (in_data.get_ndim() != 4) {
+            throw IncompatShapeForOp(O::s_opname, join_nums(in_view));
+        }
+
+        if (!dtype->is_numeric()) {
+            throw IncompatDtypeForOp(O::s_opname, dtype->str());
+        }
+
+        // Padding is at most half the kernel so every window covers at least one input element
+        const bool valid_params = params.adaptive ? params.out_h >= 1 && params.out_w >= 1 : params.kernel_h >= 1 && params.kernel_w >= 1 && params.stride_h >= 1 && params.stride_w >= 1 && params.padding_h >= 0 && params.padding_w >= 0 && 2 * params.padding_h <= params.kernel_h && 2 * params.padding_w <= params.kernel_w;
+
+        if (!valid_params) {
+            throw std::invalid_argument(std::format("Invalid parameters ({}) during {}.", params.str(), O::s_opname));
+        }
+
+        const ShapeView out_view = pool2d_view(in_view, params);
+
+        if (out_view[1] <= 0 || out_view[2] <= 0 || out_view[3] <= 0) {
+            throw IncompatShapeForOp(O::s_opname, join_nums(in_view));
+        }
+
+        const ArrayData out_data(Shape(out_view), dtype, in_data.get_device());
+        return std::make_shared<O>(out_data, in_op, params);
     }
 
-    OpPtr transpose(OpPtr in_op, isize start_dim, isize end_dim) {
+    OpPtr maxpool2d(OpPtr in_op, const Pool2dParams &params) { return pool2d<MaxPool2dOp>(in_op, params); }
+    OpPtr avgpool2d(OpPtr in_op, const Pool2dParams &params) { return pool2d<AvgPool2dOp>(in_op, params); }
+
+    OpPtr maxpool2d_grad(OpPtr in_op, OpPtr grad_op, const Pool2dParams &params) {
         const ArrayData &in_data = in_op->get_data();
-        const ShapeDims &transpose_dims = in_data.get_shape().transpose(start_dim, end_dim);
-        return permute(in_op, transpose_dims);
+        const ArrayData &grad_data = grad_op->get_data();
+
+        if (grad_data.get_view() != pool2d_view(in_data.get_view(), params)) {
+            throw IncompatShapesForOp(MaxPool2dGradOp::s_opname, join_nums(in_data.get_view()), join_nums(grad_data.get_view()));
+        }
+
+        const ArrayData out_data(Shape(in_data.get_view()), grad_data.get_dtype(), grad_data.get_device());
+        return std::make_shared<MaxPool2dGradOp>(out_data, in_op, grad_op, params);
     }
 
-    OpPtr flatten(OpPtr in_op, isize start_dim, isize end_dim) {
+    OpPtr avgpool2d_grad(OpPtr grad_op, const ShapeView &image_view, const Pool2dParams &params) {
+        const ArrayData &grad_data = grad_op->get_data();
+
+        if (grad_data.get_view() != pool2d_view(image_view, params)) {
+            throw IncompatShapesForOp(AvgPool2dGradOp::s_opname, join_nums(grad_data.get_view()), join_nums(image_view));
+        }
+
+        const ArrayData out_data(Shape(image_view), grad_data.get_dtype(), grad_data.get_device());
+        return std::make_shared<AvgPool2dGradOp>(out_data, grad_op, params);
+    }
+
+    OpPtr dropout(OpPtr in_op, uint64_t key, float p) {
         const ArrayData &in_data = in_op->get_data();
-        const ShapeView &flattened_view = in_data.get_shape().flatten(start_dim, end_dim);
-        return reshape(in_op, flattened_view);
+        DtypePtr dtype = in_data.get_dtype();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(DropoutOp::s_opname, dtype->str());
+        }
+
+        if (p < 0 || p > 1) {
+            throw std::invalid_argument(std::format("Invalid probability {} during {}.", p, DropoutOp::s_opname));
+        }
+
+        const ArrayData out_data(Shape(in_data.get_view()), dtype, in_data.get_device());
+        return std::make_shared<DropoutOp>(out_data, in_op, key, p);
     }
 
-    OpPtr sum(OpPtr in_op, const ShapeDims &dims) { return reduce<SumOp>(in_op, dims, in_op->get_data().get_dtype(), DtypeCategory::Numeric); }
+    template <class O, class... Args>
+    static OpPtr binning(OpPtr in_op, OpPtr weight_op, isize num_bins, Args... args) {
+        const ArrayData &in_data = in_op->get_data();
+        DevicePtr device = in_data.get_device();
 
-    OpPtr mean(OpPtr in_op, const ShapeDims &dims) {
-        OpPtr sum_op = sum(in_op, dims);
-        isize numel;
+        if (num_bins <= 0) {
+            throw std::invalid_argument(std::format("Invalid number of bins {} during {}.", num_bins, O::s_opname));
+        }
 
-        if (dims.empty()) {
-            numel = in_op->get_data().get_numel();
-        } else {
-            const ShapeView &in_view = in_op->get_data().get_view();
-            numel = std::accumulate(dims.begin(), dims.end(), 1ll, [&](isize acc, isize dim) { return acc * in_view[dim]; });
+        std::vector<OpPtr> operands = {in_op};
+        DtypePtr out_dtype = &i32;
+
+        if (weight_op) {
+            const ArrayData &weight_data = weight_op->get_data();
+
+            if (!weight_data.get_dtype()->is_float()) {
+                throw IncompatDtypeForOp(O::s_opname, weight_data.get_dtype()->str());
+            }
+
+            if (weight_data.get_view() != in_data.get_view()) {
+                throw IncompatShapesForOp(O::s_opname, join_nums(in_data.get_view()), join_nums(weight_data.get_view()));
+            }
+
+            if (weight_data.get_device() != device) {
+                throw IncompatDevicesForOp(O::s_opname, device->str(), weight_data.get_device()->str());
+            }
+
+            // Weights are accumulated with f32 atomics
+            operands.push_back(astype(weight_op, &f32));
+            out_dtype = &f32;
         }
 
-        return div(sum_op, numel);
+        const ArrayData out_data(Shape({num_bins}), out_dtype, device);
+        OpPtr out_op = std::make_shared<O>(out_data, operands, num_bins, args...);
+        // Counts are not differentiable
+        out_op->enable_grad(false);
+        return weight_op ? astype(out_op, weight_op->get_data().get_dtype()) : out_op;
     }
 
-    OpPtr max(OpPtr in_op, const ShapeDims &dims) { return reduce<MaxOp>(in_op, dims, in_op->get_data().get_dtype(), DtypeCategory::Numeric); }
-    OpPtr min(OpPtr in_op, const ShapeDims &dims) { return reduce<MinOp>(in_op, dims, in_op->get_data().get_dtype(), DtypeCategory::Numeric); }
-    OpPtr argmax(OpPtr in_op, const ShapeDims &dims) { return reduce<ArgmaxOp>(in_op, dims, &i32, DtypeCategory::Numeric); }
-    OpPtr argmin(OpPtr in_op, const ShapeDims &dims) { return reduce<ArgminOp>(in_op, dims, &i32, DtypeCategory::Numeric); }
+    OpPtr bincount(OpPtr in_op, OpPtr weight_op, isize num_bins) {
+        DtypePtr dtype = in_op->get_data().get_dtype();
+
+        if (!dtype->is_int()) {
+            throw IncompatDtypeForOp(BincountOp::s_opname, dtype->str());
+        }
+
+        return binning<BincountOp>(in_op, weight_op, num_bins);
+    }
+
+    OpPtr histogram(OpPtr in_op, OpPtr weight_op, isize num_bins, float min, float max) {
+        DtypePtr dtype = in_op->get_data().get_dtype();
+
+        if (!dtype->is_numeric()) {
+            throw IncompatDtypeForOp(HistogramOp::s_opname, dtype->str());
+        }
+
+        if (!(min < max)) {
+            throw std::invalid_argument(std::format("Invalid range [{}, {}] during {}.", min, max, HistogramOp::s_opname));
+        }
+
+        return binning<HistogramOp>(in_op, weight_op, num_bins, min, max);
+    }
+
+    OpPtr multinomial(OpPtr in_op, uint64_t key, isize num_samples, float temperature, isize top_k, float top_p, bool logits) {
+        const ArrayData &in_data = in_op->get_data();
+        DtypePtr dtype = in_data.get_dtype();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(MultinomialOp::s_opname, dtype->str());
+        }
+
+        if (in_data.get_ndim() == 0 || in_data.get_view().back() == 0) {
+            throw IncompatShapeForOp(MultinomialOp::s_opname, join_nums(in_data.get_view()));
+        }
+
+        if (num_samples <= 0) {
+            throw std::invalid_argument(std::format("Invalid number of samples {} during {}.", num_samples, MultinomialOp::s_opname));
+        }
+
+        if (temperature <= 0) {
+            throw std::invalid_argument(std::format("Invalid temperature {} during {}.", temperature, MultinomialOp::s_opname));
+        }
+
+        if (top_k < 0) {
+            throw std::invalid_argument(std::format("Invalid top-k {} during {}.", top_k, MultinomialOp::s_opname));
+        }
+
+        if (top_p <= 0 || top_p > 1) {
+            throw std::invalid_argument(std::format("Invalid top-p {} during {}.", top_p, MultinomialOp::s_opname));
+        }
+
+        ShapeView out_view = in_data.get_view();
+        out_view.back() = num_samples;
+        const ArrayData out_data(Shape(out_view), &i32, in_data.get_device());
+        return std::make_shared<MultinomialOp>(out_data, in_op, key, num_samples, temperature, top_k, top_p, logits);
+    }
+
+    template <class O>
+    static OpPtr norm(OpPtr in_op, std::vector<OpPtr> param_ops, float eps) {
+        // Autocast runs norms in f32 against the f32 master weights instead of rounding them to the input dtype
+        if (autocast_dtype && in_op->get_data().get_dtype()->is_float()) {
+            in_op = astype(in_op, &f32);
+
+            for (auto &param_op : param_ops) {
+                param_op = param_op->get_data().get_dtype()->is_float() ? astype(param_op, &f32) : param_op;
+            }
+        }
+
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+        DevicePtr device = in_data.get_device();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(O::s_opname, dtype->str());
+        }
+
+        if (in_data.get_ndim() == 0) {
+            throw IncompatShapeForOp(O::s_opname, join_nums(in_view));
+        }
+
+        // Weight and bias are vectors over the normalized last dimension
+        const isize nfeature = in_view.back();
+
+        for (auto &param_op : param_ops) {
+            const ArrayData &param_data = param_op->get_data();
+
+            if (param_data.get_view() != ShapeView{nfeature}) {
+                throw IncompatShapesForOp(O::s_opname, join_nums(in_view), join_nums(param_data.get_view()));
+            }
+
+            if (*param_data.get_dtype() != *dtype) {
+                throw IncompatDtypesForOp(O::s_opname, dtype->str(), param_data.get_dtype()->str());
+            }
+
+            if (param_data.get_device() != device) {
+                throw IncompatDevicesForOp(O::s_opname, device->str(), param_data.get_device()->str());
+            }
+        }
+
+        if (eps < 0) {
+            throw std::invalid_argument(std::format("Epsilon {} of {} cannot be negative.", eps, O::s_opname));
+        }
+
+        // Statistics are kept in f32 and only written by the forward kernel
+        OpPtr stats_op = empty({in_data.get_numel() / nfeature, 2}, &f32, device);
+        stats_op->enable_grad(false);
+        std::vector<OpPtr> operands = {in_op};
+        operands.insert(operands.end(), param_ops.begin(), param_ops.end());
+        operands.push_back(stats_op);
+        const ArrayData out_data(Shape(in_view), dtype, device);
+        return std::make_shared<O>(out_data, operands, eps);
+    }
+
+    OpPtr layer_norm(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, float eps) { return norm<LayerNormOp>(in_op, {weight_op, bias_op}, eps); }
+    OpPtr rms_norm(OpPtr in_op, OpPtr weight_op, float eps) { return norm<RMSNormOp>(in_op, {weight_op}, eps); }
+
+    OpPtr norm_grad(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, bool centered) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(Shape(in_data.get_view()), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<NormGradOp>(out_data, std::vector<OpPtr>{grad_op, in_op, weight_op, stats_op}, centered);
+    }
+
+    OpPtr norm_param_grad(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, bool centered) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(Shape({2, in_data.get_view().back()}), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<NormParamGradOp>(out_data, std::vector<OpPtr>{grad_op, in_op, stats_op}, centered);
+    }
+
+    OpPtr batch_norm(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr running_mean_op, OpPtr running_var_op, const BatchNormParams &params) {
+        // The kernel updates the running statistics in place, so autocast runs in their dtype rather than casting them
+        DtypePtr running_dtype = running_mean_op->get_data().get_dtype();
+
+        if (autocast_dtype && in_op->get_data().get_dtype()->is_float() && running_dtype->is_float()) {
+            in_op = astype(in_op, running_dtype);
+            weight_op = weight_op->get_data().get_dtype()->is_float() ? astype(weight_op, running_dtype) : weight_op;
+            bias_op = bias_op->get_data().get_dtype()->is_float() ? astype(bias_op, running_dtype) : bias_op;
+        }
+
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+        DevicePtr device = in_data.get_device();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(BatchNormOp::s_opname, dtype->str());
+        }
+
+        if (in_data.get_ndim() < 2 || params.channel_dim < 0 || params.channel_dim >= in_data.get_ndim()) {
+            throw IncompatShapeForOp(BatchNormOp::s_opname, join_nums(in_view));
+        }
+
+        // Weight, bias and running statistics are vectors over the channels
+        const isize nchannel = in_view[params.channel_dim];
+
+        for (auto &param_op : {weight_op, bias_op, running_mean_op, running_var_op}) {
+            const ArrayData &param_data = param_op->get_data();
+
+            if (param_data.get_view() != ShapeView{nchannel}) {
+                throw IncompatShapesForOp(BatchNormOp::s_opname, join_nums(in_view), join_nums(param_data.get_view()));
+            }
+
+            if (*param_data.get_dtype() != *dtype) {
+                throw IncompatDtypesForOp(BatchNormOp::s_opname, dtype->str(), param_data.get_dtype()->str());
+            }
+
+            if (param_data.get_device() != device) {
+                throw IncompatDevicesForOp(BatchNormOp::s_opname, device->str(), param_data.get_device()->str());
+            }
+        }
+
+        if (params.eps < 0 || params.momentum < 0 || params.momentum > 1) {
+            throw std::invalid_argument(std::format("Invalid parameters ({}) during {}.", params.str(), BatchNormOp::s_opname));
+        }
+
+        OpPtr stats_op = empty({nchannel, 2}, &f32, device);
+        stats_op->enable_grad(false);
+        const ArrayData out_data(Shape(in_view), dtype, device);
+        return std::make_shared<BatchNormOp>(out_data, std::vector<OpPtr>{in_op, weight_op, bias_op, running_mean_op, running_var_op, stats_op}, params);
+    }
+
+    OpPtr batch_norm_grad(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr param_grad_op, const BatchNormParams &params) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(Shape(in_data.get_view()), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<BatchNormGradOp>(out_data, std::vector<OpPtr>{grad_op, in_op, weight_op, stats_op, param_grad_op}, params);
+    }
+
+    OpPtr batch_norm_param_grad(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, const BatchNormParams &params) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(Shape({2, in_data.get_view()[params.channel_dim]}), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<BatchNormParamGradOp>(out_data, std::vector<OpPtr>{grad_op, in_op, stats_op}, params);
+    }
+
+    OpPtr sdpa(OpPtr q_op, OpPtr k_op, OpPtr v_op, float scale, bool causal) {
+        // The kernels accumulate scores and the online softmax in f32 so operands can be rounded like matmul operands
+        q_op = autocast(q_op);
+        k_op = autocast(k_op);
+        v_op = autocast(v_op);
+        const ArrayData &q_data = q_op->get_data();
+        const ArrayData &k_data = k_op->get_data();
+        const ArrayData &v_data = v_op->get_data();
+        const ShapeView &q_view = q_data.get_view();
+        const ShapeView &k_view = k_data.get_view();
+        const ShapeView &v_view = v_data.get_view();
+        DtypePtr dtype = q_data.get_dtype();
+        DevicePtr device = q_data.get_device();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(ScaledDotProductAttentionOp::s_opname, dtype->str());
+        }
+
+        for (auto &op : {k_op, v_op}) {
+            const ArrayData &data = op->get_data();
+
+            if (*data.get_dtype() != *dtype) {
+                throw IncompatDtypesForOp(ScaledDotProductAttentionOp::s_opname, dtype->str(), data.get_dtype()->str());
+            }
+
+            if (data.get_device() != device) {
+                throw IncompatDevicesForOp(ScaledDotProductAttentionOp::s_opname, device->str(), data.get_device()->str());
+            }
+        }
+
+        // Query is (..., Tq, D), key is (..., Tk, D) and value is (..., Tk, Dv) with the same leading dimensions
+        const isize ndim = q_data.get_ndim();
+
+        if (ndim < 2 || k_data.get_ndim() != ndim || v_data.get_ndim() != ndim ||
+            !std::equal(q_view.begin(), q_view.end() - 2, k_view.begin()) || !std::equal(q_view.begin(), q_view.end() - 2, v_view.begin()) ||
+            q_view.back() != k_view.back() || k_view[ndim - 2] != v_view[ndim - 2] || k_view[ndim - 2] == 0 || q_view.back() == 0) {
+            throw IncompatShapesForOp(ScaledDotProductAttentionOp::s_opname, join_nums(q_view), join_nums(k_view));
+        }
+
+        // Query and output rows are held in registers by the kernels
+        if (q_view.back() > ScaledDotProductAttentionOp::s_max_head_dim || v_view.back() > ScaledDotProductAttentionOp::s_max_head_dim) {
+            throw IncompatShapesForOp(ScaledDotProductAttentionOp::s_opname, join_nums(q_view), join_nums(v_view));
+        }
+
+        // One log-sum-exp per query row
+        OpPtr stats_op = empty({q_data.get_numel() / q_view.back()}, &f32, device);
+        stats_op->enable_grad(false);
+        ShapeView out_view = q_view;
+        out_view.back() = v_view.back();
+        const ArrayData out_data(Shape(out_view), dtype, device);
+        return std::make_shared<ScaledDotProductAttentionOp>(out_data, std::vector<OpPtr>{q_op, k_op, v_op, stats_op}, scale, causal);
+    }
+
+    OpPtr sdpa_grad(OpPtr grad_op, OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr out_op, OpPtr stats_op, float scale, bool causal, AttentionGradTarget target) {
+        // The gradient has the shape of the array it is taken with respect to
+        OpPtr target_op = target == AttentionGradTarget::QUERY ? q_op : target == AttentionGradTarget::KEY ? k_op : v_op;
+        const ArrayData &target_data = target_op->get_data();
+        const ArrayData out_data(Shape(target_data.get_view()), target_data.get_dtype(), target_data.get_device());
+        return std::make_shared<SDPAGradOp>(out_data, std::vector<OpPtr>{grad_op, q_op, k_op, v_op, out_op, stats_op}, scale, causal, target);
+    }
+
+    // Checks that the operands of a recurrent op share the float dtype and device of the packed gates, returns the hidden size
+    static isize recurrent_hidden_size(const std::string &opname, OpPtr gates_op, const std::vector<OpPtr> &ops, isize ngate) {
+        const ArrayData &gates_data = gates_op->get_data();
+        const ShapeView &gates_view = gates_data.get_view();
+        DtypePtr dtype = gates_data.get_dtype();
+        DevicePtr device = gates_data.get_device();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(opname, dtype->str());
+        }
+
+        for (auto &op : ops) {
+            const ArrayData &data = op->get_data();
+
+            if (*data.get_dtype() != *dtype) {
+                throw IncompatDtypesForOp(opname, dtype->str(), data.get_dtype()->str());
+            }
+
+            if (data.get_device() != device) {
+                throw IncompatDevicesForOp(opname, device->str(), data.get_device()->str());
+            }
+        }
+
+        if (gates_view.back() == 0 || gates_view.back() % ngate != 0) {
+            throw IncompatShapeForOp(opname, join_nums(gates_view));
+        }
+
+        return gates_view.back() / ngate;
+    }
+
+    // The cells take the input and hidden projections of shape (batch, gates * hidden) and a state of shape (batch, hidden)
+    static isize recurrent_cell_hidden_size(const std::string &opname, OpPtr gi_op, OpPtr gh_op, OpPtr state_op, isize ngate) {
+        const isize nhidden = recurrent_hidden_size(opname, gi_op, {gh_op, state_op}, ngate);
+        const ShapeView &gi_view = gi_op->get_data().get_view();
+        const ShapeView &gh_view = gh_op->get_data().get_view();
+        const ShapeView &state_view = state_op->get_data().get_view();
+
+        if (gi_view.size() != 2 || gh_view != gi_view) {
+            throw IncompatShapesForOp(opname, join_nums(gi_view), join_nums(gh_view));
+        }
+
+        if (state_view != ShapeView{gi_view[0], nhidden}) {
+            throw IncompatShapesForOp(opname, join_nums(gi_view), join_nums(state_view));
+        }
+
+        return nhidden;
+    }
+
+    OpPtr lstm_cell(OpPtr gi_op, OpPtr gh_op, OpPtr c_op) {
+        const ArrayData &gi_data = gi_op->get_data();
+        const isize nhidden = recurrent_cell_hidden_size(LSTMCellOp::s_opname, gi_op, gh_op, c_op, 4);
+        const ArrayData out_data(Shape({gi_data.get_view()[0], 2 * nhidden}), gi_data.get_dtype(), gi_data.get_device());
+        return std::make_shared<LSTMCellOp>(out_data, std::vector<OpPtr>{gi_op, gh_op, c_op});
+    }
+
+    OpPtr lstm_cell_grad(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr c_op, RecurrentGradTarget target) {
+        const ArrayData &target_data = target == RecurrentGradTarget::STATE ? c_op->get_data() : gi_op->get_data();
+        const ArrayData out_data(Shape(target_data.get_view()), target_data.get_dtype(), target_data.get_device());
+        return std::make_shared<LSTMCellGradOp>(out_data, std::vector<OpPtr>{grad_op, gi_op, gh_op, c_op}, target);
+    }
+
+    OpPtr gru_cell(OpPtr gi_op, OpPtr gh_op, OpPtr h_op) {
+        const ArrayData &h_data = h_op->get_data();
+        recurrent_cell_hidden_size(GRUCellOp::s_opname, gi_op, gh_op, h_op, 3);
+        const ArrayData out_data(Shape(h_data.get_view()), h_data.get_dtype(), h_data.get_device());
+        return std::make_shared<GRUCellOp>(out_data, std::vector<OpPtr>{gi_op, gh_op, h_op});
+    }
+
+    OpPtr gru_cell_grad(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr h_op, RecurrentGradTarget target) {
+        OpPtr target_op = target == RecurrentGradTarget::INPUT_GATES ? gi_op : target == RecurrentGradTarget::HIDDEN_GATES ? gh_op : h_op;
+        const ArrayData &target_data = target_op->get_data();
+        const ArrayData out_data(Shape(target_data.get_view()), target_data.get_dtype(), target_data.get_device());
+        return std::make_shared<GRUCellGradOp>(out_data, std::vector<OpPtr>{grad_op, gi_op, gh_op, h_op}, target);
+    }
+
+    // The sequences take the input projections of shape (steps, batch, gates * hidden), the transposed hidden weight of shape
+    // (hidden, gates * hidden) followed by the other parameters and states of shape (batch, hidden)
+    static isize recurrent_sequence_hidden_size(const std::string &opname, OpPtr gi_op, const std::vector<OpPtr> &param_ops, const std::vector<OpPtr> &state_ops, isize ngate) {
+        std::vector<OpPtr> ops(param_ops);
+        ops.insert(ops.end(), state_ops.begin(), state_ops.end());
+        const isize nhidden = recurrent_hidden_size(opname, gi_op, ops, ngate);
+        const ShapeView &gi_view = gi_op->get_data().get_view();
+        const ShapeView &weight_view = param_ops[0]->get_data().get_view();
+
+        if (gi_view.size() != 3 || gi_view[0] == 0) {
+            throw IncompatShapeForOp(opname, join_nums(gi_view));
+        }
+
+        if (weight_view != ShapeView{nhidden, ngate * nhidden}) {
+            throw IncompatShapesForOp(opname, join_nums(gi_view), join_nums(weight_view));
+        }
+
+        for (auto &state_op : state_ops) {
+            const ShapeView &state_view = state_op->get_data().get_view();
+
+            if (state_view != ShapeView{gi_view[1], nhidden}) {
+                throw IncompatShapesForOp(opname, join_nums(gi_view), join_nums(state_view));
+            }
+        }
+
+        // The hidden state of a batch row is held in threadgroup memory by the kernels
+        if (nhidden > RecurrentOp::s_max_hidden_size) {
+            throw IncompatShapeForOp(opname, join_nums(weight_view));
+        }
+
+        return nhidden;
+    }
+
+    OpPtr lstm(OpPtr gi_op, OpPtr weight_op, OpPtr h_op, OpPtr c_op) {
+        const ArrayData &gi_data = gi_op->get_data();
+        const ShapeView &gi_view = gi_data.get_view();
+        const isize nhidden = recurrent_sequence_hidden_size(LSTMOp::s_opname, gi_op, {weight_op}, {h_op, c_op}, 4);
+        const ArrayData out_data(Shape({gi_view[0], gi_view[1], 2 * nhidden}), gi_data.get_dtype(), gi_data.get_device());
+        return std::make_shared<LSTMOp>(out_data, std::vector<OpPtr>{gi_op, weight_op, h_op, c_op});
+    }
+
+    OpPtr gru(OpPtr gi_op, OpPtr weight_op, OpPtr bias_op, OpPtr h_op) {
+        const ArrayData &gi_data = gi_op->get_data();
+        const ShapeView &gi_view = gi_data.get_view();
+        const isize nhidden = recurrent_sequence_hidden_size(GRUOp::s_opname, gi_op, {weight_op, bias_op}, {h_op}, 3);
+        const ShapeView &bias_view = bias_op->get_data().get_view();
+
+        if (bias_view != ShapeView{3 * nhidden}) {
+            throw IncompatShapesForOp(GRUOp::s_opname, join_nums(gi_view), join_nums(bias_view));
+        }
+
+        const ArrayData out_data(Shape({gi_view[0], gi_view[1], nhidden}), gi_data.get_dtype(), gi_data.get_device());
+        return std::make_shared<GRUOp>(out_data, std::vector<OpPtr>{gi_op, weight_op, bias_op, h_op});
+    }
+
+    // Kernels that index their operands directly read them through a contiguous copy
+    static OpPtr contiguous(OpPtr op) { return op->get_data().is_contiguous() ? op : copy(op); }
+
+    OpPtr quantize(OpPtr in_op, float clip) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(QuantizeOp::s_opname, dtype->str());
+        }
+
+        if (in_data.get_ndim() == 0 || in_view.back() == 0) {
+            throw IncompatShapeForOp(QuantizeOp::s_opname, join_nums(in_view));
+        }
+
+        if (clip < 0) {
+            throw std::invalid_argument(std::format("Clipping range {} of {} cannot be negative.", clip, QuantizeOp::s_opname));
+        }
+
+        // Scales are kept in f32 and only written by the quantization kernel
+        OpPtr scale_op = empty({in_data.get_numel() / in_view.back()}, &f32, in_data.get_device());
+        scale_op->enable_grad(false);
+        const ArrayData out_data(Shape(in_view), &i8, in_data.get_device());
+        OpPtr out_op = std::make_shared<QuantizeOp>(out_data, std::vector<OpPtr>{in_op, scale_op}, clip);
+        out_op->enable_grad(false);
+        return out_op;
+    }
+
+    OpPtr quantize_scale(OpPtr quantize_op) {
+        if (quantize_op->get_opcode() != Opcode::QUANTIZE) {
+            throw std::invalid_argument(std::format("Scales can only be read from a {} op but got {}.", QuantizeOp::s_opname, quantize_op->get_opname()));
+        }
+
+        const ArrayData &scale_data = std::static_pointer_cast<QuantizeOp>(quantize_op)->get_scale()->get_data();
+        OpPtr out_op = std::make_shared<QuantizeScaleOp>(ArrayData(scale_data.get_shape(), scale_data.get_dtype(), scale_data.get_device()), quantize_op);
+        out_op->enable_grad(false);
+        return out_op;
+    }
+
+    OpPtr quantized_matmul(OpPtr in_op, OpPtr weight_op, OpPtr weight_scale_op, OpPtr bias_op, QuantizedActivation activation, float clip) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ShapeView &weight_view = weight_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+        DevicePtr device = in_data.get_device();
+
+        if (*weight_data.get_dtype() != i8 || *weight_scale_op->get_data().get_dtype() != f32) {
+            throw IncompatDtypesForOp(QuantizedMatmulOp::s_opname, weight_data.get_dtype()->str(), weight_scale_op->get_data().get_dtype()->str());
+        }
+
+        if (weight_data.get_ndim() != 2 || in_data.get_ndim() == 0 || in_view.back() != weight_view[1]) {
+            throw IncompatShapesForOp(QuantizedMatmulOp::s_opname, join_nums(in_view), join_nums(weight_view));
+        }
+
+        // Scales and bias are vectors over the output features
+        const isize nout = weight_view[0];
+        std::vector<OpPtr> vector_ops = {weight_scale_op};
+
+        if (bias_op) {
+            if (*bias_op->get_data().get_dtype() != *dtype) {
+                throw IncompatDtypesForOp(QuantizedMatmulOp::s_opname, dtype->str(), bias_op->get_data().get_dtype()->str());
+            }
+
+            vector_ops.push_back(bias_op);
+        }
+
+        for (auto &vector_op : vector_ops) {
+            const ArrayData &vector_data = vector_op->get_data();
+
+            if (vector_data.get_view() != ShapeView{nout}) {
+                throw IncompatShapesForOp(QuantizedMatmulOp::s_opname, join_nums(weight_view), join_nums(vector_data.get_view()));
+            }
+
+            if (vector_data.get_device() != device) {
+                throw IncompatDevicesForOp(QuantizedMatmulOp::s_opname, device->str(), vector_data.get_device()->str());
+            }
+        }
+
+        if (weight_data.get_device() != device) {
+            throw IncompatDevicesForOp(QuantizedMatmulOp::s_opname, device->str(), weight_data.get_device()->str());
+        }
+
+        // Activations are quantized per row on the fly, the kernel reads every operand contiguously
+        OpPtr in_q_op = quantize(in_op, clip);
+        std::vector<OpPtr> operands = {in_q_op, std::static_pointer_cast<QuantizeOp>(in_q_op)->get_scale(), weight_op, weight_scale_op};
+
+        if (bias_op) {
+            operands.push_back(bias_op);
+        }
+
+        for (isize i = 2; i < static_cast<isize>(operands.size()); i++) {
+            operands[i] = contiguous(operands[i]);
+        }
+
+        ShapeView out_view = in_view;
+        out_view.back() = nout;
+        const ArrayData out_data(Shape(out_view), dtype, device);
+        OpPtr out_op = std::make_shared<QuantizedMatmulOp>(out_data, operands, activation);
+        out_op->enable_grad(false);
+        return out_op;
+    }
+
+    template <class O>
+    static std::vector<OpPtr> sparse_operands(OpPtr row_op, OpPtr col_op, OpPtr value_op, SparseFormat format, isize nrow, isize ncol) {
+        const ArrayData &row_data = row_op->get_data();
+        const ArrayData &col_data = col_op->get_data();
+        const ArrayData &value_data = value_op->get_data();
+        DevicePtr device = value_data.get_device();
+
+        if (*row_data.get_dtype() != i32 || *col_data.get_dtype() != i32) {
+            throw IncompatDtypesForOp(O::s_opname, row_data.get_dtype()->str(), col_data.get_dtype()->str());
+        }
+
+        if (*value_data.get_dtype() != f32) {
+            throw IncompatDtypeForOp(O::s_opname, value_data.get_dtype()->str());
+        }
+
+        const isize nnz = value_data.get_numel();
+        const isize nrow_index = format == SparseFormat::CSR ? nrow + 1 : nnz;
+
+        if (value_data.get_ndim() != 1 || col_data.get_view() != ShapeView{nnz} || row_data.get_view() != ShapeView{nrow_index}) {
+            throw IncompatShapesForOp(O::s_opname, join_nums(row_data.get_view()), join_nums(col_data.get_view()));
+        }
+
+        if (nrow < 0 || ncol < 0 || (format == SparseFormat::CSR && nrow == 0 && nnz > 0)) {
+            throw std::invalid_argument(std::format("Invalid sparse shape ({}, {}) during {}.", nrow, ncol, O::s_opname));
+        }
+
+        for (auto &index_op : {row_op, col_op}) {
+            if (index_op->get_data().get_device() != device) {
+                throw IncompatDevicesForOp(O::s_opname, device->str(), index_op->get_data().get_device()->str());
+            }
+        }
+
+        return {contiguous(row_op), contiguous(col_op), contiguous(value_op)};
+    }
+
+    template <class O>
+    static OpPtr sparse_dense_operand(OpPtr dense_op, const ShapeView &view, DevicePtr device) {
+        const ArrayData &dense_data = dense_op->get_data();
+
+        if (*dense_data.get_dtype() != f32) {
+            throw IncompatDtypeForOp(O::s_opname, dense_data.get_dtype()->str());
+        }
+
+        // Dense operands without columns would give empty outputs, which cannot be allocated
+        if (dense_data.get_ndim() != 2 || dense_data.get_view()[0] != view[0] || (view.size() > 1 && dense_data.get_view()[1] != view[1]) || dense_data.get_view()[1] == 0) {
+            throw IncompatShapesForOp(O::s_opname, join_nums(view), join_nums(dense_data.get_view()));
+        }
+
+        if (dense_data.get_device() != device) {
+            throw IncompatDevicesForOp(O::s_opname, device->str(), dense_data.get_device()->str());
+        }
+
+        return contiguous(dense_op);
+    }
+
+    OpPtr spmm(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, SparseFormat format, isize nrow, isize ncol, bool transposed) {
+        std::vector<OpPtr> operands = sparse_operands<SpmmOp>(row_op, col_op, value_op, format, nrow, ncol);
+        DevicePtr device = value_op->get_data().get_device();
+        // The dense operand has as many rows as the (transposed) sparse matrix has columns
+        operands.push_back(sparse_dense_operand<SpmmOp>(dense_op, {transposed ? nrow : ncol}, device));
+        const ArrayData out_data(Shape({transposed ? ncol : nrow, dense_op->get_data().get_view()[1]}), &f32, device);
+        return std::make_shared<SpmmOp>(out_data, operands, format, nrow, ncol, transposed);
+    }
+
+    OpPtr sparse_mul(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, SparseFormat format, isize nrow, isize ncol) {
+        std::vector<OpPtr> operands = sparse_operands<SparseMulOp>(row_op, col_op, value_op, format, nrow, ncol);
+        DevicePtr device = value_op->get_data().get_device();
+        operands.push_back(sparse_dense_operand<SparseMulOp>(dense_op, {nrow, ncol}, device));
+        const ArrayData out_data(Shape(value_op->get_data().get_view()), &f32, device);
+        return std::make_shared<SparseMulOp>(out_data, operands, format, nrow, ncol);
+    }
+
+    OpPtr sparse_to_dense(OpPtr row_op, OpPtr col_op, OpPtr value_op, SparseFormat format, isize nrow, isize ncol) {
+        std::vector<OpPtr> operands = sparse_operands<SparseToDenseOp>(row_op, col_op, value_op, format, nrow, ncol);
+        const ArrayData out_data(Shape({nrow, ncol}), &f32, value_op->get_data().get_device());
+        return std::make_shared<SparseToDenseOp>(out_data, operands, format, nrow, ncol);
+    }
+
+    OpPtr block_sparse_matmul(OpPtr in_op, OpPtr block_ptr_op, OpPtr block_col_op, OpPtr block_value_op, OpPtr bias_op, isize ncol) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        const ArrayData &block_ptr_data = block_ptr_op->get_data();
+        const ArrayData &block_col_data = block_col_op->get_data();
+        const ArrayData &block_value_data = block_value_op->get_data();
+        const ShapeView &block_value_view = block_value_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+        DevicePtr device = in_data.get_device();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(BlockSparseMatmulOp::s_opname, dtype->str());
+        }
+
+        if (*block_ptr_data.get_dtype() != i32 || *block_col_data.get_dtype() != i32) {
+            throw IncompatDtypesForOp(BlockSparseMatmulOp::s_opname, block_ptr_data.get_dtype()->str(), block_col_data.get_dtype()->str());
+        }
+
+        if (*block_value_data.get_dtype() != f32) {
+            throw IncompatDtypeForOp(BlockSparseMatmulOp::s_opname, block_value_data.get_dtype()->str());
+        }
+
+        if (block_value_data.get_ndim() != 3 || block_value_view[1] == 0 || block_value_view[2] == 0 || block_ptr_data.get_ndim() != 1 || block_ptr_data.get_numel() == 0 || block_col_data.get_view() != ShapeView{block_value_view[0]}) {
+            throw IncompatShapesForOp(BlockSparseMatmulOp::s_opname, join_nums(block_ptr_data.get_view()), join_nums(block_value_view));
+        }
+
+        // Block columns tile the input features exactly so that no block reads past the end of a row
+        if (in_data.get_ndim() == 0 || in_view.back() != ncol || ncol % block_value_view[2] != 0) {
+            throw IncompatShapesForOp(BlockSparseMatmulOp::s_opname, join_nums(in_view), join_nums(block_value_view));
+        }
+
+        const isize nout = (block_ptr_data.get_numel() - 1) * block_value_view[1];
+        std::vector<OpPtr> operands = {in_op, block_ptr_op, block_col_op, block_value_op};
+
+        if (bias_op) {
+            const ArrayData &bias_data = bias_op->get_data();
+
+            if (*bias_data.get_dtype() != *dtype) {
+                throw IncompatDtypesForOp(BlockSparseMatmulOp::s_opname, dtype->str(), bias_data.get_dtype()->str());
+            }
+
+            if (bias_data.get_view() != ShapeView{nout}) {
+                throw IncompatShapesForOp(BlockSparseMatmulOp::s_opname, join_nums(block_value_view), join_nums(bias_data.get_view()));
+            }
+
+            operands.push_back(bias_op);
+        }
+
+        for (auto &operand : operands) {
+            if (operand->get_data().get_device() != device) {
+                throw IncompatDevicesForOp(BlockSparseMatmulOp::s_opname, device->str(), operand->get_data().get_device()->str());
+            }
+
+            operand = contiguous(operand);
+        }
+
+        ShapeView out_view = in_view;
+        out_view.back() = nout;
+        const ArrayData out_data(Shape(out_view), dtype, device);
+        OpPtr out_op = std::make_shared<BlockSparseMatmulOp>(out_data, operands);
+        out_op->enable_grad(false);
+        return out_op;
+    }
+
+    // A 0-d mask is packed like a single row of one element
+    static ShapeView mask_words_view(const ShapeView &view) {
+        if (view.empty()) {
+            return {1};
+        }
+
+        ShapeView words_view = view;
+        words_view.back() = num_mask_words(view.back());
+        return words_view;
+    }
+
+    OpPtr cmp_bits(OpPtr l_op, OpPtr r_op, BitCmp cmp) {
+        l_op = autocast(l_op);
+        r_op = autocast(r_op);
+        const ArrayData &l_data = l_op->get_data();
+        const ArrayData &r_data = r_op->get_data();
+        const ShapeView &l_view = l_data.get_view();
+        const ShapeView &r_view = r_data.get_view();
+        DtypePtr l_dtype = l_data.get_dtype(), r_dtype = r_data.get_dtype();
+        DevicePtr l_device = l_data.get_device(), r_device = r_data.get_device();
+        const DtypeCategory dtype_category = cmp == BitCmp::EQ || cmp == BitCmp::NEQ ? DtypeCategory::All : DtypeCategory::Numeric;
+
+        if (!l_data.get_shape().broadcastable(r_view)) {
+            throw IncompatShapesForOp(CmpBitsOp::s_opname, join_nums(l_view), join_nums(r_view));
+        }
+
+        if (!l_dtype->has_category(dtype_category) || *l_dtype != *r_dtype) {
+            throw IncompatDtypesForOp(CmpBitsOp::s_opname, l_dtype->str(), r_dtype->str());
+        }
+
+        if (l_device != r_device) {
+            throw IncompatDevicesForOp(CmpBitsOp::s_opname, l_device->str(), r_device->str());
+        }
+
+        OpPtr broadcast_l_op = broadcast(l_op, r_view);
+        OpPtr broadcast_r_op = broadcast(r_op, l_view);
+        const ArrayData out_data(Shape(mask_words_view(broadcast_l_op->get_data().get_view())), &i32, l_device);
+        OpPtr out_op = std::make_shared<CmpBitsOp>(out_data, std::vector<OpPtr>{broadcast_l_op, broadcast_r_op}, cmp);
+        out_op->enable_grad(false);
+        return out_op;
+    }
+
+    OpPtr pack_bits(OpPtr in_op) {
+        const ArrayData &in_data = in_op->get_data();
+        DtypePtr dtype = in_data.get_dtype();
+
+        if (!dtype->is_bool()) {
+            throw IncompatDtypeForOp(CmpBitsOp::s_opname, dtype->str());
+        }
+
+        // A single false broadcasted with a zero stride is compared against every element
+        OpPtr false_op = full({1}, false, dtype, in_data.get_device());
+        false_op->enable_grad(false);
+        return cmp_bits(in_op, false_op, BitCmp::NEQ);
+    }
+
+    static void check_mask_words(const std::string &opname, OpPtr mask_op, const ShapeView &view) {
+        const ArrayData &mask_data = mask_op->get_data();
+
+        if (*mask_data.get_dtype() != i32) {
+            throw IncompatDtypeForOp(opname, mask_data.get_dtype()->str());
+        }
+
+        if (mask_data.get_view() != mask_words_view(view)) {
+            throw IncompatShapesForOp(opname, join_nums(mask_data.get_view()), join_nums(view));
+        }
+    }
+
+    OpPtr where_bits(OpPtr mask_op, const ShapeView &view, OpPtr l_op, OpPtr r_op) {
+        l_op = autocast(l_op);
+        r_op = autocast(r_op);
+        const ArrayData &l_data = l_op->get_data();
+        const ArrayData &r_data = r_op->get_data();
+        DtypePtr l_dtype = l_data.get_dtype(), r_dtype = r_data.get_dtype();
+        DevicePtr device = mask_op->get_data().get_device();
+        check_mask_words(WhereBitsOp::s_opname, mask_op, view);
+
+        if (!l_data.get_shape().broadcastable_to(view) || !r_data.get_shape().broadcastable_to(view)) {
+            throw IncompatShapesForOp(WhereBitsOp::s_opname, join_nums(l_data.get_view()), join_nums(r_data.get_view()));
+        }
+
+        if (*l_dtype != *r_dtype) {
+            throw IncompatDtypesForOp(WhereBitsOp::s_opname, l_dtype->str(), r_dtype->str());
+        }
+
+        for (auto &operand : {l_op, r_op}) {
+            if (operand->get_data().get_device() != device) {
+                throw IncompatDevicesForOp(WhereBitsOp::s_opname, device->str(), operand->get_data().get_device()->str());
+            }
+        }
+
+        // The values are read through their broadcasted strides, the words are read row by row
+        const ArrayData out_data(Shape(view), l_dtype, device);
+        return std::make_shared<WhereBitsOp>(out_data, std::vector<OpPtr>{contiguous(mask_op), broadcast_to(l_op, view), broadcast_to(r_op, view)});
+    }
+
+    OpPtr count_bits(OpPtr mask_op) {
+        const ArrayData &mask_data = mask_op->get_data();
+        const ShapeView &mask_view = mask_data.get_view();
+
+        if (*mask_data.get_dtype() != i32) {
+            throw IncompatDtypeForOp(CountBitsOp::s_opname, mask_data.get_dtype()->str());
+        }
+
+        if (mask_view.empty()) {
+            throw IncompatShapeForOp(CountBitsOp::s_opname, join_nums(mask_view));
+        }
+
+        const ArrayData out_data(Shape(ShapeView(mask_view.begin(), mask_view.end() - 1)), &i32, mask_data.get_device());
+        OpPtr out_op = std::make_shared<CountBitsOp>(out_data, std::vector<OpPtr>{contiguous(mask_op)});
+        out_op->enable_grad(false);
+        return out_op;
+    }
+
+    // Crops or zero pads a dimension to the given size
+    static OpPtr resize_dim(OpPtr in_op, isize dim, isize size) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+
+        if (in_view[dim] > size) {
+            RangeVector ranges;
+
+            for (isize i = 0; i < in_data.get_ndim(); i++) {
+                ranges.emplace_back(0, i == dim ? size : in_view[i], 1);
+            }
+
+            return slice(in_op, ranges);
+        }
+
+        if (in_view[dim] < size) {
+            ShapeView pad_view = in_view;
+            pad_view[dim] = size - in_view[dim];
+            return concat({in_op, zeros(pad_view, in_data.get_dtype(), in_data.get_device())}, dim);
+        }
+
+        return in_op;
+    }
+
+    OpPtr rfft(OpPtr in_op, std::optional<isize> n) {
+        const ArrayData &in_data = in_op->get_data();
+        DtypePtr dtype = in_data.get_dtype();
+        const isize dim = in_data.get_ndim() - 1;
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(RfftOp::s_opname, dtype->str());
+        }
+
+        // Like numpy, the signal is cropped or zero padded to n
+        const isize nfft = n.value_or(in_data.get_view()[dim]);
+
+        if (nfft <= 0) {
+            throw std::invalid_argument(std::format("Invalid transform size {} during {}.", nfft, RfftOp::s_opname));
+        }
+
+        OpPtr signal_op = resize_dim(in_op, dim, nfft);
+        ShapeView out_view = signal_op->get_data().get_view();
+        out_view[dim] = nfft / 2 + 1;
+        out_view.push_back(2);
+        const ArrayData out_data(Shape(out_view), dtype, in_data.get_device());
+        return std::make_shared<RfftOp>(out_data, signal_op, nfft);
+    }
+
+    OpPtr irfft(OpPtr in_op, std::optional<isize> n) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &in_view = in_data.get_view();
+        DtypePtr dtype = in_data.get_dtype();
+        const isize dim = in_data.get_ndim() - 2;
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(IrfftOp::s_opname, dtype->str());
+        }
+
+        if (in_data.get_ndim() < 2 || in_view.back() != 2) {
+            throw IncompatShapeForOp(IrfftOp::s_opname, join_nums(in_view));
+        }
+
+        // The spectrum is cropped or zero padded to the n / 2 + 1 frequencies of the output
+        const isize nfft = n.value_or(2 * (in_view[dim] - 1));
+
+        if (nfft <= 0) {
+            throw std::invalid_argument(std::format("Invalid transform size {} during {}.", nfft, IrfftOp::s_opname));
+        }
+
+        OpPtr spectrum_op = resize_dim(in_op, dim, nfft / 2 + 1);
+        ShapeView out_view(in_view.begin(), in_view.end() - 1);
+        out_view[dim] = nfft;
+        const ArrayData out_data(Shape(out_view), dtype, in_data.get_device());
+        return std::make_shared<IrfftOp>(out_data, spectrum_op, nfft);
+    }
+
+    OpPtr iadd(OpPtr l_op, OpPtr r_op) { return in_place_binary<AddOp>(l_op, r_op); }
+    OpPtr isub(OpPtr l_op, OpPtr r_op) { return in_place_binary<SubOp>(l_op, r_op); }
+    OpPtr imul(OpPtr l_op, OpPtr r_op) { return in_place_binary<MulOp>(l_op, r_op); }
+    OpPtr idiv(OpPtr l_op, OpPtr r_op) { return in_place_binary<DivOp>(l_op, r_op); }
+    OpPtr eq(OpPtr l_op, OpPtr r_op) { return cmp<EqOp>(autocast(l_op), autocast(r_op), DtypeCategory::All); }
+    OpPtr neq(OpPtr l_op, OpPtr r_op) { return cmp<NeqOp>(autocast(l_op), autocast(r_op), DtypeCategory::All); }
+    OpPtr lt(OpPtr l_op, OpPtr r_op) { return cmp<LtOp>(autocast(l_op), autocast(r_op), DtypeCategory::Numeric); }
+    OpPtr gt(OpPtr l_op, OpPtr r_op) { return cmp<GtOp>(autocast(l_op), autocast(r_op), DtypeCategory::Numeric); }
+    OpPtr leq(OpPtr l_op, OpPtr r_op) { return cmp<LeqOp>(autocast(l_op), autocast(r_op), DtypeCategory::Numeric); }
+    OpPtr geq(OpPtr l_op, OpPtr r_op) { return cmp<GeqOp>(autocast(l_op), autocast(r_op), DtypeCategory::Numeric); }
+    OpPtr minimum(OpPtr l_op, OpPtr r_op) { return elmwise_binary<MinimumOp>(autocast(l_op), autocast(r_op)); }
+    OpPtr maximum(OpPtr l_op, OpPtr r_op) { return elmwise_binary<MaximumOp>(autocast(l_op), autocast(r_op)); }
+
+    OpPtr pow(OpPtr l_op, OpPtr r_op) {
+        l_op = autocast(l_op);
+        r_op = autocast(r_op);
+        DtypePtr dtype = l_op->get_data().get_dtype();
+
+        if (!dtype->is_float()) {
+            throw IncompatDtypeForOp(PowOp::s_opname, dtype->str());
+        }
+
+        return elmwise_binary<PowOp>(l_op, r_op);
+    }
+
+    OpPtr fmod(OpPtr l_op, OpPtr r_op) { return elmwise_binary<FmodOp>(l_op, r_op); }
+
+    OpPtr where(OpPtr cond_op, OpPtr l_op, OpPtr r_op) {
+        l_op = autocast(l_op);
+        r_op = autocast(r_op);
+        const ArrayData &cond_data = cond_op->get_data();
+        const ArrayData &l_data = l_op->get_data();
+        const ArrayData &r_data = r_op->get_data();
+        const Shape &cond_shape = cond_data.get_shape();
+        const ShapeView &cond_view = cond_data.get_view();
+        const ShapeView &l_view = l_data.get_view();
+        const ShapeView &r_view = r_data.get_view();
+        DtypePtr cond_dtype = cond_data.get_dtype(), l_dtype = l_data.get_dtype(), r_dtype = r_data.get_dtype();
+        DevicePtr cond_device = cond_data.get_device(), l_device = l_data.get_device(), r_device = r_data.get_device();
+
+        if (!l_data.get_shape().broadcastable(r_view)) {
+            throw IncompatShapesForOp(WhereOp::s_opname, join_nums(l_view), join_nums(r_view));
+        }
+
+        if (!cond_shape.broadcastable(l_view)) {
+            throw IncompatShapesForOp(WhereOp::s_opname, join_nums(cond_view), join_nums(l_view));
+        }
+
+        if (!cond_shape.broadcastable(r_view)) {
+            throw IncompatShapesForOp(WhereOp::s_opname, join_nums(cond_view), join_nums(r_view));
+        }
+
+        if (!cond_dtype->is_bool()) {
+            throw IncompatDtypeForOp(WhereOp::s_opname, cond_dtype->str());
+        }
+
+        if (*l_dtype != *r_dtype) {
+            throw IncompatDtypesForOp(WhereOp::s_opname, l_dtype->str(), r_dtype->str());
+        }
+
+        if (l_device != r_device) {
+            throw IncompatDevicesForOp(WhereOp::s_opname, l_device->str(), r_device->str());
+        }
+
+        if (cond_device != l_device) {
+            throw IncompatDevicesForOp(WhereOp::s_opname, cond_device->str(), l_device->str());
+        }
+
+        // Broadcast all three operands to their common view
+        ShapeView out_view = l_data.get_shape().broadcast(r_view).first.get_view();
+        out_view = cond_shape.broadcast(out_view).first.get_view();
+        OpPtr broadcast_cond_op = broadcast_to(cond_op, out_view);
+        OpPtr broadcast_l_op = broadcast_to(l_op, out_view);
+        OpPtr broadcast_r_op = broadcast_to(r_op, out_view);
+        const ArrayData out_data(Shape(out_view), l_dtype, l_device);
+        return std::make_shared<WhereOp>(out_data, broadcast_cond_op, broadcast_l_op, broadcast_r_op);
+    }
+
+    OpPtr sq(OpPtr in_op, bool in_place) { return unary<SqOp>(in_op, in_place); }
+    OpPtr sqrt(OpPtr in_op, bool in_place) { return unary_float<SqrtOp>(in_op, in_place); }
+    OpPtr neg(OpPtr in_op, bool in_place) { return unary<NegOp>(in_op, in_place); }
+
+    OpPtr copy(OpPtr in_op) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(Shape(in_data.get_view()), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<CopyOp>(out_data, in_op);
+    }
+
+    OpPtr exp(OpPtr in_op, bool in_place) { return unary_float<ExpOp>(in_op, in_place); }
+    OpPtr log(OpPtr in_op, bool in_place) { return unary_float<LogOp>(in_op, in_place); }
+    OpPtr recip(OpPtr in_op, bool in_place) { return unary_float<RecipOp>(in_op, in_place); }
+    OpPtr sin(OpPtr in_op, bool in_place) { return unary_float<SinOp>(in_op, in_place); }
+    OpPtr cos(OpPtr in_op, bool in_place) { return unary_float<CosOp>(in_op, in_place); }
+    OpPtr relu(OpPtr in_op) { return unary<ReluOp>(in_op, false); }
+    OpPtr sigmoid(OpPtr in_op) { return unary_float<SigmoidOp>(in_op, false); }
+    OpPtr tanh(OpPtr in_op) { return unary_float<TanhOp>(in_op, false); }
+
+    OpPtr gelu(OpPtr in_op, bool approximate) {
+        if (approximate) {
+            return unary_float<GeluTanhOp>(in_op, false);
+        }
+
+        return unary_float<GeluOp>(in_op, false);
+    }
+
+    OpPtr silu(OpPtr in_op) { return unary_float<SiluOp>(in_op, false); }
+    OpPtr softplus(OpPtr in_op) { return unary_float<SoftplusOp>(in_op, false); }
+    OpPtr relu_grad(OpPtr grad_op, OpPtr out_op) { return elmwise_binary<ReluGradOp>(grad_op, out_op); }
+    OpPtr sigmoid_grad(OpPtr grad_op, OpPtr out_op) { return elmwise_binary<SigmoidGradOp>(grad_op, out_op); }
+    OpPtr tanh_grad(OpPtr grad_op, OpPtr out_op) { return elmwise_binary<TanhGradOp>(grad_op, out_op); }
+
+    OpPtr gelu_grad(OpPtr grad_op, OpPtr in_op, bool approximate) {
+        if (approximate) {
+            return elmwise_binary<GeluTanhGradOp>(grad_op, in_op);
+        }
+
+        return elmwise_binary<GeluGradOp>(grad_op, in_op);
+    }
+
+    OpPtr silu_grad(OpPtr grad_op, OpPtr in_op) { return elmwise_binary<SiluGradOp>(grad_op, in_op); }
+    OpPtr softplus_grad(OpPtr grad_op, OpPtr in_op) { return elmwise_binary<SoftplusGradOp>(grad_op, in_op); }
+    OpPtr abs(OpPtr in_op, bool in_place) { return unary<AbsOp>(in_op, in_place); }
+    OpPtr sign(OpPtr in_op, bool in_place) { return unary<SignOp>(in_op, in_place); }
+
+    OpPtr clamp(OpPtr in_op, std::optional<double> min, std::optional<double> max) {
+        const ArrayData &in_data = in_op->get_data();
+        DtypePtr in_dtype = in_data.get_dtype();
+
+        if (!in_dtype->is_numeric()) {
+            throw IncompatDtypeForOp(ClampOp::s_opname, in_dtype->str());
+        }
+
+        if (!min && !max) {
+            throw std::invalid_argument("At least one of min and max must be given to clamp.");
+        }
+
+        const ArrayData out_data(Shape(in_data.get_view()), in_dtype, in_data.get_device());
+        return std::make_shared<ClampOp>(out_data, in_op, min.value_or(-std::numeric_limits<double>::infinity()), max.value_or(std::numeric_limits<double>::infinity()));
+    }
+
+    OpPtr abs_grad(OpPtr grad_op, OpPtr in_op) { return elmwise_binary<AbsGradOp>(grad_op, in_op); }
+
+    OpPtr clamp_grad(OpPtr grad_op, OpPtr in_op, float min, float max) {
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData out_data(Shape(grad_data.get_view()), grad_data.get_dtype(), grad_data.get_device());
+        return std::make_shared<ClampGradOp>(out_data, grad_op, in_op, min, max);
+    }
+
+    OpPtr reshape(OpPtr in_op, const ShapeView &view) {
+        const ArrayData &in_data = in_op->get_data();
+
+        if (in_data.get_view() == view) {
+            return in_op;
+        }
+
+        const ArrayData out_data(in_data.get_shape().reshape(view), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<ReshapeOp>(out_data, in_op);
+    }
+
+    OpPtr permute(OpPtr in_op, const ShapeDims &dims) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData out_data(in_data.get_shape().permute(dims), in_data.get_dtype(), in_data.get_device());
+        return std::make_shared<PermuteOp>(out_data, in_op, dims);
+    }
+
+    OpPtr transpose(OpPtr in_op, isize start_dim, isize end_dim) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeDims &transpose_dims = in_data.get_shape().transpose(start_dim, end_dim);
+        return permute(in_op, transpose_dims);
+    }
+
+    OpPtr flatten(OpPtr in_op, isize start_dim, isize end_dim) {
+        const ArrayData &in_data = in_op->get_data();
+        const ShapeView &flattened_view = in_data.get_shape().flatten(start_dim, end_dim);
+        return reshape(in_op, flattened_view);
+    }
+
+    // 16-bit floats are reduced into f32 and rounded once by the caller
+    // Precise sums of floats carry the rounding error of the f32 accumulator along for about twice the precision
+    static OpPtr accum_sum(OpPtr in_op, const ShapeDims &dims, bool precise) {
+        if (precise) {
+            return reduce<PreciseSumOp>(in_op, dims, &f32, DtypeCategory::Float);
+        }
+
+        return reduce<SumOp>(in_op, dims, accum_dtype_by_dtype(in_op->get_data().get_dtype()), DtypeCategory::Numeric);
+    }
+
+    // Sums stay in f32 under autocast instead of being rounded back
+    OpPtr sum(OpPtr in_op, const ShapeDims &dims, bool precise) {
+        OpPtr sum_op = accum_sum(in_op, dims, precise);
+        DtypePtr in_dtype = in_op->get_data().get_dtype();
+        return autocast_dtype && in_dtype->is_float() ? sum_op : astype(sum_op, in_dtype);
+    }
+
+    OpPtr mean(OpPtr in_op, const ShapeDims &dims, bool precise) {
+        OpPtr sum_op = accum_sum(in_op, dims, precise);
+        isize numel;
+
+        if (dims.empty()) {
+            numel = in_op->get_data().get_numel();
+        } else {
+            const ShapeView &in_view = in_op->get_data().get_view();
+            numel = std::accumulate(dims.begin(), dims.end(), 1ll, [&](isize acc, isize dim) { return acc * in_view[dim]; });
+        }
+
+        if (autocast_dtype && in_op->get_data().get_dtype()->is_float()) {
+            // Division must not round the f32 sum down to the autocast dtype
+            AutocastGuard guard(nullptr);
+            return div(sum_op, numel);
+        }
+
+        return astype(div(sum_op, numel), in_op->get_data().get_dtype());
+    }
+
+    // Statistics are accumulated in f32 and stay in f32 under autocast like sums
+    template <class O, class... Args>
+    static OpPtr stat_reduce(OpPtr in_op, const ShapeDims &dims, Args &&...args) {
+        OpPtr stat_op = reduce<O>(in_op, dims, &f32, DtypeCategory::Float, std::forward<Args>(args)...);
+        return autocast_dtype ? stat_op : astype(stat_op, in_op->get_data().get_dtype());
+    }
+
+    OpPtr var(OpPtr in_op, const ShapeDims &dims, float correction) { return stat_reduce<VarOp>(in_op, dims, correction); }
+    OpPtr std_dev(OpPtr in_op, const ShapeDims &dims, float correction) { return stat_reduce<StdOp>(in_op, dims, correction); }
+    OpPtr vector_norm(OpPtr in_op, const ShapeDims &dims, NormOrd ord) { return stat_reduce<VectorNormOp>(in_op, dims, ord); }
+
+    OpPtr max(OpPtr in_op, const ShapeDims &dims) {
+        DtypePtr in_dtype = in_op->get_data().get_dtype();
+        return astype(reduce<MaxOp>(in_op, dims, accum_dtype_by_dtype(in_dtype), DtypeCategory::Numeric), in_dtype);
+    }
+
+    OpPtr min(OpPtr in_op, const ShapeDims &dims) {
+        DtypePtr in_dtype = in_op->get_data().get_dtype();
+        return astype(reduce<MinOp>(in_op, dims, accum_dtype_by_dtype(in_dtype), DtypeCategory::Numeric), in_dtype);
+    }
+
+    OpPtr argmax(OpPtr in_op, const ShapeDims &dims) { return reduce<ArgmaxOp>(in_op, dims, &i32, DtypeCategory::Numeric); }
+    OpPtr argmin(OpPtr in_op, const ShapeDims &dims) { return reduce<ArgminOp>(in_op, dims, &i32, DtypeCategory::Numeric); }
+    OpPtr cumsum(OpPtr in_op, isize dim) { return scan<CumsumOp>(in_op, dim); }
+    OpPtr cumprod(OpPtr in_op, isize dim) { return scan<CumprodOp>(in_op, dim); }
+    OpPtr cummax(OpPtr in_op, isize dim) { return scan<CummaxOp>(in_op, dim); }
+
+    OpPtr sort(OpPtr in_op, isize dim, bool descending) {
+        isize ndim = in_op->get_data().get_ndim();
+        isize len = dim >= 0 && dim < ndim ? in_op->get_data().get_view()[dim] : 1;
+        return sorting<SortOp>(in_op, len, dim, descending, in_op->get_data().get_dtype());
+    }
+
+    OpPtr argsort(OpPtr in_op, isize dim, bool descending) {
+        isize ndim = in_op->get_data().get_ndim();
+        isize len = dim >= 0 && dim < ndim ? in_op->get_data().get_view()[dim] : 1;
+        return sorting<ArgsortOp>(in_op, len, dim, descending, &i32);
+    }
+
+    OpPtr argtopk(OpPtr in_op, isize k, isize dim, bool largest) { return sorting<ArgtopkOp>(in_op, k, dim, largest, &i32); }
+
+    OpPtr topk(OpPtr in_op, isize k, isize dim, bool largest) {
+        // Values are gathered at the top-k indices so that callers needing both only sort once
+        OpPtr index_op = argtopk(in_op, k, dim, largest);
+        const ArrayData &index_data = index_op->get_data();
+        const ArrayData out_data(Shape(index_data.get_view()), in_op->get_data().get_dtype(), index_data.get_device());
+        return std::make_shared<TopkOp>(out_data, in_op, index_op, dim, k, largest);
+    }
 
     OpPtr expand(OpPtr in_op, const ShapeView &reduce_operand_view, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims) {
         // TODO: check if remaining_dims and reduce_dims are valid?
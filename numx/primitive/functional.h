@@ -4,6 +4,24 @@
 #include "random.h"
 
 namespace nx::primitive {
+    // Autocast is a per-thread graph construction mode, null when disabled
+    DtypePtr get_autocast_dtype();
+    void set_autocast_dtype(DtypePtr dtype);
+
+    // Restores the previous autocast dtype on scope exit
+    class AutocastGuard {
+    private:
+        DtypePtr m_prev_dtype;
+
+    public:
+        explicit AutocastGuard(DtypePtr dtype) : m_prev_dtype(get_autocast_dtype()) { set_autocast_dtype(dtype); }
+        AutocastGuard(const AutocastGuard &) = delete;
+        AutocastGuard(AutocastGuard &&) noexcept = delete;
+        ~AutocastGuard() { set_autocast_dtype(m_prev_dtype); }
+        AutocastGuard &operator=(const AutocastGuard &) = delete;
+        AutocastGuard &operator=(AutocastGuard &&) noexcept = delete;
+    };
+
     isize item(OpPtr op);
     OpPtr detach(OpPtr op);
     OpPtr from_buffer(uint8_t *ptr, isize size, const Shape &shape, DtypePtr dtype, DevicePtr device);
@@ -23,11 +41,56 @@ namespace nx::primitive {
     OpPtr astype(OpPtr in_op, DtypePtr dtype);
     OpPtr unsqueeze(OpPtr in_op, const ShapeDims &dims);
     OpPtr squeeze(OpPtr in_op, const ShapeDims &dims);
+    OpPtr concat(const std::vector<OpPtr> &in_ops, isize dim);
+    OpPtr stack(const std::vector<OpPtr> &in_ops, isize dim);
+    std::vector<OpPtr> split(OpPtr in_op, const ShapeView &sizes, isize dim);
+    OpPtr flip(OpPtr in_op, isize dim);
+    OpPtr gather(OpPtr in_op, OpPtr index_op, isize dim);
+    OpPtr scatter(OpPtr in_op, OpPtr index_op, isize dim, const ShapeView &view);
     OpPtr add(OpPtr l_op, OpPtr r_op);
     OpPtr sub(OpPtr l_op, OpPtr r_op);
     OpPtr mul(OpPtr l_op, OpPtr r_op);
     OpPtr div(OpPtr l_op, OpPtr r_op);
     OpPtr matmul(OpPtr l_op, OpPtr r_op);
+    OpPtr conv2d(OpPtr in_op, OpPtr weight_op, const Conv2dParams &params);
+    OpPtr im2col(OpPtr in_op, const Conv2dParams &params);
+    OpPtr col2im(OpPtr in_op, const ShapeView &image_view, const Conv2dParams &params);
+    OpPtr maxpool2d(OpPtr in_op, const Pool2dParams &params);
+    OpPtr avgpool2d(OpPtr in_op, const Pool2dParams &params);
+    OpPtr maxpool2d_grad(OpPtr in_op, OpPtr grad_op, const Pool2dParams &params);
+    OpPtr avgpool2d_grad(OpPtr grad_op, const ShapeView &image_view, const Pool2dParams &params);
+    OpPtr dropout(OpPtr in_op, uint64_t key, float p);
+    OpPtr bincount(OpPtr in_op, OpPtr weight_op, isize num_bins);
+    OpPtr histogram(OpPtr in_op, OpPtr weight_op, isize num_bins, float min, float max);
+    OpPtr multinomial(OpPtr in_op, uint64_t key, isize num_samples, float temperature, isize top_k, float top_p, bool logits);
+    OpPtr layer_norm(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, float eps);
+    OpPtr rms_norm(OpPtr in_op, OpPtr weight_op, float eps);
+    OpPtr norm_grad(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, bool centered);
+    OpPtr norm_param_grad(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, bool centered);
+    OpPtr batch_norm(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr running_mean_op, OpPtr running_var_op, const BatchNormParams &params);
+    OpPtr batch_norm_grad(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr param_grad_op, const BatchNormParams &params);
+    OpPtr batch_norm_param_grad(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, const BatchNormParams &params);
+    OpPtr sdpa(OpPtr q_op, OpPtr k_op, OpPtr v_op, float scale, bool causal);
+    OpPtr sdpa_grad(OpPtr grad_op, OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr out_op, OpPtr stats_op, float scale, bool causal, AttentionGradTarget target);
+    OpPtr lstm_cell(OpPtr gi_op, OpPtr gh_op, OpPtr c_op);
+    OpPtr lstm_cell_grad(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr c_op, RecurrentGradTarget target);
+    OpPtr gru_cell(OpPtr gi_op, OpPtr gh_op, OpPtr h_op);
+    OpPtr gru_cell_grad(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr h_op, RecurrentGradTarget target);
+    OpPtr lstm(OpPtr gi_op, OpPtr weight_op, OpPtr h_op, OpPtr c_op);
+    OpPtr gru(OpPtr gi_op, OpPtr weight_op, OpPtr bias_op, OpPtr h_op);
+    OpPtr quantize(OpPtr in_op, float clip);
+    OpPtr quantize_scale(OpPtr quantize_op);
+    OpPtr quantized_matmul(OpPtr in_op, OpPtr weight_op, OpPtr weight_scale_op, OpPtr bias_op, QuantizedActivation activation, float clip);
+    OpPtr spmm(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, SparseFormat format, isize nrow, isize ncol, bool transposed);
+    OpPtr sparse_mul(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, SparseFormat format, isize nrow, isize ncol);
+    OpPtr sparse_to_dense(OpPtr row_op, OpPtr col_op, OpPtr value_op, SparseFormat format, isize nrow, isize ncol);
+    OpPtr block_sparse_matmul(OpPtr in_op, OpPtr block_ptr_op, OpPtr block_col_op, OpPtr block_value_op, OpPtr bias_op, isize ncol);
+    OpPtr cmp_bits(OpPtr l_op, OpPtr r_op, BitCmp cmp);
+    OpPtr pack_bits(OpPtr in_op);
+    OpPtr where_bits(OpPtr mask_op, const ShapeView &view, OpPtr l_op, OpPtr r_op);
+    OpPtr count_bits(OpPtr mask_op);
+    OpPtr rfft(OpPtr in_op, std::optional<isize> n = std::nullopt);
+    OpPtr irfft(OpPtr in_op, std::optional<isize> n = std::nullopt);
     OpPtr iadd(OpPtr l_op, OpPtr r_op);
     OpPtr isub(OpPtr l_op, OpPtr r_op);
     OpPtr imul(OpPtr l_op, OpPtr r_op);
@@ -40,6 +103,9 @@ namespace nx::primitive {
     OpPtr geq(OpPtr l_op, OpPtr r_op);
     OpPtr minimum(OpPtr l_op, OpPtr r_op);
     OpPtr maximum(OpPtr l_op, OpPtr r_op);
+    OpPtr pow(OpPtr l_op, OpPtr r_op);
+    OpPtr fmod(OpPtr l_op, OpPtr r_op);
+    OpPtr where(OpPtr cond_op, OpPtr l_op, OpPtr r_op);
     OpPtr sq(OpPtr in_op, bool in_place = false);
     OpPtr sqrt(OpPtr in_op, bool in_place = false);
     OpPtr neg(OpPtr in_op, bool in_place = false);
@@ -49,16 +115,43 @@ namespace nx::primitive {
     OpPtr recip(OpPtr in_op, bool in_place = false);
     OpPtr sin(OpPtr in_op, bool in_place = false);
     OpPtr cos(OpPtr in_op, bool in_place = false);
+    OpPtr relu(OpPtr in_op);
+    OpPtr sigmoid(OpPtr in_op);
+    OpPtr tanh(OpPtr in_op);
+    OpPtr gelu(OpPtr in_op, bool approximate = false);
+    OpPtr silu(OpPtr in_op);
+    OpPtr softplus(OpPtr in_op);
+    OpPtr relu_grad(OpPtr grad_op, OpPtr out_op);
+    OpPtr sigmoid_grad(OpPtr grad_op, OpPtr out_op);
+    OpPtr tanh_grad(OpPtr grad_op, OpPtr out_op);
+    OpPtr gelu_grad(OpPtr grad_op, OpPtr in_op, bool approximate = false);
+    OpPtr silu_grad(OpPtr grad_op, OpPtr in_op);
+    OpPtr softplus_grad(OpPtr grad_op, OpPtr in_op);
+    OpPtr abs(OpPtr in_op, bool in_place = false);
+    OpPtr sign(OpPtr in_op, bool in_place = false);
+    OpPtr clamp(OpPtr in_op, std::optional<double> min, std::optional<double> max);
+    OpPtr abs_grad(OpPtr grad_op, OpPtr in_op);
+    OpPtr clamp_grad(OpPtr grad_op, OpPtr in_op, float min, float max);
     OpPtr reshape(OpPtr in_op, const ShapeView &view);
     OpPtr permute(OpPtr in_op, const ShapeDims &dims);
     OpPtr transpose(OpPtr in_op, isize start_dim, isize end_dim);
     OpPtr flatten(OpPtr in_op, isize start_dim, isize end_dim);
-    OpPtr sum(OpPtr in_op, const ShapeDims &dims = {});
-    OpPtr mean(OpPtr in_op, const ShapeDims &dims = {});
+    OpPtr sum(OpPtr in_op, const ShapeDims &dims = {}, bool precise = false);
+    OpPtr mean(OpPtr in_op, const ShapeDims &dims = {}, bool precise = false);
+    OpPtr var(OpPtr in_op, const ShapeDims &dims = {}, float correction = 1.0f);
+    OpPtr std_dev(OpPtr in_op, const ShapeDims &dims = {}, float correction = 1.0f);
+    OpPtr vector_norm(OpPtr in_op, const ShapeDims &dims = {}, NormOrd ord = NormOrd::L2);
     OpPtr max(OpPtr in_op, const ShapeDims &dims = {});
     OpPtr min(OpPtr in_op, const ShapeDims &dims = {});
     OpPtr argmax(OpPtr in_op, const ShapeDims &dims = {});
     OpPtr argmin(OpPtr in_op, const ShapeDims &dims = {});
+    OpPtr cumsum(OpPtr in_op, isize dim);
+    OpPtr cumprod(OpPtr in_op, isize dim);
+    OpPtr cummax(OpPtr in_op, isize dim);
+    OpPtr sort(OpPtr in_op, isize dim, bool descending = false);
+    OpPtr argsort(OpPtr in_op, isize dim, bool descending = false);
+    OpPtr topk(OpPtr in_op, isize k, isize dim, bool largest = true);
+    OpPtr argtopk(OpPtr in_op, isize k, isize dim, bool largest = true);
     OpPtr expand(OpPtr in_op, const ShapeView &reduce_operand_view, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims);
 
     template <NumericOrBoolType T>
@@ -79,6 +172,10 @@ namespace nx::primitive {
 
     template <NumericType T>
     OpPtr uniform(const ShapeView &view, RandomKeyGeneratorPtr rand_key_gen, T low, T high, DtypePtr dtype, DevicePtr device) {
+        if (*dtype == bf16) {
+            return astype(uniform(view, rand_key_gen, low, high, &f32, device), dtype);
+        }
+
         uint64_t key = rand_key_gen->next();
         return std::make_shared<UniformOp>(ArrayData(Shape(view), dtype, device), key, dtype_bitcast_numeric(dtype, low), dtype_bitcast_numeric(dtype, high));
     }
@@ -149,8 +246,67 @@ namespace nx::primitive {
     template <NumericType T>
     OpPtr maximum(OpPtr l_op, T constant) { return binary_with_scalar(l_op, constant, maximum); }
 
+    template <NumericType T>
+    OpPtr pow(OpPtr l_op, T exponent) {
+        // Common exponents map to cheaper unary kernels instead of the generic pow
+        if (l_op->get_data().get_dtype()->is_float()) {
+            if (exponent == 2) {
+                return sq(l_op);
+            } else if (exponent == 0.5) {
+                return sqrt(l_op);
+            } else if (exponent == -1) {
+                return recip(l_op);
+            }
+        }
+
+        return binary_with_scalar(l_op, exponent, pow);
+    }
+
+    template <NumericType T>
+    OpPtr fmod(OpPtr l_op, T constant) { return binary_with_scalar(l_op, constant, fmod); }
+
+    template <NumericOrBoolType T>
+    OpPtr where(OpPtr cond_op, OpPtr l_op, T constant) {
+        // A single element is enough since it is broadcasted with a zero stride
+        const ArrayData &l_data = l_op->get_data();
+        OpPtr r_op = full({1}, constant, l_data.get_dtype(), l_data.get_device());
+        r_op->enable_grad(false);
+        return where(cond_op, l_op, r_op);
+    }
+
+    template <NumericOrBoolType T>
+    OpPtr where(OpPtr cond_op, T constant, OpPtr r_op) {
+        const ArrayData &r_data = r_op->get_data();
+        OpPtr l_op = full({1}, constant, r_data.get_dtype(), r_data.get_device());
+        l_op->enable_grad(false);
+        return where(cond_op, l_op, r_op);
+    }
+
+    template <NumericOrBoolType T>
+    OpPtr where_bits(OpPtr mask_op, const ShapeView &view, OpPtr l_op, T constant) {
+        const ArrayData &l_data = l_op->get_data();
+        OpPtr r_op = full({1}, constant, l_data.get_dtype(), l_data.get_device());
+        r_op->enable_grad(false);
+        return where_bits(mask_op, view, l_op, r_op);
+    }
+
+    template <NumericOrBoolType T>
+    OpPtr where_bits(OpPtr mask_op, const ShapeView &view, T constant, OpPtr r_op) {
+        const ArrayData &r_data = r_op->get_data();
+        OpPtr l_op = full({1}, constant, r_data.get_dtype(), r_data.get_device());
+        l_op->enable_grad(false);
+        return where_bits(mask_op, view, l_op, r_op);
+    }
+
     template <NumericType T>
     OpPtr normal(const ShapeView &view, RandomKeyGeneratorPtr rand_key_gen, T mean, T std, DtypePtr dtype, DevicePtr device) {
+        DtypePtr accum_dtype = accum_dtype_by_dtype(dtype);
+
+        // log and cos of 16-bit uniforms are too coarse for the tails
+        if (accum_dtype != dtype) {
+            return astype(normal(view, rand_key_gen, mean, std, accum_dtype, device), dtype);
+        }
+
         // TODO: cache second output by Box-Muller transform for future use?
         OpPtr lhs = uniform(view, rand_key_gen, 0, 1, dtype, device);
         OpPtr rhs = uniform(view, rand_key_gen, 0, 1, dtype, device);
@@ -276,7 +432,50 @@ namespace nx::primitive {
     }
 
     template <class O>
-    OpPtr reduce(OpPtr in_op, const ShapeDims &dims, DtypePtr out_dtype, DtypeCategory dtype_category) {
+    OpPtr scan(OpPtr in_op, isize dim) {
+        const ArrayData &in_data = in_op->get_data();
+        DtypePtr in_dtype = in_data.get_dtype();
+        isize ndim = in_data.get_ndim();
+
+        if (!in_dtype->is_numeric()) {
+            throw IncompatDtypeForOp(O::s_opname, in_dtype->str());
+        }
+
+        if (dim < 0 || dim >= ndim) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during {}.", dim, ndim, O::s_opname));
+        }
+
+        const ArrayData out_data(Shape(in_data.get_view()), in_dtype, in_data.get_device());
+        return std::make_shared<O>(out_data, in_op, dim);
+    }
+
+    template <class O>
+    OpPtr sorting(OpPtr in_op, isize k, isize dim, bool descending, DtypePtr out_dtype) {
+        const ArrayData &in_data = in_op->get_data();
+        DtypePtr in_dtype = in_data.get_dtype();
+        isize ndim = in_data.get_ndim();
+
+        if (!in_dtype->is_numeric()) {
+            throw IncompatDtypeForOp(O::s_opname, in_dtype->str());
+        }
+
+        if (dim < 0 || dim >= ndim) {
+            throw std::invalid_argument(std::format("Dimension {} is out of range [0, {}) during {}.", dim, ndim, O::s_opname));
+        }
+
+        ShapeView out_view = in_data.get_view();
+
+        if (k <= 0 || k > out_view[dim]) {
+            throw std::invalid_argument(std::format("Cannot select {} elements from dimension {} of length {} during {}.", k, dim, out_view[dim], O::s_opname));
+        }
+
+        out_view[dim] = k;
+        const ArrayData out_data(Shape(out_view), out_dtype, in_data.get_device());
+        return std::make_shared<O>(out_data, in_op, dim, k, descending);
+    }
+
+    template <class O, class... Args>
+    OpPtr reduce(OpPtr in_op, const ShapeDims &dims, DtypePtr out_dtype, DtypeCategory dtype_category, Args &&...args) {
         const ArrayData &in_data = in_op->get_data();
         const Shape &in_shape = in_data.get_shape();
         DtypePtr in_dtype = in_data.get_dtype();
@@ -296,7 +495,7 @@ namespace nx::primitive {
             reduce_dims = remaining_dims;
             remaining_dims.clear();
             ArrayData out_data(Shape({1}), out_dtype, in_device);
-            out_op = std::make_shared<O>(out_data, in_op, remaining_dims, reduce_dims);
+            out_op = std::make_shared<O>(out_data, in_op, remaining_dims, reduce_dims, std::forward<Args>(args)...);
             return out_op;
         }
 
@@ -315,7 +514,7 @@ namespace nx::primitive {
         ShapeView out_view(remaining_dims.size() + 1, 1);
         std::transform(remaining_dims.begin(), remaining_dims.end(), out_view.begin(), [&](isize dim) { return in_shape[dim]; });
         ArrayData out_data(Shape(out_view), out_dtype, in_device);
-        out_op = std::make_shared<O>(out_data, in_op, remaining_dims, reduce_dims);
+        out_op = std::make_shared<O>(out_data, in_op, remaining_dims, reduce_dims, std::forward<Args>(args)...);
         return out_op;
     }
 } // namespace nx::primitive
\ No newline at end of file
@@ -89,39 +89,72 @@ namespace nx::primitive {
 
     void MinimumOp::grad_fn() const {
         // z = min(x, y)
-        // dx += dz * (1 where x is min and 0 otherwise)
-        // dy += dz * (1 where y is min and 0 otherwise)
-        OpPtr d_out = detach_this();
+        // dx += where(x <= y, dz, 0)
+        // dy += where(x <= y, 0, dz)
+        // The mask is bit-packed since it is shared by both gradients
+        const ShapeView &view = m_grad->get_data().get_view();
+        OpPtr mask = cmp_bits(detach(m_lhs), detach(m_rhs), BitCmp::LEQ);
 
         if (m_lhs->is_grad_enabled()) {
             m_lhs->zero_grad();
-            OpPtr l_minimum = astype(eq(detach(m_lhs), d_out), d_out->get_data().get_dtype());
-            m_lhs->iadd_grad(mul(m_grad, l_minimum));
+            m_lhs->iadd_grad(where_bits(mask, view, m_grad, 0.0f));
         }
 
         if (m_rhs->is_grad_enabled()) {
             m_rhs->zero_grad();
-            OpPtr r_minimum = astype(eq(detach(m_rhs), d_out), d_out->get_data().get_dtype());
-            m_rhs->iadd_grad(mul(m_grad, r_minimum));
+            m_rhs->iadd_grad(where_bits(mask, view, 0.0f, m_grad));
         }
     }
 
     void MaximumOp::grad_fn() const {
         // z = max(x, y)
-        // dx += dz * (1 where x is max and 0 otherwise)
-        // dy += dz * (1 where y is max and 0 otherwise)
-        OpPtr d_out = detach_this();
+        // dx += where(x >= y, dz, 0)
+        // dy += where(x >= y, 0, dz)
+        // The mask is bit-packed since it is shared by both gradients
+        const ShapeView &view = m_grad->get_data().get_view();
+        OpPtr mask = cmp_bits(detach(m_lhs), detach(m_rhs), BitCmp::GEQ);
 
         if (m_lhs->is_grad_enabled()) {
             m_lhs->zero_grad();
-            OpPtr l_maximum = astype(eq(detach(m_lhs), d_out), d_out->get_data().get_dtype());
-            m_lhs->iadd_grad(mul(m_grad, l_maximum));
+            m_lhs->iadd_grad(where_bits(mask, view, m_grad, 0.0f));
         }
 
         if (m_rhs->is_grad_enabled()) {
             m_rhs->zero_grad();
-            OpPtr r_maximum = astype(eq(detach(m_rhs), d_out), d_out->get_data().get_dtype());
-            m_rhs->iadd_grad(mul(m_grad, r_maximum));
+            m_rhs->iadd_grad(where_bits(mask, view, 0.0f, m_grad));
+        }
+    }
+
+    void PowOp::grad_fn() const {
+        // z = x^y
+        // dx += y == 0 ? 0 : dz * y * x^(y-1)
+        // dy += x == 0 && y >= 0 ? 0 : dz * z * log(x)
+        // The masks avoid 0 * inf at x = 0 the same way torch does
+        if (m_lhs->is_grad_enabled()) {
+            m_lhs->zero_grad();
+            OpPtr dx = mul(m_grad, mul(detach(m_rhs), pow(detach(m_lhs), sub(detach(m_rhs), 1.0f))));
+            m_lhs->iadd_grad(where(eq(detach(m_rhs), 0.0f), 0.0f, dx));
+        }
+
+        if (m_rhs->is_grad_enabled()) {
+            m_rhs->zero_grad();
+            OpPtr dy = mul(m_grad, mul(detach_this(), log(detach(m_lhs))));
+            m_rhs->iadd_grad(where(eq(detach(m_lhs), 0.0f), where(lt(detach(m_rhs), 0.0f), dy, 0.0f), dy));
+        }
+    }
+
+    void FmodOp::grad_fn() const {
+        // z = x - y * trunc(x/y)
+        // dx += dz
+        // dy -= dz * trunc(x/y), trunc(x/y) = (x-z) / y
+        if (m_lhs->is_grad_enabled()) {
+            m_lhs->zero_grad();
+            m_lhs->iadd_grad(m_grad);
+        }
+
+        if (m_rhs->is_grad_enabled()) {
+            m_rhs->zero_grad();
+            m_rhs->isub_grad(mul(m_grad, div(sub(detach(m_lhs), detach_this()), detach(m_rhs))));
         }
     }
 
@@ -143,6 +176,536 @@ namespace nx::primitive {
         }
     }
 
+    void Conv2dOp::grad_fn() const {
+        // NCHW: z_n = w @ im2col(x)_n
+        // dx += col2im(w^T @ dz_n)
+        // dw += sum_n dz_n @ im2col(x)_n^T
+        // NHWC: z = im2col(x) @ w^T with images and patches flattened together
+        // dx += col2im(dz @ w)
+        // dw += dz^T @ im2col(x)
+        const ShapeView &in_view = m_lhs->get_data().get_view();
+        const ShapeView &weight_view = m_rhs->get_data().get_view();
+        const ShapeView &out_view = m_data.get_view();
+        const isize nimage = out_view[0];
+        const isize out_nchannel = weight_view[0];
+        const isize patch_size = weight_view[1];
+        const isize npatch = m_data.get_numel() / nimage / out_nchannel;
+
+        if (m_params.channels_last()) {
+            OpPtr grad = reshape(m_grad, {nimage * npatch, out_nchannel});
+
+            if (m_lhs->is_grad_enabled()) {
+                m_lhs->zero_grad();
+                OpPtr cols_grad = reshape(matmul(grad, detach(m_rhs)), {nimage, npatch, patch_size});
+                m_lhs->iadd_grad(col2im(cols_grad, in_view, m_params));
+            }
+
+            if (m_rhs->is_grad_enabled()) {
+                m_rhs->zero_grad();
+                OpPtr cols = reshape(im2col(detach(m_lhs), m_params), {nimage * npatch, patch_size});
+                m_rhs->iadd_grad(matmul(transpose(grad, 0, 1), cols));
+            }
+        } else {
+            OpPtr grad = reshape(m_grad, {nimage, out_nchannel, npatch});
+
+            if (m_lhs->is_grad_enabled()) {
+                m_lhs->zero_grad();
+                OpPtr cols_grad = matmul(transpose(detach(m_rhs), 0, 1), grad);
+                m_lhs->iadd_grad(col2im(cols_grad, in_view, m_params));
+            }
+
+            if (m_rhs->is_grad_enabled()) {
+                m_rhs->zero_grad();
+                OpPtr cols = im2col(detach(m_lhs), m_params);
+                OpPtr weight_grad = sum(matmul(grad, transpose(cols, 1, 2)), {0});
+                m_rhs->iadd_grad(reshape(weight_grad, {out_nchannel, patch_size}));
+            }
+        }
+    }
+
+    void Im2colOp::grad_fn() const {
+        // im2col and col2im are adjoint
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(col2im(m_grad, m_operand->get_data().get_view(), m_params));
+        }
+    }
+
+    void Col2imOp::grad_fn() const {
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(im2col(m_grad, m_params));
+        }
+    }
+
+    // Weights of the n / 2 + 1 frequencies of a real spectrum of view (n / 2 + 1, 1), every frequency other than the
+    // zero and Nyquist ones stands for a conjugate pair of the full spectrum
+    static OpPtr spectrum_weight(isize n, float single, float pair, DtypePtr dtype, DevicePtr device) {
+        const isize npair = (n - 1) / 2;
+        std::vector<OpPtr> weights = {full(ShapeView{1, 1}, single, dtype, device)};
+
+        if (npair > 0) {
+            weights.push_back(full(ShapeView{npair, 1}, pair, dtype, device));
+        }
+
+        if (n % 2 == 0) {
+            weights.push_back(full(ShapeView{1, 1}, single, dtype, device));
+        }
+
+        return weights.size() > 1 ? concat(weights, 0) : weights[0];
+    }
+
+    void RfftOp::grad_fn() const {
+        // z_k = sum_t x_t e^(-2 pi i k t / n) for k <= n / 2
+        // dx_t += sum_k Re(dz_k e^(2 pi i k t / n)), the adjoint is n irfft(dz) once the pairs it doubles are halved
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            const ArrayData &grad_data = m_grad->get_data();
+            const float n = static_cast<float>(m_n);
+            m_operand->iadd_grad(irfft(mul(m_grad, spectrum_weight(m_n, n, n / 2.0f, grad_data.get_dtype(), grad_data.get_device())), m_n));
+        }
+    }
+
+    void IrfftOp::grad_fn() const {
+        // x_t = (Re z_0 + 2 sum_pairs Re(z_k e^(2 pi i k t / n)) + Re z_(n / 2) (-1)^t) / n
+        // dz_k += c_k / n rfft(dx)_k with c_k = 2 for pairs and 1 otherwise, rfft(dx) has no imaginary part where z is ignored
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            const ArrayData &grad_data = m_grad->get_data();
+            const float n = static_cast<float>(m_n);
+            m_operand->iadd_grad(mul(rfft(m_grad, m_n), spectrum_weight(m_n, 1.0f / n, 2.0f / n, grad_data.get_dtype(), grad_data.get_device())));
+        }
+    }
+
+    void MaxPool2dOp::grad_fn() const {
+        // dx += dz at the argmax of every window, recomputed from x
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(maxpool2d_grad(detach(m_operand), m_grad, m_params));
+        }
+    }
+
+    void AvgPool2dOp::grad_fn() const {
+        // dx += dz / window size over every window containing x
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(avgpool2d_grad(m_grad, m_operand->get_data().get_view(), m_params));
+        }
+    }
+
+    void AvgPool2dGradOp::grad_fn() const {
+        // Average pooling and its gradient are adjoint
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(avgpool2d(m_grad, m_params));
+        }
+    }
+
+    void DropoutOp::grad_fn() const {
+        // z = x * mask / (1 - p)
+        // dx += dz * mask / (1 - p), the same key regenerates the same mask
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(dropout(m_grad, m_key, m_p));
+        }
+    }
+
+    void LayerNormOp::grad_fn() const {
+        // y = xhat * w + b with xhat = (x - mean) * rstd
+        // dx = rstd * (g - mean(g) - xhat * mean(g * xhat)) with g = dy * w
+        // dw += sum(dy * xhat) over rows
+        // db += sum(dy) over rows
+        OpPtr x = m_operands[0];
+        OpPtr w = m_operands[1];
+        OpPtr b = m_operands[2];
+        OpPtr stats = detach(get_stats());
+
+        if (x->is_grad_enabled()) {
+            x->zero_grad();
+            x->iadd_grad(norm_grad(m_grad, detach(x), detach(w), stats, true));
+        }
+
+        if (w->is_grad_enabled() || b->is_grad_enabled()) {
+            OpPtr param_grad = norm_param_grad(m_grad, detach(x), stats, true);
+            const isize nfeature = w->get_data().get_view().back();
+
+            if (w->is_grad_enabled()) {
+                w->zero_grad();
+                w->iadd_grad(squeeze(slice(param_grad, {Range(0, 1), Range(0, nfeature)}), {0}));
+            }
+
+            if (b->is_grad_enabled()) {
+                b->zero_grad();
+                b->iadd_grad(squeeze(slice(param_grad, {Range(1, 2), Range(0, nfeature)}), {0}));
+            }
+        }
+    }
+
+    void RMSNormOp::grad_fn() const {
+        // y = xhat * w with xhat = x * rstd
+        // dx = rstd * (g - xhat * mean(g * xhat)) with g = dy * w
+        // dw += sum(dy * xhat) over rows
+        OpPtr x = m_operands[0];
+        OpPtr w = m_operands[1];
+        OpPtr stats = detach(get_stats());
+
+        if (x->is_grad_enabled()) {
+            x->zero_grad();
+            x->iadd_grad(norm_grad(m_grad, detach(x), detach(w), stats, false));
+        }
+
+        if (w->is_grad_enabled()) {
+            w->zero_grad();
+            OpPtr param_grad = norm_param_grad(m_grad, detach(x), stats, false);
+            w->iadd_grad(squeeze(slice(param_grad, {Range(0, 1), Range(0, w->get_data().get_view().back())}), {0}));
+        }
+    }
+
+    void BatchNormOp::grad_fn() const {
+        // y = xhat * w + b with xhat = (x - mean) * rstd per channel over m elements
+        // dw += sum(dy * xhat) and db += sum(dy) per channel
+        // training: dx = w * rstd * (dy - db / m - xhat * dw / m)
+        // inference: dx = w * rstd * dy since the statistics do not depend on x
+        OpPtr x = m_operands[0];
+        OpPtr w = m_operands[1];
+        OpPtr b = m_operands[2];
+        OpPtr stats = detach(get_stats());
+
+        if (!x->is_grad_enabled() && !w->is_grad_enabled() && !b->is_grad_enabled()) {
+            return;
+        }
+
+        OpPtr param_grad = batch_norm_param_grad(m_grad, detach(x), stats, m_params);
+        const isize nchannel = w->get_data().get_view().back();
+
+        if (x->is_grad_enabled()) {
+            x->zero_grad();
+            x->iadd_grad(batch_norm_grad(m_grad, detach(x), detach(w), stats, param_grad, m_params));
+        }
+
+        if (w->is_grad_enabled()) {
+            w->zero_grad();
+            w->iadd_grad(squeeze(slice(param_grad, {Range(0, 1), Range(0, nchannel)}), {0}));
+        }
+
+        if (b->is_grad_enabled()) {
+            b->zero_grad();
+            b->iadd_grad(squeeze(slice(param_grad, {Range(1, 2), Range(0, nchannel)}), {0}));
+        }
+    }
+
+    void ScaledDotProductAttentionOp::grad_fn() const {
+        // z = softmax(s) * v with s = scale * q * k^T and p = softmax(s) recomputed from the log-sum-exp
+        // dv += p^T * dz
+        // ds = p * (dz * v^T - rowsum(dz * z))
+        // dq += scale * ds * k
+        // dk += scale * ds^T * q
+        OpPtr q = m_operands[0];
+        OpPtr k = m_operands[1];
+        OpPtr v = m_operands[2];
+        OpPtr stats = detach(get_stats());
+        OpPtr out = detach_this();
+        auto target_grad = [&](AttentionGradTarget target) { return sdpa_grad(m_grad, detach(q), detach(k), detach(v), out, stats, m_scale, m_causal, target); };
+
+        if (q->is_grad_enabled()) {
+            q->zero_grad();
+            q->iadd_grad(target_grad(AttentionGradTarget::QUERY));
+        }
+
+        if (k->is_grad_enabled()) {
+            k->zero_grad();
+            k->iadd_grad(target_grad(AttentionGradTarget::KEY));
+        }
+
+        if (v->is_grad_enabled()) {
+            v->zero_grad();
+            v->iadd_grad(target_grad(AttentionGradTarget::VALUE));
+        }
+    }
+
+    void LSTMCellOp::grad_fn() const {
+        // a = gi + gh with i, f, o = sigmoid(a_i, a_f, a_o) and g = tanh(a_g)
+        // c' = f * c + i * g, h' = o * tanh(c')
+        // dc' = dc' + dh' * o * (1 - tanh(c')^2)
+        // da_i = dc' * g * i * (1 - i), da_f = dc' * c * f * (1 - f), da_g = dc' * i * (1 - g^2), da_o = dh' * tanh(c') * o * (1 - o)
+        // dgi += da, dgh += da, dc += dc' * f
+        OpPtr gi = m_operands[0];
+        OpPtr gh = m_operands[1];
+        OpPtr c = m_operands[2];
+        auto target_grad = [&](RecurrentGradTarget target) { return lstm_cell_grad(m_grad, detach(gi), detach(gh), detach(c), target); };
+
+        if (gi->is_grad_enabled() || gh->is_grad_enabled()) {
+            // Both projections are summed before the activations so they share the gate gradient
+            OpPtr gates_grad = target_grad(RecurrentGradTarget::INPUT_GATES);
+
+            if (gi->is_grad_enabled()) {
+                gi->zero_grad();
+                gi->iadd_grad(gates_grad);
+            }
+
+            if (gh->is_grad_enabled()) {
+                gh->zero_grad();
+                gh->iadd_grad(gates_grad);
+            }
+        }
+
+        if (c->is_grad_enabled()) {
+            c->zero_grad();
+            c->iadd_grad(target_grad(RecurrentGradTarget::STATE));
+        }
+    }
+
+    void GRUCellOp::grad_fn() const {
+        // r, z = sigmoid(gi_r + gh_r, gi_z + gh_z), n = tanh(gi_n + r * gh_n)
+        // h' = (1 - z) * n + z * h
+        // dn = dh' * (1 - z) * (1 - n^2), dr = dn * gh_n * r * (1 - r), dz = dh' * (h - n) * z * (1 - z)
+        // dgi += (dr, dz, dn), dgh += (dr, dz, dn * r), dh += dh' * z
+        OpPtr gi = m_operands[0];
+        OpPtr gh = m_operands[1];
+        OpPtr h = m_operands[2];
+        auto target_grad = [&](RecurrentGradTarget target) { return gru_cell_grad(m_grad, detach(gi), detach(gh), detach(h), target); };
+
+        if (gi->is_grad_enabled()) {
+            gi->zero_grad();
+            gi->iadd_grad(target_grad(RecurrentGradTarget::INPUT_GATES));
+        }
+
+        if (gh->is_grad_enabled()) {
+            gh->zero_grad();
+            gh->iadd_grad(target_grad(RecurrentGradTarget::HIDDEN_GATES));
+        }
+
+        if (h->is_grad_enabled()) {
+            h->zero_grad();
+            h->iadd_grad(target_grad(RecurrentGradTarget::STATE));
+        }
+    }
+
+    // Array of a step of a (steps, batch, features) array
+    static OpPtr recurrent_step(OpPtr op, isize step, isize start, isize stop) {
+        const ShapeView &view = op->get_data().get_view();
+        return squeeze(slice(op, {Range(step, step + 1), Range(0, view[1]), Range(start, stop)}), {0});
+    }
+
+    void LSTMOp::grad_fn() const {
+        // Backpropagation through time with one fused cell gradient per step,
+        // the hidden projections are recomputed from the saved hidden states with w^T of shape (hidden, 4 * hidden)
+        // dgi_t = da_t, dh_{t-1} += da_t @ w, dc_{t-1} = dc_t * f_t
+        // dw^T += sum_t h_{t-1}^T @ da_t computed by one GEMM over all steps
+        OpPtr gi = detach(m_operands[0]);
+        OpPtr w = detach(m_operands[1]);
+        OpPtr h0 = detach(m_operands[2]);
+        OpPtr c0 = detach(m_operands[3]);
+        OpPtr out = detach_this();
+        const ShapeView &gi_view = gi->get_data().get_view();
+        const isize nstep = gi_view[0];
+        const isize nbatch = gi_view[1];
+        const isize nhidden = get_hidden_size();
+        std::vector<OpPtr> gates_grads(nstep);
+        OpPtr h_grad = nullptr;
+        OpPtr c_grad = nullptr;
+
+        for (isize t = nstep - 1; t >= 0; t--) {
+            OpPtr grad = recurrent_step(m_grad, t, 0, 2 * nhidden);
+
+            if (h_grad) {
+                grad = add(grad, concat({h_grad, c_grad}, 1));
+            }
+
+            OpPtr h_prev = t > 0 ? recurrent_step(out, t - 1, 0, nhidden) : h0;
+            OpPtr c_prev = t > 0 ? recurrent_step(out, t - 1, nhidden, 2 * nhidden) : c0;
+            OpPtr gi_step = recurrent_step(gi, t, 0, 4 * nhidden);
+            OpPtr gh_step = matmul(h_prev, w);
+            gates_grads[t] = lstm_cell_grad(grad, gi_step, gh_step, c_prev, RecurrentGradTarget::INPUT_GATES);
+            h_grad = matmul(gates_grads[t], transpose(w, 0, 1));
+            c_grad = lstm_cell_grad(grad, gi_step, gh_step, c_prev, RecurrentGradTarget::STATE);
+        }
+
+        OpPtr gi_grad = stack(gates_grads, 0);
+
+        if (m_operands[0]->is_grad_enabled()) {
+            m_operands[0]->zero_grad();
+            m_operands[0]->iadd_grad(gi_grad);
+        }
+
+        if (m_operands[1]->is_grad_enabled()) {
+            // The previous hidden states of all steps are the initial state followed by all but the last output
+            OpPtr h_prevs = unsqueeze(h0, {0});
+
+            if (nstep > 1) {
+                h_prevs = concat({h_prevs, slice(out, {Range(0, nstep - 1), Range(0, nbatch), Range(0, nhidden)})}, 0);
+            }
+
+            m_operands[1]->zero_grad();
+            m_operands[1]->iadd_grad(matmul(transpose(reshape(h_prevs, {nstep * nbatch, nhidden}), 0, 1), reshape(gi_grad, {nstep * nbatch, 4 * nhidden})));
+        }
+
+        if (m_operands[2]->is_grad_enabled()) {
+            m_operands[2]->zero_grad();
+            m_operands[2]->iadd_grad(h_grad);
+        }
+
+        if (m_operands[3]->is_grad_enabled()) {
+            m_operands[3]->zero_grad();
+            m_operands[3]->iadd_grad(c_grad);
+        }
+    }
+
+    void GRUOp::grad_fn() const {
+        // Backpropagation through time with one fused cell gradient per step,
+        // the hidden projections gh_t = h_{t-1} @ w^T + b are recomputed from the saved hidden states
+        // dgi_t = dgi'_t, dh_{t-1} = dh'_{t-1} + dgh_t @ w
+        // dw^T += sum_t h_{t-1}^T @ dgh_t computed by one GEMM over all steps, db += sum_t dgh_t
+        OpPtr gi = detach(m_operands[0]);
+        OpPtr w = detach(m_operands[1]);
+        OpPtr b = detach(m_operands[2]);
+        OpPtr h0 = detach(m_operands[3]);
+        OpPtr out = detach_this();
+        const ShapeView &gi_view = gi->get_data().get_view();
+        const isize nstep = gi_view[0];
+        const isize nbatch = gi_view[1];
+        const isize nhidden = get_hidden_size();
+        std::vector<OpPtr> gi_grads(nstep);
+        std::vector<OpPtr> gh_grads(nstep);
+        OpPtr h_grad = nullptr;
+
+        for (isize t = nstep - 1; t >= 0; t--) {
+            OpPtr grad = recurrent_step(m_grad, t, 0, nhidden);
+
+            if (h_grad) {
+                grad = add(grad, h_grad);
+            }
+
+            OpPtr h_prev = t > 0 ? recurrent_step(out, t - 1, 0, nhidden) : h0;
+            OpPtr gi_step = recurrent_step(gi, t, 0, 3 * nhidden);
+            OpPtr gh_step = add(matmul(h_prev, w), b);
+            gi_grads[t] = gru_cell_grad(grad, gi_step, gh_step, h_prev, RecurrentGradTarget::INPUT_GATES);
+            gh_grads[t] = gru_cell_grad(grad, gi_step, gh_step, h_prev, RecurrentGradTarget::HIDDEN_GATES);
+            h_grad = add(gru_cell_grad(grad, gi_step, gh_step, h_prev, RecurrentGradTarget::STATE), matmul(gh_grads[t], transpose(w, 0, 1)));
+        }
+
+        if (m_operands[0]->is_grad_enabled()) {
+            m_operands[0]->zero_grad();
+            m_operands[0]->iadd_grad(stack(gi_grads, 0));
+        }
+
+        if (m_operands[1]->is_grad_enabled() || m_operands[2]->is_grad_enabled()) {
+            OpPtr gh_grad = reshape(stack(gh_grads, 0), {nstep * nbatch, 3 * nhidden});
+
+            if (m_operands[1]->is_grad_enabled()) {
+                // The previous hidden states of all steps are the initial state followed by all but the last output
+                OpPtr h_prevs = unsqueeze(h0, {0});
+
+                if (nstep > 1) {
+                    h_prevs = concat({h_prevs, slice(out, {Range(0, nstep - 1), Range(0, nbatch), Range(0, nhidden)})}, 0);
+                }
+
+                m_operands[1]->zero_grad();
+                m_operands[1]->iadd_grad(matmul(transpose(reshape(h_prevs, {nstep * nbatch, nhidden}), 0, 1), gh_grad));
+            }
+
+            if (m_operands[2]->is_grad_enabled()) {
+                m_operands[2]->zero_grad();
+                m_operands[2]->iadd_grad(reshape(sum(gh_grad, {0}), {3 * nhidden}));
+            }
+        }
+
+        if (m_operands[3]->is_grad_enabled()) {
+            m_operands[3]->zero_grad();
+            m_operands[3]->iadd_grad(h_grad);
+        }
+    }
+
+    void SpmmOp::grad_fn() const {
+        // y = A @ d gives dd += A^T @ dy, and y = A^T @ d gives dd += A @ dy
+        // The nonzero values receive no gradient
+        OpPtr dense = m_operands[3];
+
+        if (dense->is_grad_enabled()) {
+            dense->zero_grad();
+            dense->iadd_grad(spmm(detach(m_operands[0]), detach(m_operands[1]), detach(m_operands[2]), m_grad, m_format, m_nrow, m_ncol, !m_transposed));
+        }
+    }
+
+    void SparseMulOp::grad_fn() const {
+        // y_i = v_i * d[r_i, c_i]
+        // dv_i += dy_i * d[r_i, c_i]
+        // dd[r_i, c_i] += dy_i * v_i
+        OpPtr rows = detach(m_operands[0]);
+        OpPtr cols = detach(m_operands[1]);
+        OpPtr values = m_operands[2];
+        OpPtr dense = m_operands[3];
+
+        if (values->is_grad_enabled()) {
+            values->zero_grad();
+            values->iadd_grad(sparse_mul(rows, cols, m_grad, detach(dense), m_format, m_nrow, m_ncol));
+        }
+
+        if (dense->is_grad_enabled()) {
+            dense->zero_grad();
+            dense->iadd_grad(sparse_to_dense(rows, cols, mul(m_grad, detach(values)), m_format, m_nrow, m_ncol));
+        }
+    }
+
+    void SparseToDenseOp::grad_fn() const {
+        // dv_i += dy[r_i, c_i]
+        OpPtr values = m_operands[2];
+
+        if (values->is_grad_enabled()) {
+            values->zero_grad();
+            values->iadd_grad(sparse_mul(detach(m_operands[0]), detach(m_operands[1]), ones_like(values), m_grad, m_format, m_nrow, m_ncol));
+        }
+    }
+
+    void WhereOp::grad_fn() const {
+        // z = where(c, x, y)
+        // dx += where(c, dz, 0)
+        // dy += where(c, 0, dz)
+        // The condition is boolean so it never receives a gradient
+        OpPtr d_cond = detach(m_first);
+
+        if (m_second->is_grad_enabled()) {
+            m_second->zero_grad();
+            m_second->iadd_grad(where(d_cond, m_grad, 0.0f));
+        }
+
+        if (m_third->is_grad_enabled()) {
+            m_third->zero_grad();
+            m_third->iadd_grad(where(d_cond, 0.0f, m_grad));
+        }
+    }
+
+    void WhereBitsOp::grad_fn() const {
+        // z = where(c, x, y) with c bit-packed
+        // dx += where(c, dz, 0)
+        // dy += where(c, 0, dz)
+        OpPtr d_mask = detach(m_operands[0]);
+        const ShapeView &view = m_data.get_view();
+
+        if (m_operands[1]->is_grad_enabled()) {
+            m_operands[1]->zero_grad();
+            m_operands[1]->iadd_grad(where_bits(d_mask, view, m_grad, 0.0f));
+        }
+
+        if (m_operands[2]->is_grad_enabled()) {
+            m_operands[2]->zero_grad();
+            m_operands[2]->iadd_grad(where_bits(d_mask, view, 0.0f, m_grad));
+        }
+    }
+
+    void ConcatOp::grad_fn() const {
+        // z = concat(x_0, ..., x_n)
+        // dx_i += dz[ranges_i]
+        for (size_t i = 0; i < m_operands.size(); i++) {
+            const OpPtr &operand = m_operands[i];
+
+            if (operand->is_grad_enabled()) {
+                operand->zero_grad();
+                operand->iadd_grad(slice(m_grad, m_ranges[i]));
+            }
+        }
+    }
+
     void SqOp::grad_fn() const {
         // z = x**2
         // dx += dz * (2*x)
@@ -181,6 +744,15 @@ namespace nx::primitive {
         }
     }
 
+    void AstypeOp::grad_fn() const {
+        // z = cast(x)
+        // dx += cast(dz), casts from or to integers and booleans have no gradient
+        if (m_operand->is_grad_enabled() && m_operand->get_data().get_dtype()->is_float() && m_dtype->is_float()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(astype(m_grad, m_operand->get_data().get_dtype()));
+        }
+    }
+
     void ExpOp::grad_fn() const {
         // z = exp(x)
         // dx += dz * exp(x)
@@ -229,6 +801,95 @@ namespace nx::primitive {
         }
     }
 
+    void ReluOp::grad_fn() const {
+        // z = relu(x)
+        // dx += dz if z > 0 else 0
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(relu_grad(m_grad, detach_this()));
+        }
+    }
+
+    void SigmoidOp::grad_fn() const {
+        // z = sigmoid(x)
+        // dx += dz * z * (1-z)
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(sigmoid_grad(m_grad, detach_this()));
+        }
+    }
+
+    void TanhOp::grad_fn() const {
+        // z = tanh(x)
+        // dx += dz * (1-z^2)
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(tanh_grad(m_grad, detach_this()));
+        }
+    }
+
+    void GeluOp::grad_fn() const {
+        // z = x * Phi(x)
+        // dx += dz * (Phi(x) + x * phi(x))
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(gelu_grad(m_grad, detach(m_operand)));
+        }
+    }
+
+    void GeluTanhOp::grad_fn() const {
+        // z = 0.5 * x * (1 + tanh(u)), u = k * (x + 0.044715 * x^3)
+        // dx += dz * (0.5 * (1 + tanh(u)) + 0.5 * x * (1 - tanh(u)^2) * du/dx)
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(gelu_grad(m_grad, detach(m_operand), true));
+        }
+    }
+
+    void SiluOp::grad_fn() const {
+        // z = x * sigmoid(x)
+        // dx += dz * sigmoid(x) * (1 + x * (1-sigmoid(x)))
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(silu_grad(m_grad, detach(m_operand)));
+        }
+    }
+
+    void SoftplusOp::grad_fn() const {
+        // z = log(1 + exp(x))
+        // dx += dz * sigmoid(x)
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(softplus_grad(m_grad, detach(m_operand)));
+        }
+    }
+
+    void AbsOp::grad_fn() const {
+        // z = |x|
+        // dx += dz * sign(x)
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(abs_grad(m_grad, detach(m_operand)));
+        }
+    }
+
+    void SignOp::grad_fn() const {
+        // z = sign(x)
+        // dx += 0
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+        }
+    }
+
+    void ClampOp::grad_fn() const {
+        // z = clamp(x, min, max)
+        // dx += dz if min <= x <= max else 0
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(clamp_grad(m_grad, detach(m_operand), static_cast<float>(m_min), static_cast<float>(m_max)));
+        }
+    }
+
     void SliceOp::grad_fn() const {
         if (m_operand->is_grad_enabled()) {
             m_operand->zero_grad();
@@ -276,7 +937,91 @@ namespace nx::primitive {
     void SumOp::grad_fn() const {
         if (m_operand->is_grad_enabled()) {
             m_operand->zero_grad();
-            m_operand->iadd_grad(expand(m_grad, m_operand->get_data().get_view(), m_remaining_dims, m_reduce_dims));
+            // The sum of 16-bit floats is accumulated in f32
+            m_operand->iadd_grad(astype(expand(m_grad, m_operand->get_data().get_view(), m_remaining_dims, m_reduce_dims), m_operand->get_data().get_dtype()));
+        }
+    }
+
+    void CumsumOp::grad_fn() const {
+        // z_j = sum_{i<=j} x_i
+        // dx_i += sum_{j>=i} dz_j
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            m_operand->iadd_grad(flip(cumsum(flip(m_grad, m_dim), m_dim), m_dim));
+        }
+    }
+
+    void CumprodOp::grad_fn() const {
+        // z_j = prod_{i<=j} x_i
+        // dx_i += sum_{j>=i} dz_j * z_j / x_i
+        // Note: zeros in x are not handled specially
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            OpPtr rev_grad = flip(cumsum(flip(mul(m_grad, detach_this()), m_dim), m_dim), m_dim);
+            m_operand->iadd_grad(div(rev_grad, detach(m_operand)));
+        }
+    }
+
+    void CummaxOp::grad_fn() const {
+        // z_j = max_{i<=j} x_i
+        // dz_j flows to the last i <= j where x_i == z_i, i.e. the record that z_j comes from
+        // Each record i owns the run of positions up to the next record next_i (or n)
+        // dx_i += x_i == z_i ? sum_{j=i}^{next_i-1} dz_j : 0
+        if (!m_operand->is_grad_enabled()) {
+            return;
+        }
+
+        m_operand->zero_grad();
+        const ShapeView &view = m_data.get_view();
+        isize len = view[m_dim];
+
+        if (len == 1) {
+            m_operand->iadd_grad(m_grad);
+            return;
+        }
+
+        DevicePtr device = m_data.get_device();
+        OpPtr is_record = eq(detach(m_operand), detach_this());
+        ShapeView pos_view(view.size(), 1);
+        pos_view[m_dim] = len;
+        OpPtr pos = broadcast_to(arange(pos_view, 0, 1, &i32, device), view);
+        OpPtr record_pos = where(is_record, pos, len);
+
+        // Shift by one so every position sees the records strictly after it
+        // The nearest one is the suffix minimum, computed as a reversed cummax of negated positions
+        RangeVector tail_ranges;
+        ShapeView end_view = view;
+        end_view[m_dim] = 1;
+
+        for (isize i = 0; i < m_data.get_ndim(); i++) {
+            tail_ranges.emplace_back(i == m_dim ? 1 : 0, view[i], 1);
+        }
+
+        OpPtr next_record_pos = concat({slice(record_pos, tail_ranges), full(end_view, len, &i32, device)}, m_dim);
+        next_record_pos = neg(flip(cummax(flip(neg(next_record_pos), m_dim), m_dim), m_dim));
+
+        // sum_{j=i}^{next_i-1} dz_j = csum[next_i-1] - csum[i] + dz_i
+        OpPtr csum = cumsum(m_grad, m_dim);
+        OpPtr run_sum = add(sub(gather(csum, sub(next_record_pos, 1), m_dim), csum), m_grad);
+        m_operand->iadd_grad(where(is_record, run_sum, 0.0f));
+    }
+
+    void SortOp::grad_fn() const {
+        // z_r = x_{p_r} where p is the sorting permutation
+        // dx_i += dz_{rank_i}, rank being the inverse permutation of p
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            OpPtr rank = argsort(argsort(detach(m_operand), m_dim, m_descending), m_dim);
+            m_operand->iadd_grad(gather(m_grad, rank, m_dim));
+        }
+    }
+
+    void TopkOp::grad_fn() const {
+        // z_r = x_{p_r} for r < k
+        // dx_{p_r} += dz_r, the other elements get no gradient
+        if (m_lhs->is_grad_enabled()) {
+            m_lhs->zero_grad();
+            m_lhs->iadd_grad(scatter(m_grad, m_rhs, get_dim(), m_lhs->get_data().get_view()));
         }
     }
 
@@ -284,8 +1029,9 @@ namespace nx::primitive {
         if (m_operand->is_grad_enabled()) {
             m_operand->zero_grad();
             const ShapeView &operand_view = m_operand->get_data().get_view();
-            OpPtr mask = eq(detach(m_operand), expand(detach_this(), operand_view, m_remaining_dims, m_reduce_dims));
-            m_operand->iadd_grad(mul(astype(mask, m_operand->get_data().get_dtype()), expand(m_grad, operand_view, m_remaining_dims, m_reduce_dims)));
+            DtypePtr operand_dtype = m_operand->get_data().get_dtype();
+            OpPtr mask = eq(detach(m_operand), astype(expand(detach_this(), operand_view, m_remaining_dims, m_reduce_dims), operand_dtype));
+            m_operand->iadd_grad(where(mask, astype(expand(m_grad, operand_view, m_remaining_dims, m_reduce_dims), operand_dtype), 0.0f));
         }
     }
 
@@ -293,8 +1039,64 @@ namespace nx::primitive {
         if (m_operand->is_grad_enabled()) {
             m_operand->zero_grad();
             const ShapeView &operand_view = m_operand->get_data().get_view();
-            OpPtr mask = eq(detach(m_operand), expand(detach_this(), operand_view, m_remaining_dims, m_reduce_dims));
-            m_operand->iadd_grad(mul(astype(mask, m_operand->get_data().get_dtype()), expand(m_grad, operand_view, m_remaining_dims, m_reduce_dims)));
+            DtypePtr operand_dtype = m_operand->get_data().get_dtype();
+            OpPtr mask = eq(detach(m_operand), astype(expand(detach_this(), operand_view, m_remaining_dims, m_reduce_dims), operand_dtype));
+            m_operand->iadd_grad(where(mask, astype(expand(m_grad, operand_view, m_remaining_dims, m_reduce_dims), operand_dtype), 0.0f));
+        }
+    }
+
+    void VarOp::grad_fn() const {
+        // z = sum_i (x_i - m)^2 / (n - c)
+        // dx_i += 2 * (x_i - m) / (n - c) * dz
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            const ShapeView &operand_view = m_operand->get_data().get_view();
+            const isize numel = std::accumulate(m_reduce_dims.begin(), m_reduce_dims.end(), 1ll, [&](isize acc, isize dim) { return acc * operand_view[dim]; });
+            OpPtr x = astype(detach(m_operand), &f32);
+            OpPtr centered = sub(x, expand(mean(x, m_reduce_dims), operand_view, m_remaining_dims, m_reduce_dims));
+            OpPtr grad = mul(centered, expand(m_grad, operand_view, m_remaining_dims, m_reduce_dims));
+            m_operand->iadd_grad(astype(mul(grad, 2.0f / (numel - m_correction)), m_operand->get_data().get_dtype()));
+        }
+    }
+
+    void StdOp::grad_fn() const {
+        // z = sqrt(sum_i (x_i - m)^2 / (n - c))
+        // dx_i += (x_i - m) / ((n - c) * z) * dz
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            const ShapeView &operand_view = m_operand->get_data().get_view();
+            const isize numel = std::accumulate(m_reduce_dims.begin(), m_reduce_dims.end(), 1ll, [&](isize acc, isize dim) { return acc * operand_view[dim]; });
+            OpPtr x = astype(detach(m_operand), &f32);
+            OpPtr centered = sub(x, expand(mean(x, m_reduce_dims), operand_view, m_remaining_dims, m_reduce_dims));
+            OpPtr scale = expand(div(m_grad, mul(detach_this(), numel - m_correction)), operand_view, m_remaining_dims, m_reduce_dims);
+            m_operand->iadd_grad(astype(mul(centered, scale), m_operand->get_data().get_dtype()));
+        }
+    }
+
+    void VectorNormOp::grad_fn() const {
+        // L1: dx_i += sign(x_i) * dz
+        // L2: dx_i += x_i / z * dz
+        // Linf: dx_i += sign(x_i) * dz where |x_i| = z
+        if (m_operand->is_grad_enabled()) {
+            m_operand->zero_grad();
+            const ShapeView &operand_view = m_operand->get_data().get_view();
+            OpPtr x = astype(detach(m_operand), &f32);
+            OpPtr grad = expand(m_grad, operand_view, m_remaining_dims, m_reduce_dims);
+
+            switch (m_ord) {
+            case NormOrd::L1:
+                grad = mul(sign(x), grad);
+                break;
+            case NormOrd::L2:
+                // x is zero wherever the norm is zero
+                grad = mul(div(x, expand(maximum(detach_this(), std::numeric_limits<float>::min()), operand_view, m_remaining_dims, m_reduce_dims)), grad);
+                break;
+            case NormOrd::LINF:
+                grad = where(eq(abs(x), expand(detach_this(), operand_view, m_remaining_dims, m_reduce_dims)), mul(sign(x), grad), 0.0f);
+                break;
+            }
+
+            m_operand->iadd_grad(astype(grad, m_operand->get_data().get_dtype()));
         }
     }
-} // namespace nx::primitive
\ No newline at end of file
+} // namespace nx::primitive
@@ -22,7 +22,19 @@ namespace nx::primitive {
         LEQ,
         MINIMUM,
         MAXIMUM,
+        RELU_GRAD,
+        SIGMOID_GRAD,
+        TANH_GRAD,
+        GELU_GRAD,
+        GELU_TANH_GRAD,
+        SILU_GRAD,
+        SOFTPLUS_GRAD,
+        POW,
+        FMOD,
+        ABS_GRAD,
+        CLAMP_GRAD,
         MATMUL,
+        WHERE,
         SQ,
         SQRT,
         NEG,
@@ -32,6 +44,16 @@ namespace nx::primitive {
         RECIP,
         SIN,
         COS,
+        RELU,
+        SIGMOID,
+        TANH,
+        GELU,
+        GELU_TANH,
+        SILU,
+        SOFTPLUS,
+        ABS,
+        SIGN,
+        CLAMP,
         RESHAPE,
         PERMUTE,
         BROADCAST,
@@ -39,11 +61,63 @@ namespace nx::primitive {
         UNSQUEEZE,
         SLICE,
         SUM,
+        PRECISE_SUM,
+        VAR,
+        STD,
+        VECTOR_NORM,
         MAX,
         MIN,
         ARGMAX,
         ARGMIN,
         ASTYPE,
+        CONCAT,
+        CUMSUM,
+        CUMPROD,
+        CUMMAX,
+        GATHER,
+        SCATTER,
+        SORT,
+        ARGSORT,
+        TOPK,
+        ARGTOPK,
+        CONV2D,
+        IM2COL,
+        COL2IM,
+        MAXPOOL2D,
+        AVGPOOL2D,
+        MAXPOOL2D_GRAD,
+        AVGPOOL2D_GRAD,
+        LAYERNORM,
+        RMSNORM,
+        NORM_GRAD,
+        NORM_PARAM_GRAD,
+        BATCHNORM,
+        BATCHNORM_GRAD,
+        BATCHNORM_PARAM_GRAD,
+        SDPA,
+        SDPA_GRAD,
+        DROPOUT,
+        MULTINOMIAL,
+        BINCOUNT,
+        HISTOGRAM,
+        LSTM_CELL,
+        LSTM_CELL_GRAD,
+        GRU_CELL,
+        GRU_CELL_GRAD,
+        LSTM,
+        GRU,
+        QUANTIZE,
+        QUANTIZE_SCALE,
+        QUANTIZED_MATMUL,
+        SPMM,
+        SPARSE_MUL,
+        SPARSE_TO_DENSE,
+        BLOCK_SPARSE_MATMUL,
+        CMP_BITS,
+        WHERE_BITS,
+        COUNT_BITS,
+        RFFT,
+        IRFFT,
         // Used to get the number of enums
         COUNT
     };
@@ -52,14 +126,117 @@ namespace nx::primitive {
         INITIALIZER,
         UNARY,
         BINARY,
+        TERNARY,
+        NARY,
         TRANSFORM,
+        SCAN,
+        SORT,
         REDUCE
     };
 
     enum struct BinaryMode {
         ELMWISE,
         CMP,
-        MATMUL
+        MATMUL,
+        GATHER,
+        SCATTER,
+        CONV,
+        POOL
+    };
+
+    enum struct ConvLayout {
+        NCHW,
+        NHWC
+    };
+
+    enum struct AttentionGradTarget {
+        QUERY,
+        KEY,
+        VALUE
+    };
+
+    // The hidden gates only differ from the input gates for a GRU, the state is the previous cell state of an LSTM
+    // and the previous hidden state of a GRU
+    enum struct RecurrentGradTarget {
+        INPUT_GATES,
+        HIDDEN_GATES,
+        STATE
+    };
+
+    // Comparison written into a bit-packed mask
+    enum struct BitCmp {
+        EQ,
+        NEQ,
+        LT,
+        GT,
+        LEQ,
+        GEQ
+    };
+
+    // Order of a vector norm, infinity takes the largest magnitude
+    enum struct NormOrd {
+        L1,
+        L2,
+        LINF
+    };
+
+    // Compressed rows keep row offsets of size (rows + 1), coordinates keep one row index per nonzero in any order
+    enum struct SparseFormat {
+        CSR,
+        COO
+    };
+
+    // Activation fused into the dequantization epilogue of a quantized matmul
+    enum struct QuantizedActivation {
+        NONE,
+        RELU,
+        GELU,
+        SILU
+    };
+
+    struct Conv2dParams {
+        isize kernel_h = 1;
+        isize kernel_w = 1;
+        isize stride_h = 1;
+        isize stride_w = 1;
+        isize padding_h = 0;
+        isize padding_w = 0;
+        isize dilation_h = 1;
+        isize dilation_w = 1;
+        ConvLayout layout = ConvLayout::NCHW;
+
+        bool channels_last() const { return layout == ConvLayout::NHWC; }
+        // Output size along one spatial dimension, zero when the dilated kernel does not fit in the padded input
+        static isize out_size(isize in_size, isize kernel_size, isize stride, isize padding, isize dilation) {
+            isize span = in_size + 2 * padding - dilation * (kernel_size - 1) - 1;
+            return span < 0 ? 0 : span / stride + 1;
+        }
+
+        const std::string str() const { return std::format("kernel: {}x{}, stride: {}x{}, padding: {}x{}, dilation: {}x{}, layout: {}", kernel_h, kernel_w, stride_h, stride_w, padding_h, padding_w, dilation_h, dilation_w, channels_last() ? "NHWC" : "NCHW"); }
+    };
+
+    struct Pool2dParams {
+        isize kernel_h = 1;
+        isize kernel_w = 1;
+        isize stride_h = 1;
+        isize stride_w = 1;
+        isize padding_h = 0;
+        isize padding_w = 0;
+        // Adaptive pooling splits the input evenly into out_h x out_w windows, kernel, stride and padding are unused
+        bool adaptive = false;
+        isize out_h = 0;
+        isize out_w = 0;
+        ConvLayout layout = ConvLayout::NCHW;
+
+        bool channels_last() const { return layout == ConvLayout::NHWC; }
+
+        const std::string str() const {
+            if (adaptive) {
+                return std::format("adaptive: {}x{}, layout: {}", out_h, out_w, channels_last() ? "NHWC" : "NCHW");
+            }
+
+            return std::format("kernel: {}x{}, stride: {}x{}, padding: {}x{}, layout: {}", kernel_h, kernel_w, stride_h, stride_w, padding_h, padding_w, channels_last() ? "NHWC" : "NCHW");
+        }
     };
 
     struct Op : public std::enable_shared_from_this<Op> {
@@ -110,6 +287,8 @@ namespace nx::primitive {
         void isub_grad(OpPtr grad);
         void slice_grad(OpPtr grad, const RangeVector &ranges);
         virtual void grad_fn() const {}
+        // Whether the kernel addresses its output through strides, so the output can be placed inside a slice of another buffer
+        virtual bool supports_strided_output() const { return false; }
         virtual const std::string str() const { return std::format("{}: {}, view: ({}), dtype: {}", m_data.get_id(), get_opname(), join_nums(m_data.get_view()), m_data.get_dtype()->str()); }
         virtual const std::string dump() const { return std::format("{}: {}\\nView: ({})\\nDtype: {}", m_data.get_id(), get_opname(), join_nums(m_data.get_view()), m_data.get_dtype()->str()); }
         friend std::ostream &operator<<(std::ostream &os, OpPtr op) { return os << op->str(); }
@@ -205,6 +384,12 @@ namespace nx::primitive {
 
     using UnaryOpPtr = std::shared_ptr<UnaryOp>;
 
+    struct ElmwiseUnaryOp : public UnaryOp {
+    public:
+        ElmwiseUnaryOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
+        bool supports_strided_output() const override { return !m_in_place; }
+    };
+
     struct BinaryOp : public Op {
     protected:
         OpPtr m_lhs;
@@ -231,6 +416,7 @@ namespace nx::primitive {
     public:
         ElmwiseBinaryOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : BinaryOp(data, lhs, rhs, BinaryMode::ELMWISE), m_in_place(in_place) {}
         bool is_in_place() const { return m_in_place; }
+        bool supports_strided_output() const override { return !m_in_place; }
         const std::string str() const override { return std::format("{}, in-place: {}", BinaryOp::str(), m_in_place); }
         const std::string dump() const override { return std::format("{}\\nIn-place: {}", BinaryOp::dump(), m_in_place); }
     };
@@ -238,8 +424,49 @@ namespace nx::primitive {
     struct CmpOp : public BinaryOp {
     public:
         CmpOp(const ArrayData &data, OpPtr lhs, OpPtr rhs) : BinaryOp(data, lhs, rhs, BinaryMode::CMP) {}
+        bool supports_strided_output() const override { return true; }
     };
 
+    struct TernaryOp : public Op {
+    protected:
+        OpPtr m_first;
+        OpPtr m_second;
+        OpPtr m_third;
+
+    public:
+        TernaryOp(const ArrayData &data, OpPtr first, OpPtr second, OpPtr third) : Op(data), m_first(first), m_second(second), m_third(third) {}
+        Optype get_optype() const override { return Optype::TERNARY; }
+        const std::string optype_str() const override { return "ternary"; }
+        OpPtr get_first() { return m_first; }
+        OpPtr get_second() { return m_second; }
+        OpPtr get_third() { return m_third; }
+        const std::string str() const override { return std::format("{}, first: {}, second: {}, third: {}", Op::str(), m_first->get_data().get_id(), m_second->get_data().get_id(), m_third->get_data().get_id()); }
+        const std::string dump() const override { return std::format("{}\\nFirst: {}\\nSecond: {}\\nThird: {}", Op::dump(), m_first->get_data().get_id(), m_second->get_data().get_id(), m_third->get_data().get_id()); }
+    };
+
+    using TernaryOpPtr = std::shared_ptr<TernaryOp>;
+
+    struct NaryOp : public Op {
+    protected:
+        std::vector<OpPtr> m_operands;
+
+    public:
+        NaryOp(const ArrayData &data, const std::vector<OpPtr> &operands) : Op(data), m_operands(operands) {}
+        Optype get_optype() const override { return Optype::NARY; }
+        const std::string optype_str() const override { return "nary"; }
+        const std::vector<OpPtr> &get_operands() const { return m_operands; }
+
+        const std::string str() const override {
+            return std::format("{}, operands: ({})", Op::str(), join<OpPtr>(m_operands, [](OpPtr operand) { return operand->get_data().get_id().str(); }));
+        }
+
+        const std::string dump() const override {
+            return std::format("{}\\nOperands: ({})", Op::dump(), join<OpPtr>(m_operands, [](OpPtr operand) { return operand->get_data().get_id().str(); }));
+        }
+    };
+
+    using NaryOpPtr = std::shared_ptr<NaryOp>;
+
     struct TransformOp : public Op {
     protected:
         OpPtr m_operand;
@@ -255,6 +482,48 @@ namespace nx::primitive {
 
     using TransformOpPtr = std::shared_ptr<TransformOp>;
 
+    struct ScanOp : public Op {
+    protected:
+        OpPtr m_operand;
+        isize m_dim;
+
+    public:
+        ScanOp(const ArrayData &data, OpPtr operand, isize dim) : Op(data), m_operand(operand), m_dim(dim) {}
+        Optype get_optype() const override { return Optype::SCAN; }
+        bool supports_strided_output() const override { return true; }
+        const std::string optype_str() const override { return "scan"; }
+        OpPtr get_operand() { return m_operand; }
+        isize get_dim() const { return m_dim; }
+        const std::string str() const override { return std::format("{}, operand: {}, dim: {}", Op::str(), m_operand->get_data().get_id(), m_dim); }
+        const std::string dump() const override { return std::format("{}\\nOperand: {}\\nDim: {}", Op::dump(), m_operand->get_data().get_id(), m_dim); }
+    };
+
+    using ScanOpPtr = std::shared_ptr<ScanOp>;
+
+    struct SortingOp : public Op {
+    protected:
+        OpPtr m_operand;
+        isize m_dim;
+        // Number of leading elements kept along dim after sorting
+        isize m_k;
+        bool m_descending;
+
+    public:
+        SortingOp(const ArrayData &data, OpPtr operand, isize dim, isize k, bool descending) : Op(data), m_operand(operand), m_dim(dim), m_k(k), m_descending(descending) {}
+        Optype get_optype() const override { return Optype::SORT; }
+        // Sorted rows are copied out of the scratch buffers with the strided copy kernel
+        bool supports_strided_output() const override { return true; }
+        const std::string optype_str() const override { return "sort"; }
+        OpPtr get_operand() { return m_operand; }
+        isize get_dim() const { return m_dim; }
+        isize get_k() const { return m_k; }
+        bool is_descending() const { return m_descending; }
+        const std::string str() const override { return std::format("{}, operand: {}, dim: {}, k: {}, descending: {}", Op::str(), m_operand->get_data().get_id(), m_dim, m_k, m_descending); }
+        const std::string dump() const override { return std::format("{}\\nOperand: {}\\nDim: {}\\nK: {}\\nDescending: {}", Op::dump(), m_operand->get_data().get_id(), m_dim, m_k, m_descending); }
+    };
+
+    using SortingOpPtr = std::shared_ptr<SortingOp>;
+
     struct ReduceOp : public Op {
     protected:
         OpPtr m_operand;
@@ -376,6 +645,107 @@ namespace nx::primitive {
         void grad_fn() const override;
     };
 
+    // Activation gradients take the output gradient as lhs and the saved output or input as rhs
+    struct ReluGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "relu_grad";
+        ReluGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::RELU_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct SigmoidGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "sigmoid_grad";
+        SigmoidGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SIGMOID_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct TanhGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "tanh_grad";
+        TanhGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::TANH_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct GeluGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "gelu_grad";
+        GeluGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::GELU_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct GeluTanhGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "gelu_tanh_grad";
+        GeluTanhGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::GELU_TANH_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct SiluGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "silu_grad";
+        SiluGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SILU_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct SoftplusGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "softplus_grad";
+        SoftplusGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SOFTPLUS_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct PowOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "pow";
+        PowOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::POW; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct FmodOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "fmod";
+        FmodOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::FMOD; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct AbsGradOp : public ElmwiseBinaryOp {
+    public:
+        inline static const std::string s_opname = "abs_grad";
+        AbsGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, bool in_place) : ElmwiseBinaryOp(data, lhs, rhs, in_place) {}
+        Opcode get_opcode() const override { return Opcode::ABS_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    // Passes the gradient through where the input lies within the bounds
+    struct ClampGradOp : public ElmwiseBinaryOp {
+    private:
+        float m_min;
+        float m_max;
+
+    public:
+        inline static const std::string s_opname = "clamp_grad";
+        ClampGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, float min, float max) : ElmwiseBinaryOp(data, lhs, rhs, false), m_min(min), m_max(max) {}
+        float get_min() const { return m_min; }
+        float get_max() const { return m_max; }
+        Opcode get_opcode() const override { return Opcode::CLAMP_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, min: {}, max: {}", ElmwiseBinaryOp::str(), m_min, m_max); }
+    };
+
+    using ClampGradOpPtr = std::shared_ptr<ClampGradOp>;
+
     struct MatmulOp : public BinaryOp {
     public:
         inline static const std::string s_opname = "matmul";
@@ -387,205 +757,1152 @@ namespace nx::primitive {
 
     using MatmulOpPtr = std::shared_ptr<MatmulOp>;
 
-    struct SqOp : public UnaryOp {
+    struct Conv2dOp : public BinaryOp {
+    private:
+        Conv2dParams m_params;
+
     public:
-        inline static const std::string s_opname = "sq";
-        SqOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::SQ; }
+        inline static const std::string s_opname = "conv2d";
+        // The lhs is the image and the rhs is the weight flattened to (out channels, in channels * kernel height * kernel width)
+        Conv2dOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, const Conv2dParams &params) : BinaryOp(data, lhs, rhs, BinaryMode::CONV), m_params(params) {}
+        const Conv2dParams &get_params() const { return m_params; }
+        Opcode get_opcode() const override { return Opcode::CONV2D; }
         const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, {}", BinaryOp::str(), m_params.str()); }
+        const std::string dump() const override { return std::format("{}\\n{}", BinaryOp::dump(), m_params.str()); }
         void grad_fn() const override;
     };
 
-    struct SqrtOp : public UnaryOp {
+    struct MaxPool2dGradOp : public BinaryOp {
+    private:
+        Pool2dParams m_params;
+
     public:
-        inline static const std::string s_opname = "sqrt";
-        SqrtOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::SQRT; }
+        inline static const std::string s_opname = "maxpool2d_grad";
+        // The lhs is the pooled image and the rhs is the output gradient, the argmax of every window is recomputed
+        // so no index array is kept from the forward pass
+        MaxPool2dGradOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, const Pool2dParams &params) : BinaryOp(data, lhs, rhs, BinaryMode::POOL), m_params(params) {}
+        const Pool2dParams &get_params() const { return m_params; }
+        Opcode get_opcode() const override { return Opcode::MAXPOOL2D_GRAD; }
         const std::string &get_opname() const override { return s_opname; }
-        void grad_fn() const override;
+        const std::string str() const override { return std::format("{}, {}", BinaryOp::str(), m_params.str()); }
+        const std::string dump() const override { return std::format("{}\\n{}", BinaryOp::dump(), m_params.str()); }
     };
 
-    struct NegOp : public UnaryOp {
+    struct GatherOp : public BinaryOp {
+    private:
+        isize m_dim;
+
     public:
-        inline static const std::string s_opname = "neg";
-        NegOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::NEG; }
+        inline static const std::string s_opname = "gather";
+        // Picks lhs elements along dim at the positions given by rhs, the output has the view of rhs
+        GatherOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, isize dim) : BinaryOp(data, lhs, rhs, BinaryMode::GATHER), m_dim(dim) {}
+        isize get_dim() const { return m_dim; }
+        Opcode get_opcode() const override { return Opcode::GATHER; }
+        bool supports_strided_output() const override { return true; }
         const std::string &get_opname() const override { return s_opname; }
-        void grad_fn() const override;
+        const std::string str() const override { return std::format("{}, dim: {}", BinaryOp::str(), m_dim); }
+        const std::string dump() const override { return std::format("{}\\nDim: {}", BinaryOp::dump(), m_dim); }
     };
 
-    struct CopyOp : public UnaryOp {
+    struct ScatterOp : public BinaryOp {
+    private:
+        isize m_dim;
+
     public:
-        inline static const std::string s_opname = "copy";
-        CopyOp(const ArrayData &data, OpPtr operand) : UnaryOp(data, operand, false) {}
-        Opcode get_opcode() const override { return Opcode::COPY; }
+        inline static const std::string s_opname = "scatter";
+        // Writes lhs elements along dim to the positions given by rhs in a zero-filled output, the positions along dim must be distinct
+        ScatterOp(const ArrayData &data, OpPtr lhs, OpPtr rhs, isize dim) : BinaryOp(data, lhs, rhs, BinaryMode::SCATTER), m_dim(dim) {}
+        isize get_dim() const { return m_dim; }
+        Opcode get_opcode() const override { return Opcode::SCATTER; }
         const std::string &get_opname() const override { return s_opname; }
-        void grad_fn() const override;
+        const std::string str() const override { return std::format("{}, dim: {}", BinaryOp::str(), m_dim); }
+        const std::string dump() const override { return std::format("{}\\nDim: {}", BinaryOp::dump(), m_dim); }
     };
 
-    using CopyOpPtr = std::shared_ptr<CopyOp>;
+    // Values of the top-k elements gathered at the indices of an argtopk, so values and indices come out of a single sort
+    struct TopkOp : public GatherOp {
+    private:
+        isize m_k;
+        bool m_descending;
 
-    struct ExpOp : public UnaryOp {
     public:
-        inline static const std::string s_opname = "exp";
-        ExpOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::EXP; }
+        inline static const std::string s_opname = "topk";
+        TopkOp(const ArrayData &data, OpPtr operand, OpPtr index, isize dim, isize k, bool descending) : GatherOp(data, operand, index, dim), m_k(k), m_descending(descending) {}
+        isize get_k() const { return m_k; }
+        bool is_descending() const { return m_descending; }
+        OpPtr get_indices() const { return m_rhs; }
+        Opcode get_opcode() const override { return Opcode::TOPK; }
         const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, k: {}, descending: {}", GatherOp::str(), m_k, m_descending); }
         void grad_fn() const override;
     };
 
-    struct LogOp : public UnaryOp {
+    struct WhereOp : public TernaryOp {
     public:
-        inline static const std::string s_opname = "log";
-        LogOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::LOG; }
+        inline static const std::string s_opname = "where";
+        // The first operand is the boolean condition, the second and third are selected when it is true and false respectively
+        WhereOp(const ArrayData &data, OpPtr cond, OpPtr lhs, OpPtr rhs) : TernaryOp(data, cond, lhs, rhs) {}
+        Opcode get_opcode() const override { return Opcode::WHERE; }
+        bool supports_strided_output() const override { return true; }
         const std::string &get_opname() const override { return s_opname; }
         void grad_fn() const override;
     };
 
-    struct RecipOp : public UnaryOp {
+    struct ConcatOp : public NaryOp {
+    private:
+        isize m_dim;
+        // Ranges of the output that each operand occupies
+        std::vector<RangeVector> m_ranges;
+
     public:
-        inline static const std::string s_opname = "recip";
-        RecipOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::RECIP; }
+        inline static const std::string s_opname = "concat";
+        ConcatOp(const ArrayData &data, const std::vector<OpPtr> &operands, isize dim, const std::vector<RangeVector> &ranges) : NaryOp(data, operands), m_dim(dim), m_ranges(ranges) {}
+        isize get_dim() const { return m_dim; }
+        const std::vector<RangeVector> &get_ranges() const { return m_ranges; }
+        Opcode get_opcode() const override { return Opcode::CONCAT; }
+        // Nested concatenations are planned first so their own operands land in the outer buffer
+        bool supports_strided_output() const override { return true; }
         const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, dim: {}", NaryOp::str(), m_dim); }
+        const std::string dump() const override { return std::format("{}\\nDim: {}", NaryOp::dump(), m_dim); }
         void grad_fn() const override;
     };
 
-    struct SinOp : public UnaryOp {
+    using ConcatOpPtr = std::shared_ptr<ConcatOp>;
+
+    // Normalizes over the last dimension, the operands are the input, weight, bias if any and statistics,
+    // the statistics are (rows, 2) arrays of mean and reciprocal standard deviation written by the forward kernel
+    struct NormOp : public NaryOp {
+    protected:
+        float m_eps;
+
     public:
-        inline static const std::string s_opname = "sin";
-        SinOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::SIN; }
+        NormOp(const ArrayData &data, const std::vector<OpPtr> &operands, float eps) : NaryOp(data, operands), m_eps(eps) {}
+        float get_eps() const { return m_eps; }
+        // Layer normalization subtracts the mean, RMS normalization does not
+        virtual bool is_centered() const = 0;
+        OpPtr get_stats() const { return m_operands.back(); }
+        const std::string str() const override { return std::format("{}, eps: {}", NaryOp::str(), m_eps); }
+        const std::string dump() const override { return std::format("{}\\nEps: {}", NaryOp::dump(), m_eps); }
+    };
+
+    using NormOpPtr = std::shared_ptr<NormOp>;
+
+    struct LayerNormOp : public NormOp {
+    public:
+        inline static const std::string s_opname = "layernorm";
+        LayerNormOp(const ArrayData &data, const std::vector<OpPtr> &operands, float eps) : NormOp(data, operands, eps) {}
+        bool is_centered() const override { return true; }
+        Opcode get_opcode() const override { return Opcode::LAYERNORM; }
         const std::string &get_opname() const override { return s_opname; }
         void grad_fn() const override;
     };
 
-    struct CosOp : public UnaryOp {
+    struct RMSNormOp : public NormOp {
     public:
-        inline static const std::string s_opname = "cos";
-        CosOp(const ArrayData &data, OpPtr operand, bool in_place) : UnaryOp(data, operand, in_place) {}
-        Opcode get_opcode() const override { return Opcode::COS; }
+        inline static const std::string s_opname = "rmsnorm";
+        RMSNormOp(const ArrayData &data, const std::vector<OpPtr> &operands, float eps) : NormOp(data, operands, eps) {}
+        bool is_centered() const override { return false; }
+        Opcode get_opcode() const override { return Opcode::RMSNORM; }
         const std::string &get_opname() const override { return s_opname; }
         void grad_fn() const override;
     };
 
-    struct ReshapeOp : public TransformOp {
+    struct BatchNormParams {
+        isize channel_dim = 1;
+        float eps = 1e-5f;
+        // Weight of the batch statistics when updating the running statistics
+        float momentum = 0.1f;
+        // Training normalizes with batch statistics and updates the running statistics,
+        // inference normalizes with the running statistics
+        bool training = true;
+
+        const std::string str() const { return std::format("channel dim: {}, eps: {}, momentum: {}, training: {}", channel_dim, eps, momentum, training); }
+    };
+
+    // Normalizes every channel over all other dimensions, the operands are the input, weight, bias,
+    // running mean, running variance and statistics, the running statistics are updated in place
+    struct BatchNormOp : public NaryOp {
+    private:
+        BatchNormParams m_params;
+
     public:
-        inline static const std::string s_opname = "reshape";
-        ReshapeOp(const ArrayData &data, OpPtr operand) : TransformOp(data, operand) {}
-        Opcode get_opcode() const override { return Opcode::RESHAPE; }
+        inline static const std::string s_opname = "batchnorm";
+        BatchNormOp(const ArrayData &data, const std::vector<OpPtr> &operands, const BatchNormParams &params) : NaryOp(data, operands), m_params(params) {}
+        const BatchNormParams &get_params() const { return m_params; }
+        OpPtr get_stats() const { return m_operands.back(); }
+        Opcode get_opcode() const override { return Opcode::BATCHNORM; }
         const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, {}", NaryOp::str(), m_params.str()); }
+        const std::string dump() const override { return std::format("{}\\n{}", NaryOp::dump(), m_params.str()); }
         void grad_fn() const override;
     };
 
-    struct SliceOp : public TransformOp {
+    using BatchNormOpPtr = std::shared_ptr<BatchNormOp>;
+
+    struct BatchNormGradOp : public NaryOp {
     private:
-        std::vector<Range> m_ranges;
+        BatchNormParams m_params;
 
     public:
-        inline static const std::string s_opname = "slice";
-        SliceOp(const ArrayData &data, OpPtr operand, const std::vector<Range> &ranges) : TransformOp(data, operand), m_ranges(ranges) {}
-        const std::vector<Range> &get_ranges() const { return m_ranges; }
-        Opcode get_opcode() const override { return Opcode::SLICE; }
+        inline static const std::string s_opname = "batchnorm_grad";
+        // Input gradient of a batch normalization, the operands are the output gradient, input, weight, statistics and parameter gradients
+        BatchNormGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, const BatchNormParams &params) : NaryOp(data, operands), m_params(params) {}
+        const BatchNormParams &get_params() const { return m_params; }
+        Opcode get_opcode() const override { return Opcode::BATCHNORM_GRAD; }
         const std::string &get_opname() const override { return s_opname; }
+    };
 
-        const std::string str() const override {
-            return std::format("{}, ranges: ({})", TransformOp::str(), join<Range>(m_ranges, [](Range range) { return range.str(); }));
-        }
+    struct BatchNormParamGradOp : public NaryOp {
+    private:
+        BatchNormParams m_params;
 
-        const std::string dump() const override {
-            return std::format("{}\\nRanges: ({})", TransformOp::dump(), join<Range>(m_ranges, [](Range range) { return range.str(); }));
-        }
+    public:
+        inline static const std::string s_opname = "batchnorm_param_grad";
+        // Weight and bias gradients of a batch normalization stacked as (2, channels),
+        // the operands are the output gradient, input and statistics
+        BatchNormParamGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, const BatchNormParams &params) : NaryOp(data, operands), m_params(params) {}
+        const BatchNormParams &get_params() const { return m_params; }
+        Opcode get_opcode() const override { return Opcode::BATCHNORM_PARAM_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
 
-        void grad_fn() const override;
+    struct NormGradOp : public NaryOp {
+    private:
+        bool m_centered;
+
+    public:
+        inline static const std::string s_opname = "norm_grad";
+        // Input gradient of a normalization, the operands are the output gradient, input, weight and statistics
+        NormGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, bool centered) : NaryOp(data, operands), m_centered(centered) {}
+        bool is_centered() const { return m_centered; }
+        Opcode get_opcode() const override { return Opcode::NORM_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
     };
 
-    struct PermuteOp : public TransformOp {
+    struct NormParamGradOp : public NaryOp {
     private:
-        ShapeDims m_dims;
+        bool m_centered;
 
     public:
-        inline static const std::string s_opname = "permute";
-        PermuteOp(const ArrayData &data, OpPtr operand, const ShapeDims &dims) : TransformOp(data, operand), m_dims(dims) {}
-        const ShapeDims &get_perm() const { return m_dims; }
-        Opcode get_opcode() const override { return Opcode::PERMUTE; }
+        inline static const std::string s_opname = "norm_param_grad";
+        // Weight and bias gradients of a normalization stacked as (2, features),
+        // the operands are the output gradient, input and statistics
+        NormParamGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, bool centered) : NaryOp(data, operands), m_centered(centered) {}
+        bool is_centered() const { return m_centered; }
+        Opcode get_opcode() const override { return Opcode::NORM_PARAM_GRAD; }
         const std::string &get_opname() const override { return s_opname; }
-        const std::string str() const override { return std::format("{}, permutation: ({})", TransformOp::str(), join_nums(m_dims)); }
-        const std::string dump() const override { return std::format("{}\\nPermutation: ({})", TransformOp::dump(), join_nums(m_dims)); }
-        void grad_fn() const override;
     };
 
-    struct BroadcastOp : public TransformOp {
+    // Attention over the last two dimensions computed tile by tile with an online softmax so the scores are never stored,
+    // the operands are the query, key, value and the log-sum-exp of every query row
+    struct ScaledDotProductAttentionOp : public NaryOp {
     private:
-        ShapeView m_input_view;
-        ShapeDims m_dims;
+        float m_scale;
+        bool m_causal;
 
     public:
-        inline static const std::string s_opname = "broadcast";
-        BroadcastOp(const ArrayData &data, OpPtr operand, const ShapeView &input_view, const ShapeDims &dims) : TransformOp(data, operand), m_input_view(input_view), m_dims(dims) {}
-        const ShapeView &get_input_view() const { return m_input_view; }
-        const ShapeDims &get_dims() const { return m_dims; }
-        Opcode get_opcode() const override { return Opcode::BROADCAST; }
+        inline static const std::string s_opname = "sdpa";
+        // Must match sdpa_max_head_dim in the attention kernels
+        static constexpr isize s_max_head_dim = 128;
+        ScaledDotProductAttentionOp(const ArrayData &data, const std::vector<OpPtr> &operands, float scale, bool causal) : NaryOp(data, operands), m_scale(scale), m_causal(causal) {}
+        float get_scale() const { return m_scale; }
+        bool is_causal() const { return m_causal; }
+        OpPtr get_stats() const { return m_operands.back(); }
+        Opcode get_opcode() const override { return Opcode::SDPA; }
         const std::string &get_opname() const override { return s_opname; }
-        const std::string str() const override { return std::format("{}, input view: ({}), dims: ({})", TransformOp::str(), join_nums(m_input_view), join_nums(m_dims)); }
-        const std::string dump() const override { return std::format("{}\\nInput view: ({})\\nDims: ({})", TransformOp::dump(), join_nums(m_input_view), join_nums(m_dims)); }
+        const std::string str() const override { return std::format("{}, scale: {}, causal: {}", NaryOp::str(), m_scale, m_causal); }
         void grad_fn() const override;
     };
 
-    struct SqueezeOp : public TransformOp {
+    using ScaledDotProductAttentionOpPtr = std::shared_ptr<ScaledDotProductAttentionOp>;
+
+    struct SDPAGradOp : public NaryOp {
     private:
-        ShapeDims m_dims;
+        float m_scale;
+        bool m_causal;
+        AttentionGradTarget m_target;
 
     public:
-        inline static const std::string s_opname = "squeeze";
-        SqueezeOp(const ArrayData &data, OpPtr operand, const ShapeDims &dims) : TransformOp(data, operand), m_dims(dims) {}
-        const ShapeDims &get_dims() const { return m_dims; }
-        Opcode get_opcode() const override { return Opcode::SQUEEZE; }
+        inline static const std::string s_opname = "sdpa_grad";
+        // Gradient of the query, key or value of an attention, the scores are recomputed per tile,
+        // the operands are the output gradient, query, key, value, output and log-sum-exp
+        SDPAGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, float scale, bool causal, AttentionGradTarget target) : NaryOp(data, operands), m_scale(scale), m_causal(causal), m_target(target) {}
+        float get_scale() const { return m_scale; }
+        bool is_causal() const { return m_causal; }
+        AttentionGradTarget get_target() const { return m_target; }
+        Opcode get_opcode() const override { return Opcode::SDPA_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    using SDPAGradOpPtr = std::shared_ptr<SDPAGradOp>;
+
+    // Fused epilogue of an LSTM step, the operands are the input and hidden projections of shape (batch, 4 * hidden)
+    // with the input, forget, cell and output gates packed in that order and the previous cell state of shape (batch, hidden),
+    // the output packs the next hidden and cell states as (batch, 2 * hidden)
+    struct LSTMCellOp : public NaryOp {
+    public:
+        inline static const std::string s_opname = "lstm_cell";
+        LSTMCellOp(const ArrayData &data, const std::vector<OpPtr> &operands) : NaryOp(data, operands) {}
+        Opcode get_opcode() const override { return Opcode::LSTM_CELL; }
         const std::string &get_opname() const override { return s_opname; }
-        const std::string str() const override { return std::format("{}, dims: ({})", TransformOp::str(), join_nums(m_dims)); }
-        const std::string dump() const override { return std::format("{}\\nDims: ({})", TransformOp::dump(), join_nums(m_dims)); }
         void grad_fn() const override;
     };
 
-    struct UnsqueezeOp : public TransformOp {
+    struct LSTMCellGradOp : public NaryOp {
     private:
-        ShapeDims m_dims;
+        RecurrentGradTarget m_target;
 
     public:
-        inline static const std::string s_opname = "unsqueeze";
-        UnsqueezeOp(const ArrayData &data, OpPtr operand, const ShapeDims &dims) : TransformOp(data, operand), m_dims(dims) {}
-        const ShapeDims &get_dims() const { return m_dims; }
-        Opcode get_opcode() const override { return Opcode::UNSQUEEZE; }
+        inline static const std::string s_opname = "lstm_cell_grad";
+        // Gradient of the gates or the previous cell state of an LSTM step with the gates recomputed,
+        // the operands are the output gradient, input and hidden projections and previous cell state
+        LSTMCellGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, RecurrentGradTarget target) : NaryOp(data, operands), m_target(target) {}
+        RecurrentGradTarget get_target() const { return m_target; }
+        Opcode get_opcode() const override { return Opcode::LSTM_CELL_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    using LSTMCellGradOpPtr = std::shared_ptr<LSTMCellGradOp>;
+
+    // Fused epilogue of a GRU step, the operands are the input and hidden projections of shape (batch, 3 * hidden)
+    // with the reset, update and new gates packed in that order and the previous hidden state of shape (batch, hidden),
+    // the hidden projection includes its bias since the reset gate scales it before the new gate
+    struct GRUCellOp : public NaryOp {
+    public:
+        inline static const std::string s_opname = "gru_cell";
+        GRUCellOp(const ArrayData &data, const std::vector<OpPtr> &operands) : NaryOp(data, operands) {}
+        Opcode get_opcode() const override { return Opcode::GRU_CELL; }
         const std::string &get_opname() const override { return s_opname; }
-        const std::string str() const override { return std::format("{}, dims: ({})", TransformOp::str(), join_nums(m_dims)); }
-        const std::string dump() const override { return std::format("{}\\nDims: ({})", TransformOp::dump(), join_nums(m_dims)); }
         void grad_fn() const override;
     };
 
-    struct AstypeOp : public TransformOp {
+    struct GRUCellGradOp : public NaryOp {
     private:
-        DtypePtr m_dtype;
+        RecurrentGradTarget m_target;
 
     public:
-        inline static const std::string s_opname = "astype";
-        AstypeOp(const ArrayData &data, OpPtr operand, DtypePtr dtype) : TransformOp(data, operand), m_dtype(dtype) {}
-        DtypePtr get_dtype() const { return m_dtype; }
-        Opcode get_opcode() const override { return Opcode::ASTYPE; }
+        inline static const std::string s_opname = "gru_cell_grad";
+        // Gradient of the input projection, hidden projection or previous hidden state of a GRU step with the gates recomputed,
+        // the operands are the output gradient, input and hidden projections and previous hidden state
+        GRUCellGradOp(const ArrayData &data, const std::vector<OpPtr> &operands, RecurrentGradTarget target) : NaryOp(data, operands), m_target(target) {}
+        RecurrentGradTarget get_target() const { return m_target; }
+        Opcode get_opcode() const override { return Opcode::GRU_CELL_GRAD; }
         const std::string &get_opname() const override { return s_opname; }
-        const std::string str() const override { return std::format("{}, dtype: {}", TransformOp::str(), m_dtype->str()); }
-        const std::string dump() const override { return std::format("{}\\nDtype: {}", TransformOp::dump(), m_dtype->str()); }
     };
 
-    struct SumOp : public ReduceOp {
+    using GRUCellGradOpPtr = std::shared_ptr<GRUCellGradOp>;
+
+    // Recurrent layer over a whole sequence with the time loop inside the kernel, every batch row is run by one threadgroup
+    // that keeps the hidden state in threadgroup memory, the input projections of all steps are computed upfront by one GEMM,
+    // the hidden weight is transposed to (hidden, gates * hidden) so consecutive threads read consecutive gate columns
+    struct RecurrentOp : public NaryOp {
     public:
-        inline static const std::string s_opname = "sum";
-        SumOp(const ArrayData &data, OpPtr operand, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims) : ReduceOp(data, operand, remaining_dims, reduce_dims) {}
-        Opcode get_opcode() const override { return Opcode::SUM; }
+        // Must match rnn_max_hidden_size in the recurrent kernels
+        static constexpr isize s_max_hidden_size = 1024;
+        RecurrentOp(const ArrayData &data, const std::vector<OpPtr> &operands) : NaryOp(data, operands) {}
+        isize get_hidden_size() const { return m_operands[1]->get_data().get_view()[0]; }
+    };
+
+    using RecurrentOpPtr = std::shared_ptr<RecurrentOp>;
+
+    // The operands are the input projections of shape (steps, batch, 4 * hidden) including both biases, the transposed hidden weight
+    // and the initial hidden and cell states of shape (batch, hidden), the output packs the hidden and cell states of every step
+    // as (steps, batch, 2 * hidden) so the backward pass can reuse them
+    struct LSTMOp : public RecurrentOp {
+    public:
+        inline static const std::string s_opname = "lstm";
+        LSTMOp(const ArrayData &data, const std::vector<OpPtr> &operands) : RecurrentOp(data, operands) {}
+        Opcode get_opcode() const override { return Opcode::LSTM; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // The operands are the input projections of shape (steps, batch, 3 * hidden) including the input bias, the transposed hidden weight,
+    // the hidden bias and the initial hidden state of shape (batch, hidden), the output is the hidden state of every step
+    struct GRUOp : public RecurrentOp {
+    public:
+        inline static const std::string s_opname = "gru";
+        GRUOp(const ArrayData &data, const std::vector<OpPtr> &operands) : RecurrentOp(data, operands) {}
+        Opcode get_opcode() const override { return Opcode::GRU; }
         const std::string &get_opname() const override { return s_opname; }
         void grad_fn() const override;
     };
 
+    // Symmetric int8 quantization of every row over the last dimension, values are rounded to [-127, 127] with the scale
+    // absmax / 127 which is written to the f32 scale operand of shape (rows), a positive clip bounds the absolute maximum
+    // with a calibrated range so that outliers do not flatten the other values of the row
+    struct QuantizeOp : public NaryOp {
+    private:
+        float m_clip;
+
+    public:
+        inline static const std::string s_opname = "quantize";
+        QuantizeOp(const ArrayData &data, const std::vector<OpPtr> &operands, float clip) : NaryOp(data, operands), m_clip(clip) {}
+        float get_clip() const { return m_clip; }
+        OpPtr get_scale() const { return m_operands.back(); }
+        Opcode get_opcode() const override { return Opcode::QUANTIZE; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, clip: {}", NaryOp::str(), m_clip); }
+    };
+
+    using QuantizeOpPtr = std::shared_ptr<QuantizeOp>;
+
+    // The operands are the quantized input of shape (..., in) with its per-row scales and the quantized weight of shape (out, in)
+    // with its per-output-channel scales, followed by an optional bias of shape (out), the int8 products are accumulated in i32
+    // and dequantized together with the bias and the activation in the epilogue, the output has the dtype of the bias
+    // or of the unquantized input
+    struct QuantizedMatmulOp : public NaryOp {
+    private:
+        QuantizedActivation m_activation;
+
+    public:
+        inline static const std::string s_opname = "quantized_matmul";
+        QuantizedMatmulOp(const ArrayData &data, const std::vector<OpPtr> &operands, QuantizedActivation activation) : NaryOp(data, operands), m_activation(activation) {}
+        QuantizedActivation get_activation() const { return m_activation; }
+        bool has_bias() const { return m_operands.size() > 4; }
+        Opcode get_opcode() const override { return Opcode::QUANTIZED_MATMUL; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override {
+            static constexpr const char *activation_names[] = {"none", "relu", "gelu", "silu"};
+            return std::format("{}, activation: {}", NaryOp::str(), activation_names[static_cast<int>(m_activation)]);
+        }
+    };
+
+    using QuantizedMatmulOpPtr = std::shared_ptr<QuantizedMatmulOp>;
+
+    // The first operands of a sparse matrix op are its i32 row offsets or row indices, its i32 column indices
+    // and its f32 nonzero values, the nonzeros are split evenly between threads regardless of how they spread over rows
+    struct SparseOp : public NaryOp {
+    protected:
+        SparseFormat m_format;
+        isize m_nrow;
+        isize m_ncol;
+
+    public:
+        SparseOp(const ArrayData &data, const std::vector<OpPtr> &operands, SparseFormat format, isize nrow, isize ncol) : NaryOp(data, operands), m_format(format), m_nrow(nrow), m_ncol(ncol) {}
+        SparseFormat get_format() const { return m_format; }
+        isize get_num_rows() const { return m_nrow; }
+        isize get_num_cols() const { return m_ncol; }
+        isize get_nnz() const { return m_operands[2]->get_data().get_numel(); }
+        const std::string str() const override { return std::format("{}, format: {}, shape: ({}, {})", NaryOp::str(), m_format == SparseFormat::CSR ? "CSR" : "COO", m_nrow, m_ncol); }
+    };
+
+    using SparseOpPtr = std::shared_ptr<SparseOp>;
+
+    // Multiplies the sparse matrix or its transpose with the dense operand of shape (cols, n) or (rows, n)
+    struct SpmmOp : public SparseOp {
+    private:
+        bool m_transposed;
+
+    public:
+        inline static const std::string s_opname = "spmm";
+        SpmmOp(const ArrayData &data, const std::vector<OpPtr> &operands, SparseFormat format, isize nrow, isize ncol, bool transposed) : SparseOp(data, operands, format, nrow, ncol), m_transposed(transposed) {}
+        bool is_transposed() const { return m_transposed; }
+        Opcode get_opcode() const override { return Opcode::SPMM; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, transposed: {}", SparseOp::str(), m_transposed); }
+        void grad_fn() const override;
+    };
+
+    using SpmmOpPtr = std::shared_ptr<SpmmOp>;
+
+    // Multiplies every nonzero with the dense operand of shape (rows, cols) at the same position,
+    // the output holds the new nonzero values of the unchanged sparsity pattern
+    struct SparseMulOp : public SparseOp {
+    public:
+        inline static const std::string s_opname = "sparse_mul";
+        SparseMulOp(const ArrayData &data, const std::vector<OpPtr> &operands, SparseFormat format, isize nrow, isize ncol) : SparseOp(data, operands, format, nrow, ncol) {}
+        Opcode get_opcode() const override { return Opcode::SPARSE_MUL; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // Scatters the nonzeros into a dense array of shape (rows, cols), duplicate coordinates are summed
+    struct SparseToDenseOp : public SparseOp {
+    public:
+        inline static const std::string s_opname = "sparse_to_dense";
+        SparseToDenseOp(const ArrayData &data, const std::vector<OpPtr> &operands, SparseFormat format, isize nrow, isize ncol) : SparseOp(data, operands, format, nrow, ncol) {}
+        Opcode get_opcode() const override { return Opcode::SPARSE_TO_DENSE; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // The operands are the input of shape (..., in), the i32 offsets of every block row into the nonzero blocks, the i32 block
+    // column of every nonzero block and the f32 nonzero blocks of shape (blocks, block rows, block cols), followed by an optional
+    // bias of shape (out), the weight of shape (out, in) is never materialized and zero blocks are skipped
+    struct BlockSparseMatmulOp : public NaryOp {
+    public:
+        inline static const std::string s_opname = "block_sparse_matmul";
+        BlockSparseMatmulOp(const ArrayData &data, const std::vector<OpPtr> &operands) : NaryOp(data, operands) {}
+        isize get_block_rows() const { return m_operands[3]->get_data().get_view()[1]; }
+        isize get_block_cols() const { return m_operands[3]->get_data().get_view()[2]; }
+        isize get_num_blocks() const { return m_operands[3]->get_data().get_view()[0]; }
+        bool has_bias() const { return m_operands.size() > 4; }
+        Opcode get_opcode() const override { return Opcode::BLOCK_SPARSE_MATMUL; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, block: ({}, {})", NaryOp::str(), get_block_rows(), get_block_cols()); }
+    };
+
+    using BlockSparseMatmulOpPtr = std::shared_ptr<BlockSparseMatmulOp>;
+
+    // Bit-packed masks hold 32 elements per i32 word along the last dimension, every row starts at a new word
+    // and the padding bits past the end of a row are zero, so a mask of view (..., n) has words of view (..., ceil(n / 32))
+    inline isize num_mask_words(isize ncol) { return (ncol + 31) / 32; }
+
+    // Compares the operands broadcasted to the view of the mask and writes one bit per element
+    struct CmpBitsOp : public NaryOp {
+    private:
+        BitCmp m_cmp;
+
+    public:
+        inline static const std::string s_opname = "cmp_bits";
+        CmpBitsOp(const ArrayData &data, const std::vector<OpPtr> &operands, BitCmp cmp) : NaryOp(data, operands), m_cmp(cmp) {}
+        BitCmp get_cmp() const { return m_cmp; }
+        const std::string &get_cmp_name() const {
+            static const std::string cmp_names[] = {"eq", "neq", "lt", "gt", "leq", "geq"};
+            return cmp_names[static_cast<int>(m_cmp)];
+        }
+        Opcode get_opcode() const override { return Opcode::CMP_BITS; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, cmp: {}", NaryOp::str(), get_cmp_name()); }
+    };
+
+    // The operands are the mask words followed by the values selected where the bit is set and where it is not,
+    // both broadcasted to the view of the mask
+    struct WhereBitsOp : public NaryOp {
+    public:
+        inline static const std::string s_opname = "where_bits";
+        WhereBitsOp(const ArrayData &data, const std::vector<OpPtr> &operands) : NaryOp(data, operands) {}
+        Opcode get_opcode() const override { return Opcode::WHERE_BITS; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // Counts the set bits of every row of a mask with popcount, the output drops the last dimension
+    struct CountBitsOp : public NaryOp {
+    public:
+        inline static const std::string s_opname = "count_bits";
+        CountBitsOp(const ArrayData &data, const std::vector<OpPtr> &operands) : NaryOp(data, operands) {}
+        Opcode get_opcode() const override { return Opcode::COUNT_BITS; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct SqOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "sq";
+        SqOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SQ; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SqrtOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "sqrt";
+        SqrtOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SQRT; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct NegOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "neg";
+        NegOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::NEG; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct CopyOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "copy";
+        CopyOp(const ArrayData &data, OpPtr operand) : ElmwiseUnaryOp(data, operand, false) {}
+        Opcode get_opcode() const override { return Opcode::COPY; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    using CopyOpPtr = std::shared_ptr<CopyOp>;
+
+    struct Im2colOp : public UnaryOp {
+    private:
+        Conv2dParams m_params;
+
+    public:
+        inline static const std::string s_opname = "im2col";
+        // Unfolds image patches into columns of shape (N, C * KH * KW, OH * OW) for NCHW or (N, OH * OW, C * KH * KW) for NHWC
+        Im2colOp(const ArrayData &data, OpPtr operand, const Conv2dParams &params) : UnaryOp(data, operand, false), m_params(params) {}
+        const Conv2dParams &get_params() const { return m_params; }
+        Opcode get_opcode() const override { return Opcode::IM2COL; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, {}", UnaryOp::str(), m_params.str()); }
+        const std::string dump() const override { return std::format("{}\\n{}", UnaryOp::dump(), m_params.str()); }
+        void grad_fn() const override;
+    };
+
+    struct Col2imOp : public UnaryOp {
+    private:
+        Conv2dParams m_params;
+
+    public:
+        inline static const std::string s_opname = "col2im";
+        // Folds columns back into an image, summing the patches that overlap
+        Col2imOp(const ArrayData &data, OpPtr operand, const Conv2dParams &params) : UnaryOp(data, operand, false), m_params(params) {}
+        const Conv2dParams &get_params() const { return m_params; }
+        Opcode get_opcode() const override { return Opcode::COL2IM; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, {}", UnaryOp::str(), m_params.str()); }
+        const std::string dump() const override { return std::format("{}\\n{}", UnaryOp::dump(), m_params.str()); }
+        void grad_fn() const override;
+    };
+
+    // Real-to-complex transform of the last dimension, a signal of view (..., n) gives its n / 2 + 1 non-negative
+    // frequencies as a view of (..., n / 2 + 1, 2) holding the real and imaginary parts
+    struct RfftOp : public UnaryOp {
+    private:
+        isize m_n;
+
+    public:
+        inline static const std::string s_opname = "rfft";
+        RfftOp(const ArrayData &data, OpPtr operand, isize n) : UnaryOp(data, operand, false), m_n(n) {}
+        isize get_n() const { return m_n; }
+        Opcode get_opcode() const override { return Opcode::RFFT; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, n: {}", UnaryOp::str(), m_n); }
+        void grad_fn() const override;
+    };
+
+    // Inverse of RfftOp scaled by 1 / n, the imaginary parts of the zero and Nyquist frequencies are ignored
+    struct IrfftOp : public UnaryOp {
+    private:
+        isize m_n;
+
+    public:
+        inline static const std::string s_opname = "irfft";
+        IrfftOp(const ArrayData &data, OpPtr operand, isize n) : UnaryOp(data, operand, false), m_n(n) {}
+        isize get_n() const { return m_n; }
+        Opcode get_opcode() const override { return Opcode::IRFFT; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, n: {}", UnaryOp::str(), m_n); }
+        void grad_fn() const override;
+    };
+
+    struct Pool2dOp : public UnaryOp {
+    protected:
+        Pool2dParams m_params;
+
+    public:
+        Pool2dOp(const ArrayData &data, OpPtr operand, const Pool2dParams &params) : UnaryOp(data, operand, false), m_params(params) {}
+        const Pool2dParams &get_params() const { return m_params; }
+        const std::string str() const override { return std::format("{}, {}", UnaryOp::str(), m_params.str()); }
+        const std::string dump() const override { return std::format("{}\\n{}", UnaryOp::dump(), m_params.str()); }
+    };
+
+    using Pool2dOpPtr = std::shared_ptr<Pool2dOp>;
+
+    // Zeroes every element with probability p and scales the others by 1 / (1 - p),
+    // the keep mask is hashed from the key and element index so backward regenerates it instead of storing it
+    struct DropoutOp : public UnaryOp {
+    private:
+        uint64_t m_key;
+        float m_p;
+
+    public:
+        inline static const std::string s_opname = "dropout";
+        DropoutOp(const ArrayData &data, OpPtr operand, uint64_t key, float p) : UnaryOp(data, operand, false), m_key(key), m_p(p) {}
+        uint64_t get_key() const { return m_key; }
+        float get_p() const { return m_p; }
+        Opcode get_opcode() const override { return Opcode::DROPOUT; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, key: {}, p: {}", UnaryOp::str(), m_key, m_p); }
+        void grad_fn() const override;
+    };
+
+    using DropoutOpPtr = std::shared_ptr<DropoutOp>;
+
+    // Draws sample indices over the last dimension, the input holds logits or unnormalized probabilities,
+    // top_k of 0 and top_p of 1 disable the corresponding filter
+    struct MultinomialOp : public UnaryOp {
+    private:
+        uint64_t m_key;
+        isize m_num_samples;
+        float m_temperature;
+        isize m_top_k;
+        float m_top_p;
+        bool m_logits;
+
+    public:
+        inline static const std::string s_opname = "multinomial";
+        MultinomialOp(const ArrayData &data, OpPtr operand, uint64_t key, isize num_samples, float temperature, isize top_k, float top_p, bool logits) : UnaryOp(data, operand, false), m_key(key), m_num_samples(num_samples), m_temperature(temperature), m_top_k(top_k), m_top_p(top_p), m_logits(logits) {}
+        uint64_t get_key() const { return m_key; }
+        isize get_num_samples() const { return m_num_samples; }
+        float get_temperature() const { return m_temperature; }
+        isize get_top_k() const { return m_top_k; }
+        float get_top_p() const { return m_top_p; }
+        bool is_logits() const { return m_logits; }
+        Opcode get_opcode() const override { return Opcode::MULTINOMIAL; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, key: {}, num_samples: {}, temperature: {}, top_k: {}, top_p: {}, logits: {}", UnaryOp::str(), m_key, m_num_samples, m_temperature, m_top_k, m_top_p, m_logits); }
+    };
+
+    using MultinomialOpPtr = std::shared_ptr<MultinomialOp>;
+
+    // Counts the elements of the first operand into num_bins bins, the optional second operand holds the weights,
+    // elements falling outside of the bins are ignored
+    struct BinningOp : public NaryOp {
+    protected:
+        isize m_num_bins;
+
+    public:
+        BinningOp(const ArrayData &data, const std::vector<OpPtr> &operands, isize num_bins) : NaryOp(data, operands), m_num_bins(num_bins) {}
+        isize get_num_bins() const { return m_num_bins; }
+        bool has_weight() const { return m_operands.size() > 1; }
+        // Bincount uses integer values as bins, histogram splits [min, max] into equal-width bins
+        virtual bool is_ranged() const = 0;
+        virtual float get_min() const { return 0.0f; }
+        virtual float get_max() const { return static_cast<float>(m_num_bins); }
+        const std::string str() const override { return std::format("{}, num_bins: {}", NaryOp::str(), m_num_bins); }
+    };
+
+    using BinningOpPtr = std::shared_ptr<BinningOp>;
+
+    struct BincountOp : public BinningOp {
+    public:
+        inline static const std::string s_opname = "bincount";
+        BincountOp(const ArrayData &data, const std::vector<OpPtr> &operands, isize num_bins) : BinningOp(data, operands, num_bins) {}
+        bool is_ranged() const override { return false; }
+        Opcode get_opcode() const override { return Opcode::BINCOUNT; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct HistogramOp : public BinningOp {
+    private:
+        float m_min;
+        float m_max;
+
+    public:
+        inline static const std::string s_opname = "histogram";
+        HistogramOp(const ArrayData &data, const std::vector<OpPtr> &operands, isize num_bins, float min, float max) : BinningOp(data, operands, num_bins), m_min(min), m_max(max) {}
+        bool is_ranged() const override { return true; }
+        float get_min() const override { return m_min; }
+        float get_max() const override { return m_max; }
+        Opcode get_opcode() const override { return Opcode::HISTOGRAM; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, min: {}, max: {}", BinningOp::str(), m_min, m_max); }
+    };
+
+    struct MaxPool2dOp : public Pool2dOp {
+    public:
+        inline static const std::string s_opname = "maxpool2d";
+        MaxPool2dOp(const ArrayData &data, OpPtr operand, const Pool2dParams &params) : Pool2dOp(data, operand, params) {}
+        Opcode get_opcode() const override { return Opcode::MAXPOOL2D; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct AvgPool2dOp : public Pool2dOp {
+    public:
+        inline static const std::string s_opname = "avgpool2d";
+        AvgPool2dOp(const ArrayData &data, OpPtr operand, const Pool2dParams &params) : Pool2dOp(data, operand, params) {}
+        Opcode get_opcode() const override { return Opcode::AVGPOOL2D; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct AvgPool2dGradOp : public Pool2dOp {
+    public:
+        inline static const std::string s_opname = "avgpool2d_grad";
+        // Spreads every output gradient evenly over its window, the operand is the output gradient
+        AvgPool2dGradOp(const ArrayData &data, OpPtr operand, const Pool2dParams &params) : Pool2dOp(data, operand, params) {}
+        Opcode get_opcode() const override { return Opcode::AVGPOOL2D_GRAD; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct ExpOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "exp";
+        ExpOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::EXP; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct LogOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "log";
+        LogOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::LOG; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct RecipOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "recip";
+        RecipOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::RECIP; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SinOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "sin";
+        SinOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SIN; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct CosOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "cos";
+        CosOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::COS; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct ReluOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "relu";
+        ReluOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::RELU; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SigmoidOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "sigmoid";
+        SigmoidOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SIGMOID; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct TanhOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "tanh";
+        TanhOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::TANH; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct GeluOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "gelu";
+        GeluOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::GELU; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct GeluTanhOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "gelu_tanh";
+        GeluTanhOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::GELU_TANH; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SiluOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "silu";
+        SiluOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SILU; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SoftplusOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "softplus";
+        SoftplusOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SOFTPLUS; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct AbsOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "abs";
+        AbsOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::ABS; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SignOp : public ElmwiseUnaryOp {
+    public:
+        inline static const std::string s_opname = "sign";
+        SignOp(const ArrayData &data, OpPtr operand, bool in_place) : ElmwiseUnaryOp(data, operand, in_place) {}
+        Opcode get_opcode() const override { return Opcode::SIGN; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // Missing bounds are stored as infinities so the kernel always compares against both
+    // Bounds are kept in double, which holds every i32 bound exactly
+    struct ClampOp : public ElmwiseUnaryOp {
+    private:
+        double m_min;
+        double m_max;
+
+    public:
+        inline static const std::string s_opname = "clamp";
+        ClampOp(const ArrayData &data, OpPtr operand, double min, double max) : ElmwiseUnaryOp(data, operand, false), m_min(min), m_max(max) {}
+        double get_min() const { return m_min; }
+        double get_max() const { return m_max; }
+        Opcode get_opcode() const override { return Opcode::CLAMP; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, min: {}, max: {}", UnaryOp::str(), m_min, m_max); }
+        void grad_fn() const override;
+    };
+
+    using ClampOpPtr = std::shared_ptr<ClampOp>;
+
+    struct ReshapeOp : public TransformOp {
+    public:
+        inline static const std::string s_opname = "reshape";
+        ReshapeOp(const ArrayData &data, OpPtr operand) : TransformOp(data, operand) {}
+        Opcode get_opcode() const override { return Opcode::RESHAPE; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SliceOp : public TransformOp {
+    private:
+        std::vector<Range> m_ranges;
+
+    public:
+        inline static const std::string s_opname = "slice";
+        SliceOp(const ArrayData &data, OpPtr operand, const std::vector<Range> &ranges) : TransformOp(data, operand), m_ranges(ranges) {}
+        const std::vector<Range> &get_ranges() const { return m_ranges; }
+        Opcode get_opcode() const override { return Opcode::SLICE; }
+        const std::string &get_opname() const override { return s_opname; }
+
+        const std::string str() const override {
+            return std::format("{}, ranges: ({})", TransformOp::str(), join<Range>(m_ranges, [](Range range) { return range.str(); }));
+        }
+
+        const std::string dump() const override {
+            return std::format("{}\\nRanges: ({})", TransformOp::dump(), join<Range>(m_ranges, [](Range range) { return range.str(); }));
+        }
+
+        void grad_fn() const override;
+    };
+
+    struct PermuteOp : public TransformOp {
+    private:
+        ShapeDims m_dims;
+
+    public:
+        inline static const std::string s_opname = "permute";
+        PermuteOp(const ArrayData &data, OpPtr operand, const ShapeDims &dims) : TransformOp(data, operand), m_dims(dims) {}
+        const ShapeDims &get_perm() const { return m_dims; }
+        Opcode get_opcode() const override { return Opcode::PERMUTE; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, permutation: ({})", TransformOp::str(), join_nums(m_dims)); }
+        const std::string dump() const override { return std::format("{}\\nPermutation: ({})", TransformOp::dump(), join_nums(m_dims)); }
+        void grad_fn() const override;
+    };
+
+    struct BroadcastOp : public TransformOp {
+    private:
+        ShapeView m_input_view;
+        ShapeDims m_dims;
+
+    public:
+        inline static const std::string s_opname = "broadcast";
+        BroadcastOp(const ArrayData &data, OpPtr operand, const ShapeView &input_view, const ShapeDims &dims) : TransformOp(data, operand), m_input_view(input_view), m_dims(dims) {}
+        const ShapeView &get_input_view() const { return m_input_view; }
+        const ShapeDims &get_dims() const { return m_dims; }
+        Opcode get_opcode() const override { return Opcode::BROADCAST; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, input view: ({}), dims: ({})", TransformOp::str(), join_nums(m_input_view), join_nums(m_dims)); }
+        const std::string dump() const override { return std::format("{}\\nInput view: ({})\\nDims: ({})", TransformOp::dump(), join_nums(m_input_view), join_nums(m_dims)); }
+        void grad_fn() const override;
+    };
+
+    struct SqueezeOp : public TransformOp {
+    private:
+        ShapeDims m_dims;
+
+    public:
+        inline static const std::string s_opname = "squeeze";
+        SqueezeOp(const ArrayData &data, OpPtr operand, const ShapeDims &dims) : TransformOp(data, operand), m_dims(dims) {}
+        const ShapeDims &get_dims() const { return m_dims; }
+        Opcode get_opcode() const override { return Opcode::SQUEEZE; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, dims: ({})", TransformOp::str(), join_nums(m_dims)); }
+        const std::string dump() const override { return std::format("{}\\nDims: ({})", TransformOp::dump(), join_nums(m_dims)); }
+        void grad_fn() const override;
+    };
+
+    struct UnsqueezeOp : public TransformOp {
+    private:
+        ShapeDims m_dims;
+
+    public:
+        inline static const std::string s_opname = "unsqueeze";
+        UnsqueezeOp(const ArrayData &data, OpPtr operand, const ShapeDims &dims) : TransformOp(data, operand), m_dims(dims) {}
+        const ShapeDims &get_dims() const { return m_dims; }
+        Opcode get_opcode() const override { return Opcode::UNSQUEEZE; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, dims: ({})", TransformOp::str(), join_nums(m_dims)); }
+        const std::string dump() const override { return std::format("{}\\nDims: ({})", TransformOp::dump(), join_nums(m_dims)); }
+        void grad_fn() const override;
+    };
+
+    // The per-row scales of a quantization as an output of its own, the operand is the quantize op so reading the scales runs
+    // the quantization kernel, the output is a view of the scale operand
+    struct QuantizeScaleOp : public TransformOp {
+    public:
+        inline static const std::string s_opname = "quantize_scale";
+        QuantizeScaleOp(const ArrayData &data, OpPtr operand) : TransformOp(data, operand) {}
+        Opcode get_opcode() const override { return Opcode::QUANTIZE_SCALE; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct AstypeOp : public TransformOp {
+    private:
+        DtypePtr m_dtype;
+
+    public:
+        inline static const std::string s_opname = "astype";
+        AstypeOp(const ArrayData &data, OpPtr operand, DtypePtr dtype) : TransformOp(data, operand), m_dtype(dtype) {}
+        DtypePtr get_dtype() const { return m_dtype; }
+        Opcode get_opcode() const override { return Opcode::ASTYPE; }
+        const std::string &get_opname() const override { return s_opname; }
+        const std::string str() const override { return std::format("{}, dtype: {}", TransformOp::str(), m_dtype->str()); }
+        const std::string dump() const override { return std::format("{}\\nDtype: {}", TransformOp::dump(), m_dtype->str()); }
+        void grad_fn() const override;
+    };
+
+    struct CumsumOp : public ScanOp {
+    public:
+        inline static const std::string s_opname = "cumsum";
+        CumsumOp(const ArrayData &data, OpPtr operand, isize dim) : ScanOp(data, operand, dim) {}
+        Opcode get_opcode() const override { return Opcode::CUMSUM; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct CumprodOp : public ScanOp {
+    public:
+        inline static const std::string s_opname = "cumprod";
+        CumprodOp(const ArrayData &data, OpPtr operand, isize dim) : ScanOp(data, operand, dim) {}
+        Opcode get_opcode() const override { return Opcode::CUMPROD; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct CummaxOp : public ScanOp {
+    public:
+        inline static const std::string s_opname = "cummax";
+        CummaxOp(const ArrayData &data, OpPtr operand, isize dim) : ScanOp(data, operand, dim) {}
+        Opcode get_opcode() const override { return Opcode::CUMMAX; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct SortOp : public SortingOp {
+    public:
+        inline static const std::string s_opname = "sort";
+        SortOp(const ArrayData &data, OpPtr operand, isize dim, isize k, bool descending) : SortingOp(data, operand, dim, k, descending) {}
+        Opcode get_opcode() const override { return Opcode::SORT; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    struct ArgsortOp : public SortingOp {
+    public:
+        inline static const std::string s_opname = "argsort";
+        ArgsortOp(const ArrayData &data, OpPtr operand, isize dim, isize k, bool descending) : SortingOp(data, operand, dim, k, descending) {}
+        Opcode get_opcode() const override { return Opcode::ARGSORT; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct ArgtopkOp : public SortingOp {
+    public:
+        inline static const std::string s_opname = "argtopk";
+        ArgtopkOp(const ArrayData &data, OpPtr operand, isize dim, isize k, bool descending) : SortingOp(data, operand, dim, k, descending) {}
+        Opcode get_opcode() const override { return Opcode::ARGTOPK; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    struct SumOp : public ReduceOp {
+    public:
+        inline static const std::string s_opname = "sum";
+        SumOp(const ArrayData &data, OpPtr operand, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims) : ReduceOp(data, operand, remaining_dims, reduce_dims) {}
+        Opcode get_opcode() const override { return Opcode::SUM; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // Accumulates f32 head and tail pairs in place of an f64 accumulator, the gradient is the same as a sum
+    struct PreciseSumOp : public SumOp {
+    public:
+        inline static const std::string s_opname = "precise_sum";
+        PreciseSumOp(const ArrayData &data, OpPtr operand, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims) : SumOp(data, operand, remaining_dims, reduce_dims) {}
+        Opcode get_opcode() const override { return Opcode::PRECISE_SUM; }
+        const std::string &get_opname() const override { return s_opname; }
+    };
+
+    // Mean and squared deviations are combined in a single pass, the divisor is the number of reduced elements minus the correction
+    struct VarOp : public ReduceOp {
+    protected:
+        float m_correction;
+
+    public:
+        inline static const std::string s_opname = "var";
+        VarOp(const ArrayData &data, OpPtr operand, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims, float correction) : ReduceOp(data, operand, remaining_dims, reduce_dims), m_correction(correction) {}
+        Opcode get_opcode() const override { return Opcode::VAR; }
+        const std::string &get_opname() const override { return s_opname; }
+        float get_correction() const { return m_correction; }
+        const std::string str() const override { return std::format("{}, correction: {}", ReduceOp::str(), m_correction); }
+        const std::string dump() const override { return std::format("{}\\nCorrection: {}", ReduceOp::dump(), m_correction); }
+        void grad_fn() const override;
+    };
+
+    struct StdOp : public VarOp {
+    public:
+        inline static const std::string s_opname = "std";
+        StdOp(const ArrayData &data, OpPtr operand, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims, float correction) : VarOp(data, operand, remaining_dims, reduce_dims, correction) {}
+        Opcode get_opcode() const override { return Opcode::STD; }
+        const std::string &get_opname() const override { return s_opname; }
+        void grad_fn() const override;
+    };
+
+    // Named apart from NormOp which normalizes the last dimension for layer and RMS normalization
+    struct VectorNormOp : public ReduceOp {
+    private:
+        NormOrd m_ord;
+
+    public:
+        inline static const std::string s_opname = "vector_norm";
+        VectorNormOp(const ArrayData &data, OpPtr operand, const ShapeDims &remaining_dims, const ShapeDims &reduce_dims, NormOrd ord) : ReduceOp(data, operand, remaining_dims, reduce_dims), m_ord(ord) {}
+        Opcode get_opcode() const override { return Opcode::VECTOR_NORM; }
+        const std::string &get_opname() const override { return s_opname; }
+        NormOrd get_ord() const { return m_ord; }
+
+        const std::string &get_ord_name() const {
+            static const std::string ord_names[] = {"l1", "l2", "linf"};
+            return ord_names[static_cast<int>(m_ord)];
+        }
+
+        const std::string str() const override { return std::format("{}, ord: {}", ReduceOp::str(), get_ord_name()); }
+        const std::string dump() const override { return std::format("{}\\nOrd: {}", ReduceOp::dump(), get_ord_name()); }
+        void grad_fn() const override;
+    };
+
     struct MaxOp : public ReduceOp {
     public:
         inline static const std::string s_opname = "max";
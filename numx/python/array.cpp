@@ -106,8 +106,14 @@ namespace nx::bind {
             return &nxp::f32;
         } else if (nb_dtype == nb::dtype<int>()) {
             return &nxp::i32;
+        } else if (nb_dtype == nb::dtype<int8_t>()) {
+            return &nxp::i8;
         } else if (nb_dtype == nb::dtype<bool>()) {
             return &nxp::b8;
+        } else if (nb_dtype == nb_f16_dtype) {
+            return &nxp::f16;
+        } else if (nb_dtype == nb_bf16_dtype) {
+            return &nxp::bf16;
         }
         throw nb::type_error("Nanobind data type cannot be converted to numx data type.");
     }
@@ -124,11 +130,17 @@ namespace nx::bind {
     nb::ndarray<nb::numpy> array_to_numpy(nxc::Array &array) {
         switch (array.get_dtype()->get_name()) {
         case nxp::DtypeName::F32:
-            return array_to_numpy_impl<float>(array);
+            return array_to_numpy_impl(array, nb::dtype<float>());
+        case nxp::DtypeName::F16:
+            return array_to_numpy_impl(array, nb_f16_dtype);
+        case nxp::DtypeName::BF16:
+            throw nb::type_error("Numpy has no bf16 data type, convert the array with astype first.");
         case nxp::DtypeName::I32:
-            return array_to_numpy_impl<int>(array);
+            return array_to_numpy_impl(array, nb::dtype<int>());
+        case nxp::DtypeName::I8:
+            return array_to_numpy_impl(array, nb::dtype<int8_t>());
         default:
-            return array_to_numpy_impl<bool>(array);
+            return array_to_numpy_impl(array, nb::dtype<bool>());
         }
     }
 
@@ -147,14 +159,54 @@ namespace nx::bind {
         return nxc::from_buffer(ptr, ndarr.nbytes(), shape, dtype, nxp::default_device_name);
     }
 
+    nxc::SparseArray sparse_from_scipy(const nb::object &matrix) {
+        const std::string format = nb::cast<std::string>(matrix.attr("format"));
+        auto to_array = [](const nb::object &ndarr) {
+            nb::ndarray<nb::numpy> np_arr = nb::cast<nb::ndarray<nb::numpy>>(ndarr);
+            return array_from_numpy(np_arr);
+        };
+        const nxp::ShapeView view = nb::cast<nxp::ShapeView>(matrix.attr("shape"));
+
+        if (format == "csr") {
+            return nxc::sparse_csr(to_array(matrix.attr("indptr")), to_array(matrix.attr("indices")), to_array(matrix.attr("data")), view);
+        } else if (format == "coo") {
+            return nxc::sparse_coo(to_array(matrix.attr("row")), to_array(matrix.attr("col")), to_array(matrix.attr("data")), view);
+        }
+
+        throw std::invalid_argument(std::format("Scipy sparse format {} is not supported, convert the matrix to csr or coo first.", format));
+    }
+
+    nb::object sparse_to_scipy(const nxc::SparseArray &sparse) {
+        // Every component is wrapped in its own Python array which owns the memory shared with scipy
+        auto to_numpy = [](const nxc::Array &array) {
+            nb::object py_arr = nb::cast(array);
+            return nb::cast(array_to_numpy(nb::cast<nxc::Array &>(py_arr)));
+        };
+        nb::module_ scipy_sparse = nb::module_::import_("scipy.sparse");
+        nb::tuple shape = nb::make_tuple(sparse.get_view()[0], sparse.get_view()[1]);
+        nb::object values = to_numpy(sparse.get_values());
+
+        if (sparse.get_format() == nxp::SparseFormat::CSR) {
+            return scipy_sparse.attr("csr_matrix")(nb::make_tuple(values, to_numpy(sparse.get_cols()), to_numpy(sparse.get_rows())), "shape"_a = shape);
+        }
+
+        return scipy_sparse.attr("coo_matrix")(nb::make_tuple(values, nb::make_tuple(to_numpy(sparse.get_rows()), to_numpy(sparse.get_cols()))), "shape"_a = shape);
+    }
+
     nb::ndarray<nb::pytorch> array_to_torch(nxc::Array &array) {
         switch (array.get_dtype()->get_name()) {
         case nxp::DtypeName::F32:
-            return array_to_torch_impl<float>(array);
+            return array_to_torch_impl(array, nb::dtype<float>());
+        case nxp::DtypeName::F16:
+            return array_to_torch_impl(array, nb_f16_dtype);
+        case nxp::DtypeName::BF16:
+            return array_to_torch_impl(array, nb_bf16_dtype);
         case nxp::DtypeName::I32:
-            return array_to_torch_impl<int>(array);
+            return array_to_torch_impl(array, nb::dtype<int>());
+        case nxp::DtypeName::I8:
+            return array_to_torch_impl(array, nb::dtype<int8_t>());
         default:
-            return array_to_torch_impl<bool>(array);
+            return array_to_torch_impl(array, nb::dtype<bool>());
         }
     }
 
@@ -165,8 +217,14 @@ namespace nx::bind {
         switch (dtype->get_name()) {
         case nxp::DtypeName::F32:
             return nb::cast<float>(std::bit_cast<float>(static_cast<int32_t>(value)));
+        case nxp::DtypeName::F16:
+            return nb::cast<float>(nxp::f16_bits_to_f32(static_cast<uint16_t>(value)));
+        case nxp::DtypeName::BF16:
+            return nb::cast<float>(nxp::bf16_bits_to_f32(static_cast<uint16_t>(value)));
         case nxp::DtypeName::I32:
             return nb::cast<int>(value);
+        case nxp::DtypeName::I8:
+            return nb::cast<int>(static_cast<int8_t>(value));
         default:
             return nb::cast<bool>(value);
         }
@@ -256,10 +314,79 @@ namespace nx::bind {
         return binary(array, rhs, [](const auto &a, const auto &b) { return a.maximum(b); });
     }
 
+    nxc::Array pow(const nxc::Array &array, const nb::object &rhs) {
+        return binary(array, rhs, [](const auto &a, const auto &b) { return a.pow(b); });
+    }
+
+    nxc::Array fmod(const nxc::Array &array, const nb::object &rhs) {
+        return binary(array, rhs, [](const auto &a, const auto &b) { return a.fmod(b); });
+    }
+
+    nxc::Array bincount(const nxc::Array &x, nxp::isize num_bins, const nxc::Array *weight) {
+        return weight ? nxc::bincount_with_weight(x, *weight, num_bins) : nxc::bincount(x, num_bins);
+    }
+
+    nxc::Array histogram(const nxc::Array &x, nxp::isize num_bins, float min, float max, const nxc::Array *weight) {
+        return weight ? nxc::histogram_with_weight(x, *weight, num_bins, min, max) : nxc::histogram(x, num_bins, min, max);
+    }
+
+    nxc::Array where(const nxc::Array &cond, const nb::object &lhs, const nb::object &rhs) {
+        if (nb::isinstance<nxc::Array>(lhs)) {
+            return binary(nb::cast<nxc::Array>(lhs), rhs, [&](const auto &a, const auto &b) { return nxc::where(cond, a, b); });
+        } else if (nb::isinstance<nxc::Array>(rhs)) {
+            return binary(nb::cast<nxc::Array>(rhs), lhs, [&](const auto &b, const auto &a) { return nxc::where(cond, a, b); });
+        }
+
+        throw nxp::NanobindInvalidArgumentType("Array", get_class_name(lhs));
+    }
+
     nxc::Array slice(const nxc::Array &array, const nb::object &selector) {
         return array.slice(nxb::selector_to_ranges(array, selector));
     }
 
+    nxc::Array concat(const nxc::ArrayVector &arrays, nxp::isize dim) {
+        if (arrays.empty()) {
+            return nxc::concat(arrays, dim);
+        }
+
+        return nxc::concat(arrays, get_index(arrays[0].get_ndim(), dim));
+    }
+
+    nxc::Array stack(const nxc::ArrayVector &arrays, nxp::isize dim) {
+        if (arrays.empty()) {
+            return nxc::stack(arrays, dim);
+        }
+
+        // The new dimension can be placed after the last one
+        return nxc::stack(arrays, get_index(arrays[0].get_ndim() + 1, dim));
+    }
+
+    nxc::Array einsum(const std::string &spec, const nb::args &operands) {
+        nxc::ArrayVector arrays;
+
+        for (nb::handle operand : operands) {
+            if (!nb::isinstance<nxc::Array>(operand)) {
+                throw nxp::NanobindInvalidArgumentType("Array", get_class_name(nb::borrow(operand)));
+            }
+
+            arrays.push_back(nb::cast<nxc::Array>(operand));
+        }
+
+        return nxc::einsum(spec, arrays);
+    }
+
+    nxc::ArrayVector split(const nxc::Array &array, const nb::object &sections, nxp::isize dim) {
+        nxp::isize index = get_index(array.get_ndim(), dim);
+
+        if (nb::isinstance<nb::int_>(sections)) {
+            return nxc::split(array, nb::cast<nxp::isize>(sections), index);
+        } else if (nb::isinstance<nb::sequence>(sections) && !nb::isinstance<nb::str>(sections)) {
+            return nxc::split(array, nb::cast<nxp::ShapeView>(sections), index);
+        }
+
+        throw nxp::NanobindInvalidArgumentType("int, sequence", get_class_name(sections));
+    }
+
     nxc::Array permute(const nxc::Array &array, nxp::ShapeDims &dims) {
         return array.permute(get_indices(array.get_shape().get_ndim(), dims));
     }
@@ -280,12 +407,24 @@ namespace nx::bind {
         return array.unsqueeze(get_indices(array.get_shape().get_ndim(), dims));
     }
 
-    nxc::Array sum(const nxc::Array &array, nxp::ShapeDims &dims) {
-        return array.sum(get_indices(array.get_shape().get_ndim(), dims));
+    nxc::Array sum(const nxc::Array &array, nxp::ShapeDims &dims, bool precise) {
+        return array.sum(get_indices(array.get_shape().get_ndim(), dims), precise);
     }
 
-    nxc::Array mean(const nxc::Array &array, nxp::ShapeDims &dims) {
-        return array.mean(get_indices(array.get_shape().get_ndim(), dims));
+    nxc::Array mean(const nxc::Array &array, nxp::ShapeDims &dims, bool precise) {
+        return array.mean(get_indices(array.get_shape().get_ndim(), dims), precise);
+    }
+
+    nxc::Array var(const nxc::Array &array, nxp::ShapeDims &dims, float correction) {
+        return array.var(get_indices(array.get_shape().get_ndim(), dims), correction);
+    }
+
+    nxc::Array std_dev(const nxc::Array &array, nxp::ShapeDims &dims, float correction) {
+        return array.std(get_indices(array.get_shape().get_ndim(), dims), correction);
+    }
+
+    nxc::Array norm(const nxc::Array &array, nxp::ShapeDims &dims, nxp::NormOrd ord) {
+        return array.norm(get_indices(array.get_shape().get_ndim(), dims), ord);
     }
 
     nxc::Array max(const nxc::Array &array, nxp::ShapeDims &dims) {
@@ -303,4 +442,18 @@ namespace nx::bind {
     nxc::Array argmin(const nxc::Array &array, nxp::ShapeDims &dims) {
         return array.argmin(get_indices(array.get_shape().get_ndim(), dims));
     }
+
+    nxc::Array cumsum(const nxc::Array &array, nxp::isize dim) { return array.cumsum(get_index(array.get_shape().get_ndim(), dim)); }
+
+    nxc::Array cumprod(const nxc::Array &array, nxp::isize dim) { return array.cumprod(get_index(array.get_shape().get_ndim(), dim)); }
+
+    nxc::Array cummax(const nxc::Array &array, nxp::isize dim) { return array.cummax(get_index(array.get_shape().get_ndim(), dim)); }
+
+    nxc::Array sort(const nxc::Array &array, nxp::isize dim, bool descending) { return array.sort(get_index(array.get_shape().get_ndim(), dim), descending); }
+
+    nxc::Array argsort(const nxc::Array &array, nxp::isize dim, bool descending) { return array.argsort(get_index(array.get_shape().get_ndim(), dim), descending); }
+
+    std::pair<nxc::Array, nxc::Array> topk(const nxc::Array &array, nxp::isize k, nxp::isize dim, bool largest) {
+        return nxc::topk(array, k, get_index(array.get_shape().get_ndim(), dim), largest);
+    }
 } // namespace nx::bind
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include "bind.h"
 
 namespace nx::bind {
-    template <class T>
-    nb::ndarray<nb::numpy> array_to_numpy_impl(nxc::Array &array) {
+    // nanobind has no 16-bit float scalar types, the dlpack descriptors are built from their codes
+    inline const nb::dlpack::dtype nb_f16_dtype{static_cast<uint8_t>(nb::dlpack::dtype_code::Float), 16, 1};
+    inline const nb::dlpack::dtype nb_bf16_dtype{static_cast<uint8_t>(nb::dlpack::dtype_code::Bfloat), 16, 1};
+
+    inline nb::ndarray<nb::numpy> array_to_numpy_impl(nxc::Array &array, nb::dlpack::dtype dtype) {
         array.eval();
         nb::object pyarr = nb::find(array);
         std::vector<size_t> view(array.get_shape().begin(), array.get_shape().end());
@@ -15,14 +18,13 @@ namespace nx::bind {
             view.data(),
             pyarr.ptr(),
             array.get_stride().data(),
-            nb::dtype<T>(),
+            dtype,
             // Numpy can only run on the cpu
             nb::device::cpu::value,
             'C');
     }
 
-    template <class T>
-    nb::ndarray<nb::pytorch> array_to_torch_impl(nxc::Array &array) {
+    inline nb::ndarray<nb::pytorch> array_to_torch_impl(nxc::Array &array, nb::dlpack::dtype dtype) {
         array.eval();
         nb::object pyarr = nb::find(array);
         std::vector<size_t> view(array.get_shape().begin(), array.get_shape().end());
@@ -45,7 +47,7 @@ namespace nx::bind {
             view.data(),
             pyarr.ptr(),
             array.get_stride().data(),
-            nb::dtype<T>(),
+            dtype,
             device,
             'C');
     }
@@ -96,6 +98,8 @@ namespace nx::bind {
     nxc::Array array_from_numpy(nb::ndarray<nb::numpy> &ndarr);
     nb::ndarray<nb::pytorch> array_to_torch(nxc::Array &array);
     nb::object item(nxc::Array &array);
+    nxc::SparseArray sparse_from_scipy(const nb::object &matrix);
+    nb::object sparse_to_scipy(const nxc::SparseArray &sparse);
     nxc::Array full(const nxp::ShapeView &view, const nb::object &constant, nxp::DtypePtr dtype, const std::string &device_name = nxp::default_device_name);
     nxc::Array full_like(const nxc::Array &array, const nb::object &constant, nxp::DtypePtr dtype, const std::string &device_name = nxp::default_device_name);
     nxc::Array neg(const nxc::Array &array);
@@ -115,16 +119,34 @@ namespace nx::bind {
     nxc::Array geq(const nxc::Array &array, const nb::object &rhs);
     nxc::Array minimum(const nxc::Array &array, const nb::object &rhs);
     nxc::Array maximum(const nxc::Array &array, const nb::object &rhs);
+    nxc::Array bincount(const nxc::Array &x, nxp::isize num_bins, const nxc::Array *weight);
+    nxc::Array histogram(const nxc::Array &x, nxp::isize num_bins, float min, float max, const nxc::Array *weight);
+    nxc::Array pow(const nxc::Array &array, const nb::object &rhs);
+    nxc::Array fmod(const nxc::Array &array, const nb::object &rhs);
+    nxc::Array where(const nxc::Array &cond, const nb::object &lhs, const nb::object &rhs);
     nxc::Array slice(const nxc::Array &array, const nb::object &selector);
+    nxc::Array concat(const nxc::ArrayVector &arrays, nxp::isize dim);
+    nxc::Array stack(const nxc::ArrayVector &arrays, nxp::isize dim);
+    nxc::Array einsum(const std::string &spec, const nb::args &operands);
+    nxc::ArrayVector split(const nxc::Array &array, const nb::object &sections, nxp::isize dim);
     nxc::Array permute(const nxc::Array &array, nxp::ShapeDims &dims);
     nxc::Array transpose(const nxc::Array &array, nxp::isize start_dim, nxp::isize end_dim);
     nxc::Array flatten(const nxc::Array &array, nxp::isize start_dim, nxp::isize end_dim);
     nxc::Array squeeze(const nxc::Array &array, nxp::ShapeDims &dims);
     nxc::Array unsqueeze(const nxc::Array &array, nxp::ShapeDims &dims);
-    nxc::Array sum(const nxc::Array &array, nxp::ShapeDims &dims);
-    nxc::Array mean(const nxc::Array &array, nxp::ShapeDims &dims);
+    nxc::Array sum(const nxc::Array &array, nxp::ShapeDims &dims, bool precise);
+    nxc::Array mean(const nxc::Array &array, nxp::ShapeDims &dims, bool precise);
+    nxc::Array var(const nxc::Array &array, nxp::ShapeDims &dims, float correction);
+    nxc::Array std_dev(const nxc::Array &array, nxp::ShapeDims &dims, float correction);
+    nxc::Array norm(const nxc::Array &array, nxp::ShapeDims &dims, nxp::NormOrd ord);
     nxc::Array max(const nxc::Array &array, nxp::ShapeDims &dims);
     nxc::Array min(const nxc::Array &array, nxp::ShapeDims &dims);
     nxc::Array argmax(const nxc::Array &array, nxp::ShapeDims &dims);
     nxc::Array argmin(const nxc::Array &array, nxp::ShapeDims &dims);
+    nxc::Array cumsum(const nxc::Array &array, nxp::isize dim);
+    nxc::Array cumprod(const nxc::Array &array, nxp::isize dim);
+    nxc::Array cummax(const nxc::Array &array, nxp::isize dim);
+    nxc::Array sort(const nxc::Array &array, nxp::isize dim, bool descending);
+    nxc::Array argsort(const nxc::Array &array, nxp::isize dim, bool descending);
+    std::pair<nxc::Array, nxc::Array> topk(const nxc::Array &array, nxp::isize k, nxp::isize dim, bool largest);
 } // namespace nx::bind
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "bind.h"
+
+namespace nx::bind {
+    // Context manager holding the autocast guard between __enter__ and __exit__
+    class PyAutocast {
+    private:
+        nxp::DtypePtr m_dtype;
+        std::optional<nxp::AutocastGuard> m_guard;
+
+    public:
+        explicit PyAutocast(nxp::DtypePtr dtype) : m_dtype(dtype) {}
+        void enter() { m_guard.emplace(m_dtype); }
+        void exit(const nb::args &) { m_guard.reset(); }
+    };
+} // namespace nx::bind
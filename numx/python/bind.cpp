@@ -1,4 +1,5 @@
 #include "array.h"
+#include "autocast.h"
 #include "module.h"
 #include "optim.h"
 #include "random.h"
@@ -27,12 +28,18 @@ NB_MODULE(numx, m) {
 
     // Derived dtype classes
     nb::class_<nxp::F32, nxp::Dtype>(m_core, "F32", "32-bit floating point dtype");
+    nb::class_<nxp::F16, nxp::Dtype>(m_core, "F16", "16-bit floating point dtype");
+    nb::class_<nxp::BF16, nxp::Dtype>(m_core, "BF16", "16-bit brain floating point dtype");
     nb::class_<nxp::I32, nxp::Dtype>(m_core, "I32", "32-bit integer dtype");
+    nb::class_<nxp::I8, nxp::Dtype>(m_core, "I8", "8-bit integer storage dtype");
     nb::class_<nxp::BoolDtype, nxp::Dtype>(m_core, "Bool", "Boolean dtype");
 
     // Global dtype instances
     m_core.attr("f32") = &nxp::f32;
+    m_core.attr("f16") = &nxp::f16;
+    m_core.attr("bf16") = &nxp::bf16;
     m_core.attr("i32") = &nxp::i32;
+    m_core.attr("i8") = &nxp::i8;
     m_core.attr("b8") = &nxp::b8;
 
     // Shape class
@@ -55,6 +62,11 @@ NB_MODULE(numx, m) {
         .def_prop_ro("name", &nxp::Device::get_name, "Get device's name")
         .def("__str__", &nxp::Device::str, "String representation of device");
 
+    nb::enum_<nxp::NormOrd>(m_core, "NormOrd")
+        .value("L1", nxp::NormOrd::L1)
+        .value("L2", nxp::NormOrd::L2)
+        .value("LINF", nxp::NormOrd::LINF);
+
     // Array class
     nb::class_<nxc::Array>(m_core, "Array")
         // Properties
@@ -106,6 +118,13 @@ NB_MODULE(numx, m) {
         .def("neg", &nxc::Array::neg, "in_place"_a = false, "Compute negative of array elements")
         .def("__neg__", &nxb::neg, "Compute negative of array elements")
         .def("recip", &nxc::Array::recip, "in_place"_a = false, "Compute reciprocal of array elements")
+        .def("abs", &nxc::Array::abs, "in_place"_a = false, "Compute absolute value of array elements")
+        .def("__abs__", [](const nxc::Array &array) { return array.abs(); }, "Compute absolute value of array elements")
+        .def("sign", &nxc::Array::sign, "in_place"_a = false, "Compute sign of array elements")
+        .def("clamp", &nxc::Array::clamp, "min"_a = nb::none(), "max"_a = nb::none(), "Clamp array elements into the range [min, max]")
+        .def("pow", &nxb::pow, "rhs"_a, "Raise array elements to the given power element-wise")
+        .def("__pow__", &nxb::pow, "rhs"_a, "Raise array elements to the given power element-wise")
+        .def("fmod", &nxb::fmod, "rhs"_a, "Element-wise remainder with the sign of the dividend")
 
         // Comparison operations
         .def("__eq__", &nxb::eq, "rhs"_a, "Element-wise equality comparison")
@@ -118,13 +137,26 @@ NB_MODULE(numx, m) {
         .def("maximum", &nxb::maximum, "rhs"_a, "Element-wise maximum comparison")
 
         // Reduction operations
-        .def("sum", &nxb::sum, "dims"_a = nxp::ShapeDims{}, "Sum array elements along specified dimensions")
-        .def("mean", &nxb::mean, "dims"_a = nxp::ShapeDims{}, "Mean value along specified dimensions")
+        .def("sum", &nxb::sum, "dims"_a = nxp::ShapeDims{}, "precise"_a = false, "Sum array elements along specified dimensions, precise sums compensate the f32 accumulator")
+        .def("mean", &nxb::mean, "dims"_a = nxp::ShapeDims{}, "precise"_a = false, "Mean value along specified dimensions, precise means compensate the f32 accumulator")
+        .def("var", &nxb::var, "dims"_a = nxp::ShapeDims{}, "correction"_a = 1.0f, "Variance along specified dimensions in a single pass, divided by the number of elements minus the correction")
+        .def("std", &nxb::std_dev, "dims"_a = nxp::ShapeDims{}, "correction"_a = 1.0f, "Standard deviation along specified dimensions in a single pass, divided by the number of elements minus the correction")
+        .def("norm", &nxb::norm, "dims"_a = nxp::ShapeDims{}, "ord"_a = nxp::NormOrd::L2, "Vector norm along specified dimensions")
         .def("max", &nxb::max, "dims"_a = nxp::ShapeDims{}, "Maximum value along specified dimensions")
         .def("min", &nxb::min, "dims"_a = nxp::ShapeDims{}, "Minimum value along specified dimensions")
         .def("argmax", &nxb::argmax, "dims"_a = nxp::ShapeDims{}, "Indices of maximum values along specified dimensions")
         .def("argmin", &nxb::argmin, "dims"_a = nxp::ShapeDims{}, "Indices of minimum values along specified dimensions")
 
+        // Scan operations
+        .def("cumsum", &nxb::cumsum, "dim"_a, "Cumulative sum along specified dimension")
+        .def("cumprod", &nxb::cumprod, "dim"_a, "Cumulative product along specified dimension")
+        .def("cummax", &nxb::cummax, "dim"_a, "Cumulative maximum along specified dimension")
+
+        // Sorting operations
+        .def("sort", &nxb::sort, "dim"_a = -1, "descending"_a = false, "Sort array elements along specified dimension")
+        .def("argsort", &nxb::argsort, "dim"_a = -1, "descending"_a = false, "Indices that sort array elements along specified dimension")
+        .def("topk", &nxb::topk, "k"_a, "dim"_a = -1, "largest"_a = true, "Values and indices of the k largest or smallest elements along specified dimension")
+
         // Shape operations
         .def("broadcast", &nxc::Array::broadcast, "view"_a, "Broadcast array to new shape")
         .def("broadcast_to", &nxc::Array::broadcast_to, "view"_a, "Broadcast array to target shape")
@@ -153,17 +185,112 @@ NB_MODULE(numx, m) {
         .def("arange", &nxc::arange, "view"_a, "start"_a, "step"_a, "dtype"_a = &nxp::f32, "device"_a = nxp::default_device_name, "Create a new array with evenly spaced values")
         .def("zeros_like", &nxc::zeros_like, "array"_a, "dtype"_a = &nxp::f32, "device"_a = nxp::default_device_name, "Create a new array of zeros with same shape as input")
         .def("ones_like", &nxc::ones_like, "array"_a, "dtype"_a = &nxp::f32, "device"_a = nxp::default_device_name, "Create a new array of ones with same shape as input")
-        .def("from_numpy", &nxb::array_from_numpy, "array"_a, "Convert numpy array to array");
+        .def("from_numpy", &nxb::array_from_numpy, "array"_a, "Convert numpy array to array")
+        .def("where", &nxb::where, "cond"_a, "x"_a, "y"_a, "Select elements from x where cond is true and from y otherwise")
+        .def("concat", &nxb::concat, "arrays"_a, "dim"_a = 0, "Concatenate arrays along an existing dimension")
+        .def("stack", &nxb::stack, "arrays"_a, "dim"_a = 0, "Stack arrays along a new dimension")
+        .def("split", &nxb::split, "array"_a, "sections"_a, "dim"_a = 0, "Split array into views of the given section size or sizes")
+        .def("einsum", &nxb::einsum, "spec"_a, "operands"_a, "Einstein summation contracted pairwise along a cost-optimized path with batched matmuls")
+        .def("einsum_path", &nxc::einsum_path, "spec"_a, "shapes"_a, "Pairwise contraction path of an einsum, every step appends its result after the operands")
+        .def("rfft", &nxc::rfft, "x"_a, "n"_a = nb::none(), "Real FFT of the last dimension cropped or zero padded to n, real and imaginary parts in a trailing dimension of 2")
+        .def("irfft", &nxc::irfft, "x"_a, "n"_a = nb::none(), "Inverse real FFT to a signal of size n, 2 * (bins - 1) by default")
+        .def("bincount", &nxb::bincount, "x"_a, "num_bins"_a, "weight"_a = nb::none(), "Count occurrences of integer values in [0, num_bins), optionally weighted")
+        .def("histogram", &nxb::histogram, "x"_a, "num_bins"_a, "min"_a, "max"_a, "weight"_a = nb::none(), "Count values into equal-width bins over [min, max], optionally weighted");
+
+    nb::class_<nxb::PyAutocast>(m_core, "autocast")
+        .def(nb::init<nxp::DtypePtr>(), "dtype"_a = &nxp::bf16, "Run matmuls, convolutions and arithmetic in low precision within the context")
+        .def("__enter__", &nxb::PyAutocast::enter, "Enable autocast")
+        .def("__exit__", &nxb::PyAutocast::exit, "Restore the previous autocast dtype");
+
+    nb::enum_<nxp::SparseFormat>(m_core, "SparseFormat")
+        .value("CSR", nxp::SparseFormat::CSR)
+        .value("COO", nxp::SparseFormat::COO);
+
+    nb::class_<nxc::SparseArray>(m_core, "SparseArray")
+        .def_prop_ro("format", &nxc::SparseArray::get_format, "Get sparse array's format")
+        .def_prop_ro("shape", &nxc::SparseArray::get_view, "Get sparse array's shape")
+        .def_prop_ro("nnz", &nxc::SparseArray::get_nnz, "Get number of nonzeros")
+        .def_prop_ro("density", &nxc::SparseArray::get_density, "Get fraction of nonzeros")
+        .def_prop_ro("rows", &nxc::SparseArray::get_rows, "Get row offsets for CSR or row indices for COO")
+        .def_prop_ro("cols", &nxc::SparseArray::get_cols, "Get column indices")
+        .def_prop_ro("values", &nxc::SparseArray::get_values, "Get nonzero values")
+        .def("matmul", &nxc::SparseArray::matmul, "dense"_a, "transposed"_a = false, "Multiply sparse array or its transpose with a dense 2D array")
+        .def("__matmul__", [](const nxc::SparseArray &sparse, const nxc::Array &dense) { return sparse.matmul(dense); }, "dense"_a, "Multiply sparse array with a dense 2D array")
+        .def("mul", &nxc::SparseArray::mul, "dense"_a, "Multiply nonzeros with the dense array elements at the same positions")
+        .def("__mul__", &nxc::SparseArray::mul, "dense"_a, "Multiply nonzeros with the dense array elements at the same positions")
+        .def("to_dense", &nxc::SparseArray::to_dense, "Convert sparse array to a dense array")
+        .def("scipy", &nxb::sparse_to_scipy, "Convert sparse array to a scipy sparse matrix sharing its memory");
+
+    m_core.def("sparse_csr", &nxc::sparse_csr, "indptr"_a, "indices"_a, "values"_a, "shape"_a, "Create a CSR sparse array from i32 row offsets and column indices and f32 values")
+        .def("sparse_coo", &nxc::sparse_coo, "rows"_a, "cols"_a, "values"_a, "shape"_a, "Create a COO sparse array from i32 row and column indices and f32 values")
+        .def("from_scipy", &nxb::sparse_from_scipy, "matrix"_a, "Convert a scipy CSR or COO matrix with int32 indices and float32 data to a sparse array sharing its memory");
+
+    nb::class_<nxc::BitMask>(m_core, "BitMask")
+        .def_prop_ro("shape", &nxc::BitMask::get_view, "Get mask's shape")
+        .def_prop_ro("words", &nxc::BitMask::get_words, "Get i32 words holding 32 elements each along the last dimension")
+        .def_prop_ro("nbytes", &nxc::BitMask::get_nbytes, "Get number of bytes of the packed words")
+        .def("count", &nxc::BitMask::count, "Count set elements")
+        .def("count_rows", &nxc::BitMask::count_rows, "Count set elements of every row along the last dimension")
+        .def("where", &nxc::BitMask::where, "lhs"_a, "rhs"_a, "Select lhs where the mask is set and rhs elsewhere")
+        .def("masked_fill", &nxc::BitMask::masked_fill<float>, "x"_a, "value"_a, "Replace elements of x where the mask is set with a value")
+        .def("to_bool", &nxc::BitMask::to_bool, "Unpack mask to a b8 array");
+
+    m_core.def("pack_bits", &nxc::pack_bits, "x"_a, "Pack a b8 array into a bit mask")
+        .def("eq_bits", &nxc::eq_bits, "lhs"_a, "rhs"_a, "Compare for equality into a bit mask")
+        .def("neq_bits", &nxc::neq_bits, "lhs"_a, "rhs"_a, "Compare for inequality into a bit mask")
+        .def("lt_bits", &nxc::lt_bits, "lhs"_a, "rhs"_a, "Compare for less than into a bit mask")
+        .def("gt_bits", &nxc::gt_bits, "lhs"_a, "rhs"_a, "Compare for greater than into a bit mask")
+        .def("leq_bits", &nxc::leq_bits, "lhs"_a, "rhs"_a, "Compare for less than or equal into a bit mask")
+        .def("geq_bits", &nxc::geq_bits, "lhs"_a, "rhs"_a, "Compare for greater than or equal into a bit mask");
 
     m_random.def("uniform", &nxb::uniform, "view"_a, "low"_a = 0.0, "high"_a = 1.0, "dtype"_a = &nxp::f32, "device"_a = nxp::default_device_name, "Create a new array with random values from a uniform distribution")
         .def("normal", &nxb::normal, "view"_a, "mean"_a = 0.0, "std"_a = 1.0, "dtype"_a = &nxp::f32, "device"_a = nxp::default_device_name, "Create a new array with random values from a normal distribution")
         .def("kaiming_uniform", &nxr::kaiming_uniform, "view"_a, "dtype"_a = &nxp::f32, "device"_a = nxp::default_device_name, "Create a new array with random values from a Kaiming uniform distribution")
         .def("randint", &nxb::randint, "view"_a, "low"_a = 0, "high"_a = 10, "dtype"_a = &nxp::i32, "device"_a = nxp::default_device_name, "Create a new array with random integer values from a uniform distribution")
-        .def("randbool", &nxb::randbool, "view"_a, "device"_a = nxp::default_device_name, "Create a new array with uniformly distributed random boolean values");
+        .def("randbool", &nxb::randbool, "view"_a, "device"_a = nxp::default_device_name, "Create a new array with uniformly distributed random boolean values")
+        .def("multinomial", &nxr::multinomial, "x"_a, "num_samples"_a = 1, "logits"_a = false, "temperature"_a = 1.0f, "top_k"_a = 0, "top_p"_a = 1.0f, "Sample indices over the last dimension from logits or unnormalized probabilities");
 
     m_nn.def("linear", &nxn::linear, "x"_a, "weight"_a, "Functional linear without bias");
     m_nn.def("linear_with_bias", &nxn::linear_with_bias, "x"_a, "weight"_a, "bias"_a, "Functional linear with bias");
+    nb::enum_<nxp::ConvLayout>(m_nn, "ConvLayout")
+        .value("NCHW", nxp::ConvLayout::NCHW)
+        .value("NHWC", nxp::ConvLayout::NHWC);
+
+    m_nn.def("conv2d", &nxn::conv2d, "x"_a, "weight"_a, "stride"_a = nxp::ShapeView{1, 1}, "padding"_a = nxp::ShapeView{0, 0}, "dilation"_a = nxp::ShapeView{1, 1}, "layout"_a = nxp::ConvLayout::NCHW, "Functional 2D convolution without bias");
+    m_nn.def("conv2d_with_bias", &nxn::conv2d_with_bias, "x"_a, "weight"_a, "bias"_a, "stride"_a = nxp::ShapeView{1, 1}, "padding"_a = nxp::ShapeView{0, 0}, "dilation"_a = nxp::ShapeView{1, 1}, "layout"_a = nxp::ConvLayout::NCHW, "Functional 2D convolution with bias");
+    m_nn.def("fft_conv1d", &nxn::fft_conv1d, "x"_a, "weight"_a, "padding"_a = 0, "use_fft"_a = nb::none(), "Functional 1D convolution through FFTs for long kernels and direct convolution otherwise");
+    m_nn.def("max_pool2d", &nxn::max_pool2d, "x"_a, "kernel_size"_a, "stride"_a = nxp::ShapeView{}, "padding"_a = nxp::ShapeView{0, 0}, "layout"_a = nxp::ConvLayout::NCHW, "Functional 2D max pooling");
+    m_nn.def("avg_pool2d", &nxn::avg_pool2d, "x"_a, "kernel_size"_a, "stride"_a = nxp::ShapeView{}, "padding"_a = nxp::ShapeView{0, 0}, "layout"_a = nxp::ConvLayout::NCHW, "Functional 2D average pooling");
+    m_nn.def("adaptive_avg_pool2d", &nxn::adaptive_avg_pool2d, "x"_a, "output_size"_a, "layout"_a = nxp::ConvLayout::NCHW, "Functional 2D adaptive average pooling");
+    m_nn.def("dropout", &nxn::dropout, "x"_a, "p"_a = 0.5f, "training"_a = true, "Functional dropout with the mask regenerated in backward");
+    m_nn.def("layer_norm", &nxn::layer_norm, "x"_a, "weight"_a, "bias"_a, "eps"_a = 1e-5f, "Functional layer normalization over the last dimension");
+    m_nn.def("rms_norm", &nxn::rms_norm, "x"_a, "weight"_a, "eps"_a = 1e-6f, "Functional RMS normalization over the last dimension");
+    m_nn.def("batch_norm", &nxn::batch_norm, "x"_a, "weight"_a, "bias"_a, "running_mean"_a, "running_var"_a, "training"_a, "momentum"_a = 0.1f, "eps"_a = 1e-5f, "layout"_a = nxp::ConvLayout::NCHW, "Functional batch normalization over the channel dimension");
+    m_nn.def("scaled_dot_product_attention", &nxn::scaled_dot_product_attention, "q"_a, "k"_a, "v"_a, "causal"_a = false, "scale"_a = nb::none(), "Fused scaled dot-product attention over the last two dimensions");
+    m_nn.def("lstm_cell", &nxn::lstm_cell, "x"_a, "h"_a, "c"_a, "weight_ih"_a, "weight_hh"_a, "bias_ih"_a, "bias_hh"_a, "Fused LSTM step with gate-packed weights, returns the next hidden and cell states");
+    m_nn.def("gru_cell", &nxn::gru_cell, "x"_a, "h"_a, "weight_ih"_a, "weight_hh"_a, "bias_ih"_a, "bias_hh"_a, "Fused GRU step with gate-packed weights, returns the next hidden state");
+    m_nn.def("lstm", &nxn::lstm, "x"_a, "h0"_a, "c0"_a, "weight_ih"_a, "weight_hh"_a, "bias_ih"_a, "bias_hh"_a, "LSTM over a (steps, batch, input) sequence in one kernel, returns all hidden states and the final hidden and cell states");
+    m_nn.def("gru", &nxn::gru, "x"_a, "h0"_a, "weight_ih"_a, "weight_hh"_a, "bias_ih"_a, "bias_hh"_a, "GRU over a (steps, batch, input) sequence in one kernel, returns all hidden states and the final hidden state");
+    m_nn.def("fold_batch_norm", nb::overload_cast<nxn::Linear &, nxn::BatchNorm &>(&nxn::fold_batch_norm), "linear"_a, "bn"_a, "Fold inference batch normalization into the preceding linear layer");
+    m_nn.def("fold_batch_norm", nb::overload_cast<nxn::Conv2d &, nxn::BatchNorm &>(&nxn::fold_batch_norm), "conv"_a, "bn"_a, "Fold inference batch normalization into the preceding convolution layer");
+    nb::enum_<nxp::QuantizedActivation>(m_nn, "QuantizedActivation")
+        .value("NONE", nxp::QuantizedActivation::NONE)
+        .value("RELU", nxp::QuantizedActivation::RELU)
+        .value("GELU", nxp::QuantizedActivation::GELU)
+        .value("SILU", nxp::QuantizedActivation::SILU);
+
+    m_nn.def("quantize", &nxn::quantize, "x"_a, "clip"_a = 0.0f, "Symmetric int8 quantization over the last dimension, returns the quantized array and its per-row scales");
+    m_nn.def("quantized_linear", &nxn::quantized_linear, "x"_a, "weight"_a, "weight_scale"_a, "activation"_a = nxp::QuantizedActivation::NONE, "clip"_a = 0.0f, "Functional int8 linear without bias, activations are quantized per row on the fly");
+    m_nn.def("quantized_linear_with_bias", &nxn::quantized_linear_with_bias, "x"_a, "weight"_a, "weight_scale"_a, "bias"_a, "activation"_a = nxp::QuantizedActivation::NONE, "clip"_a = 0.0f, "Functional int8 linear with bias, activations are quantized per row on the fly");
+    m_nn.def("block_sparsify", &nxn::block_sparsify, "weight"_a, "block_rows"_a = 16, "block_cols"_a = 16, "threshold"_a = 0.0f, "Pack the weight blocks with any element above the threshold, returns block row offsets, block columns and packed blocks");
+    m_nn.def("block_sparse_linear", &nxn::block_sparse_linear, "x"_a, "block_ptr"_a, "block_col"_a, "block_values"_a, "in_features"_a, "Functional block-sparse linear without bias");
+    m_nn.def("block_sparse_linear_with_bias", &nxn::block_sparse_linear_with_bias, "x"_a, "block_ptr"_a, "block_col"_a, "block_values"_a, "bias"_a, "in_features"_a, "Functional block-sparse linear with bias");
     m_nn.def("relu", &nxn::relu, "x"_a, "ReLU activation function");
+    m_nn.def("sigmoid", &nxn::sigmoid, "x"_a, "Sigmoid activation function");
+    m_nn.def("tanh", &nxn::tanh, "x"_a, "Tanh activation function");
+    m_nn.def("gelu", &nxn::gelu, "x"_a, "approximate"_a = false, "GELU activation function, approximated with tanh if approximate is true");
+    m_nn.def("silu", &nxn::silu, "x"_a, "SiLU activation function");
+    m_nn.def("softplus", &nxn::softplus, "x"_a, "Softplus activation function");
     m_nn.def("onehot", &nxn::onehot, "x"_a, "num_classes"_a = -1, "One-hot encode input array");
     m_nn.def("softmax", &nxn::softmax, "x"_a, "dim"_a = -1, "Compute softmax for input array");
     m_nn.def("cross_entropy_loss", &nxn::cross_entropy_loss, "x"_a, "y"_a, "Compute cross-entropy loss between input x and target y");
@@ -178,6 +305,9 @@ NB_MODULE(numx, m) {
         // Tell Python not to free the objects in vector since they are pointers to valid objects inside Module
         // and Python does not know how to free it any way
         .def("parameters", &nxn::Module::get_parameters, nb::rv_policy::reference_internal, "Get module parameters")
+        .def("train", &nxn::Module::train, "mode"_a = true, "Set module to training or inference mode")
+        .def("eval", &nxn::Module::eval, "Set module to inference mode")
+        .def_prop_ro("training", &nxn::Module::is_training, "Whether module is in training mode")
         .def("forward", &nxn::Module::forward, "x"_a, "Forward pass through module")
         .def("__call__", &nxn::Module::operator(), "x"_a, "Forward pass through module");
 
@@ -186,14 +316,112 @@ NB_MODULE(numx, m) {
         .def_prop_ro("weight", &nxn::Linear::get_weight, "Get linear layer weight")
         .def_prop_ro("bias", &nxn::Linear::get_bias, "Get linear layer bias");
 
+    nb::class_<nxn::AbsMaxObserver>(m_nn, "AbsMaxObserver")
+        .def(nb::init(), "Calibration observer of the largest absolute activation")
+        .def("observe", &nxn::AbsMaxObserver::observe, "x"_a, "Observe a calibration batch")
+        .def("reset", &nxn::AbsMaxObserver::reset, "Forget observed batches")
+        .def_prop_ro("absmax", &nxn::AbsMaxObserver::get_absmax, "Get the largest absolute value observed so far");
+
+    nb::class_<nxn::QuantizedLinear, nxn::Module>(m_nn, "QuantizedLinear")
+        .def(nb::init<nxn::Linear &, nxp::QuantizedActivation, float>(), "linear"_a, "activation"_a = nxp::QuantizedActivation::NONE, "clip"_a = 0.0f, "Inference-only int8 linear layer with per-output-channel weight scales")
+        .def_prop_ro("weight", &nxn::QuantizedLinear::get_weight, "Get int8 weight")
+        .def_prop_ro("weight_scale", &nxn::QuantizedLinear::get_weight_scale, "Get per-output-channel weight scales")
+        .def_prop_ro("activation", &nxn::QuantizedLinear::get_activation, "Get fused activation")
+        .def_prop_ro("clip", &nxn::QuantizedLinear::get_clip, "Get activation clipping range");
+
+    nb::class_<nxn::BlockSparseLinear, nxn::Module>(m_nn, "BlockSparseLinear")
+        .def(nb::init<nxn::Linear &, nxc::isize, nxc::isize, float>(), "linear"_a, "block_rows"_a = 16, "block_cols"_a = 16, "threshold"_a = 0.0f, "Inference-only linear layer that skips pruned weight blocks")
+        .def_prop_ro("block_ptr", &nxn::BlockSparseLinear::get_block_ptr, "Get offsets of every block row into the packed blocks")
+        .def_prop_ro("block_col", &nxn::BlockSparseLinear::get_block_col, "Get block column of every packed block")
+        .def_prop_ro("block_values", &nxn::BlockSparseLinear::get_block_values, "Get packed blocks")
+        .def_prop_ro("block_rows", &nxn::BlockSparseLinear::get_block_rows, "Get number of rows of a block")
+        .def_prop_ro("block_cols", &nxn::BlockSparseLinear::get_block_cols, "Get number of columns of a block")
+        .def_prop_ro("density", &nxn::BlockSparseLinear::get_density, "Get fraction of weights kept in packed blocks");
+
+    nb::class_<nxn::Conv2d, nxn::Module>(m_nn, "Conv2d")
+        .def(nb::init<nxc::isize, nxc::isize, const nxp::ShapeView &, const nxp::ShapeView &, const nxp::ShapeView &, const nxp::ShapeView &, bool, nxp::ConvLayout>(), "in_channels"_a, "out_channels"_a, "kernel_size"_a, "stride"_a = nxp::ShapeView{1, 1}, "padding"_a = nxp::ShapeView{0, 0}, "dilation"_a = nxp::ShapeView{1, 1}, "bias"_a = true, "layout"_a = nxp::ConvLayout::NCHW, "2D convolution layer")
+        .def_prop_ro("weight", &nxn::Conv2d::get_weight, "Get convolution layer weight")
+        .def_prop_ro("bias", &nxn::Conv2d::get_bias, "Get convolution layer bias");
+
+    nb::class_<nxn::MaxPool2d, nxn::Module>(m_nn, "MaxPool2d")
+        .def(nb::init<const nxp::ShapeView &, const nxp::ShapeView &, const nxp::ShapeView &, nxp::ConvLayout>(), "kernel_size"_a, "stride"_a = nxp::ShapeView{}, "padding"_a = nxp::ShapeView{0, 0}, "layout"_a = nxp::ConvLayout::NCHW, "2D max pooling layer");
+
+    nb::class_<nxn::AvgPool2d, nxn::Module>(m_nn, "AvgPool2d")
+        .def(nb::init<const nxp::ShapeView &, const nxp::ShapeView &, const nxp::ShapeView &, nxp::ConvLayout>(), "kernel_size"_a, "stride"_a = nxp::ShapeView{}, "padding"_a = nxp::ShapeView{0, 0}, "layout"_a = nxp::ConvLayout::NCHW, "2D average pooling layer");
+
+    nb::class_<nxn::AdaptiveAvgPool2d, nxn::Module>(m_nn, "AdaptiveAvgPool2d")
+        .def(nb::init<const nxp::ShapeView &, nxp::ConvLayout>(), "output_size"_a, "layout"_a = nxp::ConvLayout::NCHW, "2D adaptive average pooling layer");
+
+    nb::class_<nxn::Dropout, nxn::Module>(m_nn, "Dropout")
+        .def(nb::init<float>(), "p"_a = 0.5f, "Dropout layer")
+        .def_prop_ro("p", &nxn::Dropout::get_p, "Get dropout probability");
+
+    nb::class_<nxn::LayerNorm, nxn::Module>(m_nn, "LayerNorm")
+        .def(nb::init<nxc::isize, float>(), "normalized_size"_a, "eps"_a = 1e-5f, "Layer normalization layer")
+        .def_prop_ro("weight", &nxn::LayerNorm::get_weight, "Get layer normalization weight")
+        .def_prop_ro("bias", &nxn::LayerNorm::get_bias, "Get layer normalization bias");
+
+    nb::class_<nxn::RMSNorm, nxn::Module>(m_nn, "RMSNorm")
+        .def(nb::init<nxc::isize, float>(), "normalized_size"_a, "eps"_a = 1e-6f, "RMS normalization layer")
+        .def_prop_ro("weight", &nxn::RMSNorm::get_weight, "Get RMS normalization weight");
+
+    nb::class_<nxn::BatchNorm, nxn::Module>(m_nn, "BatchNorm")
+        .def(nb::init<nxc::isize, float, float, nxp::ConvLayout>(), "num_features"_a, "momentum"_a = 0.1f, "eps"_a = 1e-5f, "layout"_a = nxp::ConvLayout::NCHW, "Batch normalization layer")
+        .def_prop_ro("weight", &nxn::BatchNorm::get_weight, "Get batch normalization weight")
+        .def_prop_ro("bias", &nxn::BatchNorm::get_bias, "Get batch normalization bias")
+        .def_prop_ro("running_mean", &nxn::BatchNorm::get_running_mean, "Get batch normalization running mean")
+        .def_prop_ro("running_var", &nxn::BatchNorm::get_running_var, "Get batch normalization running variance")
+        .def_prop_ro("folded", &nxn::BatchNorm::is_folded, "Whether batch normalization was folded into the preceding layer");
+
+    nb::class_<nxn::RecurrentModule, nxn::Module>(m_nn, "RecurrentModule")
+        .def_prop_ro("hidden_size", &nxn::RecurrentModule::get_hidden_size, "Get recurrent layer hidden size")
+        .def_prop_ro("weight_ih", &nxn::RecurrentModule::get_weight_ih, "Get gate-packed input weight")
+        .def_prop_ro("weight_hh", &nxn::RecurrentModule::get_weight_hh, "Get gate-packed hidden weight")
+        .def_prop_ro("bias_ih", &nxn::RecurrentModule::get_bias_ih, "Get gate-packed input bias")
+        .def_prop_ro("bias_hh", &nxn::RecurrentModule::get_bias_hh, "Get gate-packed hidden bias");
+
+    nb::class_<nxn::LSTMCell, nxn::RecurrentModule>(m_nn, "LSTMCell")
+        .def(nb::init<nxc::isize, nxc::isize>(), "input_size"_a, "hidden_size"_a, "LSTM cell layer")
+        .def("forward", nb::overload_cast<const nxc::Array &>(&nxn::LSTMCell::forward), "x"_a, "Next hidden state from zero states")
+        .def("forward", nb::overload_cast<const nxc::Array &, const nxc::Array &, const nxc::Array &>(&nxn::LSTMCell::forward), "x"_a, "h"_a, "c"_a, "Next hidden and cell states")
+        .def("__call__", nb::overload_cast<const nxc::Array &>(&nxn::LSTMCell::forward), "x"_a, "Next hidden state from zero states")
+        .def("__call__", nb::overload_cast<const nxc::Array &, const nxc::Array &, const nxc::Array &>(&nxn::LSTMCell::forward), "x"_a, "h"_a, "c"_a, "Next hidden and cell states");
+
+    nb::class_<nxn::GRUCell, nxn::RecurrentModule>(m_nn, "GRUCell")
+        .def(nb::init<nxc::isize, nxc::isize>(), "input_size"_a, "hidden_size"_a, "GRU cell layer")
+        .def("forward", nb::overload_cast<const nxc::Array &>(&nxn::GRUCell::forward), "x"_a, "Next hidden state from a zero state")
+        .def("forward", nb::overload_cast<const nxc::Array &, const nxc::Array &>(&nxn::GRUCell::forward), "x"_a, "h"_a, "Next hidden state")
+        .def("__call__", nb::overload_cast<const nxc::Array &>(&nxn::GRUCell::forward), "x"_a, "Next hidden state from a zero state")
+        .def("__call__", nb::overload_cast<const nxc::Array &, const nxc::Array &>(&nxn::GRUCell::forward), "x"_a, "h"_a, "Next hidden state");
+
+    nb::class_<nxn::LSTM, nxn::RecurrentModule>(m_nn, "LSTM")
+        .def(nb::init<nxc::isize, nxc::isize>(), "input_size"_a, "hidden_size"_a, "LSTM layer over (steps, batch, input) sequences")
+        .def("forward", nb::overload_cast<const nxc::Array &>(&nxn::LSTM::forward), "x"_a, "Hidden states of every step from zero states")
+        .def("forward", nb::overload_cast<const nxc::Array &, const nxc::Array &, const nxc::Array &>(&nxn::LSTM::forward), "x"_a, "h0"_a, "c0"_a, "Hidden states of every step and the final hidden and cell states")
+        .def("__call__", nb::overload_cast<const nxc::Array &>(&nxn::LSTM::forward), "x"_a, "Hidden states of every step from zero states")
+        .def("__call__", nb::overload_cast<const nxc::Array &, const nxc::Array &, const nxc::Array &>(&nxn::LSTM::forward), "x"_a, "h0"_a, "c0"_a, "Hidden states of every step and the final hidden and cell states");
+
+    nb::class_<nxn::GRU, nxn::RecurrentModule>(m_nn, "GRU")
+        .def(nb::init<nxc::isize, nxc::isize>(), "input_size"_a, "hidden_size"_a, "GRU layer over (steps, batch, input) sequences")
+        .def("forward", nb::overload_cast<const nxc::Array &>(&nxn::GRU::forward), "x"_a, "Hidden states of every step from a zero state")
+        .def("forward", nb::overload_cast<const nxc::Array &, const nxc::Array &>(&nxn::GRU::forward), "x"_a, "h0"_a, "Hidden states of every step and the final hidden state")
+        .def("__call__", nb::overload_cast<const nxc::Array &>(&nxn::GRU::forward), "x"_a, "Hidden states of every step from a zero state")
+        .def("__call__", nb::overload_cast<const nxc::Array &, const nxc::Array &>(&nxn::GRU::forward), "x"_a, "h0"_a, "Hidden states of every step and the final hidden state");
+
     nb::class_<nxo::Optimizer, nxb::PyOptimizer>(m_optim, "Optimizer")
         .def(nb::init<float>(), "lr"_a = 1e-3, "Base optimizer")
         .def("forward", &nxo::Optimizer::forward, "Parameters update function")
-        .def("update", &nxo::Optimizer::update, "params"_a, "Update module parameters");
+        .def("update", &nxo::Optimizer::update, "params"_a, "grad_scale"_a = 1.0f, "Update module parameters");
 
     nb::class_<nxo::GradientDescent, nxo::Optimizer>(m_optim, "GradientDescent")
         .def(nb::init<float>(), "lr"_a = 1e-3, "Gradient Descent optimizer");
 
+    nb::class_<nxo::GradScaler>(m_optim, "GradScaler")
+        .def(nb::init<float, float, float, nxc::isize>(), "init_scale"_a = 65536.0f, "growth_factor"_a = 2.0f, "backoff_factor"_a = 0.5f, "growth_interval"_a = 2000, "Dynamic loss scaler for low-precision training")
+        .def_prop_ro("scale_factor", &nxo::GradScaler::get_scale, "Get current loss scale")
+        .def("scale", &nxo::GradScaler::scale, "loss"_a, "Multiply loss by the current scale")
+        .def("step", &nxo::GradScaler::step, "optimizer"_a, "params"_a, "Unscale gradients and update parameters unless any is inf or nan, returns whether the step was taken");
+
     m_profiler.def("enable_memory_profile", &nxf::enable_memory_profile, "Enable memory profiling");
     m_profiler.def("enable_device_memory_profile", &nxf::enable_device_memory_profile, "device_name"_a, "Enable device memory profiling");
     m_profiler.def("disable_memory_profile", &nxf::disable_memory_profile, "Disable memory profiling");
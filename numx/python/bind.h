@@ -1,6 +1,16 @@
 #pragma once
 
+#include "../core/bitmask.h"
+#include "../core/einsum.h"
+#include "../core/sparse.h"
+#include "../nn/block_sparse.h"
+#include "../nn/conv.h"
+#include "../nn/dropout.h"
 #include "../nn/linear.h"
+#include "../nn/norm.h"
+#include "../nn/pool.h"
+#include "../nn/quantized.h"
+#include "../nn/rnn.h"
 #include "../optim/optim.h"
 #include "../profiler/profiler.h"
 #include "../random/random.h"
@@ -8,8 +18,10 @@
 #include <nanobind/ndarray.h>
 #include <nanobind/operators.h>
 #include <nanobind/stl/optional.h>
+#include <nanobind/stl/pair.h>
 #include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/tuple.h>
 #include <nanobind/stl/vector.h>
 #include <nanobind/trampoline.h>
 
@@ -56,4 +56,10 @@ namespace nx::random {
         // TODO: change i32 to something else?
         return randint<int>(view, 0, 2, &i32, device_name).astype(&b8);
     }
+
+    // Samples indices over the last dimension with replacement, x holds logits or unnormalized probabilities
+    inline Array multinomial(const Array &x, isize num_samples = 1, bool logits = false, float temperature = 1.0f, isize top_k = 0, float top_p = 1.0f) {
+        uint64_t key = get_random_key_generator(x.get_data().get_device_name())->next();
+        return Array(nx::graph::multinomial(x.get_op(), key, num_samples, temperature, top_k, top_p, logits));
+    }
 } // namespace nx::random
\ No newline at end of file
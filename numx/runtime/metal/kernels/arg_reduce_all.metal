@@ -13,9 +13,10 @@ kernel void arg_reduce_all(
     uint simd_group_id [[simdgroup_index_in_threadgroup]])
 {
     Op op;
-    T default_val = input[offset[0]];
-    IndexValPair<T> best_pair = gid < numel ? IndexValPair<T>{input[offset[0] + gid], gid} : IndexValPair<T>{default_val, 0};
-    threadgroup IndexValPair<T> ldata[simd_size];
+    using A = acc_t<T>;
+    A default_val = static_cast<A>(input[offset[0]]);
+    IndexValPair<A> best_pair = gid < numel ? IndexValPair<A>{static_cast<A>(input[offset[0] + gid]), gid} : IndexValPair<A>{default_val, 0};
+    threadgroup IndexValPair<A> ldata[simd_size];
     // Perform per-SIMD partial reduction -> shuffling within SIMD group.
     // Each thread gets the value from another thread offset lanes above it.
     best_pair = arg_simd_reduce(op, best_pair);
@@ -27,7 +28,7 @@ kernel void arg_reduce_all(
         }
         // Wait for all partial reductions to complete.
         threadgroup_barrier(metal::mem_flags::mem_threadgroup);
-        best_pair = (lid < simd_per_group) ? ldata[lid] : IndexValPair<T>{default_val, 0};
+        best_pair = (lid < simd_per_group) ? ldata[lid] : IndexValPair<A>{default_val, 0};
         // Perform final per-SIMD partial reduction to calculate the threadgroup partial reduction result.
         best_pair = arg_simd_reduce(op, best_pair);
     }
@@ -53,9 +54,10 @@ kernel void strided_arg_reduce_all(
     uint simd_group_id [[simdgroup_index_in_threadgroup]])
 {
     Op op;
-    T default_val = input[offset[0]];
-    IndexValPair<T> best_pair = gid < numel ? IndexValPair<T>{input[offset[0] + get_elm_loc(gid, ndim, shape, stride)], gid} : IndexValPair<T>{default_val, 0};
-    threadgroup IndexValPair<T> ldata[simd_size];
+    using A = acc_t<T>;
+    A default_val = static_cast<A>(input[offset[0]]);
+    IndexValPair<A> best_pair = gid < numel ? IndexValPair<A>{static_cast<A>(input[offset[0] + get_elm_loc(gid, ndim, shape, stride)]), gid} : IndexValPair<A>{default_val, 0};
+    threadgroup IndexValPair<A> ldata[simd_size];
     // Perform per-SIMD partial reduction -> shuffling within SIMD group.
     // Each thread gets the value from another thread offset lanes above it.
     best_pair = arg_simd_reduce(op, best_pair);
@@ -67,7 +69,7 @@ kernel void strided_arg_reduce_all(
         }
         // Wait for all partial reductions to complete.
         threadgroup_barrier(metal::mem_flags::mem_threadgroup);
-        best_pair = (lid < simd_per_group) ? ldata[lid] : IndexValPair<T>{default_val, 0};
+        best_pair = (lid < simd_per_group) ? ldata[lid] : IndexValPair<A>{default_val, 0};
         // Perform final per-SIMD partial reduction to calculate the threadgroup partial reduction result.
         best_pair = arg_simd_reduce(op, best_pair);
     }
@@ -83,6 +85,8 @@ template [[host_name("strided_" #opname "_all_" #dtype)]] [[kernel]] decltype(st
 
 #define def_arg_reduce_all(opname, op, atomic_op)                   \
 def_arg_reduce_all_kernels(opname, op, atomic_op, f32, float);      \
+def_arg_reduce_all_kernels(opname, op, atomic_op, f16, half);       \
+def_arg_reduce_all_kernels(opname, op, atomic_op, bf16, bfloat);    \
 def_arg_reduce_all_kernels(opname, op, atomic_op, i32, int);
 
 def_arg_reduce_all(argmax, Argmax, AtomicArgmax);
@@ -17,9 +17,10 @@ kernel void arg_reduce_col(
     const uint lcol = lid.x;
     const uint lwidth = lsize.x;
     Op op;
-    T default_val = input[offset[0] + grow * ncol];
-	IndexValPair<T> best_pair = gcol < ncol ? IndexValPair<T>{input[offset[0] + grow * ncol + gcol], gcol} : IndexValPair<T>{default_val, 0};
-	threadgroup IndexValPair<T> ldata[tgrow][tgcol];
+    using A = acc_t<T>;
+    A default_val = static_cast<A>(input[offset[0] + grow * ncol]);
+	IndexValPair<A> best_pair = gcol < ncol ? IndexValPair<A>{static_cast<A>(input[offset[0] + grow * ncol + gcol]), gcol} : IndexValPair<A>{default_val, 0};
+	threadgroup IndexValPair<A> ldata[tgrow][tgcol];
 	best_pair = arg_simd_reduce(op, best_pair);
 	uint simd_per_row_group = lwidth / simd_size;
 	
@@ -30,7 +31,7 @@ kernel void arg_reduce_col(
 		}
 		// Wait for all partial reductions to complete.
 		threadgroup_barrier(metal::mem_flags::mem_threadgroup);
-		best_pair = (lcol < simd_per_row_group) ? ldata[lrow][lcol] : IndexValPair<T>{default_val, 0};
+		best_pair = (lcol < simd_per_row_group) ? ldata[lrow][lcol] : IndexValPair<A>{default_val, 0};
 		// Perform final per-SIMD partial reduction to calculate the threadgroup partial reduction result.
 		best_pair = arg_simd_reduce(op, best_pair);
 	}
@@ -60,9 +61,10 @@ kernel void strided_arg_reduce_col(
     const uint lcol = lid.x;
     const uint lwidth = lsize.x;
     Op op;
-    T default_val = input[offset[0] + get_elm_loc(grow * ncol, ndim, shape, stride)];
-	IndexValPair<T> best_pair = gcol < ncol ? IndexValPair<T>{input[offset[0] + get_elm_loc(grow * ncol + gcol, ndim, shape, stride)], gcol} : IndexValPair<T>{default_val, 0};
-	threadgroup IndexValPair<T> ldata[tgrow][tgcol];
+    using A = acc_t<T>;
+    A default_val = static_cast<A>(input[offset[0] + get_elm_loc(grow * ncol, ndim, shape, stride)]);
+	IndexValPair<A> best_pair = gcol < ncol ? IndexValPair<A>{static_cast<A>(input[offset[0] + get_elm_loc(grow * ncol + gcol, ndim, shape, stride)]), gcol} : IndexValPair<A>{default_val, 0};
+	threadgroup IndexValPair<A> ldata[tgrow][tgcol];
 	best_pair = arg_simd_reduce(op, best_pair);
 	uint simd_per_row_group = lwidth / simd_size;
 	
@@ -73,7 +75,7 @@ kernel void strided_arg_reduce_col(
 		}
 		// Wait for all partial reductions to complete.
 		threadgroup_barrier(metal::mem_flags::mem_threadgroup);
-		best_pair = (lcol < simd_per_row_group) ? ldata[lrow][lcol] : IndexValPair<T>{default_val, 0};
+		best_pair = (lcol < simd_per_row_group) ? ldata[lrow][lcol] : IndexValPair<A>{default_val, 0};
 		// Perform final per-SIMD partial reduction to calculate the threadgroup partial reduction result.
 		best_pair = arg_simd_reduce(op, best_pair);
 	}
@@ -112,6 +114,8 @@ def_arg_reduce_col_kernels(opname, op, atomic_op, dtype, T, 32, 1);
 
 #define def_arg_reduce_col(opname, op, atomic_op)								    \
 config_arg_reduce_col_kernels(opname, op, atomic_op, f32, float);				    \
+config_arg_reduce_col_kernels(opname, op, atomic_op, f16, half);				    \
+config_arg_reduce_col_kernels(opname, op, atomic_op, bf16, bfloat);				    \
 config_arg_reduce_col_kernels(opname, op, atomic_op, i32, int);
 
 def_arg_reduce_col(argmax, Argmax, AtomicArgmax);
@@ -0,0 +1,359 @@
+#include "utils.h"
+
+// Must match s_max_head_dim of the attention op, query and accumulator rows are held in registers
+constexpr constant uint sdpa_max_head_dim = 128;
+// Must match s_sdpa_block_size on the host, every thread of a threadgroup owns one query or key row
+constexpr constant uint sdpa_block_size = 32;
+// Number of rows staged in threadgroup memory at a time, two tiles of maximum head size fit in 16KB
+constexpr constant uint sdpa_tile_size = 16;
+
+inline isize sdpa_elm_loc(uint id, bool strided, isize ndim, const constant isize *shape, const constant isize *stride) {
+    return strided ? get_elm_loc(id, ndim, shape, stride) : id;
+}
+
+// Stages rows [row_start, row_start + nrow) of a (rows, ncol) matrix in threadgroup memory
+template <class T>
+inline void sdpa_load_tile(threadgroup float *tile, const device T *src, isize offset, isize row_start, isize nrow, isize ncol, bool strided, isize ndim, const constant isize *shape, const constant isize *stride, uint lid) {
+    for (isize i = lid; i < nrow * ncol; i += sdpa_block_size) {
+        tile[i] = static_cast<float>(src[offset + sdpa_elm_loc(row_start * ncol + i, strided, ndim, shape, stride)]);
+    }
+}
+
+// Every thread keeps the running max, sum and weighted values of one query row while key and value tiles stream through,
+// only the output and the log-sum-exp of every row are written
+template <class T>
+kernel void sdpa(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *dims [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *q_shape [[buffer(3)]],
+    const constant isize *k_shape [[buffer(4)]],
+    const constant isize *v_shape [[buffer(5)]],
+    const constant isize *q_stride [[buffer(6)]],
+    const constant isize *k_stride [[buffer(7)]],
+    const constant isize *v_stride [[buffer(8)]],
+    const constant bool *strided [[buffer(9)]],
+    const constant bool &causal [[buffer(10)]],
+    const constant float &scale [[buffer(11)]],
+    const device T *query [[buffer(12)]],
+    const device T *key [[buffer(13)]],
+    const device T *value [[buffer(14)]],
+    device float *stats [[buffer(15)]],
+    device T *output [[buffer(16)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]])
+{
+    threadgroup float key_tile[sdpa_tile_size * sdpa_max_head_dim];
+    threadgroup float value_tile[sdpa_tile_size * sdpa_max_head_dim];
+    const isize nquery = dims[0], nkey = dims[1], head_dim = dims[2], value_dim = dims[3];
+    const isize batch = group_id.y;
+    const isize row = group_id.x * sdpa_block_size + lid;
+    const isize row_id = batch * nquery + row;
+    const bool active = row < nquery;
+    // With a causal mask no query of the block attends past the last query of the block
+    const isize block_end = (group_id.x + 1) * sdpa_block_size;
+    const isize key_end = causal && block_end < nkey ? block_end : nkey;
+    float q[sdpa_max_head_dim];
+    float acc[sdpa_max_head_dim];
+    float row_max = -INFINITY;
+    float row_sum = 0;
+
+    for (isize d = 0; d < value_dim; d++) {
+        acc[d] = 0;
+    }
+
+    if (active) {
+        for (isize d = 0; d < head_dim; d++) {
+            q[d] = scale * static_cast<float>(query[offset[0] + sdpa_elm_loc(row_id * head_dim + d, strided[0], ndim, q_shape, q_stride)]);
+        }
+    }
+
+    for (isize tile_start = 0; tile_start < key_end; tile_start += sdpa_tile_size) {
+        const isize tile_len = key_end - tile_start < sdpa_tile_size ? key_end - tile_start : sdpa_tile_size;
+        sdpa_load_tile(key_tile, key, offset[1], batch * nkey + tile_start, tile_len, head_dim, strided[1], ndim, k_shape, k_stride, lid);
+        sdpa_load_tile(value_tile, value, offset[2], batch * nkey + tile_start, tile_len, value_dim, strided[2], ndim, v_shape, v_stride, lid);
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+        if (active) {
+            float scores[sdpa_tile_size];
+            float tile_max = -INFINITY;
+
+            for (isize j = 0; j < tile_len; j++) {
+                float score = -INFINITY;
+
+                if (!causal || tile_start + j <= row) {
+                    score = 0;
+
+                    for (isize d = 0; d < head_dim; d++) {
+                        score += q[d] * key_tile[j * head_dim + d];
+                    }
+                }
+
+                scores[j] = score;
+                tile_max = metal::max(tile_max, score);
+            }
+
+            // Rescale the running sum and values once per tile, rows with every key of the tile masked are left as is
+            if (tile_max > -INFINITY) {
+                const float new_max = metal::max(row_max, tile_max);
+                const float correction = metal::exp(row_max - new_max);
+                row_sum *= correction;
+
+                for (isize d = 0; d < value_dim; d++) {
+                    acc[d] *= correction;
+                }
+
+                for (isize j = 0; j < tile_len; j++) {
+                    const float p = metal::exp(scores[j] - new_max);
+                    row_sum += p;
+
+                    for (isize d = 0; d < value_dim; d++) {
+                        acc[d] += p * value_tile[j * value_dim + d];
+                    }
+                }
+
+                row_max = new_max;
+            }
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    if (active) {
+        for (isize d = 0; d < value_dim; d++) {
+            output[offset[4] + row_id * value_dim + d] = static_cast<T>(acc[d] / row_sum);
+        }
+
+        stats[offset[3] + row_id] = row_max + metal::log(row_sum);
+    }
+}
+
+// Query gradient, every thread recomputes the probabilities of one query row tile by tile from the log-sum-exp
+template <class T>
+kernel void sdpa_grad_query(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *dims [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *grad_shape [[buffer(3)]],
+    const constant isize *q_shape [[buffer(4)]],
+    const constant isize *k_shape [[buffer(5)]],
+    const constant isize *v_shape [[buffer(6)]],
+    const constant isize *grad_stride [[buffer(7)]],
+    const constant isize *q_stride [[buffer(8)]],
+    const constant isize *k_stride [[buffer(9)]],
+    const constant isize *v_stride [[buffer(10)]],
+    const constant bool *strided [[buffer(11)]],
+    const constant bool &causal [[buffer(12)]],
+    const constant float &scale [[buffer(13)]],
+    const device T *grad [[buffer(14)]],
+    const device T *query [[buffer(15)]],
+    const device T *key [[buffer(16)]],
+    const device T *value [[buffer(17)]],
+    const device T *out [[buffer(18)]],
+    const device float *stats [[buffer(19)]],
+    device T *output [[buffer(20)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]])
+{
+    threadgroup float key_tile[sdpa_tile_size * sdpa_max_head_dim];
+    threadgroup float value_tile[sdpa_tile_size * sdpa_max_head_dim];
+    const isize nquery = dims[0], nkey = dims[1], head_dim = dims[2], value_dim = dims[3];
+    const isize batch = group_id.y;
+    const isize row = group_id.x * sdpa_block_size + lid;
+    const isize row_id = batch * nquery + row;
+    const bool active = row < nquery;
+    const isize block_end = (group_id.x + 1) * sdpa_block_size;
+    const isize key_end = causal && block_end < nkey ? block_end : nkey;
+    float q[sdpa_max_head_dim];
+    float g[sdpa_max_head_dim];
+    float acc[sdpa_max_head_dim];
+    float lse = 0;
+    // Row sum of the output gradient times the output
+    float delta = 0;
+
+    for (isize d = 0; d < head_dim; d++) {
+        acc[d] = 0;
+    }
+
+    if (active) {
+        for (isize d = 0; d < head_dim; d++) {
+            q[d] = scale * static_cast<float>(query[offset[1] + sdpa_elm_loc(row_id * head_dim + d, strided[1], ndim, q_shape, q_stride)]);
+        }
+
+        for (isize d = 0; d < value_dim; d++) {
+            g[d] = static_cast<float>(grad[offset[0] + sdpa_elm_loc(row_id * value_dim + d, strided[0], ndim, grad_shape, grad_stride)]);
+            delta += g[d] * static_cast<float>(out[offset[4] + row_id * value_dim + d]);
+        }
+
+        lse = stats[offset[5] + row_id];
+    }
+
+    for (isize tile_start = 0; tile_start < key_end; tile_start += sdpa_tile_size) {
+        const isize tile_len = key_end - tile_start < sdpa_tile_size ? key_end - tile_start : sdpa_tile_size;
+        sdpa_load_tile(key_tile, key, offset[2], batch * nkey + tile_start, tile_len, head_dim, strided[2], ndim, k_shape, k_stride, lid);
+        sdpa_load_tile(value_tile, value, offset[3], batch * nkey + tile_start, tile_len, value_dim, strided[3], ndim, v_shape, v_stride, lid);
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+        if (active) {
+            for (isize j = 0; j < tile_len && (!causal || tile_start + j <= row); j++) {
+                float score = 0, dp = 0;
+
+                for (isize d = 0; d < head_dim; d++) {
+                    score += q[d] * key_tile[j * head_dim + d];
+                }
+
+                for (isize d = 0; d < value_dim; d++) {
+                    dp += g[d] * value_tile[j * value_dim + d];
+                }
+
+                const float ds = metal::exp(score - lse) * (dp - delta);
+
+                for (isize d = 0; d < head_dim; d++) {
+                    acc[d] += ds * key_tile[j * head_dim + d];
+                }
+            }
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    if (active) {
+        for (isize d = 0; d < head_dim; d++) {
+            output[offset[6] + row_id * head_dim + d] = static_cast<T>(scale * acc[d]);
+        }
+    }
+}
+
+// Key or value gradient, every thread owns one key row while query and output gradient tiles stream through
+template <class T>
+kernel void sdpa_grad_key_value(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *dims [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *grad_shape [[buffer(3)]],
+    const constant isize *q_shape [[buffer(4)]],
+    const constant isize *k_shape [[buffer(5)]],
+    const constant isize *v_shape [[buffer(6)]],
+    const constant isize *grad_stride [[buffer(7)]],
+    const constant isize *q_stride [[buffer(8)]],
+    const constant isize *k_stride [[buffer(9)]],
+    const constant isize *v_stride [[buffer(10)]],
+    const constant bool *strided [[buffer(11)]],
+    const constant bool &causal [[buffer(12)]],
+    const constant float &scale [[buffer(13)]],
+    const device T *grad [[buffer(14)]],
+    const device T *query [[buffer(15)]],
+    const device T *key [[buffer(16)]],
+    const device T *value [[buffer(17)]],
+    const device T *out [[buffer(18)]],
+    const device float *stats [[buffer(19)]],
+    device T *output [[buffer(20)]],
+    const constant bool &value_grad [[buffer(21)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]])
+{
+    threadgroup float query_tile[sdpa_tile_size * sdpa_max_head_dim];
+    threadgroup float grad_tile[sdpa_tile_size * sdpa_max_head_dim];
+    threadgroup float lse_tile[sdpa_tile_size];
+    threadgroup float delta_tile[sdpa_tile_size];
+    const isize nquery = dims[0], nkey = dims[1], head_dim = dims[2], value_dim = dims[3];
+    const isize out_dim = value_grad ? value_dim : head_dim;
+    const isize batch = group_id.y;
+    const isize col = group_id.x * sdpa_block_size + lid;
+    const isize col_id = batch * nkey + col;
+    const bool active = col < nkey;
+    // With a causal mask queries before the first key of the block attend none of its keys
+    const isize query_start = causal ? group_id.x * sdpa_block_size : 0;
+    float k[sdpa_max_head_dim];
+    float v[sdpa_max_head_dim];
+    float acc[sdpa_max_head_dim];
+
+    for (isize d = 0; d < out_dim; d++) {
+        acc[d] = 0;
+    }
+
+    if (active) {
+        for (isize d = 0; d < head_dim; d++) {
+            k[d] = scale * static_cast<float>(key[offset[2] + sdpa_elm_loc(col_id * head_dim + d, strided[2], ndim, k_shape, k_stride)]);
+        }
+
+        for (isize d = 0; !value_grad && d < value_dim; d++) {
+            v[d] = static_cast<float>(value[offset[3] + sdpa_elm_loc(col_id * value_dim + d, strided[3], ndim, v_shape, v_stride)]);
+        }
+    }
+
+    for (isize tile_start = query_start; tile_start < nquery; tile_start += sdpa_tile_size) {
+        const isize tile_len = nquery - tile_start < sdpa_tile_size ? nquery - tile_start : sdpa_tile_size;
+        const isize row_start = batch * nquery + tile_start;
+        sdpa_load_tile(query_tile, query, offset[1], row_start, tile_len, head_dim, strided[1], ndim, q_shape, q_stride, lid);
+        sdpa_load_tile(grad_tile, grad, offset[0], row_start, tile_len, value_dim, strided[0], ndim, grad_shape, grad_stride, lid);
+
+        if (lid < tile_len) {
+            const isize row_id = row_start + lid;
+            float delta = 0;
+
+            for (isize d = 0; !value_grad && d < value_dim; d++) {
+                float g = static_cast<float>(grad[offset[0] + sdpa_elm_loc(row_id * value_dim + d, strided[0], ndim, grad_shape, grad_stride)]);
+                delta += g * static_cast<float>(out[offset[4] + row_id * value_dim + d]);
+            }
+
+            lse_tile[lid] = stats[offset[5] + row_id];
+            delta_tile[lid] = delta;
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+        if (active) {
+            for (isize i = 0; i < tile_len; i++) {
+                if (causal && col > tile_start + i) {
+                    continue;
+                }
+
+                float score = 0;
+
+                for (isize d = 0; d < head_dim; d++) {
+                    score += k[d] * query_tile[i * head_dim + d];
+                }
+
+                const float p = metal::exp(score - lse_tile[i]);
+
+                if (value_grad) {
+                    for (isize d = 0; d < value_dim; d++) {
+                        acc[d] += p * grad_tile[i * value_dim + d];
+                    }
+                } else {
+                    float dp = 0;
+
+                    for (isize d = 0; d < value_dim; d++) {
+                        dp += v[d] * grad_tile[i * value_dim + d];
+                    }
+
+                    const float ds = p * (dp - delta_tile[i]);
+
+                    for (isize d = 0; d < head_dim; d++) {
+                        acc[d] += ds * query_tile[i * head_dim + d];
+                    }
+                }
+            }
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    if (active) {
+        const float factor = value_grad ? 1.0f : scale;
+
+        for (isize d = 0; d < out_dim; d++) {
+            output[offset[6] + col_id * out_dim + d] = static_cast<T>(factor * acc[d]);
+        }
+    }
+}
+
+#define def_sdpa(dtype, T)                                                                                                \
+template [[host_name("sdpa_" #dtype)]] [[kernel]] decltype(sdpa<T>) sdpa<T>;                                              \
+template [[host_name("sdpa_grad_query_" #dtype)]] [[kernel]] decltype(sdpa_grad_query<T>) sdpa_grad_query<T>;             \
+template [[host_name("sdpa_grad_key_value_" #dtype)]] [[kernel]] decltype(sdpa_grad_key_value<T>) sdpa_grad_key_value<T>;
+
+def_sdpa(f32, float);
+def_sdpa(f16, half);
+def_sdpa(bf16, bfloat);
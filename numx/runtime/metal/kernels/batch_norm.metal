@@ -0,0 +1,180 @@
+#include "norm.h"
+
+// Flat index of the i-th element of a channel, elements before and after the channel dimension are flattened
+inline uint channel_elm_id(isize i, isize channel, isize nchannel, isize inner) {
+    return ((i / inner) * nchannel + channel) * inner + i % inner;
+}
+
+// One threadgroup normalizes one channel
+// Training computes the batch mean and variance in a single Welford pass and updates the running statistics,
+// inference reads the running statistics
+template <class T>
+kernel void batch_norm(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &nchannel [[buffer(1)]],
+    const constant isize &inner [[buffer(2)]],
+    const constant isize &nelm [[buffer(3)]],
+    const constant isize *offset [[buffer(4)]],
+    const constant isize *shape [[buffer(5)]],
+    const constant isize *stride [[buffer(6)]],
+    const constant isize *param_stride [[buffer(7)]],
+    const constant bool &strided [[buffer(8)]],
+    const constant float *params [[buffer(9)]],
+    const constant bool &training [[buffer(10)]],
+    const device T *input [[buffer(11)]],
+    const device T *weight [[buffer(12)]],
+    const device T *bias [[buffer(13)]],
+    device T *running_mean [[buffer(14)]],
+    device T *running_var [[buffer(15)]],
+    device float *stats [[buffer(16)]],
+    device T *output [[buffer(17)]],
+    uint channel [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float counts[norm_max_group_size];
+    threadgroup float means[norm_max_group_size];
+    threadgroup float m2s[norm_max_group_size];
+    const float eps = params[0];
+    const float momentum = params[1];
+    const isize mean_loc = offset[3] + channel * param_stride[2];
+    const isize var_loc = offset[4] + channel * param_stride[3];
+    float mean, rstd;
+
+    if (training) {
+        float count = 0, partial_mean = 0, m2 = 0;
+
+        for (isize i = lid; i < nelm; i += group_size) {
+            float val = static_cast<float>(input[offset[0] + norm_elm_loc(channel_elm_id(i, channel, nchannel, inner), strided, ndim, shape, stride)]);
+            count++;
+            float delta = val - partial_mean;
+            partial_mean += delta / count;
+            m2 += delta * (val - partial_mean);
+        }
+
+        counts[lid] = count;
+        means[lid] = partial_mean;
+        m2s[lid] = m2;
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+        merge_welford(counts, means, m2s, lid, group_size);
+        mean = means[0];
+        rstd = metal::rsqrt(m2s[0] / nelm + eps);
+
+        // Running variance is unbiased
+        if (lid == 0) {
+            float unbiased_var = nelm > 1 ? m2s[0] / (nelm - 1) : m2s[0];
+            running_mean[mean_loc] = static_cast<T>((1.0f - momentum) * static_cast<float>(running_mean[mean_loc]) + momentum * mean);
+            running_var[var_loc] = static_cast<T>((1.0f - momentum) * static_cast<float>(running_var[var_loc]) + momentum * unbiased_var);
+        }
+    } else {
+        mean = static_cast<float>(running_mean[mean_loc]);
+        rstd = metal::rsqrt(static_cast<float>(running_var[var_loc]) + eps);
+    }
+
+    if (lid == 0) {
+        stats[offset[5] + channel * 2] = mean;
+        stats[offset[5] + channel * 2 + 1] = rstd;
+    }
+
+    const float scale = rstd * static_cast<float>(weight[offset[1] + channel * param_stride[0]]);
+    const float shift = static_cast<float>(bias[offset[2] + channel * param_stride[1]]) - mean * scale;
+
+    for (isize i = lid; i < nelm; i += group_size) {
+        uint id = channel_elm_id(i, channel, nchannel, inner);
+        float val = static_cast<float>(input[offset[0] + norm_elm_loc(id, strided, ndim, shape, stride)]);
+        output[offset[6] + id] = static_cast<T>(val * scale + shift);
+    }
+}
+
+// One threadgroup sums the weight and bias gradients of one channel in a single pass
+template <class T>
+kernel void batch_norm_param_grad(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &nchannel [[buffer(1)]],
+    const constant isize &inner [[buffer(2)]],
+    const constant isize &nelm [[buffer(3)]],
+    const constant isize *offset [[buffer(4)]],
+    const constant isize *shape [[buffer(5)]],
+    const constant isize *grad_stride [[buffer(6)]],
+    const constant isize *in_stride [[buffer(7)]],
+    const constant bool *strided [[buffer(8)]],
+    const device T *grad [[buffer(9)]],
+    const device T *input [[buffer(10)]],
+    const device float *stats [[buffer(11)]],
+    device T *output [[buffer(12)]],
+    uint channel [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float weight_grads[norm_max_group_size];
+    threadgroup float bias_grads[norm_max_group_size];
+    const float mean = stats[offset[2] + channel * 2];
+    const float rstd = stats[offset[2] + channel * 2 + 1];
+    float weight_grad = 0, bias_grad = 0;
+
+    for (isize i = lid; i < nelm; i += group_size) {
+        uint id = channel_elm_id(i, channel, nchannel, inner);
+        float g = static_cast<float>(grad[offset[0] + norm_elm_loc(id, strided[0], ndim, shape, grad_stride)]);
+        float xhat = (static_cast<float>(input[offset[1] + norm_elm_loc(id, strided[1], ndim, shape, in_stride)]) - mean) * rstd;
+        weight_grad += g * xhat;
+        bias_grad += g;
+    }
+
+    weight_grads[lid] = weight_grad;
+    bias_grads[lid] = bias_grad;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    sum_pairs(weight_grads, bias_grads, lid, group_size);
+
+    if (lid == 0) {
+        output[offset[3] + channel] = static_cast<T>(weight_grads[0]);
+        output[offset[3] + nchannel + channel] = static_cast<T>(bias_grads[0]);
+    }
+}
+
+// One thread per element, the channel reductions come from the parameter gradients
+template <class T>
+kernel void batch_norm_grad(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &nchannel [[buffer(1)]],
+    const constant isize &inner [[buffer(2)]],
+    const constant isize &nelm [[buffer(3)]],
+    const constant isize *offset [[buffer(4)]],
+    const constant isize *shape [[buffer(5)]],
+    const constant isize *grad_stride [[buffer(6)]],
+    const constant isize *in_stride [[buffer(7)]],
+    const constant isize &weight_stride [[buffer(8)]],
+    const constant bool *strided [[buffer(9)]],
+    const constant bool &training [[buffer(10)]],
+    const device T *grad [[buffer(11)]],
+    const device T *input [[buffer(12)]],
+    const device T *weight [[buffer(13)]],
+    const device float *stats [[buffer(14)]],
+    const device T *param_grad [[buffer(15)]],
+    device T *output [[buffer(16)]],
+    uint id [[thread_position_in_grid]])
+{
+    const isize channel = (id / inner) % nchannel;
+    const float mean = stats[offset[3] + channel * 2];
+    const float rstd = stats[offset[3] + channel * 2 + 1];
+    const float g = static_cast<float>(grad[offset[0] + norm_elm_loc(id, strided[0], ndim, shape, grad_stride)]);
+    const float scale = rstd * static_cast<float>(weight[offset[2] + channel * weight_stride]);
+    float out = g;
+
+    if (training) {
+        float xhat = (static_cast<float>(input[offset[1] + norm_elm_loc(id, strided[1], ndim, shape, in_stride)]) - mean) * rstd;
+        float weight_grad = static_cast<float>(param_grad[offset[4] + channel]);
+        float bias_grad = static_cast<float>(param_grad[offset[4] + nchannel + channel]);
+        out = g - bias_grad / nelm - xhat * weight_grad / nelm;
+    }
+
+    output[offset[5] + id] = static_cast<T>(scale * out);
+}
+
+#define def_batch_norm(dtype, T)                                                                                            \
+template [[host_name("batch_norm_" #dtype)]] [[kernel]] decltype(batch_norm<T>) batch_norm<T>;                              \
+template [[host_name("batch_norm_param_grad_" #dtype)]] [[kernel]] decltype(batch_norm_param_grad<T>) batch_norm_param_grad<T>; \
+template [[host_name("batch_norm_grad_" #dtype)]] [[kernel]] decltype(batch_norm_grad<T>) batch_norm_grad<T>;
+
+def_batch_norm(f32, float);
+def_batch_norm(f16, half);
+def_batch_norm(bf16, bfloat);
@@ -60,4 +60,75 @@ struct Minimum {
 struct Maximum {
     template <class T>
     T operator()(T lhs, T rhs) { return lhs > rhs ? lhs : rhs; }
-};
\ No newline at end of file
+};
+
+// Activation gradients get the output gradient as lhs and the saved output or input as rhs
+
+struct ReluGrad {
+    template <class T>
+    T operator()(T grad, T out) { return out > 0 ? grad : 0; }
+};
+
+struct SigmoidGrad {
+    template <class T>
+    T operator()(T grad, T out) { return grad * out * (1 - out); }
+};
+
+struct TanhGrad {
+    template <class T>
+    T operator()(T grad, T out) { return grad * (1 - out * out); }
+};
+
+struct GeluGrad {
+    template <class T>
+    T operator()(T grad, T x) {
+        const float cdf = 0.5f * (1.0f + erf_approx(x * inv_sqrt_2));
+        const float pdf = inv_sqrt_2pi * metal::exp(-0.5f * x * x);
+        return grad * (cdf + x * pdf);
+    }
+};
+
+struct GeluTanhGrad {
+    template <class T>
+    T operator()(T grad, T x) {
+        const float t = metal::precise::tanh(sqrt_2_over_pi * (x + gelu_tanh_coeff * x * x * x));
+        const float du = sqrt_2_over_pi * (1.0f + 3.0f * gelu_tanh_coeff * x * x);
+        return grad * (0.5f * (1.0f + t) + 0.5f * x * (1.0f - t * t) * du);
+    }
+};
+
+struct SiluGrad {
+    template <class T>
+    T operator()(T grad, T x) {
+        const float s = stable_sigmoid(x);
+        return grad * s * (1.0f + x * (1.0f - s));
+    }
+};
+
+struct SoftplusGrad {
+    template <class T>
+    T operator()(T grad, T x) { return grad * stable_sigmoid(x); }
+};
+
+struct Pow {
+    float operator()(float lhs, float rhs) {
+        // Metal's pow is undefined for negative bases, integral exponents are handled through |x|
+        if (lhs < 0.0f && metal::trunc(rhs) == rhs) {
+            const float magnitude = metal::precise::pow(-lhs, rhs);
+            return metal::fmod(rhs, 2.0f) == 0.0f ? magnitude : -magnitude;
+        }
+
+        return metal::precise::pow(lhs, rhs);
+    }
+};
+
+struct Fmod {
+    // The result has the sign of the dividend, integer division by zero gives zero
+    float operator()(float lhs, float rhs) { return metal::precise::fmod(lhs, rhs); }
+    int operator()(int lhs, int rhs) { return rhs == 0 ? 0 : lhs % rhs; }
+};
+
+struct AbsGrad {
+    template <class T>
+    T operator()(T grad, T x) { return x > 0 ? grad : (x < 0 ? -grad : static_cast<T>(0)); }
+};
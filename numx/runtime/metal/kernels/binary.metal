@@ -8,7 +8,7 @@ kernel void binary(
     device R *output [[buffer(3)]],
     uint id [[thread_position_in_grid]])
 {
-    output[offset[2] + id] = Op()(lhs[offset[0] + id], rhs[offset[1] + id]);
+    output[offset[2] + id] = convert<R>(Op()(static_cast<acc_t<T>>(lhs[offset[0] + id]), static_cast<acc_t<T>>(rhs[offset[1] + id])));
 }
 
 template <class Op, class T, class R>
@@ -28,7 +28,7 @@ kernel void strided_binary(
     isize l_loc = strided[0] ? get_elm_loc(id, ndim, shape, l_stride) : id;
     isize r_loc = strided[1] ? get_elm_loc(id, ndim, shape, r_stride) : id;
     isize out_loc = strided[2] ? get_elm_loc(id, ndim, shape, out_stride) : id;
-    output[offset[2] + out_loc] = Op()(lhs[offset[0] + l_loc], rhs[offset[1] + r_loc]);
+    output[offset[2] + out_loc] = convert<R>(Op()(static_cast<acc_t<T>>(lhs[offset[0] + l_loc]), static_cast<acc_t<T>>(rhs[offset[1] + r_loc])));
 }
 
 #define def_binary_kernels(opname, op, dtype, T, R) \
@@ -39,12 +39,19 @@ template [[host_name("strided_" #opname "_" #dtype)]] [[kernel]] decltype(stride
 template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(binary<op, T, bool>) binary<op, T, bool>;                            \
 template [[host_name("strided_" #opname "_" #dtype)]] [[kernel]] decltype(strided_binary<op, T, bool>) strided_binary<op, T, bool>;
 
-#define def_binary(opname, op)                      \
+#define def_binary_float(opname, op)                \
 def_binary_kernels(opname, op, f32, float, float);  \
+def_binary_kernels(opname, op, f16, half, half);    \
+def_binary_kernels(opname, op, bf16, bfloat, bfloat);
+
+#define def_binary(opname, op)                      \
+def_binary_float(opname, op);                       \
 def_binary_kernels(opname, op, i32, int, int);
 
 #define def_numeric_cmp(opname, op)                 \
 def_cmp_kernels(opname, op, f32, float);            \
+def_cmp_kernels(opname, op, f16, half);             \
+def_cmp_kernels(opname, op, bf16, bfloat);          \
 def_cmp_kernels(opname, op, i32, int);
 
 #define def_cmp_all(opname, op)                     \
@@ -63,3 +70,13 @@ def_numeric_cmp(lt, Lt);
 def_numeric_cmp(gt, Gt);
 def_numeric_cmp(leq, Leq);
 def_numeric_cmp(geq, Geq);
+def_binary(relu_grad, ReluGrad);
+def_binary_float(sigmoid_grad, SigmoidGrad);
+def_binary_float(tanh_grad, TanhGrad);
+def_binary_float(gelu_grad, GeluGrad);
+def_binary_float(gelu_tanh_grad, GeluTanhGrad);
+def_binary_float(silu_grad, SiluGrad);
+def_binary_float(softplus_grad, SoftplusGrad);
+def_binary_float(pow, Pow);
+def_binary(fmod, Fmod);
+def_binary(abs_grad, AbsGrad);
@@ -0,0 +1,113 @@
+#include "binary.h"
+
+// Must match the packing on the host, 32 elements per word along the last dimension
+constexpr constant isize bits_per_word = 32;
+
+// Every SIMD group packs 32 consecutive elements of one row into one word with a ballot, the rows are padded
+// to whole words on the grid and lanes past the end of the row vote false so the padding bits stay zero
+template <class Op, class T>
+kernel void cmp_bits(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize &nword [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *shape [[buffer(4)]],
+    const constant isize *l_stride [[buffer(5)]],
+    const constant isize *r_stride [[buffer(6)]],
+    const constant bool *strided [[buffer(7)]],
+    const device T *lhs [[buffer(8)]],
+    const device T *rhs [[buffer(9)]],
+    device int *output [[buffer(10)]],
+    uint2 id [[thread_position_in_grid]],
+    uint lane [[thread_index_in_simdgroup]])
+{
+    const isize col = id.x, row = id.y;
+    bool pred = false;
+
+    if (col < ncol) {
+        const uint elm = row * ncol + col;
+        const isize l_loc = strided[0] ? get_elm_loc(elm, ndim, shape, l_stride) : elm;
+        const isize r_loc = strided[1] ? get_elm_loc(elm, ndim, shape, r_stride) : elm;
+        pred = Op()(static_cast<acc_t<T>>(lhs[offset[0] + l_loc]), static_cast<acc_t<T>>(rhs[offset[1] + r_loc]));
+    }
+
+    // Lane i of the group owns bit i of the word
+    const ulong votes = static_cast<ulong>(metal::simd_ballot(pred));
+
+    if (lane == 0) {
+        output[offset[2] + row * nword + col / bits_per_word] = static_cast<int>(static_cast<uint>(votes));
+    }
+}
+
+// Selects between the broadcasted values by the bit of every element
+template <class T>
+kernel void where_bits(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize &nword [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *shape [[buffer(4)]],
+    const constant isize *l_stride [[buffer(5)]],
+    const constant isize *r_stride [[buffer(6)]],
+    const constant bool *strided [[buffer(7)]],
+    const device int *mask [[buffer(8)]],
+    const device T *lhs [[buffer(9)]],
+    const device T *rhs [[buffer(10)]],
+    device T *output [[buffer(11)]],
+    uint id [[thread_position_in_grid]])
+{
+    const isize row = id / ncol, col = id % ncol;
+    const uint word = static_cast<uint>(mask[offset[0] + row * nword + col / bits_per_word]);
+    const bool bit = (word >> (col % bits_per_word)) & 1;
+    const isize l_loc = strided[0] ? get_elm_loc(id, ndim, shape, l_stride) : id;
+    const isize r_loc = strided[1] ? get_elm_loc(id, ndim, shape, r_stride) : id;
+    output[offset[3] + id] = bit ? lhs[offset[1] + l_loc] : rhs[offset[2] + r_loc];
+}
+
+// Every thread counts the set bits of one row, the padding bits are zero
+kernel void count_bits(
+    const constant isize &nword [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const device int *mask [[buffer(2)]],
+    device int *output [[buffer(3)]],
+    uint id [[thread_position_in_grid]])
+{
+    const device int *words = mask + offset[0] + id * nword;
+    int count = 0;
+
+    for (isize i = 0; i < nword; ++i) {
+        count += metal::popcount(static_cast<uint>(words[i]));
+    }
+
+    output[offset[1] + id] = count;
+}
+
+#define def_cmp_bits(opname, op, dtype, T) \
+template [[host_name(#opname "_bits_" #dtype)]] [[kernel]] decltype(cmp_bits<op, T>) cmp_bits<op, T>;
+
+#define def_numeric_cmp_bits(opname, op)            \
+def_cmp_bits(opname, op, f32, float);               \
+def_cmp_bits(opname, op, f16, half);                \
+def_cmp_bits(opname, op, bf16, bfloat);             \
+def_cmp_bits(opname, op, i32, int);
+
+#define def_cmp_bits_all(opname, op)                \
+def_numeric_cmp_bits(opname, op);                   \
+def_cmp_bits(opname, op, b8, bool);
+
+def_cmp_bits_all(eq, Eq);
+def_cmp_bits_all(neq, Neq);
+def_numeric_cmp_bits(lt, Lt);
+def_numeric_cmp_bits(gt, Gt);
+def_numeric_cmp_bits(leq, Leq);
+def_numeric_cmp_bits(geq, Geq);
+
+// Selecting only moves bits, bf16 goes through ushort
+#define def_where_bits(dtype, T) \
+template [[host_name("where_bits_" #dtype)]] [[kernel]] decltype(where_bits<T>) where_bits<T>;
+
+def_where_bits(f32, float);
+def_where_bits(f16, half);
+def_where_bits(bf16, ushort);
+def_where_bits(i32, int);
+def_where_bits(b8, bool);
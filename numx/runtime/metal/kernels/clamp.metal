@@ -0,0 +1,61 @@
+#include "utils.h"
+
+// Bounds come in the accumulation type of the input so integers are compared exactly,
+// missing bounds are infinities or the extremes of i32 and never clamp
+template <class T>
+kernel void clamp(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const constant isize *shape [[buffer(2)]],
+    const constant isize *in_stride [[buffer(3)]],
+    const constant isize *out_stride [[buffer(4)]],
+    const constant bool *strided [[buffer(5)]],
+    const constant acc_t<T> &min [[buffer(6)]],
+    const constant acc_t<T> &max [[buffer(7)]],
+    const device T *input [[buffer(8)]],
+    device T *output [[buffer(9)]],
+    uint id [[thread_position_in_grid]])
+{
+    isize in_loc = strided[0] ? get_elm_loc(id, ndim, shape, in_stride) : id;
+    isize out_loc = strided[1] ? get_elm_loc(id, ndim, shape, out_stride) : id;
+    acc_t<T> x = static_cast<acc_t<T>>(input[offset[0] + in_loc]);
+    output[offset[1] + out_loc] = static_cast<T>(x < min ? min : (x > max ? max : x));
+}
+
+// The gradient flows only where the input lies within the bounds
+template <class T>
+kernel void clamp_grad(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const constant isize *shape [[buffer(2)]],
+    const constant isize *grad_stride [[buffer(3)]],
+    const constant isize *in_stride [[buffer(4)]],
+    const constant isize *out_stride [[buffer(5)]],
+    const constant bool *strided [[buffer(6)]],
+    const constant float &min [[buffer(7)]],
+    const constant float &max [[buffer(8)]],
+    const device T *grad [[buffer(9)]],
+    const device T *input [[buffer(10)]],
+    device T *output [[buffer(11)]],
+    uint id [[thread_position_in_grid]])
+{
+    isize grad_loc = strided[0] ? get_elm_loc(id, ndim, shape, grad_stride) : id;
+    isize in_loc = strided[1] ? get_elm_loc(id, ndim, shape, in_stride) : id;
+    isize out_loc = strided[2] ? get_elm_loc(id, ndim, shape, out_stride) : id;
+    float fx = static_cast<float>(input[offset[1] + in_loc]);
+    output[offset[2] + out_loc] = fx >= min && fx <= max ? grad[offset[0] + grad_loc] : static_cast<T>(0);
+}
+
+#define def_clamp(dtype, T) \
+template [[host_name("clamp_" #dtype)]] [[kernel]] decltype(clamp<T>) clamp<T>;
+
+#define def_clamp_grad(dtype, T) \
+template [[host_name("clamp_grad_" #dtype)]] [[kernel]] decltype(clamp_grad<T>) clamp_grad<T>;
+
+def_clamp(f32, float);
+def_clamp(f16, half);
+def_clamp(bf16, bfloat);
+def_clamp(i32, int);
+def_clamp_grad(f32, float);
+def_clamp_grad(f16, half);
+def_clamp_grad(bf16, bfloat);
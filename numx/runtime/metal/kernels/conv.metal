@@ -0,0 +1,127 @@
+#include "utils.h"
+
+// Geometry of a 2D convolution, shared by the host through a flat buffer
+struct ConvGeometry {
+    isize nchannel, height, width;
+    isize out_height, out_width;
+    isize kernel_h, kernel_w;
+    isize stride_h, stride_w;
+    isize padding_h, padding_w;
+    isize dilation_h, dilation_w;
+
+    ConvGeometry(const constant isize *geometry) :
+        nchannel(geometry[0]), height(geometry[1]), width(geometry[2]),
+        out_height(geometry[3]), out_width(geometry[4]),
+        kernel_h(geometry[5]), kernel_w(geometry[6]),
+        stride_h(geometry[7]), stride_w(geometry[8]),
+        padding_h(geometry[9]), padding_w(geometry[10]),
+        dilation_h(geometry[11]), dilation_w(geometry[12]) {}
+};
+
+// Each thread writes one column element, columns are (N, C * KH * KW, OH * OW) for NCHW
+// and (N, OH * OW, C * KH * KW) for NHWC so consecutive threads write consecutive elements
+// Image strides are given in (N, C, H, W) order whatever the layout
+template <class T>
+kernel void im2col(
+    const constant isize *geometry [[buffer(0)]],
+    const constant bool &channels_last [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *in_stride [[buffer(3)]],
+    const device T *input [[buffer(4)]],
+    device T *output [[buffer(5)]],
+    uint id [[thread_position_in_grid]])
+{
+    ConvGeometry g(geometry);
+    const isize patch_size = g.nchannel * g.kernel_h * g.kernel_w;
+    const isize npatch = g.out_height * g.out_width;
+    isize image_idx, patch_idx, patch_elm_idx;
+
+    if (channels_last) {
+        patch_elm_idx = id % patch_size;
+        patch_idx = (id / patch_size) % npatch;
+        image_idx = id / (patch_size * npatch);
+    } else {
+        patch_idx = id % npatch;
+        patch_elm_idx = (id / npatch) % patch_size;
+        image_idx = id / (npatch * patch_size);
+    }
+
+    const isize channel = patch_elm_idx / (g.kernel_h * g.kernel_w);
+    const isize kernel_row = (patch_elm_idx / g.kernel_w) % g.kernel_h;
+    const isize kernel_col = patch_elm_idx % g.kernel_w;
+    const isize row = (patch_idx / g.out_width) * g.stride_h - g.padding_h + kernel_row * g.dilation_h;
+    const isize col = (patch_idx % g.out_width) * g.stride_w - g.padding_w + kernel_col * g.dilation_w;
+    T val = static_cast<T>(0);
+
+    // Padding reads as zero
+    if (row >= 0 && row < g.height && col >= 0 && col < g.width) {
+        isize in_loc = image_idx * in_stride[0] + channel * in_stride[1] + row * in_stride[2] + col * in_stride[3];
+        val = input[offset[0] + in_loc];
+    }
+
+    output[offset[1] + id] = val;
+}
+
+// Each thread gathers the column elements that overlap one image element, no atomics are needed
+// Column strides are given in (N, C * KH * KW, OH * OW) order whatever the layout
+template <class T>
+kernel void col2im(
+    const constant isize *geometry [[buffer(0)]],
+    const constant bool &channels_last [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *in_stride [[buffer(3)]],
+    const device T *input [[buffer(4)]],
+    device T *output [[buffer(5)]],
+    uint id [[thread_position_in_grid]])
+{
+    ConvGeometry g(geometry);
+    isize image_idx, channel, row, col;
+
+    if (channels_last) {
+        channel = id % g.nchannel;
+        col = (id / g.nchannel) % g.width;
+        row = (id / (g.nchannel * g.width)) % g.height;
+        image_idx = id / (g.nchannel * g.width * g.height);
+    } else {
+        col = id % g.width;
+        row = (id / g.width) % g.height;
+        channel = (id / (g.width * g.height)) % g.nchannel;
+        image_idx = id / (g.width * g.height * g.nchannel);
+    }
+
+    acc_t<T> acc = 0;
+
+    for (isize kernel_row = 0; kernel_row < g.kernel_h; kernel_row++) {
+        isize out_row = row + g.padding_h - kernel_row * g.dilation_h;
+
+        if (out_row < 0 || out_row % g.stride_h != 0 || out_row / g.stride_h >= g.out_height) {
+            continue;
+        }
+
+        out_row /= g.stride_h;
+
+        for (isize kernel_col = 0; kernel_col < g.kernel_w; kernel_col++) {
+            isize out_col = col + g.padding_w - kernel_col * g.dilation_w;
+
+            if (out_col < 0 || out_col % g.stride_w != 0 || out_col / g.stride_w >= g.out_width) {
+                continue;
+            }
+
+            out_col /= g.stride_w;
+            isize patch_elm_idx = (channel * g.kernel_h + kernel_row) * g.kernel_w + kernel_col;
+            isize patch_idx = out_row * g.out_width + out_col;
+            acc += static_cast<acc_t<T>>(input[offset[0] + image_idx * in_stride[0] + patch_elm_idx * in_stride[1] + patch_idx * in_stride[2]]);
+        }
+    }
+
+    output[offset[1] + id] = static_cast<T>(acc);
+}
+
+#define def_conv(dtype, T)                                                                  \
+template [[host_name("im2col_" #dtype)]] [[kernel]] decltype(im2col<T>) im2col<T>;          \
+template [[host_name("col2im_" #dtype)]] [[kernel]] decltype(col2im<T>) col2im<T>;
+
+def_conv(f32, float);
+def_conv(f16, half);
+def_conv(bf16, bfloat);
+def_conv(i32, int);
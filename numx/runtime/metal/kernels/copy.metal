@@ -7,7 +7,7 @@ kernel void copy(
     device R *output [[buffer(2)]],
     uint id [[thread_position_in_grid]])
 {
-    output[offset[1] + id] = input[offset[0] + id];
+    output[offset[1] + id] = convert<R>(input[offset[0] + id]);
 }
 
 template <class T, class R>
@@ -24,7 +24,7 @@ kernel void strided_copy(
 {
     isize in_loc = strided[0] ? get_elm_loc(id, ndim, shape, in_stride) : id;
     isize out_loc = strided[1] ? get_elm_loc(id, ndim, shape, out_stride) : id;
-    output[offset[1] + out_loc] = input[offset[0] + in_loc];
+    output[offset[1] + out_loc] = convert<R>(input[offset[0] + in_loc]);
 }
 
 #define def_copy(dtype, T, R)   \
@@ -32,26 +32,50 @@ template [[host_name("copy_" #dtype)]] [[kernel]] decltype(copy<T, R>) copy<T, R
 template [[host_name("strided_copy_" #dtype)]] [[kernel]] decltype(strided_copy<T, R>) strided_copy<T, R>;
 
 def_copy(f32_f32, float, float);
+def_copy(f32_f16, float, half);
+def_copy(f32_bf16, float, bfloat);
 def_copy(f32_i32, float, int);
 def_copy(f32_i16, float, int16_t);
 def_copy(f32_i8, float, int8_t);
 def_copy(f32_b8, float, bool);
+def_copy(f16_f32, half, float);
+def_copy(f16_f16, half, half);
+def_copy(f16_bf16, half, bfloat);
+def_copy(f16_i32, half, int);
+def_copy(f16_i16, half, int16_t);
+def_copy(f16_i8, half, int8_t);
+def_copy(f16_b8, half, bool);
+def_copy(bf16_f32, bfloat, float);
+def_copy(bf16_f16, bfloat, half);
+def_copy(bf16_bf16, bfloat, bfloat);
+def_copy(bf16_i32, bfloat, int);
+def_copy(bf16_i16, bfloat, int16_t);
+def_copy(bf16_i8, bfloat, int8_t);
+def_copy(bf16_b8, bfloat, bool);
 def_copy(i32_f32, int, float);
+def_copy(i32_f16, int, half);
+def_copy(i32_bf16, int, bfloat);
 def_copy(i32_i32, int, int);
 def_copy(i32_i16, int, int16_t);
 def_copy(i32_i8, int, int8_t);
 def_copy(i32_b8, int, bool);
 def_copy(i16_f32, int16_t, float);
+def_copy(i16_f16, int16_t, half);
+def_copy(i16_bf16, int16_t, bfloat);
 def_copy(i16_i32, int16_t, int);
 def_copy(i16_i16, int16_t, int16_t);
 def_copy(i16_i8, int16_t, int8_t);
 def_copy(i16_b8, int16_t, bool);
 def_copy(i8_f32, int8_t, float);
+def_copy(i8_f16, int8_t, half);
+def_copy(i8_bf16, int8_t, bfloat);
 def_copy(i8_i32, int8_t, int);
 def_copy(i8_i16, int8_t, int16_t);
 def_copy(i8_i8, int8_t, int8_t);
 def_copy(i8_b8, int8_t, bool);
 def_copy(b8_f32, bool, float);
+def_copy(b8_f16, bool, half);
+def_copy(b8_bf16, bool, bfloat);
 def_copy(b8_i32, bool, int);
 def_copy(b8_i16, bool, int16_t);
 def_copy(b8_i8, bool, int8_t);
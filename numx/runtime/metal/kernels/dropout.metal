@@ -0,0 +1,31 @@
+#include "random.h"
+
+// Elements are kept when the uniform value hashed from the key and the element index is at least p,
+// backward runs the same kernel on the gradient with the same key to regenerate the mask
+template <class T>
+kernel void dropout(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const constant isize *shape [[buffer(2)]],
+    const constant isize *stride [[buffer(3)]],
+    const constant bool &strided [[buffer(4)]],
+    const constant isize &key [[buffer(5)]],
+    const constant float &p [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    device T *output [[buffer(8)]],
+    uint id [[thread_position_in_grid]])
+{
+    uint2 hash = threefry2x32(uint2((key >> 32) & 0xffffffff, key & 0xffffffff), uint2(id, 0));
+    // Top 24 bits map exactly to a float in [0, 1)
+    float u = static_cast<float>(hash.x >> 8) / 16777216.0f;
+    float scale = p < 1.0f ? 1.0f / (1.0f - p) : 0.0f;
+    isize loc = strided ? get_elm_loc(id, ndim, shape, stride) : id;
+    output[offset[1] + id] = u >= p ? static_cast<T>(static_cast<float>(input[offset[0] + loc]) * scale) : static_cast<T>(0);
+}
+
+#define def_dropout(dtype, T) \
+template [[host_name("dropout_" #dtype)]] [[kernel]] decltype(dropout<T>) dropout<T>;
+
+def_dropout(f32, float);
+def_dropout(f16, half);
+def_dropout(bf16, bfloat);
@@ -0,0 +1,271 @@
+#include "utils.h"
+
+// Complex numbers are float2 of the real and imaginary parts
+inline float2 cmul(float2 a, float2 b) { return float2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x); }
+inline float2 cconj(float2 a) { return float2(a.x, -a.y); }
+
+// e^(sign 2 pi i num / den), num is reduced modulo den first so the angle stays precise for long transforms
+inline float2 twiddle(float sign, ulong num, ulong den) {
+    const float angle = sign * 2.0f * M_PI_F * static_cast<float>(num % den) / static_cast<float>(den);
+    float cos_angle;
+    const float sin_angle = metal::precise::sincos(angle, cos_angle);
+    return float2(cos_angle, sin_angle);
+}
+
+// Bluestein chirp e^(sign pi i j^2 / n)
+inline float2 chirp_at(float sign, uint j, uint n) { return twiddle(sign, static_cast<ulong>(j) * j, 2 * static_cast<ulong>(n)); }
+
+// Stockham autosort transform of a power-of-two size ping-ponging between x and y, both orders are natural.
+// Every pass merges transforms of length p into transforms of length 4p with radix-4 butterflies, after a single
+// radix-2 pass for odd powers of two. Returns the buffer holding the result.
+inline device float2 *stockham_fft(device float2 *x, device float2 *y, uint nfft, float sign, uint lid, uint group_size) {
+    uint p = 1;
+
+    if ((metal::ctz(nfft) & 1) != 0) {
+        const uint half_n = nfft / 2;
+
+        // Length-1 transforms need no twiddles
+        for (uint i = lid; i < half_n; i += group_size) {
+            const float2 a = x[i];
+            const float2 b = x[i + half_n];
+            y[2 * i] = a + b;
+            y[2 * i + 1] = a - b;
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_device);
+        device float2 *tmp = x;
+        x = y;
+        y = tmp;
+        p = 2;
+    }
+
+    const uint quarter_n = nfft / 4;
+
+    for (; p < nfft; p *= 4) {
+        for (uint i = lid; i < quarter_n; i += group_size) {
+            const uint k = i & (p - 1);
+            const float2 u0 = x[i];
+            const float2 u1 = cmul(x[i + quarter_n], twiddle(sign, k, 4 * p));
+            const float2 u2 = cmul(x[i + 2 * quarter_n], twiddle(sign, 2 * k, 4 * p));
+            const float2 u3 = cmul(x[i + 3 * quarter_n], twiddle(sign, 3 * k, 4 * p));
+            const float2 v0 = u0 + u2;
+            const float2 v1 = u0 - u2;
+            const float2 v2 = u1 + u3;
+            // (u1 - u3) rotated by sign i
+            const float2 d = u1 - u3;
+            const float2 v3 = float2(-sign * d.y, sign * d.x);
+            const uint j = 4 * i - 3 * k;
+            y[j] = v0 + v2;
+            y[j + p] = v1 + v3;
+            y[j + 2 * p] = v0 - v2;
+            y[j + 3 * p] = v1 - v3;
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_device);
+        device float2 *tmp = x;
+        x = y;
+        y = tmp;
+    }
+
+    return x;
+}
+
+// Transform of size nfft held in x. When nwork > nfft the size is not a power of two and Bluestein's algorithm turns
+// the transform into a circular convolution of size nwork with the chirp spectrum, which is prescaled by 1 / nwork.
+inline device float2 *fft(device float2 *x, device float2 *y, uint nfft, uint nwork, const device float2 *chirp, float sign, uint lid, uint group_size) {
+    if (nfft == nwork) {
+        return stockham_fft(x, y, nfft, sign, lid, group_size);
+    }
+
+    for (uint j = lid; j < nwork; j += group_size) {
+        x[j] = j < nfft ? cmul(x[j], chirp_at(sign, j, nfft)) : float2(0.0f);
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_device);
+    device float2 *spectrum = stockham_fft(x, y, nwork, -1.0f, lid, group_size);
+    device float2 *other = spectrum == x ? y : x;
+
+    for (uint j = lid; j < nwork; j += group_size) {
+        spectrum[j] = cmul(spectrum[j], chirp[j]);
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_device);
+    device float2 *conv = stockham_fft(spectrum, other, nwork, 1.0f, lid, group_size);
+
+    for (uint k = lid; k < nfft; k += group_size) {
+        conv[k] = cmul(conv[k], chirp_at(sign, k, nfft));
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_device);
+    return conv;
+}
+
+// Spectrum of the conjugate chirp wrapped around nwork, shared by every row of a Bluestein transform.
+// The second half of the buffer is scratch.
+kernel void fft_chirp(
+    const constant isize &nfft [[buffer(0)]],
+    const constant isize &nwork [[buffer(1)]],
+    const constant float &sign [[buffer(2)]],
+    device float2 *chirp [[buffer(3)]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    const uint n = nfft;
+    const uint m = nwork;
+
+    for (uint j = lid; j < m; j += group_size) {
+        if (j < n) {
+            chirp[j] = cconj(chirp_at(sign, j, n)) / static_cast<float>(m);
+        } else if (m - j < n) {
+            chirp[j] = cconj(chirp_at(sign, m - j, n)) / static_cast<float>(m);
+        } else {
+            chirp[j] = float2(0.0f);
+        }
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_device);
+    device float2 *spectrum = stockham_fft(chirp, chirp + m, m, -1.0f, lid, group_size);
+
+    if (spectrum != chirp) {
+        for (uint j = lid; j < m; j += group_size) {
+            chirp[j] = spectrum[j];
+        }
+    }
+}
+
+template <class T>
+inline float read_elm(const device T *input, isize offset, uint id, bool strided, isize ndim, const constant isize *shape, const constant isize *stride) {
+    return static_cast<float>(input[offset + (strided ? get_elm_loc(id, ndim, shape, stride) : id)]);
+}
+
+// Frequency k of a real spectrum, the imaginary parts of the zero and Nyquist frequencies are dropped
+template <class T>
+inline float2 read_bin(const device T *input, isize offset, uint row_idx, uint k, uint n, bool strided, isize ndim, const constant isize *shape, const constant isize *stride) {
+    const float re = read_elm(input, offset, row_idx + 2 * k, strided, ndim, shape, stride);
+    const float im = k == 0 || 2 * k == n ? 0.0f : read_elm(input, offset, row_idx + 2 * k + 1, strided, ndim, shape, stride);
+    return float2(re, im);
+}
+
+// One threadgroup transforms one row in its own work buffers of 2 * nwork. A signal of even size n is packed into a
+// complex sequence of n / 2 whose transform is split back into the spectrum of the real signal.
+template <class T>
+kernel void rfft(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &n [[buffer(1)]],
+    const constant isize &nwork [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *shape [[buffer(4)]],
+    const constant isize *stride [[buffer(5)]],
+    const constant bool &strided [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    device T *output [[buffer(8)]],
+    device float2 *work [[buffer(9)]],
+    const device float2 *chirp [[buffer(10)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    const bool packed = n % 2 == 0;
+    const uint nfft = packed ? n / 2 : n;
+    const uint row_idx = row * n;
+    device float2 *x = work + row * 2 * nwork;
+    device float2 *y = x + nwork;
+
+    for (uint t = lid; t < nfft; t += group_size) {
+        if (packed) {
+            x[t] = float2(read_elm(input, offset[0], row_idx + 2 * t, strided, ndim, shape, stride), read_elm(input, offset[0], row_idx + 2 * t + 1, strided, ndim, shape, stride));
+        } else {
+            x[t] = float2(read_elm(input, offset[0], row_idx + t, strided, ndim, shape, stride), 0.0f);
+        }
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_device);
+    const device float2 *z = fft(x, y, nfft, nwork, chirp, -1.0f, lid, group_size);
+    device T *out = output + offset[1] + row * (n / 2 + 1) * 2;
+
+    if (packed) {
+        // X_k = E_k + e^(-2 pi i k / n) O_k with E and O the transforms of the even and odd samples,
+        // E_k = (Z_k + conj(Z_(m - k))) / 2 and O_k = (Z_k - conj(Z_(m - k))) / 2i
+        for (uint k = lid; k <= nfft; k += group_size) {
+            const float2 zk = z[k % nfft];
+            const float2 zc = cconj(z[(nfft - k) % nfft]);
+            const float2 even = 0.5f * (zk + zc);
+            const float2 diff = 0.5f * (zk - zc);
+            const float2 value = even + cmul(twiddle(-1.0f, k, n), float2(diff.y, -diff.x));
+            out[2 * k] = static_cast<T>(value.x);
+            out[2 * k + 1] = static_cast<T>(value.y);
+        }
+    } else {
+        for (uint k = lid; k <= nfft / 2; k += group_size) {
+            out[2 * k] = static_cast<T>(z[k].x);
+            out[2 * k + 1] = static_cast<T>(z[k].y);
+        }
+    }
+}
+
+// Reverses the split of rfft and scales by 1 / n
+template <class T>
+kernel void irfft(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &n [[buffer(1)]],
+    const constant isize &nwork [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *shape [[buffer(4)]],
+    const constant isize *stride [[buffer(5)]],
+    const constant bool &strided [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    device T *output [[buffer(8)]],
+    device float2 *work [[buffer(9)]],
+    const device float2 *chirp [[buffer(10)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    const bool packed = n % 2 == 0;
+    const uint nfft = packed ? n / 2 : n;
+    const uint nbin = n / 2 + 1;
+    const uint row_idx = row * nbin * 2;
+    device float2 *x = work + row * 2 * nwork;
+    device float2 *y = x + nwork;
+
+    if (packed) {
+        // Z_k = E_k + i O_k with E_k = (X_k + conj(X_(m - k))) / 2 and O_k = e^(2 pi i k / n) (X_k - conj(X_(m - k))) / 2
+        for (uint k = lid; k < nfft; k += group_size) {
+            const float2 xk = read_bin(input, offset[0], row_idx, k, n, strided, ndim, shape, stride);
+            const float2 xc = cconj(read_bin(input, offset[0], row_idx, nfft - k, n, strided, ndim, shape, stride));
+            const float2 even = 0.5f * (xk + xc);
+            const float2 odd = cmul(twiddle(1.0f, k, n), 0.5f * (xk - xc));
+            x[k] = float2(even.x - odd.y, even.y + odd.x);
+        }
+    } else {
+        // Hermitian symmetry fills in the negative frequencies
+        for (uint k = lid; k < nfft; k += group_size) {
+            x[k] = k < nbin ? read_bin(input, offset[0], row_idx, k, n, strided, ndim, shape, stride) : cconj(read_bin(input, offset[0], row_idx, nfft - k, n, strided, ndim, shape, stride));
+        }
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_device);
+    const device float2 *z = fft(x, y, nfft, nwork, chirp, 1.0f, lid, group_size);
+    device T *out = output + offset[1] + row * n;
+    const float scale = 1.0f / static_cast<float>(nfft);
+
+    for (uint t = lid; t < nfft; t += group_size) {
+        if (packed) {
+            out[2 * t] = static_cast<T>(z[t].x * scale);
+            out[2 * t + 1] = static_cast<T>(z[t].y * scale);
+        } else {
+            out[t] = static_cast<T>(z[t].x * scale);
+        }
+    }
+}
+
+#define def_fft(opname, dtype, T) \
+template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(opname<T>) opname<T>;
+
+#define def_fft_all_dtypes(opname) \
+def_fft(opname, f32, float); \
+def_fft(opname, f16, half); \
+def_fft(opname, bf16, bfloat);
+
+def_fft_all_dtypes(rfft);
+def_fft_all_dtypes(irfft);
@@ -0,0 +1,89 @@
+#include "utils.h"
+
+template <class T>
+kernel void gather(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &dim [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *in_stride [[buffer(4)]],
+    const constant isize *index_stride [[buffer(5)]],
+    const constant isize *out_stride [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    const device int *index [[buffer(8)]],
+    device T *output [[buffer(9)]],
+    uint id [[thread_position_in_grid]])
+{
+    isize carry = id;
+    isize in_loc = 0;
+    isize index_loc = 0;
+    isize out_loc = 0;
+
+    // The input location follows the output coordinates except along dim where the index is used
+    for (isize i = ndim - 1; i >= 0; i--) {
+        isize coord = carry % shape[i];
+        carry /= shape[i];
+        index_loc += coord * index_stride[i];
+        out_loc += coord * out_stride[i];
+
+        if (i != dim) {
+            in_loc += coord * in_stride[i];
+        }
+    }
+
+    in_loc += index[offset[1] + index_loc] * in_stride[dim];
+    output[offset[2] + out_loc] = input[offset[0] + in_loc];
+}
+
+template <class T>
+kernel void scatter(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &dim [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *in_stride [[buffer(4)]],
+    const constant isize *index_stride [[buffer(5)]],
+    const constant isize *out_stride [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    const device int *index [[buffer(8)]],
+    device T *output [[buffer(9)]],
+    uint id [[thread_position_in_grid]])
+{
+    isize carry = id;
+    isize in_loc = 0;
+    isize index_loc = 0;
+    isize out_loc = 0;
+
+    // The mirror of gather, the output location follows the input coordinates except along dim where the index is used
+    for (isize i = ndim - 1; i >= 0; i--) {
+        isize coord = carry % shape[i];
+        carry /= shape[i];
+        in_loc += coord * in_stride[i];
+        index_loc += coord * index_stride[i];
+
+        if (i != dim) {
+            out_loc += coord * out_stride[i];
+        }
+    }
+
+    out_loc += index[offset[1] + index_loc] * out_stride[dim];
+    output[offset[2] + out_loc] = input[offset[0] + in_loc];
+}
+
+#define def_gather(dtype, T) \
+template [[host_name("gather_" #dtype)]] [[kernel]] decltype(gather<T>) gather<T>;
+
+def_gather(f32, float);
+def_gather(f16, half);
+def_gather(bf16, bfloat);
+def_gather(i32, int);
+def_gather(b8, bool);
+
+#define def_scatter(dtype, T) \
+template [[host_name("scatter_" #dtype)]] [[kernel]] decltype(scatter<T>) scatter<T>;
+
+def_scatter(f32, float);
+def_scatter(f16, half);
+def_scatter(bf16, bfloat);
+def_scatter(i32, int);
+def_scatter(b8, bool);
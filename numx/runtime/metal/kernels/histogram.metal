@@ -0,0 +1,120 @@
+#include "utils.h"
+
+// Largest number of bins accumulated privately per threadgroup, 16KB of threadgroup memory
+constexpr constant uint histogram_local_nbin = 4096;
+
+// Returns -1 for elements outside of the bins
+template <class T>
+inline isize histogram_bin(T x, bool ranged, isize nbin, float min, float max) {
+    if (!ranged) {
+        isize bin = static_cast<isize>(static_cast<acc_t<T>>(x));
+        return bin < nbin ? bin : -1;
+    }
+
+    float fx = static_cast<float>(x);
+
+    // NaN fails both comparisons and is dropped as well
+    if (!(fx >= min && fx <= max)) {
+        return -1;
+    }
+
+    isize bin = static_cast<isize>((fx - min) / (max - min) * nbin);
+    // The upper edge belongs to the last bin
+    return bin < nbin ? bin : nbin - 1;
+}
+
+inline void local_bin_add(threadgroup metal::atomic_uint *bin, int val) {
+    metal::atomic_fetch_add_explicit(bin, static_cast<uint>(val), metal::memory_order_relaxed);
+}
+
+inline void local_bin_add(threadgroup metal::atomic_uint *bin, float val) {
+    // Threadgroup memory has no float atomics, add through a CAS loop on the bits
+    uint old_bits = metal::atomic_load_explicit(bin, metal::memory_order_relaxed);
+    while (!metal::atomic_compare_exchange_weak_explicit(bin, &old_bits, as_type<uint>(as_type<float>(old_bits) + val), metal::memory_order_relaxed, metal::memory_order_relaxed)) {
+    }
+}
+
+template <class R>
+inline R local_bin_load(threadgroup metal::atomic_uint *bin) {
+    return as_type<R>(metal::atomic_load_explicit(bin, metal::memory_order_relaxed));
+}
+
+// Every threadgroup accumulates a private histogram in threadgroup memory and merges it into the output
+// with one device atomic per non-empty bin, when the bins do not fit in threadgroup memory
+// the elements are added to the output directly since contention is low with that many bins
+template <class T, class R>
+kernel void histogram(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &numel [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *in_stride [[buffer(4)]],
+    const constant isize *weight_stride [[buffer(5)]],
+    const constant bool *strided [[buffer(6)]],
+    const constant isize &nbin [[buffer(7)]],
+    const constant bool &ranged [[buffer(8)]],
+    const constant float &min [[buffer(9)]],
+    const constant float &max [[buffer(10)]],
+    const constant bool &weighted [[buffer(11)]],
+    const device T *input [[buffer(12)]],
+    const device float *weight [[buffer(13)]],
+    device metal::_atomic<R> *output [[buffer(14)]],
+    uint id [[thread_position_in_grid]],
+    uint grid_size [[threads_per_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup metal::atomic_uint local_bins[histogram_local_nbin];
+    const bool privatized = nbin <= histogram_local_nbin;
+
+    if (privatized) {
+        for (isize bin = lid; bin < nbin; bin += group_size) {
+            metal::atomic_store_explicit(&local_bins[bin], 0u, metal::memory_order_relaxed);
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    for (isize i = id; i < numel; i += grid_size) {
+        isize in_loc = strided[0] ? get_elm_loc(i, ndim, shape, in_stride) : i;
+        isize bin = histogram_bin(input[offset[0] + in_loc], ranged, nbin, min, max);
+
+        if (bin < 0) {
+            continue;
+        }
+
+        R val = static_cast<R>(1);
+
+        if (weighted) {
+            isize weight_loc = strided[1] ? get_elm_loc(i, ndim, shape, weight_stride) : i;
+            val = static_cast<R>(weight[offset[1] + weight_loc]);
+        }
+
+        if (privatized) {
+            local_bin_add(&local_bins[bin], val);
+        } else {
+            metal::atomic_fetch_add_explicit(&output[offset[2] + bin], val, metal::memory_order_relaxed);
+        }
+    }
+
+    if (privatized) {
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+        for (isize bin = lid; bin < nbin; bin += group_size) {
+            R val = local_bin_load<R>(&local_bins[bin]);
+
+            if (val != 0) {
+                metal::atomic_fetch_add_explicit(&output[offset[2] + bin], val, metal::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+#define def_histogram(dtype, T)                                                                                                             \
+template [[host_name("histogram_" #dtype)]] [[kernel]] decltype(histogram<T, int>) histogram<T, int>;                                       \
+template [[host_name("weighted_histogram_" #dtype)]] [[kernel]] decltype(histogram<T, float>) histogram<T, float>;
+
+def_histogram(i32, int);
+def_histogram(f32, float);
+def_histogram(f16, half);
+def_histogram(bf16, bfloat);
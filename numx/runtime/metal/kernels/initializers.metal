@@ -16,7 +16,7 @@ kernel void arange(
     device T *output [[buffer(2)]],
     uint id [[thread_position_in_grid]])
 {
-    output[id] = start + static_cast<int>(id) * step;
+    output[id] = convert<T>(start + static_cast<int>(id) * step);
 }
 
 #define def_initializer_kernels(opname, op, dtype, T)   \
@@ -24,6 +24,8 @@ template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(op<T>) op<T>;
 
 #define def_initializer_numeric(opname, op)             \
 def_initializer_kernels(opname, op, f32, float);        \
+def_initializer_kernels(opname, op, f16, half);         \
+def_initializer_kernels(opname, op, bf16, bfloat);      \
 def_initializer_kernels(opname, op, i32, int);
 
 #define def_initializer_all(opname, op)                 \
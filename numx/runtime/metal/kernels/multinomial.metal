@@ -0,0 +1,220 @@
+#include "random.h"
+
+// Must match s_max_threadgroup_size on the host
+constexpr constant uint multinomial_max_group_size = 256;
+
+inline float multinomial_score(float x, bool logits, float temperature) {
+    // Probabilities are moved to log space so temperature applies the same way as for logits
+    return (logits ? x : metal::log(x)) / temperature;
+}
+
+// Maps floats to unsigned integers with the same ordering so thresholds can be searched bit by bit
+inline uint ordered_key(float x) {
+    uint bits = as_type<uint>(x);
+    return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+}
+
+// Every thread gets the sum over the threadgroup, the scratch buffer can be reused right after
+inline float threadgroup_sum(threadgroup float *scratch, float value, uint lid, uint group_size) {
+    scratch[lid] = value;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    for (uint step = group_size / 2; step > 0; step >>= 1) {
+        if (lid < step) {
+            scratch[lid] += scratch[lid + step];
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    float sum = scratch[0];
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    return sum;
+}
+
+// One threadgroup samples one row:
+// 1. the row maximum of the scores is found with a tree reduction,
+// 2. top-k and top-p thresholds are found by bisecting the ordered score keys,
+// 3. every thread sums the weights of its contiguous chunk and the chunk sums are scanned,
+// 4. each sample picks the chunk containing its uniform value and walks the chunk for the inverse CDF
+template <class T>
+kernel void multinomial(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *stride [[buffer(4)]],
+    const constant bool &strided [[buffer(5)]],
+    const constant isize &key [[buffer(6)]],
+    const constant isize &nsample [[buffer(7)]],
+    const constant float &temperature [[buffer(8)]],
+    const constant isize &top_k [[buffer(9)]],
+    const constant float &top_p [[buffer(10)]],
+    const constant bool &logits [[buffer(11)]],
+    const device T *input [[buffer(12)]],
+    device int *output [[buffer(13)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float scratch[multinomial_max_group_size];
+    threadgroup float prefixes[multinomial_max_group_size + 1];
+    threadgroup uint last_chunk;
+    const isize row_start = row * ncol;
+    const isize chunk = (ncol + group_size - 1) / group_size;
+    const isize chunk_start = lid * chunk;
+    const isize chunk_end = chunk_start + chunk < ncol ? chunk_start + chunk : ncol;
+
+    float local_max = -INFINITY;
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        isize loc = strided ? get_elm_loc(row_start + col, ndim, shape, stride) : row_start + col;
+        float score = multinomial_score(static_cast<float>(input[offset[0] + loc]), logits, temperature);
+        local_max = score > local_max ? score : local_max;
+    }
+
+    scratch[lid] = local_max;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    for (uint step = group_size / 2; step > 0; step >>= 1) {
+        if (lid < step && scratch[lid + step] > scratch[lid]) {
+            scratch[lid] = scratch[lid + step];
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    const float row_max = scratch[0];
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    // Scores below the threshold key are filtered out
+    uint threshold = 0;
+
+    if (top_k > 0 && top_k < ncol) {
+        // Largest key such that at least k scores are not below it, ties at the k-th score are all kept
+        uint lo = 0, hi = 0xffffffff;
+
+        while (lo < hi) {
+            uint mid = lo + (hi - lo) / 2 + 1;
+            float count = 0;
+
+            for (isize col = lid; col < ncol; col += group_size) {
+                isize loc = strided ? get_elm_loc(row_start + col, ndim, shape, stride) : row_start + col;
+                count += ordered_key(multinomial_score(static_cast<float>(input[offset[0] + loc]), logits, temperature)) >= mid;
+            }
+
+            if (threadgroup_sum(scratch, count, lid, group_size) >= top_k) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        threshold = lo;
+    }
+
+    if (top_p < 1.0f) {
+        // Largest key such that the scores not below it hold at least top_p of the remaining mass
+        float mass = 0;
+
+        for (isize col = lid; col < ncol; col += group_size) {
+            isize loc = strided ? get_elm_loc(row_start + col, ndim, shape, stride) : row_start + col;
+            float score = multinomial_score(static_cast<float>(input[offset[0] + loc]), logits, temperature);
+            mass += ordered_key(score) >= threshold ? metal::exp(score - row_max) : 0.0f;
+        }
+
+        const float target = top_p * threadgroup_sum(scratch, mass, lid, group_size);
+        uint lo = threshold, hi = 0xffffffff;
+
+        while (lo < hi) {
+            uint mid = lo + (hi - lo) / 2 + 1;
+            mass = 0;
+
+            for (isize col = lid; col < ncol; col += group_size) {
+                isize loc = strided ? get_elm_loc(row_start + col, ndim, shape, stride) : row_start + col;
+                float score = multinomial_score(static_cast<float>(input[offset[0] + loc]), logits, temperature);
+                mass += ordered_key(score) >= mid ? metal::exp(score - row_max) : 0.0f;
+            }
+
+            if (threadgroup_sum(scratch, mass, lid, group_size) >= target) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        threshold = lo;
+    }
+
+    float chunk_sum = 0;
+
+    for (isize col = chunk_start; col < chunk_end; col++) {
+        isize loc = strided ? get_elm_loc(row_start + col, ndim, shape, stride) : row_start + col;
+        float score = multinomial_score(static_cast<float>(input[offset[0] + loc]), logits, temperature);
+        chunk_sum += ordered_key(score) >= threshold ? metal::exp(score - row_max) : 0.0f;
+    }
+
+    scratch[lid] = chunk_sum;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    if (lid == 0) {
+        // The scan is sequential over at most 256 chunk sums, the last chunk with weight takes the rounding excess
+        prefixes[0] = 0;
+        last_chunk = 0;
+
+        for (uint i = 0; i < group_size; i++) {
+            prefixes[i + 1] = prefixes[i] + scratch[i];
+            last_chunk = scratch[i] > 0 ? i : last_chunk;
+        }
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    const float total = prefixes[group_size];
+
+    for (isize sample = 0; sample < nsample; sample++) {
+        const isize out_loc = offset[1] + row * nsample + sample;
+
+        // Rows without any weight, e.g. all probabilities are zero, fall back to the first index
+        if (total <= 0) {
+            if (lid == 0) {
+                output[out_loc] = 0;
+            }
+
+            continue;
+        }
+
+        uint2 hash = threefry2x32(uint2((key >> 32) & 0xffffffff, key & 0xffffffff), uint2(row, sample));
+        // Top 24 bits map exactly to a float in [0, 1)
+        float u = static_cast<float>(hash.x >> 8) / 16777216.0f * total;
+
+        if (chunk_sum <= 0 || u < prefixes[lid] || (u >= prefixes[lid + 1] && lid != last_chunk)) {
+            continue;
+        }
+
+        float acc = prefixes[lid];
+        isize picked = -1;
+
+        for (isize col = chunk_start; col < chunk_end; col++) {
+            isize loc = strided ? get_elm_loc(row_start + col, ndim, shape, stride) : row_start + col;
+            float score = multinomial_score(static_cast<float>(input[offset[0] + loc]), logits, temperature);
+            float weight = ordered_key(score) >= threshold ? metal::exp(score - row_max) : 0.0f;
+
+            if (weight > 0) {
+                acc += weight;
+                picked = col;
+
+                if (u < acc) {
+                    break;
+                }
+            }
+        }
+
+        output[out_loc] = static_cast<int>(picked);
+    }
+}
+
+#define def_multinomial(dtype, T) \
+template [[host_name("multinomial_" #dtype)]] [[kernel]] decltype(multinomial<T>) multinomial<T>;
+
+def_multinomial(f32, float);
+def_multinomial(f16, half);
+def_multinomial(bf16, bfloat);
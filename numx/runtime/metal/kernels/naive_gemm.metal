@@ -14,16 +14,16 @@ kernel void naive_gemm2d(
     const isize M = l_shape[0], K = l_shape[1], N = r_shape[1];
     
     if (row < M && col < N) {
-        R sum = 0;
+        acc_t<R> sum = 0;
         isize l_loc, r_loc, out_loc = offset[2] + row * N + col;
         
         for (isize i = 0; i < K; i++) {
             l_loc = offset[0] + row * K + i;
             r_loc = offset[1] + N * i + col;
-            sum += lhs[l_loc] * rhs[r_loc];
+            sum += static_cast<acc_t<R>>(lhs[l_loc]) * static_cast<acc_t<R>>(rhs[r_loc]);
         }
         
-        output[out_loc] = sum;
+        output[out_loc] = static_cast<R>(sum);
     }
 }
 
@@ -43,16 +43,16 @@ kernel void strided_naive_gemm2d(
     const isize M = l_shape[0], K = l_shape[1], N = r_shape[1];
     
     if (row < M && col < N) {
-        R sum = 0;
+        acc_t<R> sum = 0;
         isize l_loc, r_loc, out_loc = offset[2] + row * N + col;
         
         for (isize i = 0; i < K; i++) {
             l_loc = offset[0] + get_elm_loc(row * K + i, 2, l_shape, l_stride);
             r_loc = offset[1] + get_elm_loc(N * i + col, 2, r_shape, r_stride);
-            sum += lhs[l_loc] * rhs[r_loc];
+            sum += static_cast<acc_t<R>>(lhs[l_loc]) * static_cast<acc_t<R>>(rhs[r_loc]);
         }
         
-        output[out_loc] = sum;
+        output[out_loc] = static_cast<R>(sum);
     }
 }
 
@@ -76,16 +76,16 @@ kernel void naive_gemm3d(
     }
     
     if (batch < B && row < M && col < N) {
-        R sum = 0;
+        acc_t<R> sum = 0;
         isize l_loc, r_loc, out_loc = offset[2] + batch * M * N + row * N + col;
         
         for (isize i = 0; i < K; i++) {
             l_loc = offset[0] + batch * M * K + row * K + i;
             r_loc = offset[1] + batch * K * N + N * i + col;
-            sum += lhs[l_loc] * rhs[r_loc];
+            sum += static_cast<acc_t<R>>(lhs[l_loc]) * static_cast<acc_t<R>>(rhs[r_loc]);
         }
         
-        output[out_loc] = sum;
+        output[out_loc] = static_cast<R>(sum);
     }
 }
 
@@ -111,16 +111,16 @@ kernel void strided_naive_gemm3d(
     }
     
     if (batch < B && row < M && col < N) {
-        R sum = 0;
+        acc_t<R> sum = 0;
         isize l_loc, r_loc, out_loc = offset[2] + batch * M * N + row * N + col;
         
         for (isize i = 0; i < K; i++) {
             l_loc = offset[0] + get_elm_loc(batch * M * K + row * K + i, ndim, l_shape, l_stride);
             r_loc = offset[1] + get_elm_loc(batch * K * N + N * i + col, ndim, r_shape, r_stride);
-            sum += lhs[l_loc] * rhs[r_loc];
+            sum += static_cast<acc_t<R>>(lhs[l_loc]) * static_cast<acc_t<R>>(rhs[r_loc]);
         }
         
-        output[out_loc] = sum;
+        output[out_loc] = static_cast<R>(sum);
     }
 }
 
@@ -131,4 +131,6 @@ template [[host_name("strided_naive_gemm2d_" #dtype)]] [[kernel]] decltype(strid
 template [[host_name("strided_naive_gemm3d_" #dtype)]] [[kernel]] decltype(strided_naive_gemm3d<T, R>) strided_naive_gemm3d<T, R>;
 
 def_naive_gemm(f32, float, float);
+def_naive_gemm(f16, half, half);
+def_naive_gemm(bf16, bfloat, bfloat);
 def_naive_gemm(i32, int, int);
\ No newline at end of file
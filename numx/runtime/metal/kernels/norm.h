@@ -0,0 +1,41 @@
+#pragma once
+
+#include "utils.h"
+
+// Must match s_max_threadgroup_size on the host
+constexpr constant uint norm_max_group_size = 256;
+
+inline isize norm_elm_loc(uint id, bool strided, isize ndim, const constant isize *shape, const constant isize *stride) {
+    return strided ? get_elm_loc(id, ndim, shape, stride) : id;
+}
+
+// Merges the partial Welford statistics of every thread in the threadgroup into the first slot
+inline void merge_welford(threadgroup float *counts, threadgroup float *means, threadgroup float *m2s, uint lid, uint group_size) {
+    for (uint step = group_size / 2; step > 0; step >>= 1) {
+        if (lid < step) {
+            float count_a = counts[lid], count_b = counts[lid + step];
+            float count = count_a + count_b;
+
+            if (count_b > 0) {
+                float delta = means[lid + step] - means[lid];
+                means[lid] += delta * count_b / count;
+                m2s[lid] += m2s[lid + step] + delta * delta * count_a * count_b / count;
+                counts[lid] = count;
+            }
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+}
+
+// Sums two partial values of every thread in the threadgroup into the first slot
+inline void sum_pairs(threadgroup float *firsts, threadgroup float *seconds, uint lid, uint group_size) {
+    for (uint step = group_size / 2; step > 0; step >>= 1) {
+        if (lid < step) {
+            firsts[lid] += firsts[lid + step];
+            seconds[lid] += seconds[lid + step];
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+}
@@ -0,0 +1,167 @@
+#include "norm.h"
+
+// One threadgroup normalizes one row over the last dimension
+// Layer normalization computes mean and variance in a single Welford pass,
+// RMS normalization only accumulates the sum of squares
+template <class T>
+kernel void norm(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *stride [[buffer(4)]],
+    const constant isize *param_stride [[buffer(5)]],
+    const constant bool &strided [[buffer(6)]],
+    const constant bool &centered [[buffer(7)]],
+    const constant float &eps [[buffer(8)]],
+    const device T *input [[buffer(9)]],
+    const device T *weight [[buffer(10)]],
+    const device T *bias [[buffer(11)]],
+    device float *stats [[buffer(12)]],
+    device T *output [[buffer(13)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float counts[norm_max_group_size];
+    threadgroup float means[norm_max_group_size];
+    threadgroup float m2s[norm_max_group_size];
+    const isize row_start = row * ncol;
+    float count = 0, mean = 0, m2 = 0;
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        float val = static_cast<float>(input[offset[0] + norm_elm_loc(row_start + col, strided, ndim, shape, stride)]);
+
+        if (centered) {
+            count++;
+            float delta = val - mean;
+            mean += delta / count;
+            m2 += delta * (val - mean);
+        } else {
+            m2 += val * val;
+        }
+    }
+
+    counts[lid] = count;
+    means[lid] = mean;
+    m2s[lid] = m2;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    if (centered) {
+        merge_welford(counts, means, m2s, lid, group_size);
+    } else {
+        sum_pairs(m2s, means, lid, group_size);
+    }
+
+    const float row_mean = centered ? means[0] : 0.0f;
+    const float rstd = metal::rsqrt(m2s[0] / ncol + eps);
+
+    if (lid == 0) {
+        stats[offset[3] + row * 2] = row_mean;
+        stats[offset[3] + row * 2 + 1] = rstd;
+    }
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        float val = static_cast<float>(input[offset[0] + norm_elm_loc(row_start + col, strided, ndim, shape, stride)]);
+        float out = (val - row_mean) * rstd * static_cast<float>(weight[offset[1] + col * param_stride[0]]);
+
+        if (centered) {
+            out += static_cast<float>(bias[offset[2] + col * param_stride[1]]);
+        }
+
+        output[offset[4] + row_start + col] = static_cast<T>(out);
+    }
+}
+
+// One threadgroup computes the input gradient of one row, both row reductions happen in the same pass
+template <class T>
+kernel void norm_grad(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *grad_stride [[buffer(4)]],
+    const constant isize *in_stride [[buffer(5)]],
+    const constant isize &weight_stride [[buffer(6)]],
+    const constant bool *strided [[buffer(7)]],
+    const constant bool &centered [[buffer(8)]],
+    const device T *grad [[buffer(9)]],
+    const device T *input [[buffer(10)]],
+    const device T *weight [[buffer(11)]],
+    const device float *stats [[buffer(12)]],
+    device T *output [[buffer(13)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float grad_sums[norm_max_group_size];
+    threadgroup float dot_sums[norm_max_group_size];
+    const isize row_start = row * ncol;
+    const float mean = stats[offset[3] + row * 2];
+    const float rstd = stats[offset[3] + row * 2 + 1];
+    float grad_sum = 0, dot_sum = 0;
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        uint id = row_start + col;
+        float g = static_cast<float>(grad[offset[0] + norm_elm_loc(id, strided[0], ndim, shape, grad_stride)]) * static_cast<float>(weight[offset[2] + col * weight_stride]);
+        float xhat = (static_cast<float>(input[offset[1] + norm_elm_loc(id, strided[1], ndim, shape, in_stride)]) - mean) * rstd;
+        grad_sum += g;
+        dot_sum += g * xhat;
+    }
+
+    grad_sums[lid] = grad_sum;
+    dot_sums[lid] = dot_sum;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    sum_pairs(grad_sums, dot_sums, lid, group_size);
+    const float grad_mean = centered ? grad_sums[0] / ncol : 0.0f;
+    const float dot_mean = dot_sums[0] / ncol;
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        uint id = row_start + col;
+        float g = static_cast<float>(grad[offset[0] + norm_elm_loc(id, strided[0], ndim, shape, grad_stride)]) * static_cast<float>(weight[offset[2] + col * weight_stride]);
+        float xhat = (static_cast<float>(input[offset[1] + norm_elm_loc(id, strided[1], ndim, shape, in_stride)]) - mean) * rstd;
+        output[offset[4] + id] = static_cast<T>(rstd * (g - grad_mean - xhat * dot_mean));
+    }
+}
+
+// One thread per feature sums over the rows, neighbouring threads read neighbouring columns
+// Weight gradients go to the first row of the output and bias gradients to the second
+template <class T>
+kernel void norm_param_grad(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize &nrow [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *shape [[buffer(4)]],
+    const constant isize *grad_stride [[buffer(5)]],
+    const constant isize *in_stride [[buffer(6)]],
+    const constant bool *strided [[buffer(7)]],
+    const constant bool &centered [[buffer(8)]],
+    const device T *grad [[buffer(9)]],
+    const device T *input [[buffer(10)]],
+    const device float *stats [[buffer(11)]],
+    device T *output [[buffer(12)]],
+    uint col [[thread_position_in_grid]])
+{
+    float weight_grad = 0, bias_grad = 0;
+
+    for (isize row = 0; row < nrow; row++) {
+        uint id = row * ncol + col;
+        float g = static_cast<float>(grad[offset[0] + norm_elm_loc(id, strided[0], ndim, shape, grad_stride)]);
+        float xhat = (static_cast<float>(input[offset[1] + norm_elm_loc(id, strided[1], ndim, shape, in_stride)]) - stats[offset[2] + row * 2]) * stats[offset[2] + row * 2 + 1];
+        weight_grad += g * xhat;
+        bias_grad += g;
+    }
+
+    output[offset[3] + col] = static_cast<T>(weight_grad);
+    output[offset[3] + ncol + col] = static_cast<T>(centered ? bias_grad : 0.0f);
+}
+
+#define def_norm(dtype, T)                                                                              \
+template [[host_name("norm_" #dtype)]] [[kernel]] decltype(norm<T>) norm<T>;                            \
+template [[host_name("norm_grad_" #dtype)]] [[kernel]] decltype(norm_grad<T>) norm_grad<T>;             \
+template [[host_name("norm_param_grad_" #dtype)]] [[kernel]] decltype(norm_param_grad<T>) norm_param_grad<T>;
+
+def_norm(f32, float);
+def_norm(f16, half);
+def_norm(bf16, bfloat);
@@ -0,0 +1,233 @@
+#include "utils.h"
+
+// Geometry of a 2D pooling, shared by the host through a flat buffer
+struct PoolGeometry {
+    isize nchannel, height, width;
+    isize out_height, out_width;
+    isize kernel_h, kernel_w;
+    isize stride_h, stride_w;
+    isize padding_h, padding_w;
+    bool adaptive;
+
+    PoolGeometry(const constant isize *geometry) :
+        nchannel(geometry[0]), height(geometry[1]), width(geometry[2]),
+        out_height(geometry[3]), out_width(geometry[4]),
+        kernel_h(geometry[5]), kernel_w(geometry[6]),
+        stride_h(geometry[7]), stride_w(geometry[8]),
+        padding_h(geometry[9]), padding_w(geometry[10]),
+        adaptive(geometry[11] != 0) {}
+
+    // Window bounds are unclipped and the end is exclusive
+    isize row_start(isize out_row) const { return adaptive ? (out_row * height) / out_height : out_row * stride_h - padding_h; }
+    isize row_end(isize out_row) const { return adaptive ? ((out_row + 1) * height + out_height - 1) / out_height : out_row * stride_h - padding_h + kernel_h; }
+    isize col_start(isize out_col) const { return adaptive ? (out_col * width) / out_width : out_col * stride_w - padding_w; }
+    isize col_end(isize out_col) const { return adaptive ? ((out_col + 1) * width + out_width - 1) / out_width : out_col * stride_w - padding_w + kernel_w; }
+
+    // Candidate output rows whose windows may contain the input row, callers check the window bounds
+    isize first_out_row(isize row) const {
+        if (adaptive) {
+            return (row * out_height) / height;
+        }
+
+        isize first = row + padding_h - kernel_h + 1;
+        return first <= 0 ? 0 : (first + stride_h - 1) / stride_h;
+    }
+
+    isize last_out_row(isize row) const {
+        isize last = adaptive ? ((row + 1) * out_height + height - 1) / height : (row + padding_h) / stride_h + 1;
+        return last < out_height ? last : out_height;
+    }
+
+    isize first_out_col(isize col) const {
+        if (adaptive) {
+            return (col * out_width) / width;
+        }
+
+        isize first = col + padding_w - kernel_w + 1;
+        return first <= 0 ? 0 : (first + stride_w - 1) / stride_w;
+    }
+
+    isize last_out_col(isize col) const {
+        isize last = adaptive ? ((col + 1) * out_width + width - 1) / width : (col + padding_w) / stride_w + 1;
+        return last < out_width ? last : out_width;
+    }
+
+    // Padding counts towards the divisor except for adaptive windows, which never overlap the padding
+    isize divisor(isize out_row, isize out_col) const {
+        return adaptive ? (row_end(out_row) - row_start(out_row)) * (col_end(out_col) - col_start(out_col)) : kernel_h * kernel_w;
+    }
+};
+
+// Splits a flat index over (N, C, H, W) or (N, H, W, C) into (n, c, h, w)
+// Channels are the fastest dimension in NHWC so neighbouring threads read neighbouring channels
+inline void decode_image_index(uint id, bool channels_last, isize nchannel, isize height, isize width, thread isize &image_idx, thread isize &channel, thread isize &row, thread isize &col) {
+    if (channels_last) {
+        channel = id % nchannel;
+        col = (id / nchannel) % width;
+        row = (id / (nchannel * width)) % height;
+        image_idx = id / (nchannel * width * height);
+    } else {
+        col = id % width;
+        row = (id / width) % height;
+        channel = (id / (width * height)) % nchannel;
+        image_idx = id / (width * height * nchannel);
+    }
+}
+
+// Finds the first maximum of a window in row-major order, the forward and backward passes agree on ties
+template <class T>
+inline void window_argmax(PoolGeometry g, const device T *input, isize base, const constant isize *in_stride, isize out_row, isize out_col, thread isize &max_row, thread isize &max_col, thread acc_t<T> &max_val) {
+    const isize start_row = g.row_start(out_row) < 0 ? 0 : g.row_start(out_row);
+    const isize end_row = g.row_end(out_row) > g.height ? g.height : g.row_end(out_row);
+    const isize start_col = g.col_start(out_col) < 0 ? 0 : g.col_start(out_col);
+    const isize end_col = g.col_end(out_col) > g.width ? g.width : g.col_end(out_col);
+    max_row = -1;
+
+    for (isize row = start_row; row < end_row; row++) {
+        for (isize col = start_col; col < end_col; col++) {
+            acc_t<T> val = static_cast<acc_t<T>>(input[base + row * in_stride[2] + col * in_stride[3]]);
+
+            if (max_row < 0 || val > max_val) {
+                max_val = val;
+                max_row = row;
+                max_col = col;
+            }
+        }
+    }
+}
+
+// Strides are given in (N, C, H, W) order whatever the layout, outputs are contiguous
+template <class T>
+kernel void maxpool2d(
+    const constant isize *geometry [[buffer(0)]],
+    const constant bool &channels_last [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *in_stride [[buffer(3)]],
+    const device T *input [[buffer(4)]],
+    device T *output [[buffer(5)]],
+    uint id [[thread_position_in_grid]])
+{
+    PoolGeometry g(geometry);
+    isize image_idx, channel, out_row, out_col, max_row, max_col;
+    decode_image_index(id, channels_last, g.nchannel, g.out_height, g.out_width, image_idx, channel, out_row, out_col);
+    const isize base = offset[0] + image_idx * in_stride[0] + channel * in_stride[1];
+    acc_t<T> max_val = 0;
+    window_argmax(g, input, base, in_stride, out_row, out_col, max_row, max_col, max_val);
+    output[offset[1] + id] = static_cast<T>(max_val);
+}
+
+template <class T>
+kernel void avgpool2d(
+    const constant isize *geometry [[buffer(0)]],
+    const constant bool &channels_last [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *in_stride [[buffer(3)]],
+    const device T *input [[buffer(4)]],
+    device T *output [[buffer(5)]],
+    uint id [[thread_position_in_grid]])
+{
+    PoolGeometry g(geometry);
+    isize image_idx, channel, out_row, out_col;
+    decode_image_index(id, channels_last, g.nchannel, g.out_height, g.out_width, image_idx, channel, out_row, out_col);
+    const isize base = offset[0] + image_idx * in_stride[0] + channel * in_stride[1];
+    const isize start_row = g.row_start(out_row) < 0 ? 0 : g.row_start(out_row);
+    const isize end_row = g.row_end(out_row) > g.height ? g.height : g.row_end(out_row);
+    const isize start_col = g.col_start(out_col) < 0 ? 0 : g.col_start(out_col);
+    const isize end_col = g.col_end(out_col) > g.width ? g.width : g.col_end(out_col);
+    acc_t<T> acc = 0;
+
+    for (isize row = start_row; row < end_row; row++) {
+        for (isize col = start_col; col < end_col; col++) {
+            acc += static_cast<acc_t<T>>(input[base + row * in_stride[2] + col * in_stride[3]]);
+        }
+    }
+
+    output[offset[1] + id] = static_cast<T>(acc / static_cast<acc_t<T>>(g.divisor(out_row, out_col)));
+}
+
+// Each thread gathers the gradients of the windows containing one input element, no atomics are needed
+template <class T>
+kernel void avgpool2d_grad(
+    const constant isize *geometry [[buffer(0)]],
+    const constant bool &channels_last [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *grad_stride [[buffer(3)]],
+    const device T *grad [[buffer(4)]],
+    device T *output [[buffer(5)]],
+    uint id [[thread_position_in_grid]])
+{
+    PoolGeometry g(geometry);
+    isize image_idx, channel, row, col;
+    decode_image_index(id, channels_last, g.nchannel, g.height, g.width, image_idx, channel, row, col);
+    const isize grad_base = offset[0] + image_idx * grad_stride[0] + channel * grad_stride[1];
+    acc_t<T> acc = 0;
+
+    for (isize out_row = g.first_out_row(row); out_row < g.last_out_row(row); out_row++) {
+        if (row < g.row_start(out_row) || row >= g.row_end(out_row)) {
+            continue;
+        }
+
+        for (isize out_col = g.first_out_col(col); out_col < g.last_out_col(col); out_col++) {
+            if (col < g.col_start(out_col) || col >= g.col_end(out_col)) {
+                continue;
+            }
+
+            acc += static_cast<acc_t<T>>(grad[grad_base + out_row * grad_stride[2] + out_col * grad_stride[3]]) / static_cast<acc_t<T>>(g.divisor(out_row, out_col));
+        }
+    }
+
+    output[offset[1] + id] = static_cast<T>(acc);
+}
+
+// The argmax of every window containing the element is recomputed from the input instead of being stored
+template <class T>
+kernel void maxpool2d_grad(
+    const constant isize *geometry [[buffer(0)]],
+    const constant bool &channels_last [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *in_stride [[buffer(3)]],
+    const constant isize *grad_stride [[buffer(4)]],
+    const device T *input [[buffer(5)]],
+    const device T *grad [[buffer(6)]],
+    device T *output [[buffer(7)]],
+    uint id [[thread_position_in_grid]])
+{
+    PoolGeometry g(geometry);
+    isize image_idx, channel, row, col, max_row, max_col;
+    decode_image_index(id, channels_last, g.nchannel, g.height, g.width, image_idx, channel, row, col);
+    const isize in_base = offset[0] + image_idx * in_stride[0] + channel * in_stride[1];
+    const isize grad_base = offset[1] + image_idx * grad_stride[0] + channel * grad_stride[1];
+    acc_t<T> acc = 0;
+    acc_t<T> max_val = 0;
+
+    for (isize out_row = g.first_out_row(row); out_row < g.last_out_row(row); out_row++) {
+        if (row < g.row_start(out_row) || row >= g.row_end(out_row)) {
+            continue;
+        }
+
+        for (isize out_col = g.first_out_col(col); out_col < g.last_out_col(col); out_col++) {
+            if (col < g.col_start(out_col) || col >= g.col_end(out_col)) {
+                continue;
+            }
+
+            window_argmax(g, input, in_base, in_stride, out_row, out_col, max_row, max_col, max_val);
+
+            if (max_row == row && max_col == col) {
+                acc += static_cast<acc_t<T>>(grad[grad_base + out_row * grad_stride[2] + out_col * grad_stride[3]]);
+            }
+        }
+    }
+
+    output[offset[2] + id] = static_cast<T>(acc);
+}
+
+#define def_pool(dtype, T)                                                                                  \
+template [[host_name("maxpool2d_" #dtype)]] [[kernel]] decltype(maxpool2d<T>) maxpool2d<T>;                 \
+template [[host_name("avgpool2d_" #dtype)]] [[kernel]] decltype(avgpool2d<T>) avgpool2d<T>;                 \
+template [[host_name("avgpool2d_grad_" #dtype)]] [[kernel]] decltype(avgpool2d_grad<T>) avgpool2d_grad<T>;  \
+template [[host_name("maxpool2d_grad_" #dtype)]] [[kernel]] decltype(maxpool2d_grad<T>) maxpool2d_grad<T>;
+
+def_pool(f32, float);
+def_pool(f16, half);
+def_pool(bf16, bfloat);
+def_pool(i32, int);
@@ -0,0 +1,125 @@
+#include "utils.h"
+
+// Must match s_precise_sum_nread in the runner
+constexpr constant uint precise_sum_nread = 16;
+
+// Sums are carried as a head and the rounding error of the head, which doubles the precision of f32
+// since the device has no f64 arithmetic. Relies on -fno-fast-math so the error terms are not folded away.
+inline float2 two_sum(float a, float b) {
+    float s = a + b;
+    float bb = s - a;
+    return float2(s, (a - (s - bb)) + (b - bb));
+}
+
+inline float2 compensated_add(float2 a, float2 b) {
+    float2 s = two_sum(a.x, b.x);
+    float tail = s.y + a.y + b.y;
+    // Renormalize so the tail stays below half an ulp of the head
+    float head = s.x + tail;
+    return float2(head, tail - (head - s.x));
+}
+
+inline float2 compensated_simd_reduce(float2 val) {
+    for (uint lanes = simd_size / 2; lanes > 0; lanes /= 2) {
+        val = compensated_add(val, metal::simd_shuffle_down(val, lanes));
+    }
+    return val;
+}
+
+// The result is valid in the first thread of the threadgroup
+inline float2 compensated_threadgroup_reduce(float2 val, threadgroup float2 *simd_partials, uint lid, uint simd_per_group, uint simd_lane_id, uint simd_group_id) {
+    val = compensated_simd_reduce(val);
+
+    if (simd_per_group > 1) {
+        if (simd_lane_id == 0) {
+            simd_partials[simd_group_id] = val;
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+        val = lid < simd_per_group ? simd_partials[lid] : float2(0.0f);
+        val = compensated_simd_reduce(val);
+    }
+
+    return val;
+}
+
+// Each threadgroup sums one block of a row, the row being the last dimension of the given view
+// A row with a single block is written directly, otherwise the block partials are merged by precise_sum_merge
+template <class T>
+kernel void precise_sum(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *stride [[buffer(4)]],
+    const constant bool &strided [[buffer(5)]],
+    const device T *input [[buffer(6)]],
+    device float *output [[buffer(7)]],
+    device float2 *partials [[buffer(8)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint2 ngroup [[threadgroups_per_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint2 lsize [[threads_per_threadgroup]],
+    uint simd_per_group [[simdgroups_per_threadgroup]],
+    uint simd_lane_id [[thread_index_in_simdgroup]],
+    uint simd_group_id [[simdgroup_index_in_threadgroup]])
+{
+    threadgroup float2 simd_partials[simd_size];
+    const uint group_size = lsize.x;
+    const isize row_idx = group_id.y * ncol;
+    const isize block_size = group_size * precise_sum_nread;
+    const isize block_end = (group_id.x + 1) * block_size;
+    const isize col_end = block_end < ncol ? block_end : ncol;
+    float2 acc = float2(0.0f);
+
+    // Consecutive threads read consecutive columns
+    for (isize col = group_id.x * block_size + lid; col < col_end; col += group_size) {
+        const isize id = row_idx + col;
+        const isize loc = strided ? get_elm_loc(id, ndim, shape, stride) : id;
+        acc = compensated_add(acc, float2(static_cast<float>(input[offset[0] + loc]), 0.0f));
+    }
+
+    acc = compensated_threadgroup_reduce(acc, simd_partials, lid, simd_per_group, simd_lane_id, simd_group_id);
+
+    if (lid == 0) {
+        if (ngroup.x == 1) {
+            output[offset[1] + group_id.y] = acc.x + acc.y;
+        } else {
+            partials[group_id.y * ngroup.x + group_id.x] = acc;
+        }
+    }
+}
+
+// One threadgroup merges the block partials of one row
+kernel void precise_sum_merge(
+    const constant isize &npartial [[buffer(0)]],
+    const constant isize &offset [[buffer(1)]],
+    const device float2 *partials [[buffer(2)]],
+    device float *output [[buffer(3)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]],
+    uint simd_per_group [[simdgroups_per_threadgroup]],
+    uint simd_lane_id [[thread_index_in_simdgroup]],
+    uint simd_group_id [[simdgroup_index_in_threadgroup]])
+{
+    threadgroup float2 simd_partials[simd_size];
+    float2 acc = float2(0.0f);
+
+    for (isize i = lid; i < npartial; i += group_size) {
+        acc = compensated_add(acc, partials[row * npartial + i]);
+    }
+
+    acc = compensated_threadgroup_reduce(acc, simd_partials, lid, simd_per_group, simd_lane_id, simd_group_id);
+
+    if (lid == 0) {
+        output[offset + row] = acc.x + acc.y;
+    }
+}
+
+#define def_precise_sum(dtype, T) \
+template [[host_name("precise_sum_" #dtype)]] [[kernel]] decltype(precise_sum<T>) precise_sum<T>;
+
+def_precise_sum(f32, float);
+def_precise_sum(f16, half);
+def_precise_sum(bf16, bfloat);
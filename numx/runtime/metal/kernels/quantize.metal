@@ -0,0 +1,166 @@
+#include "norm.h"
+#include "unary.h"
+
+// Must match QuantizedActivation on the host
+constexpr constant uint quantized_relu = 1;
+constexpr constant uint quantized_gelu = 2;
+constexpr constant uint quantized_silu = 3;
+
+inline float quantized_activate(float x, uint activation) {
+    switch (activation) {
+    case quantized_relu:
+        return Relu()(x);
+    case quantized_gelu:
+        return Gelu()(x);
+    case quantized_silu:
+        return Silu()(x);
+    default:
+        return x;
+    }
+}
+
+// Four consecutive bytes along K, gathered bytewise since rows are not guaranteed to be 4-byte aligned
+inline int4 load_char4(const device char *ptr) {
+    return int4(ptr[0], ptr[1], ptr[2], ptr[3]);
+}
+
+// One threadgroup quantizes one row over the last dimension symmetrically to [-127, 127]
+template <class T>
+kernel void quantize(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *stride [[buffer(4)]],
+    const constant bool &strided [[buffer(5)]],
+    const constant float &clip [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    device float *scale [[buffer(8)]],
+    device char *output [[buffer(9)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float absmaxes[norm_max_group_size];
+    const isize row_start = row * ncol;
+    float absmax = 0;
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        absmax = metal::max(absmax, metal::abs(static_cast<float>(input[offset[0] + norm_elm_loc(row_start + col, strided, ndim, shape, stride)])));
+    }
+
+    absmaxes[lid] = absmax;
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    for (uint step = group_size / 2; step > 0; step >>= 1) {
+        if (lid < step) {
+            absmaxes[lid] = metal::max(absmaxes[lid], absmaxes[lid + step]);
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+
+    absmax = clip > 0 ? metal::min(absmaxes[0], clip) : absmaxes[0];
+    // Rows of zeros keep a unit scale so that dequantization stays finite
+    const float row_scale = absmax > 0 ? absmax / 127.0f : 1.0f;
+    const float inv_scale = 1.0f / row_scale;
+
+    if (lid == 0) {
+        scale[offset[1] + row] = row_scale;
+    }
+
+    for (isize col = lid; col < ncol; col += group_size) {
+        float val = static_cast<float>(input[offset[0] + norm_elm_loc(row_start + col, strided, ndim, shape, stride)]);
+        output[offset[2] + row_start + col] = static_cast<char>(metal::clamp(metal::rint(val * inv_scale), -127.0f, 127.0f));
+    }
+}
+
+// Every thread computes a 4x4 output tile of act(lhs rhs^T * l_scale r_scale + bias), both int8 operands are row-major along K
+// so that the weight keeps the (out, in) layout of a linear layer, and the products are accumulated in i32
+template <class T>
+kernel void quantized_matmul(
+    const constant isize &M [[buffer(0)]],
+    const constant isize &K [[buffer(1)]],
+    const constant isize &N [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant bool &has_bias [[buffer(4)]],
+    const constant uint &activation [[buffer(5)]],
+    const device char *lhs [[buffer(6)]],
+    const device float *l_scale [[buffer(7)]],
+    const device char *rhs [[buffer(8)]],
+    const device float *r_scale [[buffer(9)]],
+    const device T *bias [[buffer(10)]],
+    device T *output [[buffer(11)]],
+    uint2 id [[thread_position_in_grid]])
+{
+    const isize row = id.y * 4, col = id.x * 4;
+
+    if (row >= M || col >= N) {
+        return;
+    }
+
+    const isize tile_height = 4 < (M - row) ? 4 : (M - row);
+    const isize tile_width = 4 < (N - col) ? 4 : (N - col);
+    // Rows past the edge of the tile repeat the last valid row and are never stored
+    const device char *l_rows[4], *r_rows[4];
+
+    #pragma unroll
+    for (ubyte j = 0; j < 4; ++j) {
+        l_rows[j] = lhs + offset[0] + (row + (j < tile_height ? j : tile_height - 1)) * K;
+        r_rows[j] = rhs + offset[2] + (col + (j < tile_width ? j : tile_width - 1)) * K;
+    }
+
+    int acc[4][4] = {};
+    isize i = 0;
+
+    for (; i + 4 <= K; i += 4) {
+        int4 l_tile[4], r_tile[4];
+
+        #pragma unroll
+        for (ubyte j = 0; j < 4; ++j) {
+            l_tile[j] = load_char4(l_rows[j] + i);
+            r_tile[j] = load_char4(r_rows[j] + i);
+        }
+
+        #pragma unroll
+        for (ubyte j = 0; j < 4; ++j) {
+            #pragma unroll
+            for (ubyte k = 0; k < 4; ++k) {
+                int4 prod = l_tile[j] * r_tile[k];
+                acc[j][k] += prod.x + prod.y + prod.z + prod.w;
+            }
+        }
+    }
+
+    for (; i < K; ++i) {
+        #pragma unroll
+        for (ubyte j = 0; j < 4; ++j) {
+            #pragma unroll
+            for (ubyte k = 0; k < 4; ++k) {
+                acc[j][k] += static_cast<int>(l_rows[j][i]) * static_cast<int>(r_rows[k][i]);
+            }
+        }
+    }
+
+    for (isize j = 0; j < tile_height; ++j) {
+        const float row_scale = l_scale[offset[1] + row + j];
+
+        for (isize k = 0; k < tile_width; ++k) {
+            float val = static_cast<float>(acc[j][k]) * row_scale * r_scale[offset[3] + col + k];
+
+            if (has_bias) {
+                val += static_cast<float>(bias[offset[4] + col + k]);
+            }
+
+            output[offset[5] + (row + j) * N + col + k] = static_cast<T>(quantized_activate(val, activation));
+        }
+    }
+}
+
+#define def_quantize(dtype, T)                                                                                                         \
+template [[host_name("quantize_" #dtype)]] [[kernel]] decltype(quantize<T>) quantize<T>;                                               \
+template [[host_name("quantized_matmul_" #dtype)]] [[kernel]] decltype(quantized_matmul<T>) quantized_matmul<T>;
+
+def_quantize(f32, float);
+def_quantize(f16, half);
+def_quantize(bf16, bfloat);
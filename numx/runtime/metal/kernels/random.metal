@@ -1,33 +1,4 @@
-#include "utils.h"
-
-static constexpr constant uint s_rot2x32[] = {13, 15, 26, 6, 17, 29, 16, 24};
-
-uint rotl32(uint x, uint N) {
-    return (x << (N & 31)) | (x >> ((32-N) & 31));
-}
-
-uint2 threefry2x32(uint2 key, uint2 counter) {
-    uint ks[] = {key.x, key.y, 0x1BD11BDA ^ key.x ^ key.y};
-    uint2 X = counter;
-    X.x += ks[0];
-    X.y += ks[1];
-    short j = 1;
-    
-    for (short i = 0; i < 20; i++) {
-        X.x += X.y;
-        X.y = rotl32(X.y, s_rot2x32[i % 8]);
-        X.y ^= X.x;
-        
-        if (i % 4 == 3) {
-            X.x += ks[j % 3];
-            X.y += ks[(j+1) % 3];
-            X.y += j;
-            j++;
-        }
-    }
-    
-    return X;
-}
+#include "random.h"
 
 struct Uniform {
     template<class F, class I>
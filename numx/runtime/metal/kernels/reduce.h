@@ -136,28 +136,28 @@ struct Argmin {
 };
 
 struct AtomicArgmax {
-    template <class T>
-    void operator()(const device T *input, volatile device metal::_atomic<uint> *output, thread IndexValPair<T> &new_pair) {
+    template <class T, class A>
+    void operator()(const device T *input, volatile device metal::_atomic<uint> *output, thread IndexValPair<A> &new_pair) {
         uint old_idx = metal::atomic_load_explicit(output, metal::memory_order_relaxed);
-        T old_val;
+        A old_val;
 
         do {
-            old_val = input[old_idx];
+            old_val = static_cast<A>(input[old_idx]);
             if (old_val >= new_pair.val) {
                 break;
             }
         } while (!metal::atomic_compare_exchange_weak_explicit(output, &old_idx, new_pair.idx, metal::memory_order_relaxed, metal::memory_order_relaxed));
     }
 
-    template <class T>
-    void operator()(const device T *input, const isize row_idx, const isize ndim, const constant isize *shape, const constant isize *stride, volatile device metal::_atomic<uint> *output, thread IndexValPair<T> &new_pair) {
+    template <class T, class A>
+    void operator()(const device T *input, const isize row_idx, const isize ndim, const constant isize *shape, const constant isize *stride, volatile device metal::_atomic<uint> *output, thread IndexValPair<A> &new_pair) {
         uint col_idx = metal::atomic_load_explicit(output, metal::memory_order_relaxed);
         isize old_loc;
-        T old_val;
+        A old_val;
 
         do {
             old_loc = get_elm_loc(row_idx + col_idx, ndim, shape, stride);
-            old_val = input[old_loc];
+            old_val = static_cast<A>(input[old_loc]);
             if (old_val >= new_pair.val) {
                 break;
             }
@@ -166,28 +166,28 @@ struct AtomicArgmax {
 };
 
 struct AtomicArgmin {
-    template <class T>
-    void operator()(const device T *input, volatile device metal::_atomic<uint> *output, thread IndexValPair<T> &new_pair) {
+    template <class T, class A>
+    void operator()(const device T *input, volatile device metal::_atomic<uint> *output, thread IndexValPair<A> &new_pair) {
         uint old_idx = metal::atomic_load_explicit(output, metal::memory_order_relaxed);
-        T old_val;
+        A old_val;
 
         do {
-            old_val = input[old_idx];
+            old_val = static_cast<A>(input[old_idx]);
             if (old_val <= new_pair.val) {
                 break;
             }
         } while (!metal::atomic_compare_exchange_weak_explicit(output, &old_idx, new_pair.idx, metal::memory_order_relaxed, metal::memory_order_relaxed));
     }
 
-    template <class T>
-    void operator()(const device T *input, const isize row_idx, const isize ndim, const constant isize *shape, const constant isize *stride, volatile device metal::_atomic<uint> *output, thread IndexValPair<T> &new_pair) {
+    template <class T, class A>
+    void operator()(const device T *input, const isize row_idx, const isize ndim, const constant isize *shape, const constant isize *stride, volatile device metal::_atomic<uint> *output, thread IndexValPair<A> &new_pair) {
         uint col_idx = metal::atomic_load_explicit(output, metal::memory_order_relaxed);
         isize old_loc;
-        T old_val;
+        A old_val;
 
         do {
             old_loc = get_elm_loc(row_idx + col_idx, ndim, shape, stride);
-            old_val = input[old_loc];
+            old_val = static_cast<A>(input[old_loc]);
             if (old_val <= new_pair.val) {
                 break;
             }
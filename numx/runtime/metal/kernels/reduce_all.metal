@@ -13,9 +13,9 @@ kernel void reduce_all(
     uint simd_group_id [[simdgroup_index_in_threadgroup]])
 {
     Op op;
-    T default_val = op.template get_default<T>();
-    T best_val = gid < numel ? input[offset[0] + gid] : default_val;
-    threadgroup T ldata[simd_size];
+    R default_val = op.template get_default<R>();
+    R best_val = gid < numel ? static_cast<R>(input[offset[0] + gid]) : default_val;
+    threadgroup R ldata[simd_size];
     // Perform per-SIMD partial reduction -> shuffling within SIMD group.
     // Each thread gets the value from another thread offset lanes above it.
     best_val = simd_reduce(op, best_val);
@@ -53,9 +53,9 @@ kernel void strided_reduce_all(
     uint simd_group_id [[simdgroup_index_in_threadgroup]])
 {
     Op op;
-    T default_val = op.template get_default<T>();
-    T best_val = gid < numel ? input[offset[0] + get_elm_loc(gid, ndim, shape, stride)] : default_val;
-    threadgroup T ldata[simd_size];
+    R default_val = op.template get_default<R>();
+    R best_val = gid < numel ? static_cast<R>(input[offset[0] + get_elm_loc(gid, ndim, shape, stride)]) : default_val;
+    threadgroup R ldata[simd_size];
     // Perform per-SIMD partial reduction -> shuffling within SIMD group.
     // Each thread gets the value from another thread offset lanes above it.
     best_val = simd_reduce(op, best_val);
@@ -82,8 +82,11 @@ kernel void strided_reduce_all(
 template [[host_name(#opname "_all_" #dtype)]] [[kernel]] decltype(reduce_all<op, atomic_op, T, R>) reduce_all<op, atomic_op, T, R>;                            \
 template [[host_name("strided_" #opname "_all_" #dtype)]] [[kernel]] decltype(strided_reduce_all<op, atomic_op, T, R>) strided_reduce_all<op, atomic_op, T, R>;
 
+// 16-bit floats are reduced into an f32 output
 #define def_reduce_all(opname, op, atomic_op_float, atomic_op_int)      \
 def_reduce_all_kernels(opname, op, atomic_op_float, f32, float, float); \
+def_reduce_all_kernels(opname, op, atomic_op_float, f16, half, float);  \
+def_reduce_all_kernels(opname, op, atomic_op_float, bf16, bfloat, float);\
 def_reduce_all_kernels(opname, op, atomic_op_int, i32, int, int);
 
 def_reduce_all(sum, Sum, AtomicSum, AtomicSum);
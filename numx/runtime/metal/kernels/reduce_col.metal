@@ -17,9 +17,9 @@ kernel void reduce_col(
     const uint lcol = lid.x;
     const uint lwidth = lsize.x;
     Op op;
-    T default_val = op.template get_default<T>();
-    T best_val = gcol < ncol ? input[offset[0] + grow * ncol + gcol] : default_val;
-	threadgroup T ldata[tgrow][tgcol];
+    R default_val = op.template get_default<R>();
+    R best_val = gcol < ncol ? static_cast<R>(input[offset[0] + grow * ncol + gcol]) : default_val;
+	threadgroup R ldata[tgrow][tgcol];
 	best_val = simd_reduce(op, best_val);
 	uint simd_per_row_group = lwidth / simd_size;
 	
@@ -60,9 +60,9 @@ kernel void strided_reduce_col(
     const uint lcol = lid.x;
     const uint lwidth = lsize.x;
 	Op op;
-    T default_val = op.template get_default<T>();
-    T best_val = gcol < ncol ? input[offset[0] + get_elm_loc(grow * ncol + gcol, ndim, shape, stride)] : default_val;
-	threadgroup T ldata[tgrow][tgcol];
+    R default_val = op.template get_default<R>();
+    R best_val = gcol < ncol ? static_cast<R>(input[offset[0] + get_elm_loc(grow * ncol + gcol, ndim, shape, stride)]) : default_val;
+	threadgroup R ldata[tgrow][tgcol];
 	best_val = simd_reduce(op, best_val);
 	uint simd_per_row_group = lwidth / simd_size;
 	
@@ -110,8 +110,11 @@ def_reduce_col_kernels(opname, op, atomic_op, dtype, T, R, 16, 1);
 def_reduce_col_kernels(opname, op, atomic_op, dtype, T, R, 16, 2);                  \
 def_reduce_col_kernels(opname, op, atomic_op, dtype, T, R, 32, 1);
 
+// 16-bit floats are reduced into an f32 output
 #define def_reduce_col(opname, op, atomic_op_float, atomic_op_int)                  \
 config_reduce_col_kernels(opname, op, atomic_op_float, f32, float, float);          \
+config_reduce_col_kernels(opname, op, atomic_op_float, f16, half, float);           \
+config_reduce_col_kernels(opname, op, atomic_op_float, bf16, bfloat, float);        \
 config_reduce_col_kernels(opname, op, atomic_op_int, i32, int, int);
 
 def_reduce_col(sum, Sum, AtomicSum, AtomicSum);
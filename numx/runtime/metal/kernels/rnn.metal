@@ -0,0 +1,314 @@
+#include "utils.h"
+
+// Must match RecurrentOp::s_max_hidden_size on the host
+constexpr constant uint rnn_max_hidden_size = 1024;
+// Must match RecurrentGradTarget on the host
+constexpr constant isize rnn_grad_input_gates = 0;
+constexpr constant isize rnn_grad_hidden_gates = 1;
+
+struct LSTMStep {
+    float i, f, g, o, c, tc, h;
+};
+
+// Gate preactivations are packed as input, forget, cell and output
+inline LSTMStep lstm_step(float a_i, float a_f, float a_g, float a_o, float c_prev) {
+    LSTMStep step;
+    step.i = stable_sigmoid(a_i);
+    step.f = stable_sigmoid(a_f);
+    step.g = metal::precise::tanh(a_g);
+    step.o = stable_sigmoid(a_o);
+    step.c = step.f * c_prev + step.i * step.g;
+    step.tc = metal::precise::tanh(step.c);
+    step.h = step.o * step.tc;
+    return step;
+}
+
+struct GRUStep {
+    float r, z, n;
+};
+
+// Gate preactivations are packed as reset, update and new, the hidden projection of the new gate is scaled by the reset gate
+inline GRUStep gru_step(float gi_r, float gi_z, float gi_n, float gh_r, float gh_z, float gh_n) {
+    GRUStep step;
+    step.r = stable_sigmoid(gi_r + gh_r);
+    step.z = stable_sigmoid(gi_z + gh_z);
+    step.n = metal::precise::tanh(gi_n + step.r * gh_n);
+    return step;
+}
+
+template <class T>
+inline float load2d(const device T *data, isize offset, const constant isize *stride, isize row, isize col) {
+    return static_cast<float>(data[offset + row * stride[0] + col * stride[1]]);
+}
+
+// One thread per hidden unit of a batch row, the output packs the next hidden and cell states as (batch, 2 * hidden)
+template <class T>
+kernel void lstm_cell(
+    const constant isize &nhidden [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const constant isize *gi_stride [[buffer(2)]],
+    const constant isize *gh_stride [[buffer(3)]],
+    const constant isize *c_stride [[buffer(4)]],
+    const device T *gi [[buffer(5)]],
+    const device T *gh [[buffer(6)]],
+    const device T *c [[buffer(7)]],
+    device T *output [[buffer(8)]],
+    uint id [[thread_position_in_grid]])
+{
+    const isize row = id / nhidden;
+    const isize col = id % nhidden;
+    float a[4];
+
+    for (isize gate = 0; gate < 4; gate++) {
+        a[gate] = load2d(gi, offset[0], gi_stride, row, gate * nhidden + col) + load2d(gh, offset[1], gh_stride, row, gate * nhidden + col);
+    }
+
+    LSTMStep step = lstm_step(a[0], a[1], a[2], a[3], load2d(c, offset[2], c_stride, row, col));
+    const isize out_loc = offset[3] + row * 2 * nhidden + col;
+    output[out_loc] = static_cast<T>(step.h);
+    output[out_loc + nhidden] = static_cast<T>(step.c);
+}
+
+// Gradient of the packed gates or the previous cell state, the gradient of the next states is packed as (batch, 2 * hidden)
+template <class T>
+kernel void lstm_cell_grad(
+    const constant isize &nhidden [[buffer(0)]],
+    const constant isize &target [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *grad_stride [[buffer(3)]],
+    const constant isize *gi_stride [[buffer(4)]],
+    const constant isize *gh_stride [[buffer(5)]],
+    const constant isize *c_stride [[buffer(6)]],
+    const device T *grad [[buffer(7)]],
+    const device T *gi [[buffer(8)]],
+    const device T *gh [[buffer(9)]],
+    const device T *c [[buffer(10)]],
+    device T *output [[buffer(11)]],
+    uint id [[thread_position_in_grid]])
+{
+    const isize row = id / nhidden;
+    const isize col = id % nhidden;
+    float a[4];
+
+    for (isize gate = 0; gate < 4; gate++) {
+        a[gate] = load2d(gi, offset[1], gi_stride, row, gate * nhidden + col) + load2d(gh, offset[2], gh_stride, row, gate * nhidden + col);
+    }
+
+    const float c_prev = load2d(c, offset[3], c_stride, row, col);
+    LSTMStep step = lstm_step(a[0], a[1], a[2], a[3], c_prev);
+    const float dh = load2d(grad, offset[0], grad_stride, row, col);
+    const float dc = load2d(grad, offset[0], grad_stride, row, nhidden + col) + dh * step.o * (1.0f - step.tc * step.tc);
+
+    if (target != rnn_grad_input_gates && target != rnn_grad_hidden_gates) {
+        output[offset[4] + row * nhidden + col] = static_cast<T>(dc * step.f);
+        return;
+    }
+
+    const isize out_loc = offset[4] + row * 4 * nhidden + col;
+    output[out_loc] = static_cast<T>(dc * step.g * step.i * (1.0f - step.i));
+    output[out_loc + nhidden] = static_cast<T>(dc * c_prev * step.f * (1.0f - step.f));
+    output[out_loc + 2 * nhidden] = static_cast<T>(dc * step.i * (1.0f - step.g * step.g));
+    output[out_loc + 3 * nhidden] = static_cast<T>(dh * step.tc * step.o * (1.0f - step.o));
+}
+
+// One thread per hidden unit of a batch row
+template <class T>
+kernel void gru_cell(
+    const constant isize &nhidden [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const constant isize *gi_stride [[buffer(2)]],
+    const constant isize *gh_stride [[buffer(3)]],
+    const constant isize *h_stride [[buffer(4)]],
+    const device T *gi [[buffer(5)]],
+    const device T *gh [[buffer(6)]],
+    const device T *h [[buffer(7)]],
+    device T *output [[buffer(8)]],
+    uint id [[thread_position_in_grid]])
+{
+    const isize row = id / nhidden;
+    const isize col = id % nhidden;
+    GRUStep step = gru_step(
+        load2d(gi, offset[0], gi_stride, row, col), load2d(gi, offset[0], gi_stride, row, nhidden + col), load2d(gi, offset[0], gi_stride, row, 2 * nhidden + col),
+        load2d(gh, offset[1], gh_stride, row, col), load2d(gh, offset[1], gh_stride, row, nhidden + col), load2d(gh, offset[1], gh_stride, row, 2 * nhidden + col));
+    const float h_prev = load2d(h, offset[2], h_stride, row, col);
+    output[offset[3] + row * nhidden + col] = static_cast<T>((1.0f - step.z) * step.n + step.z * h_prev);
+}
+
+// Gradient of the input projection, hidden projection or previous hidden state
+template <class T>
+kernel void gru_cell_grad(
+    const constant isize &nhidden [[buffer(0)]],
+    const constant isize &target [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *grad_stride [[buffer(3)]],
+    const constant isize *gi_stride [[buffer(4)]],
+    const constant isize *gh_stride [[buffer(5)]],
+    const constant isize *h_stride [[buffer(6)]],
+    const device T *grad [[buffer(7)]],
+    const device T *gi [[buffer(8)]],
+    const device T *gh [[buffer(9)]],
+    const device T *h [[buffer(10)]],
+    device T *output [[buffer(11)]],
+    uint id [[thread_position_in_grid]])
+{
+    const isize row = id / nhidden;
+    const isize col = id % nhidden;
+    const float gh_n = load2d(gh, offset[2], gh_stride, row, 2 * nhidden + col);
+    GRUStep step = gru_step(
+        load2d(gi, offset[1], gi_stride, row, col), load2d(gi, offset[1], gi_stride, row, nhidden + col), load2d(gi, offset[1], gi_stride, row, 2 * nhidden + col),
+        load2d(gh, offset[2], gh_stride, row, col), load2d(gh, offset[2], gh_stride, row, nhidden + col), gh_n);
+    const float dh = load2d(grad, offset[0], grad_stride, row, col);
+    const float h_prev = load2d(h, offset[3], h_stride, row, col);
+
+    if (target != rnn_grad_input_gates && target != rnn_grad_hidden_gates) {
+        output[offset[4] + row * nhidden + col] = static_cast<T>(dh * step.z);
+        return;
+    }
+
+    const float dn = dh * (1.0f - step.z) * (1.0f - step.n * step.n);
+    const float dr = dn * gh_n * step.r * (1.0f - step.r);
+    const float dz = dh * (h_prev - step.n) * step.z * (1.0f - step.z);
+    const isize out_loc = offset[4] + row * 3 * nhidden + col;
+    output[out_loc] = static_cast<T>(dr);
+    output[out_loc + nhidden] = static_cast<T>(dz);
+    output[out_loc + 2 * nhidden] = static_cast<T>(target == rnn_grad_input_gates ? dn : dn * step.r);
+}
+
+// One threadgroup runs every step of one batch row with the states kept in threadgroup memory,
+// the hidden state is double buffered so one barrier per step separates the reads of the current state from the writes of the next one,
+// the transposed hidden weight is read row by row so consecutive threads read consecutive gate columns
+template <class T>
+kernel void lstm(
+    const constant isize &nstep [[buffer(0)]],
+    const constant isize &nbatch [[buffer(1)]],
+    const constant isize &nhidden [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *gi_stride [[buffer(4)]],
+    const constant isize *weight_stride [[buffer(5)]],
+    const constant isize *h_stride [[buffer(6)]],
+    const constant isize *c_stride [[buffer(7)]],
+    const device T *gi [[buffer(8)]],
+    const device T *weight [[buffer(9)]],
+    const device T *h0 [[buffer(10)]],
+    const device T *c0 [[buffer(11)]],
+    device T *output [[buffer(12)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float h_state[2][rnn_max_hidden_size];
+    // Every cell state is only touched by the thread owning its hidden unit
+    threadgroup float c_state[rnn_max_hidden_size];
+
+    for (isize col = lid; col < nhidden; col += group_size) {
+        h_state[0][col] = load2d(h0, offset[2], h_stride, row, col);
+        c_state[col] = load2d(c0, offset[3], c_stride, row, col);
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    for (isize t = 0; t < nstep; t++) {
+        const threadgroup float *h_cur = h_state[t % 2];
+        threadgroup float *h_next = h_state[(t + 1) % 2];
+        const isize gi_loc = offset[0] + t * gi_stride[0] + row * gi_stride[1];
+
+        for (isize col = lid; col < nhidden; col += group_size) {
+            float a[4];
+
+            for (isize gate = 0; gate < 4; gate++) {
+                a[gate] = static_cast<float>(gi[gi_loc + (gate * nhidden + col) * gi_stride[2]]);
+            }
+
+            for (isize k = 0; k < nhidden; k++) {
+                const float h = h_cur[k];
+                const isize weight_loc = offset[1] + k * weight_stride[0];
+
+                for (isize gate = 0; gate < 4; gate++) {
+                    a[gate] += h * static_cast<float>(weight[weight_loc + (gate * nhidden + col) * weight_stride[1]]);
+                }
+            }
+
+            LSTMStep step = lstm_step(a[0], a[1], a[2], a[3], c_state[col]);
+            c_state[col] = step.c;
+            h_next[col] = step.h;
+            const isize out_loc = offset[4] + (t * nbatch + row) * 2 * nhidden + col;
+            output[out_loc] = static_cast<T>(step.h);
+            output[out_loc + nhidden] = static_cast<T>(step.c);
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+}
+
+// Same scheme as the LSTM, the hidden bias is added inside the kernel since the reset gate scales the hidden projection
+template <class T>
+kernel void gru(
+    const constant isize &nstep [[buffer(0)]],
+    const constant isize &nbatch [[buffer(1)]],
+    const constant isize &nhidden [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant isize *gi_stride [[buffer(4)]],
+    const constant isize *weight_stride [[buffer(5)]],
+    const constant isize &bias_stride [[buffer(6)]],
+    const constant isize *h_stride [[buffer(7)]],
+    const device T *gi [[buffer(8)]],
+    const device T *weight [[buffer(9)]],
+    const device T *bias [[buffer(10)]],
+    const device T *h0 [[buffer(11)]],
+    device T *output [[buffer(12)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]])
+{
+    threadgroup float h_state[2][rnn_max_hidden_size];
+
+    for (isize col = lid; col < nhidden; col += group_size) {
+        h_state[0][col] = load2d(h0, offset[3], h_stride, row, col);
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    for (isize t = 0; t < nstep; t++) {
+        const threadgroup float *h_cur = h_state[t % 2];
+        threadgroup float *h_next = h_state[(t + 1) % 2];
+        const isize gi_loc = offset[0] + t * gi_stride[0] + row * gi_stride[1];
+
+        for (isize col = lid; col < nhidden; col += group_size) {
+            float a[3];
+
+            for (isize gate = 0; gate < 3; gate++) {
+                a[gate] = static_cast<float>(bias[offset[2] + (gate * nhidden + col) * bias_stride]);
+            }
+
+            for (isize k = 0; k < nhidden; k++) {
+                const float h = h_cur[k];
+                const isize weight_loc = offset[1] + k * weight_stride[0];
+
+                for (isize gate = 0; gate < 3; gate++) {
+                    a[gate] += h * static_cast<float>(weight[weight_loc + (gate * nhidden + col) * weight_stride[1]]);
+                }
+            }
+
+            GRUStep step = gru_step(
+                static_cast<float>(gi[gi_loc + col * gi_stride[2]]), static_cast<float>(gi[gi_loc + (nhidden + col) * gi_stride[2]]),
+                static_cast<float>(gi[gi_loc + (2 * nhidden + col) * gi_stride[2]]), a[0], a[1], a[2]);
+            const float h = (1.0f - step.z) * step.n + step.z * h_cur[col];
+            h_next[col] = h;
+            output[offset[4] + (t * nbatch + row) * nhidden + col] = static_cast<T>(h);
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    }
+}
+
+#define def_rnn(dtype, T)                                                                                              \
+template [[host_name("lstm_cell_" #dtype)]] [[kernel]] decltype(lstm_cell<T>) lstm_cell<T>;                            \
+template [[host_name("lstm_cell_grad_" #dtype)]] [[kernel]] decltype(lstm_cell_grad<T>) lstm_cell_grad<T>;             \
+template [[host_name("gru_cell_" #dtype)]] [[kernel]] decltype(gru_cell<T>) gru_cell<T>;                               \
+template [[host_name("gru_cell_grad_" #dtype)]] [[kernel]] decltype(gru_cell_grad<T>) gru_cell_grad<T>;                \
+template [[host_name("lstm_" #dtype)]] [[kernel]] decltype(lstm<T>) lstm<T>;                                           \
+template [[host_name("gru_" #dtype)]] [[kernel]] decltype(gru<T>) gru<T>;
+
+def_rnn(f32, float);
+def_rnn(f16, half);
+def_rnn(bf16, bfloat);
@@ -0,0 +1,44 @@
+#include "utils.h"
+
+// Number of consecutive elements scanned serially by each thread
+constexpr constant uint scan_nread = 4;
+
+template <class Op, class T>
+T simd_exclusive_scan(thread Op &op, T val, uint simd_lane_id) {
+    // Hillis-Steele inclusive scan across the SIMD group
+    for (ushort lanes = 1; lanes < simd_size; lanes <<= 1) {
+        T prev = metal::simd_shuffle_up(val, lanes);
+
+        if (simd_lane_id >= lanes) {
+            val = op(prev, val);
+        }
+    }
+
+    // Shift by one lane to make the scan exclusive
+    T prev = metal::simd_shuffle_up(val, 1);
+    return simd_lane_id == 0 ? op.template get_default<T>() : prev;
+}
+
+struct Cumsum {
+    template <class T>
+    T operator()(T lhs, T rhs) { return lhs + rhs; }
+
+    template <class T>
+    T get_default() { return 0; }
+};
+
+struct Cumprod {
+    template <class T>
+    T operator()(T lhs, T rhs) { return lhs * rhs; }
+
+    template <class T>
+    T get_default() { return 1; }
+};
+
+struct Cummax {
+    template <class T>
+    T operator()(T lhs, T rhs) { return metal::max(lhs, rhs); }
+
+    template <class T>
+    T get_default() { return Limits<T>::min(); }
+};
@@ -0,0 +1,106 @@
+#include "scan.h"
+
+// Each threadgroup scans one block of a row, the row being the last dimension of the given views
+// Rows of several blocks take two launches, the first one only writes the block totals in the accumulation type,
+// the second one scans the blocks again starting from the scanned totals of the preceding blocks so every element is rounded once
+template <class Op, class T>
+kernel void scan(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *in_stride [[buffer(4)]],
+    const constant isize *out_stride [[buffer(5)]],
+    const constant bool *strided [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    device T *output [[buffer(8)]],
+    device acc_t<T> *block_totals [[buffer(9)]],
+    const constant bool &write_totals [[buffer(10)]],
+    const constant bool &carry_in [[buffer(11)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint2 ngroup [[threadgroups_per_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint2 lsize [[threads_per_threadgroup]],
+    uint simd_per_group [[simdgroups_per_threadgroup]],
+    uint simd_lane_id [[thread_index_in_simdgroup]],
+    uint simd_group_id [[simdgroup_index_in_threadgroup]])
+{
+    Op op;
+    // 16-bit floats are scanned in f32 and rounded once on store
+    using A = acc_t<T>;
+    A default_val = op.template get_default<A>();
+    threadgroup A simd_totals[simd_size];
+    const uint group_size = lsize.x;
+    const isize row_idx = group_id.y * ncol;
+    const isize col_start = (group_id.x * group_size + lid) * scan_nread;
+    A vals[scan_nread];
+    A acc = default_val;
+
+    // Local pass: each thread scans its own elements serially
+    for (uint i = 0; i < scan_nread; i++) {
+        isize col = col_start + i;
+
+        if (col < ncol) {
+            uint id = row_idx + col;
+            isize in_loc = strided[0] ? get_elm_loc(id, ndim, shape, in_stride) : id;
+            acc = op(acc, static_cast<A>(input[offset[0] + in_loc]));
+        }
+
+        vals[i] = acc;
+    }
+
+    // Scan the thread totals within the SIMD group, then the SIMD group totals within the threadgroup
+    A prefix = simd_exclusive_scan(op, acc, simd_lane_id);
+
+    if (simd_lane_id == simd_size - 1) {
+        simd_totals[simd_group_id] = op(prefix, acc);
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    if (simd_group_id == 0) {
+        A total = simd_lane_id < simd_per_group ? simd_totals[simd_lane_id] : default_val;
+        // Each lane only overwrites the slot it has read
+        simd_totals[simd_lane_id] = simd_exclusive_scan(op, total, simd_lane_id);
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+    prefix = op(simd_totals[simd_group_id], prefix);
+
+    if (write_totals) {
+        if (lid == group_size - 1) {
+            block_totals[group_id.y * ngroup.x + group_id.x] = op(prefix, acc);
+        }
+
+        return;
+    }
+
+    // The inclusive scan of the preceding block totals is carried into the block
+    if (carry_in && group_id.x > 0) {
+        prefix = op(block_totals[group_id.y * ngroup.x + group_id.x - 1], prefix);
+    }
+
+    // Fix-up pass: add the exclusive prefix of the thread to its elements
+    for (uint i = 0; i < scan_nread; i++) {
+        isize col = col_start + i;
+
+        if (col < ncol) {
+            uint id = row_idx + col;
+            isize out_loc = strided[1] ? get_elm_loc(id, ndim, shape, out_stride) : id;
+            output[offset[1] + out_loc] = static_cast<T>(op(prefix, vals[i]));
+        }
+    }
+}
+
+#define def_scan_kernels(opname, op, dtype, T)                                              \
+template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(scan<op, T>) scan<op, T>;
+
+#define def_scan(opname, op)                    \
+def_scan_kernels(opname, op, f32, float);       \
+def_scan_kernels(opname, op, f16, half);        \
+def_scan_kernels(opname, op, bf16, bfloat);     \
+def_scan_kernels(opname, op, i32, int);
+
+def_scan(cumsum, Cumsum);
+def_scan(cumprod, Cumprod);
+def_scan(cummax, Cummax);
@@ -0,0 +1,145 @@
+#include "utils.h"
+
+// Maximum number of elements sorted by one threadgroup, values and indices must fit in threadgroup memory
+constexpr constant uint sort_block_size = 2048;
+
+// Ties are broken by index so every key is unique and the sort is stable
+template <class T>
+inline bool sorts_before(T lhs, int lhs_idx, T rhs, int rhs_idx, bool descending) {
+    acc_t<T> lhs_val = static_cast<acc_t<T>>(lhs);
+    acc_t<T> rhs_val = static_cast<acc_t<T>>(rhs);
+
+    if (lhs_val == rhs_val) {
+        return lhs_idx < rhs_idx;
+    }
+
+    return descending ? lhs_val > rhs_val : lhs_val < rhs_val;
+}
+
+// Each threadgroup sorts one block of a row with a bitonic network and writes its first nkeep elements
+// Blocks are padded to block_size with sentinels that sort last
+template <class T>
+kernel void sort_block(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize &offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *stride [[buffer(4)]],
+    const constant bool &strided [[buffer(5)]],
+    const constant bool &has_index [[buffer(6)]],
+    const constant bool &descending [[buffer(7)]],
+    const constant isize &block_size [[buffer(8)]],
+    const constant isize &nkeep [[buffer(9)]],
+    const device T *input [[buffer(10)]],
+    const device int *in_index [[buffer(11)]],
+    device T *output [[buffer(12)]],
+    device int *out_index [[buffer(13)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint2 ngroup [[threadgroups_per_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint2 lsize [[threads_per_threadgroup]])
+{
+    threadgroup T vals[sort_block_size];
+    threadgroup int idxs[sort_block_size];
+    const uint group_size = lsize.x;
+    const isize row_idx = group_id.y * ncol;
+    const isize block_start = group_id.x * block_size;
+
+    for (isize i = lid; i < block_size; i += group_size) {
+        isize col = block_start + i;
+
+        if (col < ncol) {
+            uint id = row_idx + col;
+            isize in_loc = strided ? get_elm_loc(id, ndim, shape, stride) : id;
+            vals[i] = input[offset + in_loc];
+            idxs[i] = has_index ? in_index[id] : col;
+        } else {
+            vals[i] = descending ? Limits<T>::min() : Limits<T>::max();
+            idxs[i] = Limits<int>::finite_max();
+        }
+    }
+
+    threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+
+    // Bitonic sorting network, each thread handles block_size / 2 / group_size comparators per step
+    for (isize k = 2; k <= block_size; k <<= 1) {
+        for (isize j = k >> 1; j > 0; j >>= 1) {
+            for (isize i = lid; i < block_size / 2; i += group_size) {
+                isize lo = (i / j) * 2 * j + i % j;
+                isize hi = lo + j;
+                bool ascending = (lo & k) == 0;
+
+                if (sorts_before(vals[hi], idxs[hi], vals[lo], idxs[lo], descending) == ascending) {
+                    T val = vals[lo];
+                    vals[lo] = vals[hi];
+                    vals[hi] = val;
+                    int idx = idxs[lo];
+                    idxs[lo] = idxs[hi];
+                    idxs[hi] = idx;
+                }
+            }
+
+            threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+        }
+    }
+
+    const isize out_start = (group_id.y * ngroup.x + group_id.x) * nkeep;
+
+    for (isize i = lid; i < nkeep; i += group_size) {
+        output[out_start + i] = vals[i];
+        out_index[out_start + i] = idxs[i];
+    }
+}
+
+// Merges pairs of adjacent sorted runs, each thread places one element by counting the elements
+// of the other run that sort before it
+template <class T>
+kernel void sort_merge(
+    const constant isize &ncol [[buffer(0)]],
+    const constant isize &run [[buffer(1)]],
+    const constant bool &descending [[buffer(2)]],
+    const device T *input [[buffer(3)]],
+    const device int *in_index [[buffer(4)]],
+    device T *output [[buffer(5)]],
+    device int *out_index [[buffer(6)]],
+    uint2 gid [[thread_position_in_grid]])
+{
+    const isize row_idx = gid.y * ncol;
+    const isize col = gid.x;
+    const isize run_idx = col / run;
+    const bool is_left = (run_idx & 1) == 0;
+    const isize other_start = (is_left ? run_idx + 1 : run_idx - 1) * run;
+    const isize other_remaining = ncol - other_start;
+    const isize other_len = other_remaining < 0 ? 0 : (other_remaining < run ? other_remaining : run);
+    const T val = input[row_idx + col];
+    const int idx = in_index[row_idx + col];
+    isize lo = 0;
+    isize hi = other_len;
+
+    // Left elements go before equal right elements, which only happens between padding sentinels
+    while (lo < hi) {
+        isize mid = (lo + hi) / 2;
+        isize other = row_idx + other_start + mid;
+        bool before = is_left ? sorts_before(input[other], in_index[other], val, idx, descending) : !sorts_before(val, idx, input[other], in_index[other], descending);
+
+        if (before) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const isize merged_start = (is_left ? run_idx : run_idx - 1) * run;
+    const isize dest = row_idx + merged_start + col - run_idx * run + lo;
+    output[dest] = val;
+    out_index[dest] = idx;
+}
+
+#define def_sort(dtype, T)                                                                                           \
+template [[host_name("sort_block_" #dtype)]] [[kernel]] decltype(sort_block<T>) sort_block<T>;                       \
+template [[host_name("sort_merge_" #dtype)]] [[kernel]] decltype(sort_merge<T>) sort_merge<T>;
+
+def_sort(f32, float);
+def_sort(f16, half);
+def_sort(bf16, bfloat);
+def_sort(i32, int);
@@ -0,0 +1,223 @@
+#include "utils.h"
+
+// Must match s_sparse_chunk_nnz on the host
+constexpr constant isize sparse_chunk_nnz = 64;
+
+// Last row whose offset is at most i, empty rows share the offset of the next row and are skipped
+inline isize csr_row(const device int *row_ptr, isize nrow, isize i) {
+    isize lo = 0, hi = nrow - 1;
+
+    while (lo < hi) {
+        isize mid = (lo + hi + 1) / 2;
+
+        if (row_ptr[mid] <= i) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+inline isize sparse_row(const device int *rows, bool csr, isize nrow, isize i) {
+    return csr ? csr_row(rows, nrow, i) : rows[i];
+}
+
+// Every thread multiplies one chunk of nonzeros with one dense column, so the work is balanced by nonzeros
+// rather than by rows. Partial sums are flushed with an atomic add whenever the output row changes,
+// which only contends on rows shared by neighbouring chunks, the output is zero-initialized
+kernel void spmm(
+    const constant isize &nrow [[buffer(0)]],
+    const constant isize &nnz [[buffer(1)]],
+    const constant isize &N [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant bool &csr [[buffer(4)]],
+    const constant bool &transposed [[buffer(5)]],
+    const device int *rows [[buffer(6)]],
+    const device int *cols [[buffer(7)]],
+    const device float *values [[buffer(8)]],
+    const device float *dense [[buffer(9)]],
+    device metal::atomic_float *output [[buffer(10)]],
+    uint2 id [[thread_position_in_grid]])
+{
+    const isize n = id.x;
+    const isize begin = id.y * sparse_chunk_nnz;
+
+    if (n >= N || begin >= nnz) {
+        return;
+    }
+
+    const isize end = begin + sparse_chunk_nnz < nnz ? begin + sparse_chunk_nnz : nnz;
+    const device int *offset_rows = rows + offset[0];
+    const device int *offset_cols = cols + offset[1];
+    const device float *offset_values = values + offset[2];
+    const device float *offset_dense = dense + offset[3];
+    device metal::atomic_float *offset_output = output + offset[4];
+
+    if (transposed) {
+        // Output rows are the column indices which are not grouped, every nonzero is flushed on its own
+        for (isize i = begin; i < end; i++) {
+            const isize row = sparse_row(offset_rows, csr, nrow, i);
+            const float val = offset_values[i] * offset_dense[row * N + n];
+            metal::atomic_fetch_add_explicit(&offset_output[offset_cols[i] * N + n], val, metal::memory_order_relaxed);
+        }
+
+        return;
+    }
+
+    isize row = sparse_row(offset_rows, csr, nrow, begin);
+    float acc = 0;
+
+    for (isize i = begin; i < end; i++) {
+        isize next_row = row;
+
+        if (csr) {
+            while (offset_rows[next_row + 1] <= i) {
+                next_row++;
+            }
+        } else {
+            next_row = offset_rows[i];
+        }
+
+        if (next_row != row) {
+            metal::atomic_fetch_add_explicit(&offset_output[row * N + n], acc, metal::memory_order_relaxed);
+            row = next_row;
+            acc = 0;
+        }
+
+        acc += offset_values[i] * offset_dense[offset_cols[i] * N + n];
+    }
+
+    metal::atomic_fetch_add_explicit(&offset_output[row * N + n], acc, metal::memory_order_relaxed);
+}
+
+// Multiplies every nonzero with the dense element at its position
+kernel void sparse_mul(
+    const constant isize &nrow [[buffer(0)]],
+    const constant isize &nnz [[buffer(1)]],
+    const constant isize &ncol [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant bool &csr [[buffer(4)]],
+    const device int *rows [[buffer(5)]],
+    const device int *cols [[buffer(6)]],
+    const device float *values [[buffer(7)]],
+    const device float *dense [[buffer(8)]],
+    device float *output [[buffer(9)]],
+    uint id [[thread_position_in_grid]])
+{
+    if (id >= nnz) {
+        return;
+    }
+
+    const isize row = sparse_row(rows + offset[0], csr, nrow, id);
+    output[offset[4] + id] = values[offset[2] + id] * dense[offset[3] + row * ncol + cols[offset[1] + id]];
+}
+
+// Scatters every nonzero into the zero-initialized output, duplicate coordinates are summed
+kernel void sparse_to_dense(
+    const constant isize &nrow [[buffer(0)]],
+    const constant isize &nnz [[buffer(1)]],
+    const constant isize &ncol [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant bool &csr [[buffer(4)]],
+    const device int *rows [[buffer(5)]],
+    const device int *cols [[buffer(6)]],
+    const device float *values [[buffer(7)]],
+    device metal::atomic_float *output [[buffer(8)]],
+    uint id [[thread_position_in_grid]])
+{
+    if (id >= nnz) {
+        return;
+    }
+
+    const isize row = sparse_row(rows + offset[0], csr, nrow, id);
+    metal::atomic_fetch_add_explicit(&output[offset[3] + row * ncol + cols[offset[1] + id]], values[offset[2] + id], metal::memory_order_relaxed);
+}
+
+// Every thread computes a 4x4 output tile of lhs W^T + bias within one block row of the weight W of shape (N, K), only the nonzero
+// blocks of the row are visited, each one a packed row-major (block_rows, block_cols) tile next to the previous one
+template <class T>
+kernel void block_sparse_matmul(
+    const constant isize &M [[buffer(0)]],
+    const constant isize &K [[buffer(1)]],
+    const constant isize &N [[buffer(2)]],
+    const constant isize *offset [[buffer(3)]],
+    const constant bool &has_bias [[buffer(4)]],
+    const constant isize &block_rows [[buffer(5)]],
+    const constant isize &block_cols [[buffer(6)]],
+    const device T *lhs [[buffer(7)]],
+    const device int *block_ptr [[buffer(8)]],
+    const device int *block_col [[buffer(9)]],
+    const device float *block_values [[buffer(10)]],
+    const device T *bias [[buffer(11)]],
+    device T *output [[buffer(12)]],
+    uint2 id [[thread_position_in_grid]])
+{
+    const isize ntile = (block_rows + 3) / 4;
+    const isize block_row = id.x / ntile;
+    const isize row = id.y * 4;
+
+    if (block_row * block_rows >= N || row >= M) {
+        return;
+    }
+
+    const isize tile_col = (id.x % ntile) * 4;
+    const isize col = block_row * block_rows + tile_col;
+    const isize tile_height = 4 < (M - row) ? 4 : (M - row);
+    const isize tile_width = 4 < (block_rows - tile_col) ? 4 : (block_rows - tile_col);
+    // Rows past the edge of the tile repeat the last valid row and are never stored
+    const device T *l_rows[4];
+    isize r_rows[4];
+
+    #pragma unroll
+    for (ubyte j = 0; j < 4; ++j) {
+        l_rows[j] = lhs + offset[0] + (row + (j < tile_height ? j : tile_height - 1)) * K;
+        r_rows[j] = (tile_col + (j < tile_width ? j : tile_width - 1)) * block_cols;
+    }
+
+    float acc[4][4] = {};
+    const isize block_end = block_ptr[offset[1] + block_row + 1];
+
+    for (isize b = block_ptr[offset[1] + block_row]; b < block_end; ++b) {
+        const device float *block = block_values + offset[3] + b * block_rows * block_cols;
+        const isize k_start = block_col[offset[2] + b] * block_cols;
+
+        for (isize i = 0; i < block_cols; ++i) {
+            float l_tile[4], r_tile[4];
+
+            #pragma unroll
+            for (ubyte j = 0; j < 4; ++j) {
+                l_tile[j] = static_cast<float>(l_rows[j][k_start + i]);
+                r_tile[j] = block[r_rows[j] + i];
+            }
+
+            #pragma unroll
+            for (ubyte j = 0; j < 4; ++j) {
+                #pragma unroll
+                for (ubyte k = 0; k < 4; ++k) {
+                    acc[j][k] += l_tile[j] * r_tile[k];
+                }
+            }
+        }
+    }
+
+    for (isize j = 0; j < tile_height; ++j) {
+        for (isize k = 0; k < tile_width; ++k) {
+            float val = acc[j][k];
+
+            if (has_bias) {
+                val += static_cast<float>(bias[offset[4] + col + k]);
+            }
+
+            output[offset[5] + (row + j) * N + col + k] = static_cast<T>(val);
+        }
+    }
+}
+
+#define def_block_sparse_matmul(dtype, T)                                                                                              \
+template [[host_name("block_sparse_matmul_" #dtype)]] [[kernel]] decltype(block_sparse_matmul<T>) block_sparse_matmul<T>;
+
+def_block_sparse_matmul(f32, float);
+def_block_sparse_matmul(f16, half);
+def_block_sparse_matmul(bf16, bfloat);
@@ -0,0 +1,179 @@
+#include "utils.h"
+
+// Must match s_stat_reduce_nread in the runner
+constexpr constant uint stat_reduce_nread = 16;
+
+// Running count, mean and sum of squared deviations updated one element at a time
+struct Welford {
+    static float4 init() { return float4(0.0f); }
+
+    static float4 add(float4 acc, float x) {
+        const float n = acc.x + 1.0f;
+        const float delta = x - acc.y;
+        const float mean = acc.y + delta / n;
+        return float4(n, mean, acc.z + delta * (x - mean), 0.0f);
+    }
+
+    // Chan combine of two partial results, either of which may be empty
+    static float4 combine(float4 a, float4 b) {
+        const float n = a.x + b.x;
+
+        if (n == 0.0f) {
+            return a;
+        }
+
+        const float delta = b.y - a.y;
+        const float ratio = b.x / n;
+        return float4(n, a.y + delta * ratio, a.z + b.z + delta * delta * a.x * ratio, 0.0f);
+    }
+};
+
+struct Var : Welford {
+    static float finalize(float4 acc, float correction) { return acc.z / (acc.x - correction); }
+};
+
+struct Std : Welford {
+    static float finalize(float4 acc, float correction) { return metal::sqrt(acc.z / (acc.x - correction)); }
+};
+
+struct L1Norm {
+    static float4 init() { return float4(0.0f); }
+    static float4 add(float4 acc, float x) { return float4(acc.x + metal::abs(x), 0.0f, 0.0f, 0.0f); }
+    static float4 combine(float4 a, float4 b) { return float4(a.x + b.x, 0.0f, 0.0f, 0.0f); }
+    static float finalize(float4 acc, float) { return acc.x; }
+};
+
+struct L2Norm {
+    static float4 init() { return float4(0.0f); }
+    static float4 add(float4 acc, float x) { return float4(metal::fma(x, x, acc.x), 0.0f, 0.0f, 0.0f); }
+    static float4 combine(float4 a, float4 b) { return float4(a.x + b.x, 0.0f, 0.0f, 0.0f); }
+    static float finalize(float4 acc, float) { return metal::sqrt(acc.x); }
+};
+
+struct LinfNorm {
+    static float4 init() { return float4(0.0f); }
+    static float4 add(float4 acc, float x) { return float4(metal::max(acc.x, metal::abs(x)), 0.0f, 0.0f, 0.0f); }
+    static float4 combine(float4 a, float4 b) { return float4(metal::max(a.x, b.x), 0.0f, 0.0f, 0.0f); }
+    static float finalize(float4 acc, float) { return acc.x; }
+};
+
+template <class R>
+inline float4 stat_simd_reduce(float4 acc) {
+    for (uint lanes = simd_size / 2; lanes > 0; lanes /= 2) {
+        acc = R::combine(acc, metal::simd_shuffle_down(acc, lanes));
+    }
+    return acc;
+}
+
+// The result is valid in the first thread of the threadgroup
+template <class R>
+inline float4 stat_threadgroup_reduce(float4 acc, threadgroup float4 *simd_partials, uint lid, uint simd_per_group, uint simd_lane_id, uint simd_group_id) {
+    acc = stat_simd_reduce<R>(acc);
+
+    if (simd_per_group > 1) {
+        if (simd_lane_id == 0) {
+            simd_partials[simd_group_id] = acc;
+        }
+
+        threadgroup_barrier(metal::mem_flags::mem_threadgroup);
+        acc = lid < simd_per_group ? simd_partials[lid] : R::init();
+        acc = stat_simd_reduce<R>(acc);
+    }
+
+    return acc;
+}
+
+// Each threadgroup reads one block of a row in a single pass, the row being the last dimension of the given view
+// A row with a single block is written directly, otherwise the block partials are combined by the merge kernel
+template <class R, class T>
+kernel void stat_reduce(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize &ncol [[buffer(1)]],
+    const constant isize *offset [[buffer(2)]],
+    const constant isize *shape [[buffer(3)]],
+    const constant isize *stride [[buffer(4)]],
+    const constant bool &strided [[buffer(5)]],
+    const constant float &correction [[buffer(6)]],
+    const device T *input [[buffer(7)]],
+    device float *output [[buffer(8)]],
+    device float4 *partials [[buffer(9)]],
+    uint2 group_id [[threadgroup_position_in_grid]],
+    uint2 ngroup [[threadgroups_per_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint2 lsize [[threads_per_threadgroup]],
+    uint simd_per_group [[simdgroups_per_threadgroup]],
+    uint simd_lane_id [[thread_index_in_simdgroup]],
+    uint simd_group_id [[simdgroup_index_in_threadgroup]])
+{
+    threadgroup float4 simd_partials[simd_size];
+    const uint group_size = lsize.x;
+    const isize row_idx = group_id.y * ncol;
+    const isize block_size = group_size * stat_reduce_nread;
+    const isize block_end = (group_id.x + 1) * block_size;
+    const isize col_end = block_end < ncol ? block_end : ncol;
+    float4 acc = R::init();
+
+    // Consecutive threads read consecutive columns
+    for (isize col = group_id.x * block_size + lid; col < col_end; col += group_size) {
+        const isize id = row_idx + col;
+        const isize loc = strided ? get_elm_loc(id, ndim, shape, stride) : id;
+        acc = R::add(acc, static_cast<float>(input[offset[0] + loc]));
+    }
+
+    acc = stat_threadgroup_reduce<R>(acc, simd_partials, lid, simd_per_group, simd_lane_id, simd_group_id);
+
+    if (lid == 0) {
+        if (ngroup.x == 1) {
+            output[offset[1] + group_id.y] = R::finalize(acc, correction);
+        } else {
+            partials[group_id.y * ngroup.x + group_id.x] = acc;
+        }
+    }
+}
+
+// One threadgroup combines the block partials of one row
+template <class R>
+kernel void stat_reduce_merge(
+    const constant isize &npartial [[buffer(0)]],
+    const constant isize &offset [[buffer(1)]],
+    const constant float &correction [[buffer(2)]],
+    const device float4 *partials [[buffer(3)]],
+    device float *output [[buffer(4)]],
+    uint row [[threadgroup_position_in_grid]],
+    uint lid [[thread_index_in_threadgroup]],
+    uint group_size [[threads_per_threadgroup]],
+    uint simd_per_group [[simdgroups_per_threadgroup]],
+    uint simd_lane_id [[thread_index_in_simdgroup]],
+    uint simd_group_id [[simdgroup_index_in_threadgroup]])
+{
+    threadgroup float4 simd_partials[simd_size];
+    float4 acc = R::init();
+
+    for (isize i = lid; i < npartial; i += group_size) {
+        acc = R::combine(acc, partials[row * npartial + i]);
+    }
+
+    acc = stat_threadgroup_reduce<R>(acc, simd_partials, lid, simd_per_group, simd_lane_id, simd_group_id);
+
+    if (lid == 0) {
+        output[offset + row] = R::finalize(acc, correction);
+    }
+}
+
+#define def_stat_reduce(opname, R, dtype, T) \
+template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(stat_reduce<R, T>) stat_reduce<R, T>;
+
+#define def_stat_reduce_merge(opname, R) \
+template [[host_name(#opname "_merge")]] [[kernel]] decltype(stat_reduce_merge<R>) stat_reduce_merge<R>;
+
+#define def_stat_reduce_all_dtypes(opname, R) \
+def_stat_reduce(opname, R, f32, float); \
+def_stat_reduce(opname, R, f16, half); \
+def_stat_reduce(opname, R, bf16, bfloat); \
+def_stat_reduce_merge(opname, R);
+
+def_stat_reduce_all_dtypes(var, Var);
+def_stat_reduce_all_dtypes(std, Std);
+def_stat_reduce_all_dtypes(l1_norm, L1Norm);
+def_stat_reduce_all_dtypes(l2_norm, L2Norm);
+def_stat_reduce_all_dtypes(linf_norm, LinfNorm);
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "utils.h"
+
+struct Where {
+    // select() compiles to a single branchless blend
+    template <class T>
+    T operator()(bool cond, T lhs, T rhs) { return metal::select(rhs, lhs, cond); }
+};
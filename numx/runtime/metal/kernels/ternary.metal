@@ -0,0 +1,50 @@
+#include "ternary.h"
+
+template <class Op, class C, class T>
+kernel void ternary(
+    const constant isize *offset [[buffer(0)]],
+    const device C *first [[buffer(1)]],
+    const device T *second [[buffer(2)]],
+    const device T *third [[buffer(3)]],
+    device T *output [[buffer(4)]],
+    uint id [[thread_position_in_grid]])
+{
+    output[offset[3] + id] = Op()(first[offset[0] + id], second[offset[1] + id], third[offset[2] + id]);
+}
+
+template <class Op, class C, class T>
+kernel void strided_ternary(
+    const constant isize &ndim [[buffer(0)]],
+    const constant isize *offset [[buffer(1)]],
+    const constant isize *shape [[buffer(2)]],
+    const constant isize *first_stride [[buffer(3)]],
+    const constant isize *second_stride [[buffer(4)]],
+    const constant isize *third_stride [[buffer(5)]],
+    const constant isize *out_stride [[buffer(6)]],
+    const constant bool *strided [[buffer(7)]],
+    const device C *first [[buffer(8)]],
+    const device T *second [[buffer(9)]],
+    const device T *third [[buffer(10)]],
+    device T *output [[buffer(11)]],
+    uint id [[thread_position_in_grid]])
+{
+    isize first_loc = strided[0] ? get_elm_loc(id, ndim, shape, first_stride) : id;
+    isize second_loc = strided[1] ? get_elm_loc(id, ndim, shape, second_stride) : id;
+    isize third_loc = strided[2] ? get_elm_loc(id, ndim, shape, third_stride) : id;
+    isize out_loc = strided[3] ? get_elm_loc(id, ndim, shape, out_stride) : id;
+    output[offset[3] + out_loc] = Op()(first[offset[0] + first_loc], second[offset[1] + second_loc], third[offset[2] + third_loc]);
+}
+
+#define def_ternary_kernels(opname, op, dtype, C, T) \
+template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(ternary<op, C, T>) ternary<op, C, T>;                                \
+template [[host_name("strided_" #opname "_" #dtype)]] [[kernel]] decltype(strided_ternary<op, C, T>) strided_ternary<op, C, T>;
+
+// Selecting only moves bits, bf16 goes through ushort
+#define def_where(opname, op)                       \
+def_ternary_kernels(opname, op, f32, bool, float);  \
+def_ternary_kernels(opname, op, f16, bool, half);   \
+def_ternary_kernels(opname, op, bf16, bool, ushort);\
+def_ternary_kernels(opname, op, i32, bool, int);    \
+def_ternary_kernels(opname, op, b8, bool, bool);
+
+def_where(where, Where);
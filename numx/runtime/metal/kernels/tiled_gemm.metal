@@ -17,7 +17,7 @@ void load_l_tile_2d(const device T* lhs, thread HxW &l_tile, const isize row, co
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            l_tile[k][j] = metal::select(0.0f, lhs[(row + j) * K + i + k], (j < tile_height) && (k < tile_width));
+            l_tile[k][j] = metal::select(0.0f, static_cast<float>(lhs[(row + j) * K + i + k]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -28,7 +28,7 @@ void load_strided_l_tile_2d(const isize ndim, const constant isize *shape, const
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            l_tile[k][j] = metal::select(0.0f, lhs[get_elm_loc((row + j) * K + i + k, ndim, shape, stride)], (j < tile_height) && (k < tile_width));
+            l_tile[k][j] = metal::select(0.0f, static_cast<float>(lhs[get_elm_loc((row + j) * K + i + k, ndim, shape, stride)]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -39,7 +39,7 @@ void load_l_tile_3d(const device T* lhs, thread HxW &l_tile, const isize batch,
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            l_tile[k][j] = metal::select(0.0f, lhs[batch * M * K + (row + j) * K + i + k], (j < tile_height) && (k < tile_width));
+            l_tile[k][j] = metal::select(0.0f, static_cast<float>(lhs[batch * M * K + (row + j) * K + i + k]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -50,7 +50,7 @@ void load_strided_l_tile_3d(const isize ndim, const constant isize *shape, const
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            l_tile[k][j] = metal::select(0.0f, lhs[get_elm_loc(batch * M * K + (row + j) * K + i + k, ndim, shape, stride)], (j < tile_height) && (k < tile_width));
+            l_tile[k][j] = metal::select(0.0f, static_cast<float>(lhs[get_elm_loc(batch * M * K + (row + j) * K + i + k, ndim, shape, stride)]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -61,7 +61,7 @@ void load_r_tile_2d(const device T* rhs, thread HxW &r_tile, const isize col, co
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            r_tile[k][j] = metal::select(0.0f, rhs[(i + j) * N + col + k], (j < tile_height) && (k < tile_width));
+            r_tile[k][j] = metal::select(0.0f, static_cast<float>(rhs[(i + j) * N + col + k]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -72,7 +72,7 @@ void load_r_tile_3d(const device T* rhs, thread HxW &r_tile, const isize batch,
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            r_tile[k][j] = metal::select(0.0f, rhs[batch * K * N + (i + j) * N + col + k], (j < tile_height) && (k < tile_width));
+            r_tile[k][j] = metal::select(0.0f, static_cast<float>(rhs[batch * K * N + (i + j) * N + col + k]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -83,7 +83,7 @@ void load_strided_r_tile_2d(const isize ndim, const constant isize *shape, const
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            r_tile[k][j] = metal::select(0.0f, rhs[get_elm_loc((i + j) * N + col + k, ndim, shape, stride)], (j < tile_height) && (k < tile_width));
+            r_tile[k][j] = metal::select(0.0f, static_cast<float>(rhs[get_elm_loc((i + j) * N + col + k, ndim, shape, stride)]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -94,7 +94,7 @@ void load_strided_r_tile_3d(const isize ndim, const constant isize *shape, const
     for (ubyte j = 0; j < 4; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < 4; ++k) {
-            r_tile[k][j] = metal::select(0.0f, rhs[get_elm_loc(batch * K * N + (i + j) * N + col + k, ndim, shape, stride)], (j < tile_height) && (k < tile_width));
+            r_tile[k][j] = metal::select(0.0f, static_cast<float>(rhs[get_elm_loc(batch * K * N + (i + j) * N + col + k, ndim, shape, stride)]), (j < tile_height) && (k < tile_width));
         }
     }
 }
@@ -105,7 +105,7 @@ void store_out_tile_2d(device T* output, thread HxW &out_tile, const isize row,
     for (ubyte j = 0; j < tile_height; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < tile_width; ++k) {
-            output[(row + j) * N + col + k] = out_tile[k][j];
+            output[(row + j) * N + col + k] = static_cast<T>(out_tile[k][j]);
         }
     }
 }
@@ -116,7 +116,7 @@ void store_out_tile_3d(device T* output, thread HxW &out_tile, const isize batch
     for (ubyte j = 0; j < tile_height; ++j) {
         #pragma unroll
         for (ubyte k = 0; k < tile_width; ++k) {
-            output[batch * M * N + (row + j) * N + col + k] = out_tile[k][j];
+            output[batch * M * N + (row + j) * N + col + k] = static_cast<T>(out_tile[k][j]);
         }
     }
 }
@@ -505,4 +505,7 @@ template [[host_name("strided_tiled_gemm2d_" #dtype)]] [[kernel]] decltype(strid
 template [[host_name("tiled_gemm3d_" #dtype)]] [[kernel]] decltype(tiled_gemm3d<T, R, HxW>) tiled_gemm3d<T, R, HxW>;                            \
 template [[host_name("strided_tiled_gemm3d_" #dtype)]] [[kernel]] decltype(strided_tiled_gemm3d<T, R, HxW>) strided_tiled_gemm3d<T, R, HxW>;
 
-def_tiled_gemm(f32, float, float, metal::float4x4);
\ No newline at end of file
+// 16-bit inputs are multiplied and accumulated in f32 tiles
+def_tiled_gemm(f32, float, float, metal::float4x4);
+def_tiled_gemm(f16, half, half, metal::float4x4);
+def_tiled_gemm(bf16, bfloat, bfloat, metal::float4x4);
\ No newline at end of file
@@ -56,4 +56,73 @@ struct Sq {
     float operator()(T x) const {
         return x * x;
     }
-};
\ No newline at end of file
+};
+
+struct Relu {
+    template <class T>
+    T operator()(T x) const {
+        return x > 0 ? x : 0;
+    }
+};
+
+struct Sigmoid {
+    template <class T>
+    float operator()(T x) const {
+        return stable_sigmoid(static_cast<float>(x));
+    }
+};
+
+struct Tanh {
+    template <class T>
+    float operator()(T x) const {
+        return metal::precise::tanh(static_cast<float>(x));
+    }
+};
+
+struct Gelu {
+    template <class T>
+    float operator()(T x) const {
+        const float fx = static_cast<float>(x);
+        return 0.5f * fx * (1.0f + erf_approx(fx * inv_sqrt_2));
+    }
+};
+
+struct GeluTanh {
+    template <class T>
+    float operator()(T x) const {
+        const float fx = static_cast<float>(x);
+        return 0.5f * fx * (1.0f + metal::precise::tanh(sqrt_2_over_pi * (fx + gelu_tanh_coeff * fx * fx * fx)));
+    }
+};
+
+struct Silu {
+    template <class T>
+    float operator()(T x) const {
+        const float fx = static_cast<float>(x);
+        return fx * stable_sigmoid(fx);
+    }
+};
+
+struct Softplus {
+    template <class T>
+    float operator()(T x) const {
+        // log(1 + exp(x)) = max(x, 0) + log(1 + exp(-|x|))
+        const float fx = static_cast<float>(x);
+        return (fx > 0.0f ? fx : 0.0f) + metal::log(1.0f + metal::exp(-metal::abs(fx)));
+    }
+};
+
+struct Abs {
+    template <class T>
+    T operator()(T x) const {
+        return x < 0 ? -x : x;
+    }
+};
+
+struct Sign {
+    // Zero and NaN are returned unchanged
+    template <class T>
+    T operator()(T x) const {
+        return x > 0 ? static_cast<T>(1) : (x < 0 ? static_cast<T>(-1) : x);
+    }
+};
@@ -7,7 +7,7 @@ kernel void unary(
     device R *output [[buffer(2)]],
     uint id [[thread_position_in_grid]])
 {
-    output[offset[1] + id] = Op()(input[offset[0] + id]);
+    output[offset[1] + id] = convert<R>(Op()(static_cast<acc_t<T>>(input[offset[0] + id])));
 }
 
 template <class Op, class T, class R>
@@ -24,23 +24,24 @@ kernel void strided_unary(
 {
     isize in_loc = strided[0] ? get_elm_loc(id, ndim, shape, in_stride) : id;
     isize out_loc = strided[1] ? get_elm_loc(id, ndim, shape, out_stride) : id;
-    output[offset[1] + out_loc] = Op()(input[offset[0] + in_loc]);
+    output[offset[1] + out_loc] = convert<R>(Op()(static_cast<acc_t<T>>(input[offset[0] + in_loc])));
 }
 
 #define def_unary_all_kernels(opname, op, dtype, T, R)  \
 template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(unary<op, T, R>) unary<op, T, R>;                            \
 template [[host_name("strided_" #opname "_" #dtype)]] [[kernel]] decltype(strided_unary<op, T, R>) strided_unary<op, T, R>;
 
-#define def_unary_float_kernels(opname, op, dtype, T)   \
-template [[host_name(#opname "_" #dtype)]] [[kernel]] decltype(unary<op, T, float>) unary<op, T, float>;                            \
-template [[host_name("strided_" #opname "_" #dtype)]] [[kernel]] decltype(strided_unary<op, T, float>) strided_unary<op, T, float>;
-
+// Float ops keep 16-bit inputs in their own dtype and promote ints to f32
 #define def_unary_float(opname, op)                     \
-def_unary_float_kernels(opname, op, f32, float);        \
-def_unary_float_kernels(opname, op, i32, int);
+def_unary_all_kernels(opname, op, f32, float, float);   \
+def_unary_all_kernels(opname, op, f16, half, half);     \
+def_unary_all_kernels(opname, op, bf16, bfloat, bfloat);\
+def_unary_all_kernels(opname, op, i32, int, float);
 
 #define def_unary_all(opname, op)                       \
 def_unary_all_kernels(opname, op, f32, float, float);   \
+def_unary_all_kernels(opname, op, f16, half, half);     \
+def_unary_all_kernels(opname, op, bf16, bfloat, bfloat);\
 def_unary_all_kernels(opname, op, i32, int, int);
 
 def_unary_float(exp, Exp);
@@ -51,3 +52,12 @@ def_unary_float(sin, Sin);
 def_unary_float(cos, Cos);
 def_unary_all(sq, Sq);
 def_unary_float(sqrt, Sqrt);
+def_unary_all(relu, Relu);
+def_unary_float(sigmoid, Sigmoid);
+def_unary_float(tanh, Tanh);
+def_unary_float(gelu, Gelu);
+def_unary_float(gelu_tanh, GeluTanh);
+def_unary_float(silu, Silu);
+def_unary_float(softplus, Softplus);
+def_unary_all(abs, Abs);
+def_unary_all(sign, Sign);
@@ -20,10 +20,87 @@ inline isize get_elm_loc(const uint id, const isize ndim, const constant isize *
     return loc;
 }
 
+// Branches on the sign so exp never overflows
+inline float stable_sigmoid(float x) {
+    if (x >= 0.0f) {
+        return 1.0f / (1.0f + metal::exp(-x));
+    }
+
+    const float e = metal::exp(x);
+    return e / (1.0f + e);
+}
+
+// Metal has no erf, use Abramowitz and Stegun 7.1.26 which has an absolute error below 1.5e-7
+inline float erf_approx(float x) {
+    const float sign = x < 0.0f ? -1.0f : 1.0f;
+    x = metal::abs(x);
+    const float t = 1.0f / (1.0f + 0.3275911f * x);
+    const float poly = t * (0.254829592f + t * (-0.284496736f + t * (1.421413741f + t * (-1.453152027f + t * 1.061405429f))));
+    return sign * (1.0f - poly * metal::exp(-x * x));
+}
+
+constexpr constant float sqrt_2_over_pi = 0.7978845608f;
+constexpr constant float inv_sqrt_2 = 0.7071067812f;
+constexpr constant float inv_sqrt_2pi = 0.3989422804f;
+constexpr constant float gelu_tanh_coeff = 0.044715f;
+
 template <class T>
 struct Limits {
     static T finite_min() { return metal::numeric_limits<T>::min(); }
     static T finite_max() { return metal::numeric_limits<T>::max(); }
     static T min() { return metal::numeric_limits<T>::has_infinity ? -metal::numeric_limits<T>::infinity() : finite_min(); }
     static T max() { return metal::numeric_limits<T>::has_infinity ? metal::numeric_limits<T>::infinity() : finite_max(); }
-};
\ No newline at end of file
+};
+// bfloat has no numeric_limits, build the limits from their bits
+template <>
+struct Limits<bfloat> {
+    static bfloat finite_min() { return as_type<bfloat>(static_cast<ushort>(0xff7f)); }
+    static bfloat finite_max() { return as_type<bfloat>(static_cast<ushort>(0x7f7f)); }
+    static bfloat min() { return as_type<bfloat>(static_cast<ushort>(0xff80)); }
+    static bfloat max() { return as_type<bfloat>(static_cast<ushort>(0x7f80)); }
+};
+
+// 16-bit floats are only a storage format, arithmetic runs in f32
+template <class T>
+struct Accum {
+    using type = T;
+};
+
+template <>
+struct Accum<half> {
+    using type = float;
+};
+
+template <>
+struct Accum<bfloat> {
+    using type = float;
+};
+
+template <class T>
+using acc_t = typename Accum<T>::type;
+
+// bfloat only converts to and from float, every other conversion goes through float
+template <class R, class T>
+struct Convert {
+    static R apply(T x) { return static_cast<R>(x); }
+};
+
+template <class T>
+struct Convert<bfloat, T> {
+    static bfloat apply(T x) { return static_cast<bfloat>(static_cast<float>(x)); }
+};
+
+template <class R>
+struct Convert<R, bfloat> {
+    static R apply(bfloat x) { return static_cast<R>(static_cast<float>(x)); }
+};
+
+template <>
+struct Convert<bfloat, bfloat> {
+    static bfloat apply(bfloat x) { return x; }
+};
+
+template <class R, class T>
+inline R convert(T x) {
+    return Convert<R, T>::apply(x);
+}
@@ -0,0 +1,114 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    // Query rows, key rows, head size and value size, leading dimensions are flattened into the batch
+    static std::array<isize, 4> sdpa_dims(const ArrayData &q_data, const ArrayData &k_data, const ArrayData &v_data) {
+        const ShapeView &q_view = q_data.get_view();
+        const ShapeView &k_view = k_data.get_view();
+        const isize ndim = q_data.get_ndim();
+        return {q_view[ndim - 2], k_view[ndim - 2], q_view.back(), v_data.get_view().back()};
+    }
+
+    void MTLRunner::run_sdpa_kernel(OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr stats_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        ScaledDotProductAttentionOpPtr sdpa_op = std::static_pointer_cast<ScaledDotProductAttentionOp>(out_op);
+        const ArrayData &q_data = q_op->get_data();
+        const ArrayData &k_data = k_op->get_data();
+        const ArrayData &v_data = v_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = q_data.get_ndim();
+        const std::array<isize, 4> dims = sdpa_dims(q_data, k_data, v_data);
+        const isize nbatch = q_data.get_numel() / (dims[0] * dims[2]);
+        const isize offset[] = {q_data.get_offset(), k_data.get_offset(), v_data.get_offset(), stats_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!q_data.is_contiguous(), !k_data.is_contiguous(), !v_data.is_contiguous()};
+        const bool causal = sdpa_op->is_causal();
+        const float scale = sdpa_op->get_scale();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(dims.data(), sizeof(isize) * 4);
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_view(q_data);
+        encoder.encode_view(k_data);
+        encoder.encode_view(v_data);
+        encoder.encode_stride(q_data);
+        encoder.encode_stride(k_data);
+        encoder.encode_stride(v_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 3);
+        encoder.encode_mtl_buffer(&causal, sizeof(bool));
+        encoder.encode_mtl_buffer(&scale, sizeof(float));
+        encoder.encode_array_buffer(q_data);
+        encoder.encode_array_buffer(k_data);
+        encoder.encode_array_buffer(v_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("sdpa_{}", q_data.get_dtype()->str()));
+        // One threadgroup per block of query rows of every batch
+        const isize nblock = (dims[0] + s_sdpa_block_size - 1) / s_sdpa_block_size;
+        auto grid_size = MTL::Size::Make(nblock * s_sdpa_block_size, nbatch, 1);
+        auto threadgroup_size = MTL::Size::Make(s_sdpa_block_size, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_sdpa_grad_kernel(OpPtr grad_op, OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr out_op, OpPtr stats_op, OpPtr dst_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        SDPAGradOpPtr sdpa_grad_op = std::static_pointer_cast<SDPAGradOp>(dst_op);
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &q_data = q_op->get_data();
+        const ArrayData &k_data = k_op->get_data();
+        const ArrayData &v_data = v_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &dst_data = dst_op->get_data();
+        const isize ndim = q_data.get_ndim();
+        const std::array<isize, 4> dims = sdpa_dims(q_data, k_data, v_data);
+        const isize nbatch = q_data.get_numel() / (dims[0] * dims[2]);
+        const isize offset[] = {grad_data.get_offset(), q_data.get_offset(), k_data.get_offset(), v_data.get_offset(), out_data.get_offset(), stats_data.get_offset(), dst_data.get_offset()};
+        const bool strided[] = {!grad_data.is_contiguous(), !q_data.is_contiguous(), !k_data.is_contiguous(), !v_data.is_contiguous()};
+        const bool causal = sdpa_grad_op->is_causal();
+        const float scale = sdpa_grad_op->get_scale();
+        const AttentionGradTarget target = sdpa_grad_op->get_target();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(dims.data(), sizeof(isize) * 4);
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 7);
+        encoder.encode_view(grad_data);
+        encoder.encode_view(q_data);
+        encoder.encode_view(k_data);
+        encoder.encode_view(v_data);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(q_data);
+        encoder.encode_stride(k_data);
+        encoder.encode_stride(v_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 4);
+        encoder.encode_mtl_buffer(&causal, sizeof(bool));
+        encoder.encode_mtl_buffer(&scale, sizeof(float));
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(q_data);
+        encoder.encode_array_buffer(k_data);
+        encoder.encode_array_buffer(v_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(dst_data);
+        // Query gradients are computed per query row, key and value gradients per key row
+        isize nrow = dims[0];
+
+        if (target == AttentionGradTarget::QUERY) {
+            encoder.set_pipeline_state(std::format("sdpa_grad_query_{}", q_data.get_dtype()->str()));
+        } else {
+            const bool value_grad = target == AttentionGradTarget::VALUE;
+            encoder.encode_mtl_buffer(&value_grad, sizeof(bool));
+            encoder.set_pipeline_state(std::format("sdpa_grad_key_value_{}", q_data.get_dtype()->str()));
+            nrow = dims[1];
+        }
+
+        const isize nblock = (nrow + s_sdpa_block_size - 1) / s_sdpa_block_size;
+        auto grid_size = MTL::Size::Make(nblock * s_sdpa_block_size, nbatch, 1);
+        auto threadgroup_size = MTL::Size::Make(s_sdpa_block_size, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,130 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    // Number of channels, elements after the channel dimension, and elements per channel
+    static std::tuple<isize, isize, isize> batch_norm_geometry(const ArrayData &in_data, isize channel_dim) {
+        const ShapeView &in_view = in_data.get_view();
+        const isize nchannel = in_view[channel_dim];
+        const isize inner = std::accumulate(in_view.begin() + channel_dim + 1, in_view.end(), 1ll, std::multiplies<isize>());
+        return {nchannel, inner, in_data.get_numel() / nchannel};
+    }
+
+    void MTLRunner::run_batch_norm_kernel(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr running_mean_op, OpPtr running_var_op, OpPtr stats_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const BatchNormParams &params = std::static_pointer_cast<BatchNormOp>(out_op)->get_params();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ArrayData &bias_data = bias_op->get_data();
+        const ArrayData &running_mean_data = running_mean_op->get_data();
+        const ArrayData &running_var_data = running_var_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const auto [nchannel, inner, nelm] = batch_norm_geometry(in_data, params.channel_dim);
+        const isize offset[] = {in_data.get_offset(), weight_data.get_offset(), bias_data.get_offset(), running_mean_data.get_offset(),
+                                running_var_data.get_offset(), stats_data.get_offset(), out_data.get_offset()};
+        const isize param_stride[] = {weight_data.get_stride()[0], bias_data.get_stride()[0], running_mean_data.get_stride()[0], running_var_data.get_stride()[0]};
+        const bool strided = !in_data.is_contiguous();
+        const float scalar_params[] = {params.eps, params.momentum};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&nchannel, sizeof(isize));
+        encoder.encode_mtl_buffer(&inner, sizeof(isize));
+        encoder.encode_mtl_buffer(&nelm, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 7);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(param_stride, sizeof(isize) * 4);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(scalar_params, sizeof(float) * 2);
+        encoder.encode_mtl_buffer(&params.training, sizeof(bool));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(bias_data);
+        encoder.encode_array_buffer(running_mean_data);
+        encoder.encode_array_buffer(running_var_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("batch_norm_{}", in_data.get_dtype()->str()));
+        // One threadgroup per channel, the threadgroup size is a power of two for the tree reductions
+        const isize threadgroup_nthread = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(nelm))), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nchannel * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_batch_norm_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr param_grad_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const BatchNormParams &params = std::static_pointer_cast<BatchNormGradOp>(out_op)->get_params();
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &param_grad_data = param_grad_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const auto [nchannel, inner, nelm] = batch_norm_geometry(in_data, params.channel_dim);
+        const isize offset[] = {grad_data.get_offset(), in_data.get_offset(), weight_data.get_offset(), stats_data.get_offset(), param_grad_data.get_offset(), out_data.get_offset()};
+        const isize weight_stride = weight_data.get_stride()[0];
+        const bool strided[] = {!grad_data.is_contiguous(), !in_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&nchannel, sizeof(isize));
+        encoder.encode_mtl_buffer(&inner, sizeof(isize));
+        encoder.encode_mtl_buffer(&nelm, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 6);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&weight_stride, sizeof(isize));
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_mtl_buffer(&params.training, sizeof(bool));
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(param_grad_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("batch_norm_grad_{}", in_data.get_dtype()->str()));
+        const isize numel = in_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_batch_norm_param_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const BatchNormParams &params = std::static_pointer_cast<BatchNormParamGradOp>(out_op)->get_params();
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const auto [nchannel, inner, nelm] = batch_norm_geometry(in_data, params.channel_dim);
+        const isize offset[] = {grad_data.get_offset(), in_data.get_offset(), stats_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!grad_data.is_contiguous(), !in_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&nchannel, sizeof(isize));
+        encoder.encode_mtl_buffer(&inner, sizeof(isize));
+        encoder.encode_mtl_buffer(&nelm, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("batch_norm_param_grad_{}", in_data.get_dtype()->str()));
+        const isize threadgroup_nthread = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(nelm))), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nchannel * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
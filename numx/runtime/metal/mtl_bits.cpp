@@ -0,0 +1,104 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_cmp_bits_kernel(OpPtr l_op, OpPtr r_op, OpPtr out_op) {
+        const ArrayData &l_data = l_op->get_data();
+        const isize numel = l_data.get_numel();
+
+        if (numel == 0) {
+            return;
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &r_data = r_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = l_data.get_ndim();
+        // A 0-d mask is a single row of one element
+        const isize ncol = ndim > 0 ? l_data.get_view().back() : 1;
+        const isize nrow = numel / ncol;
+        const isize nword = num_mask_words(ncol);
+        const isize offset[] = {l_data.get_offset(), r_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!l_data.is_contiguous(), !r_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(&nword, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_view(l_data);
+        encoder.encode_stride(l_data);
+        encoder.encode_stride(r_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_array_buffer(l_data);
+        encoder.encode_array_buffer(r_data);
+        encoder.encode_array_buffer(out_data);
+        const std::string cmp_name = std::static_pointer_cast<CmpBitsOp>(out_op)->get_cmp_name();
+        encoder.set_pipeline_state(std::format("{}_bits_{}", cmp_name, l_data.get_dtype()->str()));
+        // Rows are padded to whole words and the threadgroup width is a multiple of the SIMD width,
+        // so every SIMD group covers exactly one word of one row
+        const isize row_nthread = nword * 32;
+        auto grid_size = MTL::Size::Make(row_nthread, nrow, 1);
+        auto threadgroup_size = MTL::Size::Make(std::min(row_nthread, s_max_threadgroup_size), 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_where_bits_kernel(OpPtr mask_op, OpPtr l_op, OpPtr r_op, OpPtr out_op) {
+        const ArrayData &out_data = out_op->get_data();
+        const isize numel = out_data.get_numel();
+
+        if (numel == 0) {
+            return;
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &mask_data = mask_op->get_data();
+        const ArrayData &l_data = l_op->get_data();
+        const ArrayData &r_data = r_op->get_data();
+        const isize ndim = out_data.get_ndim();
+        const isize ncol = ndim > 0 ? out_data.get_view().back() : 1;
+        const isize nword = num_mask_words(ncol);
+        const isize offset[] = {mask_data.get_offset(), l_data.get_offset(), r_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!l_data.is_contiguous(), !r_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(&nword, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_view(out_data);
+        encoder.encode_stride(l_data);
+        encoder.encode_stride(r_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_array_buffer(mask_data);
+        encoder.encode_array_buffer(l_data);
+        encoder.encode_array_buffer(r_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("where_bits_{}", out_data.get_dtype()->str()));
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_count_bits_kernel(OpPtr mask_op, OpPtr out_op) {
+        const ArrayData &out_data = out_op->get_data();
+        const isize nrow = out_data.get_numel();
+
+        if (nrow == 0) {
+            return;
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &mask_data = mask_op->get_data();
+        const isize nword = mask_data.get_view().back();
+        const isize offset[] = {mask_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(&nword, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_array_buffer(mask_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state("count_bits");
+        encoder.dispatch_threads(nrow, std::min(nrow, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,71 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_clamp_kernel(OpPtr in_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        ClampOpPtr clamp_op = std::static_pointer_cast<ClampOp>(out_op);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!in_data.is_contiguous(), !out_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_stride(out_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+
+        if (in_data.get_dtype()->is_float()) {
+            const float bounds[] = {static_cast<float>(clamp_op->get_min()), static_cast<float>(clamp_op->get_max())};
+            encoder.encode_mtl_buffer(&bounds[0], sizeof(float));
+            encoder.encode_mtl_buffer(&bounds[1], sizeof(float));
+        } else {
+            // Integers are clamped to the integers within the bounds, which saturate to the range of i32
+            const double int_min = std::numeric_limits<int32_t>::min(), int_max = std::numeric_limits<int32_t>::max();
+            const int32_t bounds[] = {static_cast<int32_t>(std::clamp(std::ceil(clamp_op->get_min()), int_min, int_max)), static_cast<int32_t>(std::clamp(std::floor(clamp_op->get_max()), int_min, int_max))};
+            encoder.encode_mtl_buffer(&bounds[0], sizeof(int32_t));
+            encoder.encode_mtl_buffer(&bounds[1], sizeof(int32_t));
+        }
+
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("clamp_{}", in_data.get_dtype()->str()));
+        const isize numel = in_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_clamp_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        ClampGradOpPtr clamp_grad_op = std::static_pointer_cast<ClampGradOp>(out_op);
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = grad_data.get_ndim();
+        const isize offset[] = {grad_data.get_offset(), in_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!grad_data.is_contiguous(), !in_data.is_contiguous(), !out_data.is_contiguous()};
+        const float min = clamp_grad_op->get_min();
+        const float max = clamp_grad_op->get_max();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_view(grad_data);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_stride(out_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 3);
+        encoder.encode_mtl_buffer(&min, sizeof(float));
+        encoder.encode_mtl_buffer(&max, sizeof(float));
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("clamp_grad_{}", grad_data.get_dtype()->str()));
+        const isize numel = grad_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -38,12 +38,14 @@ namespace nx::runtime::metal {
     void MTLContext::init_initializer_kernels() {
         init_kernels("full", DtypeCategory::All);
         init_kernels("arange", DtypeCategory::Numeric);
-        init_kernels("uniform", DtypeCategory::Float);
+        // bf16 values are drawn in f32 since the generator needs float math functions
+        init_kernel("uniform_f32");
+        init_kernel("uniform_f16");
     }
 
     void MTLContext::init_unary_kernels() {
-        std::vector<std::string> unary_names = {"neg", "sq"};
-        std::vector<std::string> unary_float_names = {"exp", "log", "recip", "sin", "cos", "sqrt"};
+        std::vector<std::string> unary_names = {"neg", "sq", "relu", "abs", "sign"};
+        std::vector<std::string> unary_float_names = {"exp", "log", "recip", "sin", "cos", "sqrt", "sigmoid", "tanh", "gelu", "gelu_tanh", "silu", "softplus"};
         init_kernels(unary_names, DtypeCategory::Numeric);
         init_strided_kernels(unary_names, DtypeCategory::Numeric);
         init_kernels(unary_float_names, DtypeCategory::Float);
@@ -51,12 +53,22 @@ namespace nx::runtime::metal {
     }
 
     void MTLContext::init_binary_kernels() {
-        std::vector<std::string> binary_names = {"add", "sub", "mul", "div", "lt", "gt", "leq", "geq", "minimum", "maximum"};
+        std::vector<std::string> binary_names = {"add", "sub", "mul", "div", "lt", "gt", "leq", "geq", "minimum", "maximum", "relu_grad", "fmod", "abs_grad"};
+        std::vector<std::string> binary_float_names = {"pow", "sigmoid_grad", "tanh_grad", "gelu_grad", "gelu_tanh_grad", "silu_grad", "softplus_grad"};
         std::vector<std::string> eq_names = {"eq", "neq"};
         init_kernels(binary_names, DtypeCategory::Numeric);
         init_strided_kernels(binary_names, DtypeCategory::Numeric);
+        init_kernels(binary_float_names, DtypeCategory::Float);
+        init_strided_kernels(binary_float_names, DtypeCategory::Float);
         init_kernels(eq_names, DtypeCategory::All);
         init_strided_kernels(eq_names, DtypeCategory::All);
+        init_kernels("gather", DtypeCategory::All);
+        init_kernels("scatter", DtypeCategory::All);
+    }
+
+    void MTLContext::init_ternary_kernels() {
+        init_kernels("where", DtypeCategory::All);
+        init_strided_kernels("where", DtypeCategory::All);
     }
 
     void MTLContext::init_reduce_kernels() {
@@ -72,6 +84,82 @@ namespace nx::runtime::metal {
                 }
             }
         }
+
+        init_kernels("precise_sum", DtypeCategory::Float);
+        init_kernel("precise_sum_merge");
+
+        std::vector<std::string> stat_names = {"var", "std", "l1_norm", "l2_norm", "linf_norm"};
+
+        for (auto &name : stat_names) {
+            init_kernels(name, DtypeCategory::Float);
+            init_kernel(name + "_merge");
+        }
+    }
+
+    void MTLContext::init_scan_kernels() {
+        std::vector<std::string> scan_names = {"cumsum", "cumprod", "cummax"};
+
+        for (auto &name : scan_names) {
+            init_kernels(name, DtypeCategory::Numeric);
+        }
+    }
+
+    void MTLContext::init_sort_kernels() {
+        init_kernels("sort_block", DtypeCategory::Numeric);
+        init_kernels("sort_merge", DtypeCategory::Numeric);
+    }
+
+    void MTLContext::init_conv_kernels() {
+        init_kernels("im2col", DtypeCategory::Numeric);
+        init_kernels("col2im", DtypeCategory::Numeric);
+    }
+
+    void MTLContext::init_pool_kernels() {
+        init_kernels("maxpool2d", DtypeCategory::Numeric);
+        init_kernels("avgpool2d", DtypeCategory::Numeric);
+        init_kernels("avgpool2d_grad", DtypeCategory::Numeric);
+        init_kernels("maxpool2d_grad", DtypeCategory::Numeric);
+    }
+
+    void MTLContext::init_norm_kernels() {
+        init_kernels("norm", DtypeCategory::Float);
+        init_kernels("norm_grad", DtypeCategory::Float);
+        init_kernels("norm_param_grad", DtypeCategory::Float);
+    }
+
+    void MTLContext::init_batch_norm_kernels() {
+        init_kernels("batch_norm", DtypeCategory::Float);
+        init_kernels("batch_norm_grad", DtypeCategory::Float);
+        init_kernels("batch_norm_param_grad", DtypeCategory::Float);
+    }
+
+    void MTLContext::init_attention_kernels() {
+        init_kernels("sdpa", DtypeCategory::Float);
+        init_kernels("sdpa_grad_query", DtypeCategory::Float);
+        init_kernels("sdpa_grad_key_value", DtypeCategory::Float);
+    }
+
+    void MTLContext::init_dropout_kernels() { init_kernels("dropout", DtypeCategory::Float); }
+
+    void MTLContext::init_clamp_kernels() {
+        init_kernels("clamp", DtypeCategory::Numeric);
+        init_kernels("clamp_grad", DtypeCategory::Float);
+    }
+
+    void MTLContext::init_multinomial_kernels() { init_kernels("multinomial", DtypeCategory::Float); }
+
+    void MTLContext::init_histogram_kernels() {
+        init_kernels("histogram", DtypeCategory::Numeric);
+        init_kernels("weighted_histogram", DtypeCategory::Numeric);
+    }
+
+    void MTLContext::init_rnn_kernels() {
+        init_kernels("lstm_cell", DtypeCategory::Float);
+        init_kernels("lstm_cell_grad", DtypeCategory::Float);
+        init_kernels("gru_cell", DtypeCategory::Float);
+        init_kernels("gru_cell_grad", DtypeCategory::Float);
+        init_kernels("lstm", DtypeCategory::Float);
+        init_kernels("gru", DtypeCategory::Float);
     }
 
     void MTLContext::init_matmul_kernels() {
@@ -85,9 +173,40 @@ namespace nx::runtime::metal {
         init_kernels("strided_tiled_gemm3d", DtypeCategory::Float);
     }
 
+    void MTLContext::init_quantize_kernels() {
+        init_kernels("quantize", DtypeCategory::Float);
+        init_kernels("quantized_matmul", DtypeCategory::Float);
+    }
+
+    void MTLContext::init_sparse_kernels() {
+        init_kernel("spmm");
+        init_kernel("sparse_mul");
+        init_kernel("sparse_to_dense");
+        init_kernels("block_sparse_matmul", DtypeCategory::Float);
+    }
+
+    void MTLContext::init_bits_kernels() {
+        std::vector<std::string> cmp_bits_names = {"lt_bits", "gt_bits", "leq_bits", "geq_bits"};
+        std::vector<std::string> eq_bits_names = {"eq_bits", "neq_bits", "where_bits"};
+        init_kernels(cmp_bits_names, DtypeCategory::Numeric);
+        init_kernels(eq_bits_names, DtypeCategory::All);
+        init_kernel("count_bits");
+    }
+
+    void MTLContext::init_fft_kernels() {
+        init_kernels("rfft", DtypeCategory::Float);
+        init_kernels("irfft", DtypeCategory::Float);
+        init_kernel("fft_chirp");
+    }
+
     void MTLContext::init_copy_kernels() {
-        for (auto &dtype1 : all_dtypes) {
-            for (auto &dtype2 : all_dtypes) {
+        // Narrow integers are storage-only dtypes, e.g. quantized weights, so they only have conversions
+        std::vector<DtypePtr> copy_dtypes = all_dtypes;
+        copy_dtypes.push_back(&i16);
+        copy_dtypes.push_back(&i8);
+
+        for (auto &dtype1 : copy_dtypes) {
+            for (auto &dtype2 : copy_dtypes) {
                 init_kernel(std::format("copy_{}_{}", dtype1->get_name_str(), dtype2->get_name_str()));
                 init_kernel(std::format("strided_copy_{}_{}", dtype1->get_name_str(), dtype2->get_name_str()));
             }
@@ -116,8 +235,25 @@ namespace nx::runtime::metal {
         init_initializer_kernels();
         init_unary_kernels();
         init_binary_kernels();
+        init_ternary_kernels();
         init_reduce_kernels();
+        init_scan_kernels();
+        init_sort_kernels();
         init_matmul_kernels();
+        init_conv_kernels();
+        init_pool_kernels();
+        init_norm_kernels();
+        init_batch_norm_kernels();
+        init_attention_kernels();
+        init_dropout_kernels();
+        init_clamp_kernels();
+        init_multinomial_kernels();
+        init_histogram_kernels();
+        init_rnn_kernels();
+        init_quantize_kernels();
+        init_sparse_kernels();
+        init_bits_kernels();
+        init_fft_kernels();
         init_copy_kernels();
     }
 
@@ -23,8 +23,25 @@ namespace nx::runtime::metal {
         void init_initializer_kernels();
         void init_unary_kernels();
         void init_binary_kernels();
+        void init_ternary_kernels();
         void init_reduce_kernels();
+        void init_scan_kernels();
+        void init_sort_kernels();
         void init_matmul_kernels();
+        void init_conv_kernels();
+        void init_pool_kernels();
+        void init_norm_kernels();
+        void init_batch_norm_kernels();
+        void init_attention_kernels();
+        void init_dropout_kernels();
+        void init_clamp_kernels();
+        void init_multinomial_kernels();
+        void init_histogram_kernels();
+        void init_rnn_kernels();
+        void init_quantize_kernels();
+        void init_sparse_kernels();
+        void init_bits_kernels();
+        void init_fft_kernels();
         void init_copy_kernels();
 
     public:
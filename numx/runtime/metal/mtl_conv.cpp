@@ -0,0 +1,105 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    // Flattens the convolution geometry for the kernels, the image view is in the layout of params
+    static std::vector<isize> conv2d_geometry(const ShapeView &image_view, const Conv2dParams &params) {
+        const bool channels_last = params.channels_last();
+        const isize nchannel = channels_last ? image_view[3] : image_view[1];
+        const isize height = channels_last ? image_view[1] : image_view[2];
+        const isize width = channels_last ? image_view[2] : image_view[3];
+        const isize out_height = Conv2dParams::out_size(height, params.kernel_h, params.stride_h, params.padding_h, params.dilation_h);
+        const isize out_width = Conv2dParams::out_size(width, params.kernel_w, params.stride_w, params.padding_w, params.dilation_w);
+        return {
+            nchannel, height, width,
+            out_height, out_width,
+            params.kernel_h, params.kernel_w,
+            params.stride_h, params.stride_w,
+            params.padding_h, params.padding_w,
+            params.dilation_h, params.dilation_w};
+    }
+
+    void MTLRunner::run_im2col_kernel(OpPtr in_op, OpPtr out_op, const Conv2dParams &params) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const bool channels_last = params.channels_last();
+        const std::vector<isize> geometry = conv2d_geometry(in_data.get_view(), params);
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const ShapeStride &stride = in_data.get_stride();
+        // Image strides in (N, C, H, W) order
+        const isize in_stride[] = {stride[0], channels_last ? stride[3] : stride[1], channels_last ? stride[1] : stride[2], channels_last ? stride[2] : stride[3]};
+        encoder.encode_mtl_buffer(geometry.data(), sizeof(isize) * vsize(geometry));
+        encoder.encode_mtl_buffer(&channels_last, sizeof(bool));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_mtl_buffer(in_stride, sizeof(isize) * 4);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("im2col_{}", in_data.get_dtype()->str()));
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_col2im_kernel(OpPtr in_op, OpPtr out_op, const Conv2dParams &params) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const bool channels_last = params.channels_last();
+        const std::vector<isize> geometry = conv2d_geometry(out_data.get_view(), params);
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const ShapeStride &stride = in_data.get_stride();
+        // Column strides in (N, C * KH * KW, OH * OW) order
+        const isize in_stride[] = {stride[0], channels_last ? stride[2] : stride[1], channels_last ? stride[1] : stride[2]};
+        encoder.encode_mtl_buffer(geometry.data(), sizeof(isize) * vsize(geometry));
+        encoder.encode_mtl_buffer(&channels_last, sizeof(bool));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_mtl_buffer(in_stride, sizeof(isize) * 3);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("col2im_{}", in_data.get_dtype()->str()));
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_conv2d_kernel(OpPtr in_op, OpPtr weight_op, OpPtr out_op) {
+        const Conv2dParams &params = std::static_pointer_cast<Conv2dOp>(out_op)->get_params();
+        const ArrayData &out_data = out_op->get_data();
+        const ShapeView &weight_view = weight_op->get_data().get_view();
+        DtypePtr dtype = out_data.get_dtype();
+        const isize nimage = out_data.get_view()[0];
+        const isize out_nchannel = weight_view[0];
+        const isize patch_size = weight_view[1];
+        const isize npatch = out_data.get_numel() / nimage / out_nchannel;
+
+        // Columns are written to a scratch block that goes back to the cache once the GEMM is done
+        const isize cols_size = nimage * npatch * patch_size * dtype->get_size();
+        MemoryPtr memory = m_ctx->get_memory();
+        BufferBlock *cols_block = memory->alloc_block(cols_size);
+        const ShapeView cols_view = params.channels_last() ? ShapeView{nimage * npatch, patch_size} : ShapeView{nimage, patch_size, npatch};
+        OpPtr cols_op = from_buffer(cols_block->get_ptr(), cols_size, Shape(cols_view), dtype, out_data.get_device());
+        run_im2col_kernel(in_op, cols_op, params);
+
+        if (params.channels_last()) {
+            // (N * OH * OW, C * KH * KW) @ (C * KH * KW, O)
+            OpPtr flat_out_op = reshape(detach(out_op), {nimage * npatch, out_nchannel});
+            OpPtr weight_transpose_op = transpose(detach(weight_op), 0, 1);
+            share_buffer(flat_out_op, out_op);
+            share_buffer(weight_transpose_op, weight_op);
+            run_gemm_kernel(cols_op, weight_transpose_op, flat_out_op);
+        } else {
+            // (N, O, C * KH * KW) @ (N, C * KH * KW, OH * OW) with the weight broadcast over images
+            OpPtr flat_out_op = reshape(detach(out_op), {nimage, out_nchannel, npatch});
+            OpPtr batch_weight_op = broadcast(detach(weight_op), {nimage, out_nchannel, patch_size});
+            share_buffer(flat_out_op, out_op);
+            share_buffer(batch_weight_op, weight_op);
+            run_gemm_kernel(batch_weight_op, cols_op, flat_out_op);
+        }
+
+        memory->free_block(cols_block);
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,30 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_dropout_kernel(OpPtr in_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        DropoutOpPtr dropout_op = std::static_pointer_cast<DropoutOp>(out_op);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const bool strided = !in_data.is_contiguous();
+        const isize key = dropout_op->get_key();
+        const float p = dropout_op->get_p();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(&key, sizeof(isize));
+        encoder.encode_mtl_buffer(&p, sizeof(float));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("dropout_{}", in_data.get_dtype()->str()));
+        const isize numel = in_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,74 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_fft_kernel(OpPtr in_op, OpPtr out_op) {
+        const bool inverse = out_op->get_opcode() == Opcode::IRFFT;
+        const isize n = inverse ? std::static_pointer_cast<IrfftOp>(out_op)->get_n() : std::static_pointer_cast<RfftOp>(out_op)->get_n();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nrow = out_data.get_numel() / (inverse ? n : (n / 2 + 1) * 2);
+        // Even sizes are packed into complex sequences of half the size, sizes that are not powers of two go through
+        // Bluestein's algorithm with a power-of-two circular convolution of at least 2 nfft - 1
+        const isize nfft = n % 2 == 0 ? n / 2 : n;
+        const isize nwork = std::has_single_bit(static_cast<uint64_t>(nfft)) ? nfft : static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(2 * nfft - 1)));
+        const float sign = inverse ? 1.0f : -1.0f;
+        MemoryPtr memory = m_ctx->get_memory();
+        // Every row ping-pongs between two complex buffers of nwork
+        BufferBlock *work = memory->alloc_block(nrow * nwork * 2 * sizeof(float) * 2);
+        BufferBlock *chirp = nwork > nfft ? memory->alloc_block(nwork * 2 * sizeof(float) * 2) : nullptr;
+
+        if (chirp) {
+            run_fft_chirp_kernel(chirp, nfft, nwork, sign);
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const isize ndim = in_data.get_ndim();
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const bool strided = !in_data.is_contiguous();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&n, sizeof(isize));
+        encoder.encode_mtl_buffer(&nwork, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.encode_mtl_buffer(work->get_ptr(), work->get_size());
+
+        if (chirp) {
+            encoder.encode_mtl_buffer(chirp->get_ptr(), chirp->get_size());
+        } else {
+            // The chirp is not read for power-of-two sizes
+            encoder.encode_mtl_buffer(work->get_ptr(), work->get_size());
+        }
+
+        encoder.set_pipeline_state(std::format("{}_{}", out_op->get_opname(), in_data.get_dtype()->str()));
+        // One threadgroup per row, every thread runs at least one butterfly of a radix-4 pass
+        const isize threadgroup_nthread = std::min(align_to(std::max<isize>(nwork / 4, 1), s_simd_size), s_max_threadgroup_size);
+        encoder.dispatch_threads(nrow * threadgroup_nthread, threadgroup_nthread);
+        encoder.wait_to_complete();
+        pool->release();
+        memory->free_block(work);
+
+        if (chirp) {
+            memory->free_block(chirp);
+        }
+    }
+
+    void MTLRunner::run_fft_chirp_kernel(BufferBlock *chirp, isize nfft, isize nwork, float sign) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        encoder.encode_mtl_buffer(&nfft, sizeof(isize));
+        encoder.encode_mtl_buffer(&nwork, sizeof(isize));
+        encoder.encode_mtl_buffer(&sign, sizeof(float));
+        encoder.encode_mtl_buffer(chirp->get_ptr(), chirp->get_size());
+        encoder.set_pipeline_state("fft_chirp");
+        // A single threadgroup since the passes synchronize through device memory
+        const isize threadgroup_nthread = std::min(align_to(nwork / 4, s_simd_size), s_max_threadgroup_size);
+        encoder.dispatch_threads(threadgroup_nthread, threadgroup_nthread);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
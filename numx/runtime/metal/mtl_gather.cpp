@@ -0,0 +1,58 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_gather_kernel(OpPtr in_op, OpPtr index_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &index_data = index_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        std::shared_ptr<GatherOp> gather_op = std::static_pointer_cast<GatherOp>(out_op);
+        const isize ndim = out_data.get_ndim();
+        const isize dim = gather_op->get_dim();
+        const isize offset[] = {in_data.get_offset(), index_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&dim, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_view(index_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_stride(index_data);
+        encoder.encode_stride(out_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(index_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("gather_{}", out_data.get_dtype()->str()));
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_scatter_kernel(OpPtr in_op, OpPtr index_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &index_data = index_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        std::shared_ptr<ScatterOp> scatter_op = std::static_pointer_cast<ScatterOp>(out_op);
+        const isize ndim = out_data.get_ndim();
+        const isize dim = scatter_op->get_dim();
+        const isize offset[] = {in_data.get_offset(), index_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&dim, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_view(index_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_stride(index_data);
+        encoder.encode_stride(out_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(index_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("scatter_{}", out_data.get_dtype()->str()));
+        // One thread per input element, the output was zero-filled beforehand
+        const isize numel = in_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
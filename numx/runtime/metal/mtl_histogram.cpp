@@ -0,0 +1,45 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_histogram_kernel(OpPtr in_op, OpPtr weight_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        BinningOpPtr binning_op = std::static_pointer_cast<BinningOp>(out_op);
+        const ArrayData &in_data = in_op->get_data();
+        // Without weights, the input is bound in place of the weights and never read
+        const ArrayData &weight_data = weight_op ? weight_op->get_data() : in_data;
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize numel = in_data.get_numel();
+        const isize offset[] = {in_data.get_offset(), weight_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!in_data.is_contiguous(), !weight_data.is_contiguous()};
+        const isize nbin = binning_op->get_num_bins();
+        const bool ranged = binning_op->is_ranged();
+        const float min = binning_op->get_min();
+        const float max = binning_op->get_max();
+        const bool weighted = weight_op != nullptr;
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&numel, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_stride(weight_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_mtl_buffer(&nbin, sizeof(isize));
+        encoder.encode_mtl_buffer(&ranged, sizeof(bool));
+        encoder.encode_mtl_buffer(&min, sizeof(float));
+        encoder.encode_mtl_buffer(&max, sizeof(float));
+        encoder.encode_mtl_buffer(&weighted, sizeof(bool));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("{}histogram_{}", weighted ? "weighted_" : "", in_data.get_dtype()->str()));
+        const isize threadgroup_nthread = std::min(std::max(numel, static_cast<isize>(1)), s_max_threadgroup_size);
+        const isize nthreadgroup = std::min((numel + threadgroup_nthread - 1) / threadgroup_nthread, s_histogram_max_threadgroups);
+        auto grid_size = MTL::Size::Make(std::max(nthreadgroup, static_cast<isize>(1)) * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,44 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_multinomial_kernel(OpPtr in_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        MultinomialOpPtr multinomial_op = std::static_pointer_cast<MultinomialOp>(out_op);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const bool strided = !in_data.is_contiguous();
+        const isize key = multinomial_op->get_key();
+        const isize nsample = multinomial_op->get_num_samples();
+        const float temperature = multinomial_op->get_temperature();
+        const isize top_k = multinomial_op->get_top_k();
+        const float top_p = multinomial_op->get_top_p();
+        const bool logits = multinomial_op->is_logits();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(&key, sizeof(isize));
+        encoder.encode_mtl_buffer(&nsample, sizeof(isize));
+        encoder.encode_mtl_buffer(&temperature, sizeof(float));
+        encoder.encode_mtl_buffer(&top_k, sizeof(isize));
+        encoder.encode_mtl_buffer(&top_p, sizeof(float));
+        encoder.encode_mtl_buffer(&logits, sizeof(bool));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("multinomial_{}", in_data.get_dtype()->str()));
+        // One threadgroup per row, the threadgroup size is a power of two for the tree reductions
+        const isize threadgroup_nthread = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(ncol))), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nrow * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
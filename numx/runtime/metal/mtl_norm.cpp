@@ -0,0 +1,115 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_norm_kernel(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr stats_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        NormOpPtr norm_op = std::static_pointer_cast<NormOp>(out_op);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        // RMS normalization has no bias, the weight is bound in its place and never read
+        const ArrayData &bias_data = bias_op ? bias_op->get_data() : weight_data;
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize offset[] = {in_data.get_offset(), weight_data.get_offset(), bias_data.get_offset(), stats_data.get_offset(), out_data.get_offset()};
+        const isize param_stride[] = {weight_data.get_stride()[0], bias_data.get_stride()[0]};
+        const bool strided = !in_data.is_contiguous();
+        const bool centered = norm_op->is_centered();
+        const float eps = norm_op->get_eps();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(param_stride, sizeof(isize) * 2);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(&centered, sizeof(bool));
+        encoder.encode_mtl_buffer(&eps, sizeof(float));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(bias_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("norm_{}", in_data.get_dtype()->str()));
+        // One threadgroup per row, the threadgroup size is a power of two for the tree reductions
+        const isize threadgroup_nthread = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(ncol))), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nrow * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_norm_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize offset[] = {grad_data.get_offset(), in_data.get_offset(), weight_data.get_offset(), stats_data.get_offset(), out_data.get_offset()};
+        const isize weight_stride = weight_data.get_stride()[0];
+        const bool strided[] = {!grad_data.is_contiguous(), !in_data.is_contiguous()};
+        const bool centered = std::static_pointer_cast<NormGradOp>(out_op)->is_centered();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&weight_stride, sizeof(isize));
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_mtl_buffer(&centered, sizeof(bool));
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("norm_grad_{}", in_data.get_dtype()->str()));
+        const isize threadgroup_nthread = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(ncol))), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nrow * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_norm_param_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &stats_data = stats_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize offset[] = {grad_data.get_offset(), in_data.get_offset(), stats_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!grad_data.is_contiguous(), !in_data.is_contiguous()};
+        const bool centered = std::static_pointer_cast<NormParamGradOp>(out_op)->is_centered();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(&nrow, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_mtl_buffer(&centered, sizeof(bool));
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(stats_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("norm_param_grad_{}", in_data.get_dtype()->str()));
+        encoder.dispatch_threads(ncol, std::min(ncol, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
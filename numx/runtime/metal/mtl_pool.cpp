@@ -0,0 +1,97 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    // Flattens the pooling geometry for the kernels from the image and pooled views in the layout of params
+    static std::vector<isize> pool2d_geometry(const ShapeView &image_view, const ShapeView &pooled_view, const Pool2dParams &params) {
+        const bool channels_last = params.channels_last();
+        return {
+            channels_last ? image_view[3] : image_view[1],
+            channels_last ? image_view[1] : image_view[2],
+            channels_last ? image_view[2] : image_view[3],
+            channels_last ? pooled_view[1] : pooled_view[2],
+            channels_last ? pooled_view[2] : pooled_view[3],
+            params.kernel_h, params.kernel_w,
+            params.stride_h, params.stride_w,
+            params.padding_h, params.padding_w,
+            params.adaptive};
+    }
+
+    // Strides in (N, C, H, W) order
+    static std::array<isize, 4> pool2d_stride(const ArrayData &data, const Pool2dParams &params) {
+        const ShapeStride &stride = data.get_stride();
+        return params.channels_last() ? std::array<isize, 4>{stride[0], stride[3], stride[1], stride[2]} : std::array<isize, 4>{stride[0], stride[1], stride[2], stride[3]};
+    }
+
+    void MTLRunner::run_pool2d_kernel(OpPtr in_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const Pool2dParams &params = std::static_pointer_cast<Pool2dOp>(out_op)->get_params();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const bool channels_last = params.channels_last();
+        const std::vector<isize> geometry = pool2d_geometry(in_data.get_view(), out_data.get_view(), params);
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const std::array<isize, 4> in_stride = pool2d_stride(in_data, params);
+        encoder.encode_mtl_buffer(geometry.data(), sizeof(isize) * vsize(geometry));
+        encoder.encode_mtl_buffer(&channels_last, sizeof(bool));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_mtl_buffer(in_stride.data(), sizeof(isize) * 4);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("{}_{}", out_op->get_opname(), in_data.get_dtype()->str()));
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_avgpool2d_grad_kernel(OpPtr grad_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const Pool2dParams &params = std::static_pointer_cast<Pool2dOp>(out_op)->get_params();
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const bool channels_last = params.channels_last();
+        const std::vector<isize> geometry = pool2d_geometry(out_data.get_view(), grad_data.get_view(), params);
+        const isize offset[] = {grad_data.get_offset(), out_data.get_offset()};
+        const std::array<isize, 4> grad_stride = pool2d_stride(grad_data, params);
+        encoder.encode_mtl_buffer(geometry.data(), sizeof(isize) * vsize(geometry));
+        encoder.encode_mtl_buffer(&channels_last, sizeof(bool));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_mtl_buffer(grad_stride.data(), sizeof(isize) * 4);
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("avgpool2d_grad_{}", grad_data.get_dtype()->str()));
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_maxpool2d_grad_kernel(OpPtr in_op, OpPtr grad_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const Pool2dParams &params = std::static_pointer_cast<MaxPool2dGradOp>(out_op)->get_params();
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const bool channels_last = params.channels_last();
+        const std::vector<isize> geometry = pool2d_geometry(in_data.get_view(), grad_data.get_view(), params);
+        const isize offset[] = {in_data.get_offset(), grad_data.get_offset(), out_data.get_offset()};
+        const std::array<isize, 4> in_stride = pool2d_stride(in_data, params);
+        const std::array<isize, 4> grad_stride = pool2d_stride(grad_data, params);
+        encoder.encode_mtl_buffer(geometry.data(), sizeof(isize) * vsize(geometry));
+        encoder.encode_mtl_buffer(&channels_last, sizeof(bool));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_mtl_buffer(in_stride.data(), sizeof(isize) * 4);
+        encoder.encode_mtl_buffer(grad_stride.data(), sizeof(isize) * 4);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("maxpool2d_grad_{}", in_data.get_dtype()->str()));
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,72 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_quantize_kernel(OpPtr in_op, OpPtr scale_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &scale_data = scale_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize offset[] = {in_data.get_offset(), scale_data.get_offset(), out_data.get_offset()};
+        const bool strided = !in_data.is_contiguous();
+        const float clip = std::static_pointer_cast<QuantizeOp>(out_op)->get_clip();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 3);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(&clip, sizeof(float));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(scale_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("quantize_{}", in_data.get_dtype()->str()));
+        // One threadgroup per row, the threadgroup size is a power of two for the tree reduction
+        const isize threadgroup_nthread = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(ncol))), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nrow * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_quantized_matmul_kernel(OpPtr in_op, OpPtr in_scale_op, OpPtr weight_op, OpPtr weight_scale_op, OpPtr bias_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &in_scale_data = in_scale_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ArrayData &weight_scale_data = weight_scale_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        // Without bias, the output is bound in place of the bias and never read
+        const ArrayData &bias_data = bias_op ? bias_op->get_data() : out_data;
+        const isize K = in_data.get_view().back();
+        const isize M = in_data.get_numel() / K;
+        const isize N = weight_data.get_view()[0];
+        const isize offset[] = {in_data.get_offset(), in_scale_data.get_offset(), weight_data.get_offset(), weight_scale_data.get_offset(), bias_data.get_offset(), out_data.get_offset()};
+        const bool has_bias = bias_op != nullptr;
+        const uint32_t activation = static_cast<uint32_t>(std::static_pointer_cast<QuantizedMatmulOp>(out_op)->get_activation());
+        encoder.encode_mtl_buffer(&M, sizeof(isize));
+        encoder.encode_mtl_buffer(&K, sizeof(isize));
+        encoder.encode_mtl_buffer(&N, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 6);
+        encoder.encode_mtl_buffer(&has_bias, sizeof(bool));
+        encoder.encode_mtl_buffer(&activation, sizeof(uint32_t));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(in_scale_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(weight_scale_data);
+        encoder.encode_array_buffer(bias_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("quantized_matmul_{}", out_data.get_dtype()->str()));
+        // Every thread computes a 4x4 output tile
+        auto grid_size = MTL::Size::Make((N + 3) / 4, (M + 3) / 4, 1);
+        auto threadgroup_size = MTL::Size::Make(s_max_threadgroup_size, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
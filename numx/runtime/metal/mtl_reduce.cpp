@@ -119,4 +119,173 @@ namespace nx::runtime::metal {
         encoder.wait_to_complete();
         pool->release();
     }
-} // namespace nx::runtime::metal
\ No newline at end of file
+
+    void MTLRunner::run_precise_sum_kernel(OpPtr in_op, OpPtr out_op) {
+        ReduceOpPtr reduce_op = std::static_pointer_cast<ReduceOp>(out_op);
+        const ShapeDims &remaining_dims = reduce_op->get_remaining_dims();
+        const ShapeDims &reduce_dims = reduce_op->get_reduce_dims();
+        const ShapeView &in_view = in_op->get_data().get_view();
+
+        // Move reduction dimensions to the end
+        ShapeDims permutation_dims;
+        permutation_dims.reserve(remaining_dims.size() + reduce_dims.size());
+        permutation_dims.insert(permutation_dims.end(), remaining_dims.begin(), remaining_dims.end());
+        permutation_dims.insert(permutation_dims.end(), reduce_dims.begin(), reduce_dims.end());
+        // Detach input op so the computational graph is not affected
+        OpPtr permutation_op = permute(detach(in_op), permutation_dims);
+        const ArrayData &permutation_data = permutation_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        share_buffer(permutation_op, in_op);
+        const isize ndim = permutation_data.get_ndim();
+        const isize nrow = std::accumulate(remaining_dims.begin(), remaining_dims.end(), 1ll, [&](isize acc, isize dim) { return acc * in_view[dim]; });
+        const isize ncol = std::accumulate(reduce_dims.begin(), reduce_dims.end(), 1ll, [&](isize acc, isize dim) { return acc * in_view[dim]; });
+
+        // Each threadgroup sums s_precise_sum_nread elements per thread, long rows are split into blocks merged afterwards
+        const isize threadgroup_nthread = std::min(align_to(ncol, s_simd_size), s_max_threadgroup_size);
+        const isize block_size = threadgroup_nthread * s_precise_sum_nread;
+        const isize nblock = (ncol + block_size - 1) / block_size;
+        MemoryPtr memory = m_ctx->get_memory();
+        BufferBlock *partials = nblock > 1 ? memory->alloc_block(nrow * nblock * sizeof(float) * 2) : nullptr;
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const isize offset[] = {permutation_data.get_offset(), out_data.get_offset()};
+        const bool strided = !permutation_data.is_contiguous();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(permutation_data);
+        encoder.encode_stride(permutation_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_array_buffer(permutation_data);
+        encoder.encode_array_buffer(out_data);
+
+        if (partials) {
+            encoder.encode_mtl_buffer(partials->get_ptr(), partials->get_size());
+        } else {
+            // Partials are not written when there is a single block per row
+            encoder.encode_array_buffer(out_data);
+        }
+
+        encoder.set_pipeline_state(std::format("precise_sum_{}", permutation_data.get_dtype()->str()));
+        auto grid_size = MTL::Size::Make(nblock * threadgroup_nthread, nrow, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+
+        if (partials) {
+            run_precise_sum_merge_kernel(partials, nrow, nblock, out_op);
+            memory->free_block(partials);
+        }
+    }
+
+    void MTLRunner::run_precise_sum_merge_kernel(BufferBlock *partials, isize nrow, isize npartial, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &out_data = out_op->get_data();
+        const isize offset = out_data.get_offset();
+        encoder.encode_mtl_buffer(&npartial, sizeof(isize));
+        encoder.encode_mtl_buffer(&offset, sizeof(isize));
+        encoder.encode_mtl_buffer(partials->get_ptr(), partials->get_size());
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state("precise_sum_merge");
+        // One threadgroup per row
+        const isize threadgroup_nthread = std::min(align_to(npartial, s_simd_size), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nrow * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_stat_reduce_kernel(OpPtr in_op, OpPtr out_op) {
+        ReduceOpPtr reduce_op = std::static_pointer_cast<ReduceOp>(out_op);
+        const ShapeDims &remaining_dims = reduce_op->get_remaining_dims();
+        const ShapeDims &reduce_dims = reduce_op->get_reduce_dims();
+        const ShapeView &in_view = in_op->get_data().get_view();
+        std::string opname;
+        float correction = 0.0f;
+
+        if (reduce_op->get_opcode() == Opcode::VECTOR_NORM) {
+            opname = std::static_pointer_cast<VectorNormOp>(out_op)->get_ord_name() + "_norm";
+        } else {
+            opname = out_op->get_opname();
+            correction = std::static_pointer_cast<VarOp>(out_op)->get_correction();
+        }
+
+        // Move reduction dimensions to the end
+        ShapeDims permutation_dims;
+        permutation_dims.reserve(remaining_dims.size() + reduce_dims.size());
+        permutation_dims.insert(permutation_dims.end(), remaining_dims.begin(), remaining_dims.end());
+        permutation_dims.insert(permutation_dims.end(), reduce_dims.begin(), reduce_dims.end());
+        // Detach input op so the computational graph is not affected
+        OpPtr permutation_op = permute(detach(in_op), permutation_dims);
+        const ArrayData &permutation_data = permutation_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        share_buffer(permutation_op, in_op);
+        const isize ndim = permutation_data.get_ndim();
+        const isize nrow = std::accumulate(remaining_dims.begin(), remaining_dims.end(), 1ll, [&](isize acc, isize dim) { return acc * in_view[dim]; });
+        const isize ncol = std::accumulate(reduce_dims.begin(), reduce_dims.end(), 1ll, [&](isize acc, isize dim) { return acc * in_view[dim]; });
+
+        // Same blocking as precise sums, partials hold the count, mean and squared deviations of a block for variances
+        const isize threadgroup_nthread = std::min(align_to(ncol, s_simd_size), s_max_threadgroup_size);
+        const isize block_size = threadgroup_nthread * s_stat_reduce_nread;
+        const isize nblock = (ncol + block_size - 1) / block_size;
+        MemoryPtr memory = m_ctx->get_memory();
+        BufferBlock *partials = nblock > 1 ? memory->alloc_block(nrow * nblock * sizeof(float) * 4) : nullptr;
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const isize offset[] = {permutation_data.get_offset(), out_data.get_offset()};
+        const bool strided = !permutation_data.is_contiguous();
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(permutation_data);
+        encoder.encode_stride(permutation_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(&correction, sizeof(float));
+        encoder.encode_array_buffer(permutation_data);
+        encoder.encode_array_buffer(out_data);
+
+        if (partials) {
+            encoder.encode_mtl_buffer(partials->get_ptr(), partials->get_size());
+        } else {
+            // Partials are not written when there is a single block per row
+            encoder.encode_array_buffer(out_data);
+        }
+
+        encoder.set_pipeline_state(std::format("{}_{}", opname, permutation_data.get_dtype()->str()));
+        auto grid_size = MTL::Size::Make(nblock * threadgroup_nthread, nrow, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+
+        if (partials) {
+            run_stat_reduce_merge_kernel(opname + "_merge", partials, nrow, nblock, correction, out_op);
+            memory->free_block(partials);
+        }
+    }
+
+    void MTLRunner::run_stat_reduce_merge_kernel(const std::string &kernel_name, BufferBlock *partials, isize nrow, isize npartial, float correction, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &out_data = out_op->get_data();
+        const isize offset = out_data.get_offset();
+        encoder.encode_mtl_buffer(&npartial, sizeof(isize));
+        encoder.encode_mtl_buffer(&offset, sizeof(isize));
+        encoder.encode_mtl_buffer(&correction, sizeof(float));
+        encoder.encode_mtl_buffer(partials->get_ptr(), partials->get_size());
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(kernel_name);
+        // One threadgroup per row
+        const isize threadgroup_nthread = std::min(align_to(npartial, s_simd_size), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nrow * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,130 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_recurrent_cell_kernel(OpPtr gi_op, OpPtr gh_op, OpPtr state_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &gi_data = gi_op->get_data();
+        const ArrayData &gh_data = gh_op->get_data();
+        const ArrayData &state_data = state_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nhidden = state_data.get_view()[1];
+        const isize offset[] = {gi_data.get_offset(), gh_data.get_offset(), state_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(&nhidden, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_stride(gi_data);
+        encoder.encode_stride(gh_data);
+        encoder.encode_stride(state_data);
+        encoder.encode_array_buffer(gi_data);
+        encoder.encode_array_buffer(gh_data);
+        encoder.encode_array_buffer(state_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("{}_{}", out_op->get_opname(), gi_data.get_dtype()->str()));
+        // One thread per hidden unit of every batch row
+        const isize numel = state_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_recurrent_cell_grad_kernel(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr state_op, OpPtr out_op, RecurrentGradTarget target) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &grad_data = grad_op->get_data();
+        const ArrayData &gi_data = gi_op->get_data();
+        const ArrayData &gh_data = gh_op->get_data();
+        const ArrayData &state_data = state_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nhidden = state_data.get_view()[1];
+        const isize target_id = static_cast<isize>(target);
+        const isize offset[] = {grad_data.get_offset(), gi_data.get_offset(), gh_data.get_offset(), state_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(&nhidden, sizeof(isize));
+        encoder.encode_mtl_buffer(&target_id, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_stride(grad_data);
+        encoder.encode_stride(gi_data);
+        encoder.encode_stride(gh_data);
+        encoder.encode_stride(state_data);
+        encoder.encode_array_buffer(grad_data);
+        encoder.encode_array_buffer(gi_data);
+        encoder.encode_array_buffer(gh_data);
+        encoder.encode_array_buffer(state_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("{}_{}", out_op->get_opname(), gi_data.get_dtype()->str()));
+        // Every thread writes all gates of its hidden unit
+        const isize numel = state_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_lstm_kernel(OpPtr gi_op, OpPtr weight_op, OpPtr h_op, OpPtr c_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &gi_data = gi_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ArrayData &h_data = h_op->get_data();
+        const ArrayData &c_data = c_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nstep = gi_data.get_view()[0];
+        const isize nbatch = gi_data.get_view()[1];
+        const isize nhidden = weight_data.get_view()[0];
+        const isize offset[] = {gi_data.get_offset(), weight_data.get_offset(), h_data.get_offset(), c_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(&nstep, sizeof(isize));
+        encoder.encode_mtl_buffer(&nbatch, sizeof(isize));
+        encoder.encode_mtl_buffer(&nhidden, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_stride(gi_data);
+        encoder.encode_stride(weight_data);
+        encoder.encode_stride(h_data);
+        encoder.encode_stride(c_data);
+        encoder.encode_array_buffer(gi_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(h_data);
+        encoder.encode_array_buffer(c_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("lstm_{}", gi_data.get_dtype()->str()));
+        // One threadgroup per batch row runs all steps
+        const isize threadgroup_nthread = std::min(nhidden, s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nbatch * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_gru_kernel(OpPtr gi_op, OpPtr weight_op, OpPtr bias_op, OpPtr h_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &gi_data = gi_op->get_data();
+        const ArrayData &weight_data = weight_op->get_data();
+        const ArrayData &bias_data = bias_op->get_data();
+        const ArrayData &h_data = h_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nstep = gi_data.get_view()[0];
+        const isize nbatch = gi_data.get_view()[1];
+        const isize nhidden = weight_data.get_view()[0];
+        const isize offset[] = {gi_data.get_offset(), weight_data.get_offset(), bias_data.get_offset(), h_data.get_offset(), out_data.get_offset()};
+        const isize bias_stride = bias_data.get_stride()[0];
+        encoder.encode_mtl_buffer(&nstep, sizeof(isize));
+        encoder.encode_mtl_buffer(&nbatch, sizeof(isize));
+        encoder.encode_mtl_buffer(&nhidden, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_stride(gi_data);
+        encoder.encode_stride(weight_data);
+        encoder.encode_mtl_buffer(&bias_stride, sizeof(isize));
+        encoder.encode_stride(h_data);
+        encoder.encode_array_buffer(gi_data);
+        encoder.encode_array_buffer(weight_data);
+        encoder.encode_array_buffer(bias_data);
+        encoder.encode_array_buffer(h_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("gru_{}", gi_data.get_dtype()->str()));
+        const isize threadgroup_nthread = std::min(nhidden, s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nbatch * threadgroup_nthread, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -42,6 +42,22 @@ namespace nx::runtime::metal {
 
         if (op->get_opcode() == Opcode::COPY) {
             run_copy_kernel(operand, op);
+        } else if (op->get_opcode() == Opcode::IM2COL) {
+            run_im2col_kernel(operand, op, std::static_pointer_cast<Im2colOp>(op)->get_params());
+        } else if (op->get_opcode() == Opcode::COL2IM) {
+            run_col2im_kernel(operand, op, std::static_pointer_cast<Col2imOp>(op)->get_params());
+        } else if (op->get_opcode() == Opcode::MAXPOOL2D || op->get_opcode() == Opcode::AVGPOOL2D) {
+            run_pool2d_kernel(operand, op);
+        } else if (op->get_opcode() == Opcode::AVGPOOL2D_GRAD) {
+            run_avgpool2d_grad_kernel(operand, op);
+        } else if (op->get_opcode() == Opcode::DROPOUT) {
+            run_dropout_kernel(operand, op);
+        } else if (op->get_opcode() == Opcode::CLAMP) {
+            run_clamp_kernel(operand, op);
+        } else if (op->get_opcode() == Opcode::MULTINOMIAL) {
+            run_multinomial_kernel(operand, op);
+        } else if (op->get_opcode() == Opcode::RFFT || op->get_opcode() == Opcode::IRFFT) {
+            run_fft_kernel(operand, op);
         } else {
             run_unary_kernel(operand, op);
         }
@@ -65,11 +81,230 @@ namespace nx::runtime::metal {
 
         if (binary_op->get_mode() == BinaryMode::MATMUL) {
             run_gemm_kernel(lop, rop, op);
+        } else if (binary_op->get_mode() == BinaryMode::GATHER) {
+            run_gather_kernel(lop, rop, op);
+        } else if (binary_op->get_mode() == BinaryMode::SCATTER) {
+            // Only the positions given by the index are written
+            run_full_kernel(op, 0);
+            run_scatter_kernel(lop, rop, op);
+        } else if (binary_op->get_mode() == BinaryMode::CONV) {
+            run_conv2d_kernel(lop, rop, op);
+        } else if (binary_op->get_mode() == BinaryMode::POOL) {
+            run_maxpool2d_grad_kernel(lop, rop, op);
+        } else if (op->get_opcode() == Opcode::CLAMP_GRAD) {
+            run_clamp_grad_kernel(lop, rop, op);
         } else {
             run_binary_kernel(lop, rop, op);
         }
     }
 
+    void MTLRunner::run_ternary_op(OpPtr op) {
+        TernaryOpPtr ternary_op = std::static_pointer_cast<TernaryOp>(op);
+        alloc_buffer(op);
+        run_ternary_kernel(ternary_op->get_first(), ternary_op->get_second(), ternary_op->get_third(), op);
+    }
+
+    void MTLRunner::run_nary_op(OpPtr op) {
+        switch (op->get_opcode()) {
+        case Opcode::CONCAT: {
+            run_concat_op(op);
+            break;
+        }
+        case Opcode::LAYERNORM:
+        case Opcode::RMSNORM: {
+            NormOpPtr norm_op = std::static_pointer_cast<NormOp>(op);
+            const std::vector<OpPtr> &operands = norm_op->get_operands();
+            alloc_buffer(op);
+            run_norm_kernel(operands[0], operands[1], norm_op->is_centered() ? operands[2] : nullptr, norm_op->get_stats(), op);
+            break;
+        }
+        case Opcode::NORM_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_norm_grad_kernel(operands[0], operands[1], operands[2], operands[3], op);
+            break;
+        }
+        case Opcode::NORM_PARAM_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_norm_param_grad_kernel(operands[0], operands[1], operands[2], op);
+            break;
+        }
+        case Opcode::BATCHNORM: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_batch_norm_kernel(operands[0], operands[1], operands[2], operands[3], operands[4], operands[5], op);
+            break;
+        }
+        case Opcode::BATCHNORM_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_batch_norm_grad_kernel(operands[0], operands[1], operands[2], operands[3], operands[4], op);
+            break;
+        }
+        case Opcode::BATCHNORM_PARAM_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_batch_norm_param_grad_kernel(operands[0], operands[1], operands[2], op);
+            break;
+        }
+        case Opcode::SDPA: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_sdpa_kernel(operands[0], operands[1], operands[2], operands[3], op);
+            break;
+        }
+        case Opcode::SDPA_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_sdpa_grad_kernel(operands[0], operands[1], operands[2], operands[3], operands[4], operands[5], op);
+            break;
+        }
+        case Opcode::BINCOUNT:
+        case Opcode::HISTOGRAM: {
+            BinningOpPtr binning_op = std::static_pointer_cast<BinningOp>(op);
+            const std::vector<OpPtr> &operands = binning_op->get_operands();
+            alloc_buffer(op);
+            // Bins are accumulated atomically into the zeroed output
+            run_full_kernel(op, 0);
+            run_histogram_kernel(operands[0], binning_op->has_weight() ? operands[1] : nullptr, op);
+            break;
+        }
+        case Opcode::LSTM_CELL:
+        case Opcode::GRU_CELL: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_recurrent_cell_kernel(operands[0], operands[1], operands[2], op);
+            break;
+        }
+        case Opcode::LSTM_CELL_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_recurrent_cell_grad_kernel(operands[0], operands[1], operands[2], operands[3], op, std::static_pointer_cast<LSTMCellGradOp>(op)->get_target());
+            break;
+        }
+        case Opcode::GRU_CELL_GRAD: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_recurrent_cell_grad_kernel(operands[0], operands[1], operands[2], operands[3], op, std::static_pointer_cast<GRUCellGradOp>(op)->get_target());
+            break;
+        }
+        case Opcode::LSTM: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_lstm_kernel(operands[0], operands[1], operands[2], operands[3], op);
+            break;
+        }
+        case Opcode::GRU: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_gru_kernel(operands[0], operands[1], operands[2], operands[3], op);
+            break;
+        }
+        case Opcode::QUANTIZE: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_quantize_kernel(operands[0], operands[1], op);
+            break;
+        }
+        case Opcode::QUANTIZED_MATMUL: {
+            QuantizedMatmulOpPtr matmul_op = std::static_pointer_cast<QuantizedMatmulOp>(op);
+            const std::vector<OpPtr> &operands = matmul_op->get_operands();
+            alloc_buffer(op);
+            run_quantized_matmul_kernel(operands[0], operands[1], operands[2], operands[3], matmul_op->has_bias() ? operands[4] : nullptr, op);
+            break;
+        }
+        case Opcode::SPMM: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            // Partial sums are added atomically into the output
+            run_full_kernel(op, 0);
+            run_spmm_kernel(operands[0], operands[1], operands[2], operands[3], op);
+            break;
+        }
+        case Opcode::SPARSE_MUL: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_sparse_mul_kernel(operands[0], operands[1], operands[2], operands[3], op);
+            break;
+        }
+        case Opcode::SPARSE_TO_DENSE: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_full_kernel(op, 0);
+            run_sparse_to_dense_kernel(operands[0], operands[1], operands[2], op);
+            break;
+        }
+        case Opcode::BLOCK_SPARSE_MATMUL: {
+            BlockSparseMatmulOpPtr matmul_op = std::static_pointer_cast<BlockSparseMatmulOp>(op);
+            const std::vector<OpPtr> &operands = matmul_op->get_operands();
+            alloc_buffer(op);
+            run_block_sparse_matmul_kernel(operands[0], operands[1], operands[2], operands[3], matmul_op->has_bias() ? operands[4] : nullptr, op);
+            break;
+        }
+        case Opcode::CMP_BITS: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_cmp_bits_kernel(operands[0], operands[1], op);
+            break;
+        }
+        case Opcode::WHERE_BITS: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_where_bits_kernel(operands[0], operands[1], operands[2], op);
+            break;
+        }
+        case Opcode::COUNT_BITS: {
+            const std::vector<OpPtr> &operands = std::static_pointer_cast<NaryOp>(op)->get_operands();
+            alloc_buffer(op);
+            run_count_bits_kernel(operands[0], op);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void MTLRunner::plan_concat_op(OpPtr op) {
+        ConcatOpPtr concat_op = std::static_pointer_cast<ConcatOp>(op);
+        const std::vector<OpPtr> &operands = concat_op->get_operands();
+        const std::vector<RangeVector> &ranges = concat_op->get_ranges();
+        alloc_buffer(op);
+        const ArrayData &data = op->get_data();
+
+        // Let each eligible operand's producer write straight into its slice of the output
+        for (size_t i = 0; i < operands.size(); i++) {
+            const OpPtr &operand = operands[i];
+
+            if (can_write_into_slice(operand)) {
+                ArrayData &operand_data = operand->get_data();
+                operand_data.set_shape(data.get_shape().slice(ranges[i]));
+                operand_data.set_view_buffer(data.get_buffer().get_block());
+            }
+        }
+    }
+
+    void MTLRunner::run_concat_op(OpPtr op) {
+        ConcatOpPtr concat_op = std::static_pointer_cast<ConcatOp>(op);
+        const std::vector<OpPtr> &operands = concat_op->get_operands();
+        const std::vector<RangeVector> &ranges = concat_op->get_ranges();
+        alloc_buffer(op);
+        uint8_t *ptr = op->get_data().get_buffer().get_ptr();
+
+        for (size_t i = 0; i < operands.size(); i++) {
+            const OpPtr &operand = operands[i];
+
+            // Operands planned into the output buffer have already been written in place
+            if (operand->get_data().get_buffer().get_ptr() == ptr) {
+                continue;
+            }
+
+            OpPtr out_slice = slice(op, ranges[i]);
+            share_buffer(out_slice, op);
+            run_copy_kernel(operand, out_slice);
+        }
+    }
+
     void MTLRunner::run_transform_op(OpPtr op) {
         switch (op->get_opcode()) {
         case Opcode::RESHAPE: {
@@ -105,6 +340,12 @@ namespace nx::runtime::metal {
             run_simple_transform_op<UnsqueezeOp>(op);
             break;
         }
+        case Opcode::QUANTIZE_SCALE: {
+            // The scales were written into the scale operand by the quantize op
+            std::shared_ptr<QuantizeScaleOp> scale_op = std::static_pointer_cast<QuantizeScaleOp>(op);
+            share_buffer(op, std::static_pointer_cast<QuantizeOp>(scale_op->get_operand())->get_scale());
+            break;
+        }
         case Opcode::ASTYPE: {
             std::shared_ptr<AstypeOp> as_type_op = std::static_pointer_cast<AstypeOp>(op);
             OpPtr operand = as_type_op->get_operand();
@@ -117,11 +358,34 @@ namespace nx::runtime::metal {
         }
     }
 
+    void MTLRunner::run_scan_op(OpPtr op) {
+        ScanOpPtr scan_op = std::static_pointer_cast<ScanOp>(op);
+        alloc_buffer(op);
+        run_scan_kernel(scan_op->get_operand(), op);
+    }
+
+    void MTLRunner::run_sort_op(OpPtr op) {
+        SortingOpPtr sorting_op = std::static_pointer_cast<SortingOp>(op);
+        alloc_buffer(op);
+        run_sort_kernel(sorting_op->get_operand(), op);
+    }
+
     void MTLRunner::run_reduce_op(OpPtr op) {
         ReduceOpPtr reduce_op = std::static_pointer_cast<ReduceOp>(op);
         OpPtr operand = reduce_op->get_operand();
         alloc_buffer(op);
 
+        // Every output element is written without atomics
+        if (reduce_op->get_opcode() == Opcode::PRECISE_SUM) {
+            run_precise_sum_kernel(operand, op);
+            return;
+        }
+
+        if (reduce_op->get_opcode() == Opcode::VAR || reduce_op->get_opcode() == Opcode::STD || reduce_op->get_opcode() == Opcode::VECTOR_NORM) {
+            run_stat_reduce_kernel(operand, op);
+            return;
+        }
+
         // Fill up array with default value
         if (reduce_op->get_opcode() == Opcode::MAX) {
             run_full_kernel(op, reduce_op->get_data().get_dtype()->min());
@@ -8,6 +8,20 @@ namespace nx::runtime::metal {
     private:
         static constexpr isize s_simd_size = 32;
         static constexpr isize s_max_threadgroup_size = 256;
+        // Must match scan_nread in the scan kernels
+        static constexpr isize s_scan_nread = 4;
+        // Must match precise_sum_nread in the precise sum kernels
+        static constexpr isize s_precise_sum_nread = 16;
+        // Must match stat_reduce_nread in the variance and norm kernels
+        static constexpr isize s_stat_reduce_nread = 16;
+        // Must match sort_block_size in the sort kernels
+        static constexpr isize s_sort_block_size = 2048;
+        // Must match sdpa_block_size in the attention kernels
+        static constexpr isize s_sdpa_block_size = 32;
+        // Threadgroups loop over the input so each private histogram covers many elements before merging
+        static constexpr isize s_histogram_max_threadgroups = 64;
+        // Must match sparse_chunk_nnz in the sparse kernels
+        static constexpr isize s_sparse_chunk_nnz = 64;
 
         void run_full_kernel(OpPtr op, isize constant) override;
         void run_arange_kernel(OpPtr op, isize start, isize step) override;
@@ -19,6 +33,9 @@ namespace nx::runtime::metal {
         void run_gemm2d_kernel(MTLEncoder &encoder, OpPtr l_op, OpPtr r_op, OpPtr out_op);
         void run_gemm3d_kernel(MTLEncoder &encoder, OpPtr l_op, OpPtr r_op, OpPtr out_op);
         void run_gemm_kernel(OpPtr l_op, OpPtr r_op, OpPtr out_op) override;
+        void run_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op) override;
+        void run_contiguous_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op);
+        void run_strided_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op);
         void run_unary_kernel(OpPtr in_op, OpPtr out_op) override;
         void run_contiguous_unary_kernel(OpPtr in_op, OpPtr out_op);
         void run_strided_unary_kernel(OpPtr in_op, OpPtr out_op);
@@ -28,11 +45,64 @@ namespace nx::runtime::metal {
         void run_reduce_all_kernel(OpPtr in_op, OpPtr out_op) override;
         std::pair<isize, isize> select_reduce_col_kernel_size(isize nrow, isize ncol);
         void run_reduce_col_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_precise_sum_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_precise_sum_merge_kernel(BufferBlock *partials, isize nrow, isize npartial, OpPtr out_op);
+        void run_stat_reduce_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_stat_reduce_merge_kernel(const std::string &kernel_name, BufferBlock *partials, isize nrow, isize npartial, float correction, OpPtr out_op);
+        void run_scan_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_blocked_scan_kernel(const std::string &opname, OpPtr in_op, OpPtr out_op);
+        isize scan_block_size(isize ncol) const;
+        void run_scan_block_kernel(const std::string &opname, OpPtr in_op, OpPtr out_op, BufferBlock *block_totals, bool write_totals, bool carry_in);
+        void run_gather_kernel(OpPtr in_op, OpPtr index_op, OpPtr out_op) override;
+        void run_scatter_kernel(OpPtr in_op, OpPtr index_op, OpPtr out_op) override;
+        void run_sort_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_sort_block_kernel(OpPtr in_op, OpPtr in_index_op, OpPtr out_op, OpPtr out_index_op, isize block_size, isize nkeep, bool descending);
+        void run_sort_merge_kernel(OpPtr in_op, OpPtr in_index_op, OpPtr out_op, OpPtr out_index_op, isize run, bool descending);
+        void run_conv2d_kernel(OpPtr in_op, OpPtr weight_op, OpPtr out_op) override;
+        void run_im2col_kernel(OpPtr in_op, OpPtr out_op, const Conv2dParams &params) override;
+        void run_col2im_kernel(OpPtr in_op, OpPtr out_op, const Conv2dParams &params) override;
+        void run_pool2d_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_dropout_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_clamp_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_multinomial_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_fft_kernel(OpPtr in_op, OpPtr out_op) override;
+        void run_fft_chirp_kernel(BufferBlock *chirp, isize nfft, isize nwork, float sign);
+        void run_clamp_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr out_op) override;
+        void run_avgpool2d_grad_kernel(OpPtr grad_op, OpPtr out_op) override;
+        void run_maxpool2d_grad_kernel(OpPtr in_op, OpPtr grad_op, OpPtr out_op) override;
+        void run_norm_kernel(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr stats_op, OpPtr out_op) override;
+        void run_norm_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr out_op) override;
+        void run_norm_param_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, OpPtr out_op) override;
+        void run_batch_norm_kernel(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr running_mean_op, OpPtr running_var_op, OpPtr stats_op, OpPtr out_op) override;
+        void run_batch_norm_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr param_grad_op, OpPtr out_op) override;
+        void run_batch_norm_param_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, OpPtr out_op) override;
+        void run_sdpa_kernel(OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr stats_op, OpPtr out_op) override;
+        void run_sdpa_grad_kernel(OpPtr grad_op, OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr out_op, OpPtr stats_op, OpPtr dst_op) override;
+        void run_histogram_kernel(OpPtr in_op, OpPtr weight_op, OpPtr out_op) override;
+        void run_recurrent_cell_kernel(OpPtr gi_op, OpPtr gh_op, OpPtr state_op, OpPtr out_op) override;
+        void run_recurrent_cell_grad_kernel(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr state_op, OpPtr out_op, RecurrentGradTarget target) override;
+        void run_lstm_kernel(OpPtr gi_op, OpPtr weight_op, OpPtr h_op, OpPtr c_op, OpPtr out_op) override;
+        void run_gru_kernel(OpPtr gi_op, OpPtr weight_op, OpPtr bias_op, OpPtr h_op, OpPtr out_op) override;
+        void run_quantize_kernel(OpPtr in_op, OpPtr scale_op, OpPtr out_op) override;
+        void run_quantized_matmul_kernel(OpPtr in_op, OpPtr in_scale_op, OpPtr weight_op, OpPtr weight_scale_op, OpPtr bias_op, OpPtr out_op) override;
+        void run_spmm_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, OpPtr out_op) override;
+        void run_sparse_mul_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, OpPtr out_op) override;
+        void run_sparse_to_dense_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr out_op) override;
+        void run_cmp_bits_kernel(OpPtr l_op, OpPtr r_op, OpPtr out_op) override;
+        void run_where_bits_kernel(OpPtr mask_op, OpPtr l_op, OpPtr r_op, OpPtr out_op) override;
+        void run_count_bits_kernel(OpPtr mask_op, OpPtr out_op) override;
+        void run_block_sparse_matmul_kernel(OpPtr in_op, OpPtr block_ptr_op, OpPtr block_col_op, OpPtr block_value_op, OpPtr bias_op, OpPtr out_op) override;
         void run_initializer_op(OpPtr op) override;
         void run_unary_op(OpPtr op) override;
         void run_binary_op(OpPtr op) override;
+        void run_ternary_op(OpPtr op) override;
+        void run_nary_op(OpPtr op) override;
+        void run_concat_op(OpPtr op);
         void run_transform_op(OpPtr op) override;
+        void run_scan_op(OpPtr op) override;
+        void run_sort_op(OpPtr op) override;
         void run_reduce_op(OpPtr op) override;
+        void plan_concat_op(OpPtr op) override;
 
         template <class O>
         void run_simple_transform_op(OpPtr op) {
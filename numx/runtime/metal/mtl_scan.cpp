@@ -0,0 +1,96 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_scan_kernel(OpPtr in_op, OpPtr out_op) {
+        ScanOpPtr scan_op = std::static_pointer_cast<ScanOp>(out_op);
+        const isize dim = scan_op->get_dim();
+        const isize ndim = in_op->get_data().get_ndim();
+
+        // Move the scanned dimension to the end by permuting the views, no data is moved
+        ShapeDims permutation_dims;
+        permutation_dims.reserve(ndim);
+
+        for (isize i = 0; i < ndim; i++) {
+            if (i != dim) {
+                permutation_dims.push_back(i);
+            }
+        }
+
+        permutation_dims.push_back(dim);
+        // Detach input and output ops so the computational graph is not affected
+        OpPtr in_permutation_op = permute(detach(in_op), permutation_dims);
+        OpPtr out_permutation_op = permute(detach(out_op), permutation_dims);
+        share_buffer(in_permutation_op, in_op);
+        share_buffer(out_permutation_op, out_op);
+        run_blocked_scan_kernel(out_op->get_opname(), in_permutation_op, out_permutation_op);
+    }
+
+    void MTLRunner::run_blocked_scan_kernel(const std::string &opname, OpPtr in_op, OpPtr out_op) {
+        const ArrayData &in_data = in_op->get_data();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize nblock = (ncol + scan_block_size(ncol) - 1) / scan_block_size(ncol);
+
+        if (nblock == 1) {
+            run_scan_block_kernel(opname, in_op, out_op, nullptr, false, false);
+            return;
+        }
+
+        // 16-bit floats keep their block totals in f32 so the carries are not rounded before they reach the elements
+        DtypePtr accum_dtype = accum_dtype_by_dtype(out_op->get_data().get_dtype());
+        MemoryPtr memory = m_ctx->get_memory();
+        BufferBlock *block_totals = memory->alloc_block(nrow * nblock * accum_dtype->get_size());
+        OpPtr block_totals_op = from_buffer(block_totals->get_ptr(), block_totals->get_size(), Shape({nrow, nblock}), accum_dtype, in_data.get_device());
+        // Write the block totals, scan them in place, then scan the blocks again starting from the totals of the preceding blocks
+        run_scan_block_kernel(opname, in_op, out_op, block_totals, true, false);
+        run_blocked_scan_kernel(opname, block_totals_op, block_totals_op);
+        run_scan_block_kernel(opname, in_op, out_op, block_totals, false, true);
+        memory->free_block(block_totals);
+    }
+
+    isize MTLRunner::scan_block_size(isize ncol) const {
+        // Each thread scans s_scan_nread consecutive elements and each threadgroup scans one block of a row
+        return std::min(align_to((ncol + s_scan_nread - 1) / s_scan_nread, s_simd_size), s_max_threadgroup_size) * s_scan_nread;
+    }
+
+    void MTLRunner::run_scan_block_kernel(const std::string &opname, OpPtr in_op, OpPtr out_op, BufferBlock *block_totals, bool write_totals, bool carry_in) {
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize block_size = scan_block_size(ncol);
+        const isize threadgroup_nthread = block_size / s_scan_nread;
+        const isize nblock = (ncol + block_size - 1) / block_size;
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const isize offset[] = {in_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!in_data.is_contiguous(), !out_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 2);
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_stride(out_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 2);
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(out_data);
+
+        if (block_totals) {
+            encoder.encode_mtl_buffer(block_totals->get_ptr(), block_totals->get_size());
+        } else {
+            // Block totals are not accessed when there is a single block per row
+            encoder.encode_array_buffer(out_data);
+        }
+
+        encoder.encode_mtl_buffer(&write_totals, sizeof(bool));
+        encoder.encode_mtl_buffer(&carry_in, sizeof(bool));
+        encoder.set_pipeline_state(std::format("{}_{}", opname, out_data.get_dtype()->str()));
+        auto grid_size = MTL::Size::Make(nblock * threadgroup_nthread, nrow, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,165 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_sort_kernel(OpPtr in_op, OpPtr out_op) {
+        SortingOpPtr sorting_op = std::static_pointer_cast<SortingOp>(out_op);
+        const isize dim = sorting_op->get_dim();
+        const isize k = sorting_op->get_k();
+        const bool descending = sorting_op->is_descending();
+        const bool index_output = sorting_op->get_opcode() == Opcode::ARGSORT || sorting_op->get_opcode() == Opcode::ARGTOPK;
+        const isize ndim = in_op->get_data().get_ndim();
+
+        // Move the sorted dimension to the end by permuting the views, no data is moved
+        ShapeDims permutation_dims;
+        permutation_dims.reserve(ndim);
+
+        for (isize i = 0; i < ndim; i++) {
+            if (i != dim) {
+                permutation_dims.push_back(i);
+            }
+        }
+
+        permutation_dims.push_back(dim);
+        // Detach input and output ops so the computational graph is not affected
+        OpPtr in_permutation_op = permute(detach(in_op), permutation_dims);
+        OpPtr out_permutation_op = permute(detach(out_op), permutation_dims);
+        share_buffer(in_permutation_op, in_op);
+        share_buffer(out_permutation_op, out_op);
+
+        const ArrayData &in_data = in_permutation_op->get_data();
+        DtypePtr dtype = in_data.get_dtype();
+        DevicePtr device = in_data.get_device();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        MemoryPtr memory = m_ctx->get_memory();
+
+        // Sorted values and indices are kept in contiguous scratch rows of length len
+        OpPtr src_op = in_permutation_op;
+        OpPtr src_index_op = nullptr;
+        BufferBlock *src_blocks[] = {nullptr, nullptr};
+        isize len = ncol;
+        isize block_size;
+
+        auto alloc_scratch = [&](BufferBlock **blocks, OpPtr &scratch_op, OpPtr &scratch_index_op) {
+            blocks[0] = memory->alloc_block(nrow * len * dtype->get_size());
+            blocks[1] = memory->alloc_block(nrow * len * i32.get_size());
+            scratch_op = from_buffer(blocks[0]->get_ptr(), blocks[0]->get_size(), Shape({nrow, len}), dtype, device);
+            scratch_index_op = from_buffer(blocks[1]->get_ptr(), blocks[1]->get_size(), Shape({nrow, len}), &i32, device);
+        };
+
+        auto free_scratch = [&](BufferBlock **blocks) {
+            if (blocks[0]) {
+                memory->free_block(blocks[0]);
+                memory->free_block(blocks[1]);
+            }
+        };
+
+        // Selecting at most half a block only keeps the first k elements of every block,
+        // rows shrink with each pass until a single block remains
+        const bool partial = k <= s_sort_block_size / 2;
+
+        while (true) {
+            block_size = std::min(static_cast<isize>(std::bit_ceil(static_cast<uint64_t>(len))), s_sort_block_size);
+            const isize nblock = (len + block_size - 1) / block_size;
+            const isize nkeep = partial ? std::min(k, block_size) : block_size;
+            len = nblock * nkeep;
+            BufferBlock *dst_blocks[2];
+            OpPtr dst_op, dst_index_op;
+            alloc_scratch(dst_blocks, dst_op, dst_index_op);
+            run_sort_block_kernel(src_op, src_index_op, dst_op, dst_index_op, block_size, nkeep, descending);
+            free_scratch(src_blocks);
+            src_op = dst_op;
+            src_index_op = dst_index_op;
+            std::copy(dst_blocks, dst_blocks + 2, src_blocks);
+
+            if (!partial || nblock == 1) {
+                break;
+            }
+        }
+
+        // Merge sorted runs pairwise until whole rows are sorted
+        for (isize run = block_size; run < len; run *= 2) {
+            BufferBlock *dst_blocks[2];
+            OpPtr dst_op, dst_index_op;
+            alloc_scratch(dst_blocks, dst_op, dst_index_op);
+            run_sort_merge_kernel(src_op, src_index_op, dst_op, dst_index_op, run, descending);
+            free_scratch(src_blocks);
+            src_op = dst_op;
+            src_index_op = dst_index_op;
+            std::copy(dst_blocks, dst_blocks + 2, src_blocks);
+        }
+
+        // Copy the first k elements of every row to the output
+        BufferBlock *result_block = index_output ? src_blocks[1] : src_blocks[0];
+        ShapeView result_view = out_permutation_op->get_data().get_view();
+        result_view.back() = len;
+        OpPtr result_op = from_buffer(result_block->get_ptr(), result_block->get_size(), Shape(result_view), index_output ? &i32 : dtype, device);
+        RangeVector ranges;
+
+        for (isize i = 0; i < ndim; i++) {
+            ranges.emplace_back(0, i == ndim - 1 ? k : result_view[i], 1);
+        }
+
+        OpPtr result_slice_op = slice(result_op, ranges);
+        share_buffer(result_slice_op, result_op);
+        run_copy_kernel(result_slice_op, out_permutation_op);
+        free_scratch(src_blocks);
+    }
+
+    void MTLRunner::run_sort_block_kernel(OpPtr in_op, OpPtr in_index_op, OpPtr out_op, OpPtr out_index_op, isize block_size, isize nkeep, bool descending) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = in_data.get_ndim();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        const isize nblock = (ncol + block_size - 1) / block_size;
+        const isize offset = in_data.get_offset();
+        const bool strided = !in_data.is_contiguous();
+        // Without input indices, the kernel uses the column positions
+        const bool has_index = in_index_op != nullptr;
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(&offset, sizeof(isize));
+        encoder.encode_view(in_data);
+        encoder.encode_stride(in_data);
+        encoder.encode_mtl_buffer(&strided, sizeof(bool));
+        encoder.encode_mtl_buffer(&has_index, sizeof(bool));
+        encoder.encode_mtl_buffer(&descending, sizeof(bool));
+        encoder.encode_mtl_buffer(&block_size, sizeof(isize));
+        encoder.encode_mtl_buffer(&nkeep, sizeof(isize));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(has_index ? in_index_op->get_data() : out_index_op->get_data());
+        encoder.encode_array_buffer(out_data);
+        encoder.encode_array_buffer(out_index_op->get_data());
+        encoder.set_pipeline_state(std::format("sort_block_{}", in_data.get_dtype()->str()));
+        const isize threadgroup_nthread = std::min(std::max(block_size / 2, static_cast<isize>(1)), s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(nblock * threadgroup_nthread, nrow, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_nthread, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_sort_merge_kernel(OpPtr in_op, OpPtr in_index_op, OpPtr out_op, OpPtr out_index_op, isize run, bool descending) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &in_data = in_op->get_data();
+        const isize ncol = in_data.get_view().back();
+        const isize nrow = in_data.get_numel() / ncol;
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(&run, sizeof(isize));
+        encoder.encode_mtl_buffer(&descending, sizeof(bool));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(in_index_op->get_data());
+        encoder.encode_array_buffer(out_op->get_data());
+        encoder.encode_array_buffer(out_index_op->get_data());
+        encoder.set_pipeline_state(std::format("sort_merge_{}", in_data.get_dtype()->str()));
+        auto grid_size = MTL::Size::Make(ncol, nrow, 1);
+        auto threadgroup_size = MTL::Size::Make(std::min(ncol, s_max_threadgroup_size), 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,159 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_spmm_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, OpPtr out_op) {
+        SpmmOpPtr spmm_op = std::static_pointer_cast<SpmmOp>(out_op);
+        const isize nnz = spmm_op->get_nnz();
+        const ArrayData &dense_data = dense_op->get_data();
+        const isize N = dense_data.get_view()[1];
+
+        // The output is already zero-filled and the threadgroup width would be zero without dense columns
+        if (nnz == 0 || N == 0) {
+            return;
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &row_data = row_op->get_data();
+        const ArrayData &col_data = col_op->get_data();
+        const ArrayData &value_data = value_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nrow = spmm_op->get_num_rows();
+        const isize offset[] = {row_data.get_offset(), col_data.get_offset(), value_data.get_offset(), dense_data.get_offset(), out_data.get_offset()};
+        const bool csr = spmm_op->get_format() == SparseFormat::CSR;
+        const bool transposed = spmm_op->is_transposed();
+        encoder.encode_mtl_buffer(&nrow, sizeof(isize));
+        encoder.encode_mtl_buffer(&nnz, sizeof(isize));
+        encoder.encode_mtl_buffer(&N, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_mtl_buffer(&csr, sizeof(bool));
+        encoder.encode_mtl_buffer(&transposed, sizeof(bool));
+        encoder.encode_array_buffer(row_data);
+        encoder.encode_array_buffer(col_data);
+        encoder.encode_array_buffer(value_data);
+        encoder.encode_array_buffer(dense_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state("spmm");
+        // Threads along x read consecutive dense columns, threads along y own equally sized chunks of nonzeros
+        const isize nchunk = (nnz + s_sparse_chunk_nnz - 1) / s_sparse_chunk_nnz;
+        const isize threadgroup_width = std::min(N, s_max_threadgroup_size);
+        auto grid_size = MTL::Size::Make(N, nchunk, 1);
+        auto threadgroup_size = MTL::Size::Make(threadgroup_width, s_max_threadgroup_size / threadgroup_width, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_sparse_mul_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, OpPtr out_op) {
+        SparseOpPtr sparse_op = std::static_pointer_cast<SparseOp>(out_op);
+        const isize nnz = sparse_op->get_nnz();
+
+        if (nnz == 0) {
+            return;
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &row_data = row_op->get_data();
+        const ArrayData &col_data = col_op->get_data();
+        const ArrayData &value_data = value_op->get_data();
+        const ArrayData &dense_data = dense_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nrow = sparse_op->get_num_rows();
+        const isize ncol = sparse_op->get_num_cols();
+        const isize offset[] = {row_data.get_offset(), col_data.get_offset(), value_data.get_offset(), dense_data.get_offset(), out_data.get_offset()};
+        const bool csr = sparse_op->get_format() == SparseFormat::CSR;
+        encoder.encode_mtl_buffer(&nrow, sizeof(isize));
+        encoder.encode_mtl_buffer(&nnz, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 5);
+        encoder.encode_mtl_buffer(&csr, sizeof(bool));
+        encoder.encode_array_buffer(row_data);
+        encoder.encode_array_buffer(col_data);
+        encoder.encode_array_buffer(value_data);
+        encoder.encode_array_buffer(dense_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state("sparse_mul");
+        auto grid_size = MTL::Size::Make(nnz, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(std::min(nnz, s_max_threadgroup_size), 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_sparse_to_dense_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr out_op) {
+        SparseOpPtr sparse_op = std::static_pointer_cast<SparseOp>(out_op);
+        const isize nnz = sparse_op->get_nnz();
+
+        if (nnz == 0) {
+            return;
+        }
+
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &row_data = row_op->get_data();
+        const ArrayData &col_data = col_op->get_data();
+        const ArrayData &value_data = value_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize nrow = sparse_op->get_num_rows();
+        const isize ncol = sparse_op->get_num_cols();
+        const isize offset[] = {row_data.get_offset(), col_data.get_offset(), value_data.get_offset(), out_data.get_offset()};
+        const bool csr = sparse_op->get_format() == SparseFormat::CSR;
+        encoder.encode_mtl_buffer(&nrow, sizeof(isize));
+        encoder.encode_mtl_buffer(&nnz, sizeof(isize));
+        encoder.encode_mtl_buffer(&ncol, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_mtl_buffer(&csr, sizeof(bool));
+        encoder.encode_array_buffer(row_data);
+        encoder.encode_array_buffer(col_data);
+        encoder.encode_array_buffer(value_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state("sparse_to_dense");
+        auto grid_size = MTL::Size::Make(nnz, 1, 1);
+        auto threadgroup_size = MTL::Size::Make(std::min(nnz, s_max_threadgroup_size), 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_block_sparse_matmul_kernel(OpPtr in_op, OpPtr block_ptr_op, OpPtr block_col_op, OpPtr block_value_op, OpPtr bias_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        BlockSparseMatmulOpPtr matmul_op = std::static_pointer_cast<BlockSparseMatmulOp>(out_op);
+        const ArrayData &in_data = in_op->get_data();
+        const ArrayData &block_ptr_data = block_ptr_op->get_data();
+        const ArrayData &block_col_data = block_col_op->get_data();
+        const ArrayData &block_value_data = block_value_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        // Without bias, the output is bound in place of the bias and never read
+        const ArrayData &bias_data = bias_op ? bias_op->get_data() : out_data;
+        const isize K = in_data.get_view().back();
+        const isize M = in_data.get_numel() / K;
+        const isize N = out_data.get_view().back();
+        const isize block_rows = matmul_op->get_block_rows();
+        const isize block_cols = matmul_op->get_block_cols();
+        const isize offset[] = {in_data.get_offset(), block_ptr_data.get_offset(), block_col_data.get_offset(), block_value_data.get_offset(), bias_data.get_offset(), out_data.get_offset()};
+        const bool has_bias = bias_op != nullptr;
+        encoder.encode_mtl_buffer(&M, sizeof(isize));
+        encoder.encode_mtl_buffer(&K, sizeof(isize));
+        encoder.encode_mtl_buffer(&N, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 6);
+        encoder.encode_mtl_buffer(&has_bias, sizeof(bool));
+        encoder.encode_mtl_buffer(&block_rows, sizeof(isize));
+        encoder.encode_mtl_buffer(&block_cols, sizeof(isize));
+        encoder.encode_array_buffer(in_data);
+        encoder.encode_array_buffer(block_ptr_data);
+        encoder.encode_array_buffer(block_col_data);
+        encoder.encode_array_buffer(block_value_data);
+        encoder.encode_array_buffer(bias_data);
+        encoder.encode_array_buffer(out_data);
+        encoder.set_pipeline_state(std::format("block_sparse_matmul_{}", out_data.get_dtype()->str()));
+        // Every thread computes a 4x4 output tile that never straddles two block rows
+        const isize nblock_row = N / block_rows;
+        auto grid_size = MTL::Size::Make(nblock_row * ((block_rows + 3) / 4), (M + 3) / 4, 1);
+        auto threadgroup_size = MTL::Size::Make(s_max_threadgroup_size, 1, 1);
+        encoder.dispatch_threads(grid_size, threadgroup_size);
+        encoder.wait_to_complete();
+        pool->release();
+    }
+} // namespace nx::runtime::metal
@@ -0,0 +1,62 @@
+#include "mtl_runner.h"
+
+namespace nx::runtime::metal {
+    void MTLRunner::run_contiguous_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &first_data = first_op->get_data();
+        const ArrayData &second_data = second_op->get_data();
+        const ArrayData &third_data = third_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize offset[] = {first_data.get_offset(), second_data.get_offset(), third_data.get_offset(), out_data.get_offset()};
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_array_buffer(first_data);
+        encoder.encode_array_buffer(second_data);
+        encoder.encode_array_buffer(third_data);
+        encoder.encode_array_buffer(out_data);
+        const std::string kernel_name = std::format("{}_{}", out_op->get_opname(), out_data.get_dtype()->str());
+        encoder.set_pipeline_state(kernel_name);
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_strided_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op) {
+        NS::AutoreleasePool *pool = NS::AutoreleasePool::alloc()->init();
+        MTLEncoder encoder(m_ctx);
+        const ArrayData &first_data = first_op->get_data();
+        const ArrayData &second_data = second_op->get_data();
+        const ArrayData &third_data = third_op->get_data();
+        const ArrayData &out_data = out_op->get_data();
+        const isize ndim = out_data.get_ndim();
+        const isize offset[] = {first_data.get_offset(), second_data.get_offset(), third_data.get_offset(), out_data.get_offset()};
+        const bool strided[] = {!first_data.is_contiguous(), !second_data.is_contiguous(), !third_data.is_contiguous(), !out_data.is_contiguous()};
+        encoder.encode_mtl_buffer(&ndim, sizeof(isize));
+        encoder.encode_mtl_buffer(offset, sizeof(isize) * 4);
+        encoder.encode_view(out_data);
+        encoder.encode_stride(first_data);
+        encoder.encode_stride(second_data);
+        encoder.encode_stride(third_data);
+        encoder.encode_stride(out_data);
+        encoder.encode_mtl_buffer(strided, sizeof(bool) * 4);
+        encoder.encode_array_buffer(first_data);
+        encoder.encode_array_buffer(second_data);
+        encoder.encode_array_buffer(third_data);
+        encoder.encode_array_buffer(out_data);
+        const std::string kernel_name = std::format("strided_{}_{}", out_op->get_opname(), out_data.get_dtype()->str());
+        encoder.set_pipeline_state(kernel_name);
+        const isize numel = out_data.get_numel();
+        encoder.dispatch_threads(numel, std::min(numel, s_max_threadgroup_size));
+        encoder.wait_to_complete();
+        pool->release();
+    }
+
+    void MTLRunner::run_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op) {
+        if (first_op->get_data().is_contiguous() && second_op->get_data().is_contiguous() && third_op->get_data().is_contiguous() && out_op->get_data().is_contiguous()) {
+            run_contiguous_ternary_kernel(first_op, second_op, third_op, out_op);
+        } else {
+            run_strided_ternary_kernel(first_op, second_op, third_op, out_op);
+        }
+    }
+} // namespace nx::runtime::metal
@@ -15,10 +15,26 @@ namespace nx::runtime {
             run_binary_op(op);
             break;
         }
+        case Optype::TERNARY: {
+            run_ternary_op(op);
+            break;
+        }
+        case Optype::NARY: {
+            run_nary_op(op);
+            break;
+        }
         case Optype::TRANSFORM: {
             run_transform_op(op);
             break;
         }
+        case Optype::SCAN: {
+            run_scan_op(op);
+            break;
+        }
+        case Optype::SORT: {
+            run_sort_op(op);
+            break;
+        }
         default: {
             run_reduce_op(op);
             break;
@@ -26,15 +42,29 @@ namespace nx::runtime {
         }
     }
 
-    void Runner::forward() {
-        for (auto iter = m_graph->fw_begin(); iter != m_graph->fw_end(); ++iter) {
-            run_op(*iter);
+    void Runner::plan_op(OpPtr op) {
+        if (op->get_opcode() == Opcode::CONCAT) {
+            plan_concat_op(op);
         }
     }
 
-    void Runner::backward() {
-        for (auto iter = m_graph->bw_begin(); iter != m_graph->bw_end(); ++iter) {
+    bool Runner::can_write_into_slice(const OpPtr &operand) const {
+        // The operand can be placed inside its consumer's buffer only if it has not been computed yet,
+        // its kernel writes through the output strides, and the consumer is its only one in the graph
+        return !operand->get_data().is_buffer_valid() && operand->supports_strided_output() && m_graph->count_consumers(operand) == 1;
+    }
+
+    void Runner::run_tape(std::vector<OpPtr>::const_iterator begin, std::vector<OpPtr>::const_iterator end) {
+        // Plan in reverse so consumers decide where their operands live before the operands are planned
+        for (auto iter = std::make_reverse_iterator(end); iter != std::make_reverse_iterator(begin); ++iter) {
+            plan_op(*iter);
+        }
+
+        for (auto iter = begin; iter != end; ++iter) {
             run_op(*iter);
         }
     }
+
+    void Runner::forward() { run_tape(m_graph->fw_begin(), m_graph->fw_end()); }
+    void Runner::backward() { run_tape(m_graph->bw_begin(), m_graph->bw_end()); }
 } // namespace nx::runtime
\ No newline at end of file
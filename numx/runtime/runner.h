@@ -13,16 +13,64 @@ namespace nx::runtime {
         virtual void run_uniform_kernel(OpPtr op, isize key, isize low, isize high) = 0;
         virtual void run_binary_kernel(OpPtr l_op, OpPtr r_op, OpPtr out_op) = 0;
         virtual void run_gemm_kernel(OpPtr l_op, OpPtr r_op, OpPtr out_op) = 0;
+        virtual void run_ternary_kernel(OpPtr first_op, OpPtr second_op, OpPtr third_op, OpPtr out_op) = 0;
         virtual void run_unary_kernel(OpPtr in_op, OpPtr out_op) = 0;
         virtual void run_copy_kernel(OpPtr in_op, OpPtr out_op) = 0;
         virtual void run_reduce_all_kernel(OpPtr in_op, OpPtr out_op) = 0;
         virtual void run_reduce_col_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_precise_sum_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_stat_reduce_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_scan_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_gather_kernel(OpPtr in_op, OpPtr index_op, OpPtr out_op) = 0;
+        virtual void run_scatter_kernel(OpPtr in_op, OpPtr index_op, OpPtr out_op) = 0;
+        virtual void run_sort_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_conv2d_kernel(OpPtr in_op, OpPtr weight_op, OpPtr out_op) = 0;
+        virtual void run_im2col_kernel(OpPtr in_op, OpPtr out_op, const Conv2dParams &params) = 0;
+        virtual void run_col2im_kernel(OpPtr in_op, OpPtr out_op, const Conv2dParams &params) = 0;
+        virtual void run_pool2d_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_dropout_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_clamp_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_multinomial_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_fft_kernel(OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_clamp_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr out_op) = 0;
+        virtual void run_avgpool2d_grad_kernel(OpPtr grad_op, OpPtr out_op) = 0;
+        virtual void run_maxpool2d_grad_kernel(OpPtr in_op, OpPtr grad_op, OpPtr out_op) = 0;
+        virtual void run_norm_kernel(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr stats_op, OpPtr out_op) = 0;
+        virtual void run_norm_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr out_op) = 0;
+        virtual void run_norm_param_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, OpPtr out_op) = 0;
+        virtual void run_batch_norm_kernel(OpPtr in_op, OpPtr weight_op, OpPtr bias_op, OpPtr running_mean_op, OpPtr running_var_op, OpPtr stats_op, OpPtr out_op) = 0;
+        virtual void run_batch_norm_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr weight_op, OpPtr stats_op, OpPtr param_grad_op, OpPtr out_op) = 0;
+        virtual void run_batch_norm_param_grad_kernel(OpPtr grad_op, OpPtr in_op, OpPtr stats_op, OpPtr out_op) = 0;
+        virtual void run_sdpa_kernel(OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr stats_op, OpPtr out_op) = 0;
+        virtual void run_sdpa_grad_kernel(OpPtr grad_op, OpPtr q_op, OpPtr k_op, OpPtr v_op, OpPtr out_op, OpPtr stats_op, OpPtr dst_op) = 0;
+        virtual void run_histogram_kernel(OpPtr in_op, OpPtr weight_op, OpPtr out_op) = 0;
+        virtual void run_recurrent_cell_kernel(OpPtr gi_op, OpPtr gh_op, OpPtr state_op, OpPtr out_op) = 0;
+        virtual void run_recurrent_cell_grad_kernel(OpPtr grad_op, OpPtr gi_op, OpPtr gh_op, OpPtr state_op, OpPtr out_op, RecurrentGradTarget target) = 0;
+        virtual void run_lstm_kernel(OpPtr gi_op, OpPtr weight_op, OpPtr h_op, OpPtr c_op, OpPtr out_op) = 0;
+        virtual void run_gru_kernel(OpPtr gi_op, OpPtr weight_op, OpPtr bias_op, OpPtr h_op, OpPtr out_op) = 0;
+        virtual void run_quantize_kernel(OpPtr in_op, OpPtr scale_op, OpPtr out_op) = 0;
+        virtual void run_quantized_matmul_kernel(OpPtr in_op, OpPtr in_scale_op, OpPtr weight_op, OpPtr weight_scale_op, OpPtr bias_op, OpPtr out_op) = 0;
+        virtual void run_spmm_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, OpPtr out_op) = 0;
+        virtual void run_sparse_mul_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr dense_op, OpPtr out_op) = 0;
+        virtual void run_sparse_to_dense_kernel(OpPtr row_op, OpPtr col_op, OpPtr value_op, OpPtr out_op) = 0;
+        virtual void run_cmp_bits_kernel(OpPtr l_op, OpPtr r_op, OpPtr out_op) = 0;
+        virtual void run_where_bits_kernel(OpPtr mask_op, OpPtr l_op, OpPtr r_op, OpPtr out_op) = 0;
+        virtual void run_count_bits_kernel(OpPtr mask_op, OpPtr out_op) = 0;
+        virtual void run_block_sparse_matmul_kernel(OpPtr in_op, OpPtr block_ptr_op, OpPtr block_col_op, OpPtr block_value_op, OpPtr bias_op, OpPtr out_op) = 0;
         virtual void run_initializer_op(OpPtr op) = 0;
         virtual void run_unary_op(OpPtr op) = 0;
         virtual void run_binary_op(OpPtr op) = 0;
+        virtual void run_ternary_op(OpPtr op) = 0;
+        virtual void run_nary_op(OpPtr op) = 0;
         virtual void run_transform_op(OpPtr op) = 0;
+        virtual void run_scan_op(OpPtr op) = 0;
+        virtual void run_sort_op(OpPtr op) = 0;
         virtual void run_reduce_op(OpPtr op) = 0;
+        virtual void plan_concat_op(OpPtr op) = 0;
         void run_op(OpPtr op);
+        void plan_op(OpPtr op);
+        bool can_write_into_slice(const OpPtr &operand) const;
+        void run_tape(std::vector<OpPtr>::const_iterator begin, std::vector<OpPtr>::const_iterator end);
 
     public:
         Runner(GraphPtr graph, RuntimeContextPtr ctx) : m_graph(graph), m_ctx(ctx) {}
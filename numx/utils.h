@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <bitset>
 #include <chrono>
@@ -16,6 +17,7 @@
 #include <memory>
 #include <numbers>
 #include <numeric>
+#include <optional>
 #include <print>
 #include <ranges>
 #include <set>
@@ -42,16 +42,31 @@ class Dtype:
 class F32(Dtype):
     """32-bit floating point dtype"""
 
+class F16(Dtype):
+    """16-bit floating point dtype"""
+
+class BF16(Dtype):
+    """16-bit brain floating point dtype"""
+
 class I32(Dtype):
     """32-bit integer dtype"""
 
+class I8(Dtype):
+    """8-bit integer storage dtype"""
+
 class Bool(Dtype):
     """Boolean dtype"""
 
 f32: F32 = ...
 
+f16: F16 = ...
+
+bf16: BF16 = ...
+
 i32: I32 = ...
 
+i8: I8 = ...
+
 b8: Bool = ...
 
 class Shape:
@@ -83,6 +98,13 @@ class DeviceType(enum.Enum):
 
     MPS = 1
 
+class NormOrd(enum.Enum):
+    L1 = 0
+
+    L2 = 1
+
+    LINF = 2
+
 class Device:
     @property
     def type(self) -> DeviceType:
@@ -252,6 +274,27 @@ class Array:
     def recip(self, in_place: bool = False) -> Array:
         """Compute reciprocal of array elements"""
 
+    def abs(self, in_place: bool = False) -> Array:
+        """Compute absolute value of array elements"""
+
+    def __abs__(self) -> Array:
+        """Compute absolute value of array elements"""
+
+    def sign(self, in_place: bool = False) -> Array:
+        """Compute sign of array elements"""
+
+    def clamp(self, min: float | None = None, max: float | None = None) -> Array:
+        """Clamp array elements into the range [min, max]"""
+
+    def pow(self, rhs: object) -> Array:
+        """Raise array elements to the given power element-wise"""
+
+    def __pow__(self, rhs: object) -> Array:
+        """Raise array elements to the given power element-wise"""
+
+    def fmod(self, rhs: object) -> Array:
+        """Element-wise remainder with the sign of the dividend"""
+
     def __eq__(self, rhs: object) -> Array:
         """Element-wise equality comparison"""
 
@@ -276,11 +319,20 @@ class Array:
     def maximum(self, rhs: object) -> Array:
         """Element-wise maximum comparison"""
 
-    def sum(self, dims: Sequence[int] = []) -> Array:
-        """Sum array elements along specified dimensions"""
+    def sum(self, dims: Sequence[int] = [], precise: bool = False) -> Array:
+        """Sum array elements along specified dimensions, precise sums compensate the f32 accumulator"""
 
-    def mean(self, dims: Sequence[int] = []) -> Array:
-        """Mean value along specified dimensions"""
+    def mean(self, dims: Sequence[int] = [], precise: bool = False) -> Array:
+        """Mean value along specified dimensions, precise means compensate the f32 accumulator"""
+
+    def var(self, dims: Sequence[int] = [], correction: float = 1.0) -> Array:
+        """Variance along specified dimensions in a single pass, divided by the number of elements minus the correction"""
+
+    def std(self, dims: Sequence[int] = [], correction: float = 1.0) -> Array:
+        """Standard deviation along specified dimensions in a single pass, divided by the number of elements minus the correction"""
+
+    def norm(self, dims: Sequence[int] = [], ord: NormOrd = NormOrd.L2) -> Array:
+        """Vector norm along specified dimensions"""
 
     def max(self, dims: Sequence[int] = []) -> Array:
         """Maximum value along specified dimensions"""
@@ -294,6 +346,24 @@ class Array:
     def argmin(self, dims: Sequence[int] = []) -> Array:
         """Indices of minimum values along specified dimensions"""
 
+    def cumsum(self, dim: int) -> Array:
+        """Cumulative sum along specified dimension"""
+
+    def cumprod(self, dim: int) -> Array:
+        """Cumulative product along specified dimension"""
+
+    def cummax(self, dim: int) -> Array:
+        """Cumulative maximum along specified dimension"""
+
+    def sort(self, dim: int = -1, descending: bool = False) -> Array:
+        """Sort array elements along specified dimension"""
+
+    def argsort(self, dim: int = -1, descending: bool = False) -> Array:
+        """Indices that sort array elements along specified dimension"""
+
+    def topk(self, k: int, dim: int = -1, largest: bool = True) -> tuple[Array, Array]:
+        """Values and indices of the k largest or smallest elements along specified dimension"""
+
     def broadcast(self, view: Sequence[int]) -> Array:
         """Broadcast array to new shape"""
 
@@ -358,3 +428,153 @@ def ones_like(array: Array, dtype: Dtype = ..., device: str = 'mps:0') -> Array:
 
 def from_numpy(array: ArrayLike) -> Array:
     """Convert numpy array to array"""
+
+def where(cond: Array, x: object, y: object) -> Array:
+    """Select elements from x where cond is true and from y otherwise"""
+
+def concat(arrays: Sequence[Array], dim: int = 0) -> Array:
+    """Concatenate arrays along an existing dimension"""
+
+def stack(arrays: Sequence[Array], dim: int = 0) -> Array:
+    """Stack arrays along a new dimension"""
+
+def split(array: Array, sections: int | Sequence[int], dim: int = 0) -> list[Array]:
+    """Split array into views of the given section size or sizes"""
+
+def einsum(spec: str, *operands: Array) -> Array:
+    """Einstein summation contracted pairwise along a cost-optimized path with batched matmuls"""
+
+def einsum_path(spec: str, shapes: Sequence[Sequence[int]]) -> list[tuple[int, int]]:
+    """Pairwise contraction path of an einsum, every step appends its result after the operands"""
+
+def rfft(x: Array, n: int | None = None) -> Array:
+    """Real FFT of the last dimension cropped or zero padded to n, real and imaginary parts in a trailing dimension of 2"""
+
+def irfft(x: Array, n: int | None = None) -> Array:
+    """Inverse real FFT to a signal of size n, 2 * (bins - 1) by default"""
+
+def bincount(x: Array, num_bins: int, weight: Array | None = None) -> Array:
+    """Count occurrences of integer values in [0, num_bins), optionally weighted"""
+
+def histogram(x: Array, num_bins: int, min: float, max: float, weight: Array | None = None) -> Array:
+    """Count values into equal-width bins over [min, max], optionally weighted"""
+
+class autocast:
+    def __init__(self, dtype: Dtype = ...) -> None:
+        """Run matmuls, convolutions and arithmetic in low precision within the context"""
+
+    def __enter__(self) -> None:
+        """Enable autocast"""
+
+    def __exit__(self, *args) -> None:
+        """Restore the previous autocast dtype"""
+
+class SparseFormat(enum.Enum):
+    CSR = 0
+
+    COO = 1
+
+class SparseArray:
+    @property
+    def format(self) -> SparseFormat:
+        """Get sparse array's format"""
+
+    @property
+    def shape(self) -> list[int]:
+        """Get sparse array's shape"""
+
+    @property
+    def nnz(self) -> int:
+        """Get number of nonzeros"""
+
+    @property
+    def density(self) -> float:
+        """Get fraction of nonzeros"""
+
+    @property
+    def rows(self) -> Array:
+        """Get row offsets for CSR or row indices for COO"""
+
+    @property
+    def cols(self) -> Array:
+        """Get column indices"""
+
+    @property
+    def values(self) -> Array:
+        """Get nonzero values"""
+
+    def matmul(self, dense: Array, transposed: bool = False) -> Array:
+        """Multiply sparse array or its transpose with a dense 2D array"""
+
+    def __matmul__(self, dense: Array) -> Array:
+        """Multiply sparse array with a dense 2D array"""
+
+    def mul(self, dense: Array) -> SparseArray:
+        """Multiply nonzeros with the dense array elements at the same positions"""
+
+    def __mul__(self, dense: Array) -> SparseArray:
+        """Multiply nonzeros with the dense array elements at the same positions"""
+
+    def to_dense(self) -> Array:
+        """Convert sparse array to a dense array"""
+
+    def scipy(self) -> object:
+        """Convert sparse array to a scipy sparse matrix sharing its memory"""
+
+def sparse_csr(indptr: Array, indices: Array, values: Array, shape: Sequence[int]) -> SparseArray:
+    """Create a CSR sparse array from i32 row offsets and column indices and f32 values"""
+
+def sparse_coo(rows: Array, cols: Array, values: Array, shape: Sequence[int]) -> SparseArray:
+    """Create a COO sparse array from i32 row and column indices and f32 values"""
+
+def from_scipy(matrix: object) -> SparseArray:
+    """Convert a scipy CSR or COO matrix with int32 indices and float32 data to a sparse array sharing its memory"""
+
+class BitMask:
+    @property
+    def shape(self) -> list[int]:
+        """Get mask's shape"""
+
+    @property
+    def words(self) -> Array:
+        """Get i32 words holding 32 elements each along the last dimension"""
+
+    @property
+    def nbytes(self) -> int:
+        """Get number of bytes of the packed words"""
+
+    def count(self) -> Array:
+        """Count set elements"""
+
+    def count_rows(self) -> Array:
+        """Count set elements of every row along the last dimension"""
+
+    def where(self, lhs: Array, rhs: Array) -> Array:
+        """Select lhs where the mask is set and rhs elsewhere"""
+
+    def masked_fill(self, x: Array, value: float) -> Array:
+        """Replace elements of x where the mask is set with a value"""
+
+    def to_bool(self) -> Array:
+        """Unpack mask to a b8 array"""
+
+def pack_bits(x: Array) -> BitMask:
+    """Pack a b8 array into a bit mask"""
+
+def eq_bits(lhs: Array, rhs: Array) -> BitMask:
+    """Compare for equality into a bit mask"""
+
+def neq_bits(lhs: Array, rhs: Array) -> BitMask:
+    """Compare for inequality into a bit mask"""
+
+def lt_bits(lhs: Array, rhs: Array) -> BitMask:
+    """Compare for less than into a bit mask"""
+
+def gt_bits(lhs: Array, rhs: Array) -> BitMask:
+    """Compare for greater than into a bit mask"""
+
+def leq_bits(lhs: Array, rhs: Array) -> BitMask:
+    """Compare for less than or equal into a bit mask"""
+
+def geq_bits(lhs: Array, rhs: Array) -> BitMask:
+    """Compare for greater than or equal into a bit mask"""
@@ -1,4 +1,5 @@
 from collections.abc import Sequence
+import enum
 from typing import overload
 
 import numx.core
@@ -10,9 +11,109 @@ def linear(x: numx.core.Array, weight: numx.core.Array) -> numx.core.Array:
 def linear_with_bias(x: numx.core.Array, weight: numx.core.Array, bias: numx.core.Array) -> numx.core.Array:
     """Functional linear with bias"""
 
+class ConvLayout(enum.Enum):
+    NCHW = 0
+
+    NHWC = 1
+
+def conv2d(x: numx.core.Array, weight: numx.core.Array, stride: Sequence[int] = [1, 1], padding: Sequence[int] = [0, 0], dilation: Sequence[int] = [1, 1], layout: ConvLayout = ConvLayout.NCHW) -> numx.core.Array:
+    """Functional 2D convolution without bias"""
+
+def conv2d_with_bias(x: numx.core.Array, weight: numx.core.Array, bias: numx.core.Array, stride: Sequence[int] = [1, 1], padding: Sequence[int] = [0, 0], dilation: Sequence[int] = [1, 1], layout: ConvLayout = ConvLayout.NCHW) -> numx.core.Array:
+    """Functional 2D convolution with bias"""
+
+def fft_conv1d(x: numx.core.Array, weight: numx.core.Array, padding: int = 0, use_fft: bool | None = None) -> numx.core.Array:
+    """Functional 1D convolution through FFTs for long kernels and direct convolution otherwise"""
+
+def max_pool2d(x: numx.core.Array, kernel_size: Sequence[int], stride: Sequence[int] = [], padding: Sequence[int] = [0, 0], layout: ConvLayout = ConvLayout.NCHW) -> numx.core.Array:
+    """Functional 2D max pooling"""
+
+def avg_pool2d(x: numx.core.Array, kernel_size: Sequence[int], stride: Sequence[int] = [], padding: Sequence[int] = [0, 0], layout: ConvLayout = ConvLayout.NCHW) -> numx.core.Array:
+    """Functional 2D average pooling"""
+
+def adaptive_avg_pool2d(x: numx.core.Array, output_size: Sequence[int], layout: ConvLayout = ConvLayout.NCHW) -> numx.core.Array:
+    """Functional 2D adaptive average pooling"""
+
+def dropout(x: numx.core.Array, p: float = 0.5, training: bool = True) -> numx.core.Array:
+    """Functional dropout with the mask regenerated in backward"""
+
+def layer_norm(x: numx.core.Array, weight: numx.core.Array, bias: numx.core.Array, eps: float = 1e-05) -> numx.core.Array:
+    """Functional layer normalization over the last dimension"""
+
+def rms_norm(x: numx.core.Array, weight: numx.core.Array, eps: float = 1e-06) -> numx.core.Array:
+    """Functional RMS normalization over the last dimension"""
+
+def batch_norm(x: numx.core.Array, weight: numx.core.Array, bias: numx.core.Array, running_mean: numx.core.Array, running_var: numx.core.Array, training: bool, momentum: float = 0.1, eps: float = 1e-05, layout: ConvLayout = ConvLayout.NCHW) -> numx.core.Array:
+    """Functional batch normalization over the channel dimension"""
+
+def scaled_dot_product_attention(q: numx.core.Array, k: numx.core.Array, v: numx.core.Array, causal: bool = False, scale: float | None = None) -> numx.core.Array:
+    """Fused scaled dot-product attention over the last two dimensions"""
+
+def lstm_cell(x: numx.core.Array, h: numx.core.Array, c: numx.core.Array, weight_ih: numx.core.Array, weight_hh: numx.core.Array, bias_ih: numx.core.Array, bias_hh: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array]:
+    """Fused LSTM step with gate-packed weights, returns the next hidden and cell states"""
+
+def gru_cell(x: numx.core.Array, h: numx.core.Array, weight_ih: numx.core.Array, weight_hh: numx.core.Array, bias_ih: numx.core.Array, bias_hh: numx.core.Array) -> numx.core.Array:
+    """Fused GRU step with gate-packed weights, returns the next hidden state"""
+
+def lstm(x: numx.core.Array, h0: numx.core.Array, c0: numx.core.Array, weight_ih: numx.core.Array, weight_hh: numx.core.Array, bias_ih: numx.core.Array, bias_hh: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array, numx.core.Array]:
+    """LSTM over a (steps, batch, input) sequence in one kernel, returns all hidden states and the final hidden and cell states"""
+
+def gru(x: numx.core.Array, h0: numx.core.Array, weight_ih: numx.core.Array, weight_hh: numx.core.Array, bias_ih: numx.core.Array, bias_hh: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array]:
+    """GRU over a (steps, batch, input) sequence in one kernel, returns all hidden states and the final hidden state"""
+
+@overload
+def fold_batch_norm(linear: Linear, bn: BatchNorm) -> None:
+    """Fold inference batch normalization into the preceding linear layer"""
+
+@overload
+def fold_batch_norm(conv: Conv2d, bn: BatchNorm) -> None:
+    """Fold inference batch normalization into the preceding convolution layer"""
+
+class QuantizedActivation(enum.Enum):
+    NONE = 0
+
+    RELU = 1
+
+    GELU = 2
+
+    SILU = 3
+
+def quantize(x: numx.core.Array, clip: float = 0.0) -> tuple[numx.core.Array, numx.core.Array]:
+    """Symmetric int8 quantization over the last dimension, returns the quantized array and its per-row scales"""
+
+def quantized_linear(x: numx.core.Array, weight: numx.core.Array, weight_scale: numx.core.Array, activation: QuantizedActivation = QuantizedActivation.NONE, clip: float = 0.0) -> numx.core.Array:
+    """Functional int8 linear without bias, activations are quantized per row on the fly"""
+
+def quantized_linear_with_bias(x: numx.core.Array, weight: numx.core.Array, weight_scale: numx.core.Array, bias: numx.core.Array, activation: QuantizedActivation = QuantizedActivation.NONE, clip: float = 0.0) -> numx.core.Array:
+    """Functional int8 linear with bias, activations are quantized per row on the fly"""
+
+def block_sparsify(weight: numx.core.Array, block_rows: int = 16, block_cols: int = 16, threshold: float = 0.0) -> tuple[numx.core.Array, numx.core.Array, numx.core.Array]:
+    """Pack the weight blocks with any element above the threshold, returns block row offsets, block columns and packed blocks"""
+
+def block_sparse_linear(x: numx.core.Array, block_ptr: numx.core.Array, block_col: numx.core.Array, block_values: numx.core.Array, in_features: int) -> numx.core.Array:
+    """Functional block-sparse linear without bias"""
+
+def block_sparse_linear_with_bias(x: numx.core.Array, block_ptr: numx.core.Array, block_col: numx.core.Array, block_values: numx.core.Array, bias: numx.core.Array, in_features: int) -> numx.core.Array:
+    """Functional block-sparse linear with bias"""
+
 def relu(x: numx.core.Array) -> numx.core.Array:
     """ReLU activation function"""
 
+def sigmoid(x: numx.core.Array) -> numx.core.Array:
+    """Sigmoid activation function"""
+
+def tanh(x: numx.core.Array) -> numx.core.Array:
+    """Tanh activation function"""
+
+def gelu(x: numx.core.Array, approximate: bool = False) -> numx.core.Array:
+    """GELU activation function, approximated with tanh if approximate is true"""
+
+def silu(x: numx.core.Array) -> numx.core.Array:
+    """SiLU activation function"""
+
+def softplus(x: numx.core.Array) -> numx.core.Array:
+    """Softplus activation function"""
+
 def onehot(x: numx.core.Array, num_classes: int = -1) -> numx.core.Array:
     """One-hot encode input array"""
 
@@ -40,6 +141,16 @@ class Module:
     def parameters(self) -> list[Parameter]:
         """Get module parameters"""
 
+    def train(self, mode: bool = True) -> None:
+        """Set module to training or inference mode"""
+
+    def eval(self) -> None:
+        """Set module to inference mode"""
+
+    @property
+    def training(self) -> bool:
+        """Whether module is in training mode"""
+
     def forward(self, x: numx.core.Array) -> numx.core.Array:
         """Forward pass through module"""
 
@@ -57,3 +168,242 @@ class Linear(Module):
     @property
     def bias(self) -> Parameter:
         """Get linear layer bias"""
+
+class AbsMaxObserver:
+    def __init__(self) -> None:
+        """Calibration observer of the largest absolute activation"""
+
+    def observe(self, x: numx.core.Array) -> None:
+        """Observe a calibration batch"""
+
+    def reset(self) -> None:
+        """Forget observed batches"""
+
+    @property
+    def absmax(self) -> float:
+        """Get the largest absolute value observed so far"""
+
+class QuantizedLinear(Module):
+    def __init__(self, linear: Linear, activation: QuantizedActivation = QuantizedActivation.NONE, clip: float = 0.0) -> None:
+        """Inference-only int8 linear layer with per-output-channel weight scales"""
+
+    @property
+    def weight(self) -> numx.core.Array:
+        """Get int8 weight"""
+
+    @property
+    def weight_scale(self) -> numx.core.Array:
+        """Get per-output-channel weight scales"""
+
+    @property
+    def activation(self) -> QuantizedActivation:
+        """Get fused activation"""
+
+    @property
+    def clip(self) -> float:
+        """Get activation clipping range"""
+
+class BlockSparseLinear(Module):
+    def __init__(self, linear: Linear, block_rows: int = 16, block_cols: int = 16, threshold: float = 0.0) -> None:
+        """Inference-only linear layer that skips pruned weight blocks"""
+
+    @property
+    def block_ptr(self) -> numx.core.Array:
+        """Get offsets of every block row into the packed blocks"""
+
+    @property
+    def block_col(self) -> numx.core.Array:
+        """Get block column of every packed block"""
+
+    @property
+    def block_values(self) -> numx.core.Array:
+        """Get packed blocks"""
+
+    @property
+    def block_rows(self) -> int:
+        """Get number of rows of a block"""
+
+    @property
+    def block_cols(self) -> int:
+        """Get number of columns of a block"""
+
+    @property
+    def density(self) -> float:
+        """Get fraction of weights kept in packed blocks"""
+
+class Conv2d(Module):
+    def __init__(self, in_channels: int, out_channels: int, kernel_size: Sequence[int], stride: Sequence[int] = [1, 1], padding: Sequence[int] = [0, 0], dilation: Sequence[int] = [1, 1], bias: bool = True, layout: ConvLayout = ConvLayout.NCHW) -> None:
+        """2D convolution layer"""
+
+    @property
+    def weight(self) -> Parameter:
+        """Get convolution layer weight"""
+
+    @property
+    def bias(self) -> Parameter:
+        """Get convolution layer bias"""
+
+class MaxPool2d(Module):
+    def __init__(self, kernel_size: Sequence[int], stride: Sequence[int] = [], padding: Sequence[int] = [0, 0], layout: ConvLayout = ConvLayout.NCHW) -> None:
+        """2D max pooling layer"""
+
+class AvgPool2d(Module):
+    def __init__(self, kernel_size: Sequence[int], stride: Sequence[int] = [], padding: Sequence[int] = [0, 0], layout: ConvLayout = ConvLayout.NCHW) -> None:
+        """2D average pooling layer"""
+
+class AdaptiveAvgPool2d(Module):
+    def __init__(self, output_size: Sequence[int], layout: ConvLayout = ConvLayout.NCHW) -> None:
+        """2D adaptive average pooling layer"""
+
+class Dropout(Module):
+    def __init__(self, p: float = 0.5) -> None:
+        """Dropout layer"""
+
+    @property
+    def p(self) -> float:
+        """Get dropout probability"""
+
+class LayerNorm(Module):
+    def __init__(self, normalized_size: int, eps: float = 1e-05) -> None:
+        """Layer normalization layer"""
+
+    @property
+    def weight(self) -> Parameter:
+        """Get layer normalization weight"""
+
+    @property
+    def bias(self) -> Parameter:
+        """Get layer normalization bias"""
+
+class RMSNorm(Module):
+    def __init__(self, normalized_size: int, eps: float = 1e-06) -> None:
+        """RMS normalization layer"""
+
+    @property
+    def weight(self) -> Parameter:
+        """Get RMS normalization weight"""
+
+class BatchNorm(Module):
+    def __init__(self, num_features: int, momentum: float = 0.1, eps: float = 1e-05, layout: ConvLayout = ConvLayout.NCHW) -> None:
+        """Batch normalization layer"""
+
+    @property
+    def weight(self) -> Parameter:
+        """Get batch normalization weight"""
+
+    @property
+    def bias(self) -> Parameter:
+        """Get batch normalization bias"""
+
+    @property
+    def running_mean(self) -> Parameter:
+        """Get batch normalization running mean"""
+
+    @property
+    def running_var(self) -> Parameter:
+        """Get batch normalization running variance"""
+
+    @property
+    def folded(self) -> bool:
+        """Whether batch normalization was folded into the preceding layer"""
+
+class RecurrentModule(Module):
+    @property
+    def hidden_size(self) -> int:
+        """Get recurrent layer hidden size"""
+
+    @property
+    def weight_ih(self) -> Parameter:
+        """Get gate-packed input weight"""
+
+    @property
+    def weight_hh(self) -> Parameter:
+        """Get gate-packed hidden weight"""
+
+    @property
+    def bias_ih(self) -> Parameter:
+        """Get gate-packed input bias"""
+
+    @property
+    def bias_hh(self) -> Parameter:
+        """Get gate-packed hidden bias"""
+
+class LSTMCell(RecurrentModule):
+    def __init__(self, input_size: int, hidden_size: int) -> None:
+        """LSTM cell layer"""
+
+    @overload
+    def forward(self, x: numx.core.Array) -> numx.core.Array:
+        """Next hidden state from zero states"""
+
+    @overload
+    def forward(self, x: numx.core.Array, h: numx.core.Array, c: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array]:
+        """Next hidden and cell states"""
+
+    @overload
+    def __call__(self, x: numx.core.Array) -> numx.core.Array:
+        """Next hidden state from zero states"""
+
+    @overload
+    def __call__(self, x: numx.core.Array, h: numx.core.Array, c: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array]:
+        """Next hidden and cell states"""
+
+class GRUCell(RecurrentModule):
+    def __init__(self, input_size: int, hidden_size: int) -> None:
+        """GRU cell layer"""
+
+    @overload
+    def forward(self, x: numx.core.Array) -> numx.core.Array:
+        """Next hidden state from a zero state"""
+
+    @overload
+    def forward(self, x: numx.core.Array, h: numx.core.Array) -> numx.core.Array:
+        """Next hidden state"""
+
+    @overload
+    def __call__(self, x: numx.core.Array) -> numx.core.Array:
+        """Next hidden state from a zero state"""
+
+    @overload
+    def __call__(self, x: numx.core.Array, h: numx.core.Array) -> numx.core.Array:
+        """Next hidden state"""
+
+class LSTM(RecurrentModule):
+    def __init__(self, input_size: int, hidden_size: int) -> None:
+        """LSTM layer over (steps, batch, input) sequences"""
+
+    @overload
+    def forward(self, x: numx.core.Array) -> numx.core.Array:
+        """Hidden states of every step from zero states"""
+
+    @overload
+    def forward(self, x: numx.core.Array, h0: numx.core.Array, c0: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array, numx.core.Array]:
+        """Hidden states of every step and the final hidden and cell states"""
+
+    @overload
+    def __call__(self, x: numx.core.Array) -> numx.core.Array:
+        """Hidden states of every step from zero states"""
+
+    @overload
+    def __call__(self, x: numx.core.Array, h0: numx.core.Array, c0: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array, numx.core.Array]:
+        """Hidden states of every step and the final hidden and cell states"""
+
+class GRU(RecurrentModule):
+    def __init__(self, input_size: int, hidden_size: int) -> None:
+        """GRU layer over (steps, batch, input) sequences"""
+
+    @overload
+    def forward(self, x: numx.core.Array) -> numx.core.Array:
+        """Hidden states of every step from a zero state"""
+
+    @overload
+    def forward(self, x: numx.core.Array, h0: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array]:
+        """Hidden states of every step and the final hidden state"""
+
+    @overload
+    def __call__(self, x: numx.core.Array) -> numx.core.Array:
+        """Hidden states of every step from a zero state"""
+
+    @overload
+    def __call__(self, x: numx.core.Array, h0: numx.core.Array) -> tuple[numx.core.Array, numx.core.Array]:
+        """Hidden states of every step and the final hidden state"""
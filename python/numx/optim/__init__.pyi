@@ -1,5 +1,6 @@
 from collections.abc import Sequence
 
+import numx.core
 import numx.nn
 
 
@@ -10,9 +11,23 @@ class Optimizer:
     def forward(self) -> None:
         """Parameters update function"""
 
-    def update(self, params: Sequence[numx.nn.Parameter]) -> None:
+    def update(self, params: Sequence[numx.nn.Parameter], grad_scale: float = 1.0) -> None:
         """Update module parameters"""
 
 class GradientDescent(Optimizer):
     def __init__(self, lr: float = 0.001) -> None:
         """Gradient Descent optimizer"""
+
+class GradScaler:
+    def __init__(self, init_scale: float = 65536.0, growth_factor: float = 2.0, backoff_factor: float = 0.5, growth_interval: int = 2000) -> None:
+        """Dynamic loss scaler for low-precision training"""
+
+    @property
+    def scale_factor(self) -> float:
+        """Get current loss scale"""
+
+    def scale(self, loss: numx.core.Array) -> numx.core.Array:
+        """Multiply loss by the current scale"""
+
+    def step(self, optimizer: Optimizer, params: Sequence[numx.nn.Parameter]) -> bool:
+        """Unscale gradients and update parameters unless any is inf or nan, returns whether the step was taken"""
@@ -21,3 +21,6 @@ def randint(view: Sequence[int], low: object = 0, high: object = 10, dtype: numx
 
 def randbool(view: Sequence[int], device: str = 'mps:0') -> numx.core.Array:
     """Create a new array with uniformly distributed random boolean values"""
+
+def multinomial(x: numx.core.Array, num_samples: int = 1, logits: bool = False, temperature: float = 1.0, top_k: int = 0, top_p: float = 1.0) -> numx.core.Array:
+    """Sample indices over the last dimension from logits or unnormalized probabilities"""
@@ -0,0 +1,48 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+import torch
+import torch.nn.functional as F
+
+
+class TestActivation:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def activation(self, name: str, nx_fn, torch_fn):
+        print(f"{name}:")
+        # Large magnitudes check that the kernels do not overflow
+        np_x = np.concatenate([np.random.randn(37, 53), 30 * np.random.randn(3, 53)]).astype(np.float32)
+        np_out = nx_fn(from_numpy(np_x)).numpy()
+        assert np.allclose(np_out, torch_fn(torch.from_numpy(np_x)).numpy(), atol=1e-4, rtol=0)
+        # Strided input
+        np_out = nx_fn(from_numpy(np_x).transpose(0, 1)).numpy()
+        assert np.allclose(np_out, torch_fn(torch.from_numpy(np_x.T.copy())).numpy(), atol=1e-4, rtol=0)
+
+    def test_relu(self):
+        self.activation("relu", nn.relu, F.relu)
+
+    def test_sigmoid(self):
+        self.activation("sigmoid", nn.sigmoid, torch.sigmoid)
+
+    def test_tanh(self):
+        self.activation("tanh", nn.tanh, torch.tanh)
+
+    def test_gelu(self):
+        self.activation("gelu", nn.gelu, F.gelu)
+
+    def test_gelu_tanh(self):
+        self.activation("gelu tanh", lambda x: nn.gelu(x, True), lambda t: F.gelu(t, approximate="tanh"))
+
+    def test_silu(self):
+        self.activation("silu", nn.silu, F.silu)
+
+    def test_softplus(self):
+        self.activation("softplus", nn.softplus, F.softplus)
+
+    def test_relu_int(self):
+        print("relu int:")
+        np_x = np.random.randint(-10, 10, (20, 30)).astype(np.int32)
+        assert np.array_equal(nn.relu(from_numpy(np_x)).numpy(), np.maximum(np_x, 0))
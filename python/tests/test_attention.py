@@ -0,0 +1,45 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+import torch
+import torch.nn.functional as F
+
+
+class TestAttention:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_sdpa(self):
+        print("scaled_dot_product_attention:")
+
+        for q_shape, k_shape, v_dim in [((1, 1, 4), (1, 1, 4), 4), ((2, 3, 37, 16), (2, 3, 37, 16), 16), ((4, 100, 64), (4, 257, 64), 32), ((1, 2, 513, 128), (1, 2, 513, 128), 128)]:
+            np_q = np.random.randn(*q_shape).astype(np.float32)
+            np_k = np.random.randn(*k_shape).astype(np.float32)
+            np_v = np.random.randn(*k_shape[:-1], v_dim).astype(np.float32)
+
+            for causal in [False, True]:
+                nx_out = nn.scaled_dot_product_attention(from_numpy(np_q), from_numpy(np_k), from_numpy(np_v), causal)
+                t_out = F.scaled_dot_product_attention(torch.from_numpy(np_q), torch.from_numpy(np_k), torch.from_numpy(np_v), is_causal=causal)
+                assert torch.allclose(nx_out.torch(), t_out, atol=1e-4, rtol=0)
+
+    def test_sdpa_scale_and_strided(self):
+        print("scaled_dot_product_attention scale and strided:")
+        # (B, T, H, D) inputs transposed to (B, H, T, D) without a copy
+        np_q = np.random.randn(2, 50, 4, 32).astype(np.float32)
+        np_k = np.random.randn(2, 70, 4, 32).astype(np.float32)
+        np_v = np.random.randn(2, 70, 4, 32).astype(np.float32)
+        nx_out = nn.scaled_dot_product_attention(from_numpy(np_q).transpose(1, 2), from_numpy(np_k).transpose(1, 2), from_numpy(np_v).transpose(1, 2), scale=0.3)
+        t_out = F.scaled_dot_product_attention(torch.from_numpy(np_q).transpose(1, 2), torch.from_numpy(np_k).transpose(1, 2), torch.from_numpy(np_v).transpose(1, 2), scale=0.3)
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-4, rtol=0)
+
+    def test_sdpa_long_sequence(self):
+        print("scaled_dot_product_attention long sequence:")
+        # Scores of a 8192 x 8192 attention are never materialized
+        np_q = np.random.randn(1, 8192, 64).astype(np.float32)
+        np_k = np.random.randn(1, 8192, 64).astype(np.float32)
+        np_v = np.random.randn(1, 8192, 64).astype(np.float32)
+        nx_out = nn.scaled_dot_product_attention(from_numpy(np_q), from_numpy(np_k), from_numpy(np_v), True)
+        t_out = F.scaled_dot_product_attention(torch.from_numpy(np_q), torch.from_numpy(np_k), torch.from_numpy(np_v), is_causal=True)
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-4, rtol=0)
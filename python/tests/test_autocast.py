@@ -0,0 +1,119 @@
+import numpy as np
+import torch
+import torch.nn.functional as F
+import numx.nn as nn
+from numx.core import autocast, bf16, f16, f32, from_numpy, where
+from numx.optim import GradientDescent, GradScaler
+from numx.profiler import enable_memory_profile
+
+
+class TestAutocast:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_dtypes(self):
+        print("autocast dtypes:")
+        nx_x = from_numpy(np.random.randn(16, 32).astype(np.float32))
+        nx_w = from_numpy(np.random.randn(32, 10).astype(np.float32))
+
+        with autocast(bf16):
+            nx_y = nx_x @ nx_w
+            assert nx_y.dtype == bf16
+            assert (nx_y + nx_y).dtype == bf16
+            assert nx_y.sum().dtype == f32
+            assert nn.softmax(nx_y).dtype == f32
+            assert nn.cross_entropy_loss(nx_y, from_numpy(np.arange(16, dtype=np.int32) % 10)).dtype == f32
+
+        # The scope is restored on exit
+        assert (nx_x @ nx_w).dtype == f32
+
+    def test_matmul_and_backward(self):
+        print("autocast matmul and backward:")
+        np_x = np.random.randn(37, 64).astype(np.float32)
+        np_w = np.random.randn(64, 21).astype(np.float32)
+        nx_x, nx_w = from_numpy(np_x), from_numpy(np_w)
+
+        with autocast(f16):
+            nx_loss = (nx_x @ nx_w).sum()
+
+        nx_loss.backward()
+        t_x, t_w = torch.from_numpy(np_x).requires_grad_(), torch.from_numpy(np_w).requires_grad_()
+        t_loss = (t_x @ t_w).sum()
+        t_loss.backward()
+        assert abs(nx_loss.item() - t_loss.item()) < 1e-2 * abs(t_loss.item()) + 1e-1
+        # Gradients of f32 inputs are f32 again after the autocast cast
+        assert nx_w.grad.dtype == f32
+        assert torch.allclose(nx_w.grad.torch(), t_w.grad, atol=0, rtol=1e-2)
+
+    def test_norms(self):
+        print("autocast norms:")
+        np_x = np.random.randn(12, 16).astype(np.float32)
+        linear = nn.Linear(16, 8)
+        t_y = torch.from_numpy(np_x @ linear.weight.numpy().T + linear.bias.numpy())
+
+        # Norms run in f32 against their f32 weights after a 16-bit linear
+        for norm, t_out in [(nn.LayerNorm(8), F.layer_norm(t_y, (8,))), (nn.RMSNorm(8), t_y * torch.rsqrt(t_y.square().mean(-1, keepdim=True) + 1e-6))]:
+            with autocast(bf16):
+                nx_out = norm(linear(from_numpy(np_x)))
+
+            assert nx_out.dtype == f32
+            assert torch.allclose(nx_out.torch(), t_out, atol=5e-2)
+            nx_out.sum().backward()
+            assert norm.weight.grad.dtype == f32
+
+        bn = nn.BatchNorm(8)
+
+        with autocast(bf16):
+            nx_out = bn(linear(from_numpy(np_x)))
+
+        assert nx_out.dtype == f32
+        assert torch.allclose(nx_out.torch(), F.batch_norm(t_y, None, None, training=True), atol=5e-2)
+        assert bn.running_mean.dtype == f32
+        assert torch.allclose(bn.running_mean.torch(), 0.1 * t_y.mean(0), atol=1e-2)
+
+    def test_mixed_operands(self):
+        print("autocast mixed operands:")
+        np_q, np_k, np_v = (np.random.randn(2, 10, 16).astype(np.float32) for _ in range(3))
+        np_w = np.eye(16, dtype=np.float32)
+
+        # One operand comes out of an autocast matmul while the others are still f32
+        with autocast(bf16):
+            nx_q = from_numpy(np_q) @ from_numpy(np_w)
+            nx_out = nn.scaled_dot_product_attention(nx_q, from_numpy(np_k), from_numpy(np_v))
+            nx_cmp = nx_q < from_numpy(np_k)
+            nx_where = where(nx_cmp, nx_q, from_numpy(np_k))
+            nx_pow = nx_q ** from_numpy(np.full((16,), 2.0, dtype=np.float32))
+
+        assert nx_out.dtype == bf16 and nx_where.dtype == bf16 and nx_pow.dtype == bf16
+        t_out = F.scaled_dot_product_attention(torch.from_numpy(np_q), torch.from_numpy(np_k), torch.from_numpy(np_v))
+        assert torch.allclose(nx_out.astype(f32).torch(), t_out, atol=5e-2)
+        assert np.allclose(nx_pow.astype(f32).numpy(), np_q**2, atol=5e-2, rtol=2e-2)
+        assert nx_cmp.numpy().shape == np_q.shape
+
+    def test_grad_scaler(self):
+        print("grad scaler:")
+        layer = nn.Linear(8, 4)
+        optimizer = GradientDescent(lr=0.1)
+        scaler = GradScaler(init_scale=1024.0, growth_interval=2)
+        np_x = np.random.randn(5, 8).astype(np.float32)
+        np_weight = layer.weight.numpy().copy()
+
+        with autocast(bf16):
+            loss = layer(from_numpy(np_x)).sum()
+
+        scaler.scale(loss).backward()
+        assert scaler.step(optimizer, layer.parameters())
+        # Unscaled update matches plain gradient descent
+        expected = np_weight - 0.1 * np.broadcast_to(np_x.sum(0), np_weight.shape)
+        assert np.allclose(layer.weight.numpy(), expected, atol=5e-2)
+        assert scaler.scale_factor == 1024.0
+
+        # An overflowing loss skips the step and backs off the scale
+        layer = nn.Linear(8, 4)
+        np_weight = layer.weight.numpy().copy()
+        loss = layer(from_numpy(np.full((5, 8), 1e38, dtype=np.float32))).sum()
+        scaler.scale(loss).backward()
+        assert not scaler.step(optimizer, layer.parameters())
+        assert np.array_equal(layer.weight.numpy(), np_weight)
+        assert scaler.scale_factor == 512.0
@@ -1,4 +1,5 @@
-from numx.core import Array, Shape, from_numpy
+from numx.core import Array, Shape, concat, from_numpy, split, stack, where
+import numx.nn as nn
 from numx.profiler import enable_memory_profile
 import numpy as np
 import torch
@@ -517,3 +518,382 @@ class TestBackprop:
         assert_array(nx_a1.grad, t1.grad)
         assert_array(nx_a2.grad, t2.grad)
         assert_array(nx_a3.grad, t3.grad)
+
+    def test_where_backprop(self):
+        print("\nTesting where backprop:")
+        np_cond = np.random.rand(4, 1, 6) > 0.5
+        np_a1 = np.random.randn(4, 5, 6).astype(np.float32)
+        np_a2 = np.random.randn(5, 1).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        nx_a3 = where(from_numpy(np_cond), nx_a1.exp(), nx_a2 * nx_a2)
+        nx_a4 = nx_a3.sum()
+        nx_a4.backward()
+        t_cond = torch.from_numpy(np_cond)
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = torch.from_numpy(np_a2).requires_grad_(True)
+        t3 = torch.where(t_cond, t1.exp(), t2 * t2)
+        t3.retain_grad()
+        t4 = t3.sum()
+        t4.backward()
+        assert_array(nx_a3, t3)
+        assert_array(nx_a1.grad, t1.grad)
+        assert_array(nx_a2.grad, t2.grad)
+
+    def test_concat_backprop(self):
+        print("\nTesting concat backprop:")
+        np_a1 = np.random.randn(4, 3).astype(np.float32)
+        np_a2 = np.random.randn(4, 5).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        nx_a3 = stack(split(concat([nx_a1.exp(), nx_a2 * nx_a2], 1), 2, 1), 0)
+        nx_a4 = (nx_a3 * nx_a3).sum()
+        nx_a4.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = torch.from_numpy(np_a2).requires_grad_(True)
+        t3 = torch.stack(torch.split(torch.cat([t1.exp(), t2 * t2], 1), 2, 1), 0)
+        t3.retain_grad()
+        t4 = (t3 * t3).sum()
+        t4.backward()
+        assert_array(nx_a3, t3)
+        assert_array(nx_a1.grad, t1.grad)
+        assert_array(nx_a2.grad, t2.grad)
+
+    def test_cumsum_backprop(self):
+        print("\nTesting cumsum backprop:")
+        np_a1 = np.random.randn(5, 40, 6).astype(np.float32)
+        np_a2 = np.random.randn(5, 40, 6).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = (nx_a1.cumsum(1) * from_numpy(np_a2)).sum()
+        nx_a2.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = (t1.cumsum(1) * torch.from_numpy(np_a2)).sum()
+        t2.backward()
+        assert_array(nx_a1.grad, t1.grad)
+
+    def test_cumprod_backprop(self):
+        print("\nTesting cumprod backprop:")
+        np_a1 = np.random.uniform(0.5, 1.5, (4, 12)).astype(np.float32)
+        np_a2 = np.random.randn(4, 12).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = (nx_a1.cumprod(-1) * from_numpy(np_a2)).sum()
+        nx_a2.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = (t1.cumprod(-1) * torch.from_numpy(np_a2)).sum()
+        t2.backward()
+        assert_array(nx_a1.grad, t1.grad)
+
+    def test_cummax_backprop(self):
+        print("\nTesting cummax backprop:")
+        np_a1 = np.random.randn(6, 50).astype(np.float32)
+        np_a2 = np.random.randn(6, 50).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = (nx_a1.cummax(1) * from_numpy(np_a2)).sum()
+        nx_a2.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = (t1.cummax(1).values * torch.from_numpy(np_a2)).sum()
+        t2.backward()
+        assert_array(nx_a1.grad, t1.grad)
+
+    def test_sort_backprop(self):
+        print("\nTesting sort backprop:")
+        np_a1 = np.random.randn(7, 30).astype(np.float32)
+        np_a2 = np.random.randn(7, 30).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = (nx_a1.sort(1, descending=True) * from_numpy(np_a2)).sum()
+        nx_a2.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = (t1.sort(1, descending=True).values * torch.from_numpy(np_a2)).sum()
+        t2.backward()
+        assert_array(nx_a1.grad, t1.grad)
+
+    def test_topk_backprop(self):
+        print("\nTesting topk backprop:")
+        np_a1 = np.random.randn(20, 5).astype(np.float32)
+        np_a2 = np.random.randn(6, 5).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = (nx_a1.topk(6, 0)[0] * from_numpy(np_a2)).sum()
+        nx_a2.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = (t1.topk(6, 0).values * torch.from_numpy(np_a2)).sum()
+        t2.backward()
+        assert_array(nx_a1.grad, t1.grad)
+        # The gradient is scattered to the top-k positions of long rows without sorting them again
+        np_a3 = np.random.randn(3, 50000).astype(np.float32)
+        np_a4 = np.random.randn(3, 10).astype(np.float32)
+        nx_a3 = from_numpy(np_a3)
+        (nx_a3.topk(10, 1, largest=False)[0] * from_numpy(np_a4)).sum().backward()
+        t3 = torch.from_numpy(np_a3).requires_grad_(True)
+        (t3.topk(10, 1, largest=False).values * torch.from_numpy(np_a4)).sum().backward()
+        assert_array(nx_a3.grad, t3.grad)
+
+    def test_conv2d_backprop(self):
+        print("\nTesting conv2d backprop:")
+        np_a1 = np.random.randn(2, 3, 11, 9).astype(np.float32)
+        np_a2 = np.random.randn(4, 3, 3, 2).astype(np.float32)
+
+        for layout in [nn.ConvLayout.NCHW, nn.ConvLayout.NHWC]:
+            nx_a1 = from_numpy(np_a1 if layout == nn.ConvLayout.NCHW else np.ascontiguousarray(np_a1.transpose(0, 2, 3, 1)))
+            nx_a2 = from_numpy(np_a2)
+            nx_a3 = nn.conv2d(nx_a1, nx_a2, (2, 1), (1, 1), (1, 2), layout)
+            nx_a4 = (nx_a3 * nx_a3).sum()
+            nx_a4.backward()
+            t1 = torch.from_numpy(np_a1).requires_grad_(True)
+            t2 = torch.from_numpy(np_a2).requires_grad_(True)
+            t3 = torch.nn.functional.conv2d(t1, t2, None, (2, 1), (1, 1), (1, 2))
+            t4 = (t3 * t3).sum()
+            t4.backward()
+            t1_grad = t1.grad if layout == nn.ConvLayout.NCHW else t1.grad.permute(0, 2, 3, 1)
+            assert_array(nx_a1.grad, t1_grad)
+            assert_array(nx_a2.grad, t2.grad)
+
+    def test_pool2d_backprop(self):
+        print("\nTesting pool2d backprop:")
+        np_a1 = np.random.randn(2, 3, 12, 9).astype(np.float32)
+        np_a2 = np.random.randn(2, 3, 6, 5).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        nx_a3 = (nn.max_pool2d(nx_a1, (3, 3), (2, 2), (1, 1)) * nx_a2).sum() + (nn.avg_pool2d(nx_a1, (2, 3), (2, 2), (0, 1)) * nx_a2).sum()
+        nx_a4 = nn.adaptive_avg_pool2d(nx_a1, (5, 4))
+        nx_a5 = nx_a3 + (nx_a4 * nx_a4).sum()
+        nx_a5.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = torch.from_numpy(np_a2)
+        t3 = (torch.nn.functional.max_pool2d(t1, (3, 3), (2, 2), (1, 1)) * t2).sum() + (torch.nn.functional.avg_pool2d(t1, (2, 3), (2, 2), (0, 1)) * t2).sum()
+        t4 = torch.nn.functional.adaptive_avg_pool2d(t1, (5, 4))
+        t5 = t3 + (t4 * t4).sum()
+        t5.backward()
+        assert_array(nx_a1.grad, t1.grad)
+
+    def test_norm_backprop(self):
+        print("\nTesting layer_norm and rms_norm backprop:")
+        np_a1 = np.random.randn(6, 9, 50).astype(np.float32)
+        np_a2 = np.random.randn(50).astype(np.float32)
+        np_a3 = np.random.randn(50).astype(np.float32)
+        np_a4 = np.random.randn(6, 9, 50).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        nx_a3 = from_numpy(np_a3)
+        nx_a4 = from_numpy(np_a4)
+        nx_a5 = (nn.layer_norm(nx_a1, nx_a2, nx_a3) * nx_a4).sum() + (nn.rms_norm(nx_a1, nx_a2) * nx_a4).sum()
+        nx_a5.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = torch.from_numpy(np_a2).requires_grad_(True)
+        t3 = torch.from_numpy(np_a3).requires_grad_(True)
+        t4 = torch.from_numpy(np_a4)
+        t5 = t1 * torch.rsqrt(t1.pow(2).mean(-1, keepdim=True) + 1e-6) * t2
+        t6 = (torch.nn.functional.layer_norm(t1, (50,), t2, t3) * t4).sum() + (t5 * t4).sum()
+        t6.backward()
+        assert_array(nx_a1.grad, t1.grad)
+        assert_array(nx_a2.grad, t2.grad)
+        assert_array(nx_a3.grad, t3.grad)
+
+    def test_batch_norm_backprop(self):
+        print("\nTesting batch_norm backprop:")
+
+        for training in [True, False]:
+            np_a1 = np.random.randn(4, 3, 5, 6).astype(np.float32)
+            np_a2 = np.random.randn(3).astype(np.float32)
+            np_a3 = np.random.randn(3).astype(np.float32)
+            np_a4 = np.random.randn(4, 3, 5, 6).astype(np.float32)
+            np_mean = np.random.randn(3).astype(np.float32)
+            np_var = np.random.rand(3).astype(np.float32) + 0.5
+            nx_a1 = from_numpy(np_a1)
+            nx_a2 = from_numpy(np_a2)
+            nx_a3 = from_numpy(np_a3)
+            nx_a4 = from_numpy(np_a4)
+            nx_a5 = (nn.batch_norm(nx_a1, nx_a2, nx_a3, from_numpy(np_mean.copy()), from_numpy(np_var.copy()), training) * nx_a4).sum()
+            nx_a5.backward()
+            t1 = torch.from_numpy(np_a1).requires_grad_(True)
+            t2 = torch.from_numpy(np_a2).requires_grad_(True)
+            t3 = torch.from_numpy(np_a3).requires_grad_(True)
+            t4 = torch.from_numpy(np_a4)
+            t5 = (torch.nn.functional.batch_norm(t1, torch.from_numpy(np_mean.copy()), torch.from_numpy(np_var.copy()), t2, t3, training) * t4).sum()
+            t5.backward()
+            assert_array(nx_a1.grad, t1.grad)
+            assert_array(nx_a2.grad, t2.grad)
+            assert_array(nx_a3.grad, t3.grad)
+
+    def test_sdpa_backprop(self):
+        print("\nTesting scaled_dot_product_attention backprop:")
+
+        for causal in [False, True]:
+            np_a1 = np.random.randn(2, 3, 45, 16).astype(np.float32)
+            np_a2 = np.random.randn(2, 3, 70, 16).astype(np.float32)
+            np_a3 = np.random.randn(2, 3, 70, 24).astype(np.float32)
+            np_a4 = np.random.randn(2, 3, 45, 24).astype(np.float32)
+            nx_a1 = from_numpy(np_a1)
+            nx_a2 = from_numpy(np_a2)
+            nx_a3 = from_numpy(np_a3)
+            nx_a4 = from_numpy(np_a4)
+            nx_a5 = (nn.scaled_dot_product_attention(nx_a1, nx_a2, nx_a3, causal) * nx_a4).sum()
+            nx_a5.backward()
+            t1 = torch.from_numpy(np_a1).requires_grad_(True)
+            t2 = torch.from_numpy(np_a2).requires_grad_(True)
+            t3 = torch.from_numpy(np_a3).requires_grad_(True)
+            t4 = torch.from_numpy(np_a4)
+            t5 = (torch.nn.functional.scaled_dot_product_attention(t1, t2, t3, is_causal=causal) * t4).sum()
+            t5.backward()
+            assert_array(nx_a1.grad, t1.grad)
+            assert_array(nx_a2.grad, t2.grad)
+            assert_array(nx_a3.grad, t3.grad)
+
+    def test_dropout_backprop(self):
+        print("\nTesting dropout backprop:")
+        np_a1 = np.random.randn(30, 40).astype(np.float32)
+        np_a2 = np.random.randn(30, 40).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        nx_a3 = nn.dropout(nx_a1, 0.3)
+        nx_a4 = (nx_a3 * nx_a2).sum()
+        nx_a4.backward()
+        # The regenerated mask must match the forward mask
+        mask = torch.from_numpy((nx_a3.numpy() != 0).astype(np.float32))
+        assert_array(nx_a1.grad, mask * torch.from_numpy(np_a2) / 0.7)
+
+    def test_activation_backprop(self):
+        print("\nTesting activation backprop:")
+        activations = [
+            (nn.relu, torch.relu),
+            (nn.sigmoid, torch.sigmoid),
+            (nn.tanh, torch.tanh),
+            (nn.gelu, torch.nn.functional.gelu),
+            (lambda x: nn.gelu(x, True), lambda t: torch.nn.functional.gelu(t, approximate="tanh")),
+            (nn.silu, torch.nn.functional.silu),
+            (nn.softplus, torch.nn.functional.softplus),
+        ]
+
+        for nx_fn, torch_fn in activations:
+            np_a1 = (3 * np.random.randn(30, 40)).astype(np.float32)
+            np_a2 = np.random.randn(30, 40).astype(np.float32)
+            nx_a1 = from_numpy(np_a1)
+            nx_a2 = from_numpy(np_a2)
+            nx_a3 = (nx_fn(nx_a1) * nx_a2).sum()
+            nx_a3.backward()
+            t1 = torch.from_numpy(np_a1).requires_grad_(True)
+            t2 = torch.from_numpy(np_a2)
+            t3 = (torch_fn(t1) * t2).sum()
+            t3.backward()
+            assert_array(nx_a1.grad, t1.grad)
+
+    def test_pow_abs_clamp_fmod_backprop(self):
+        print("\nTesting pow, abs, clamp and fmod backprop:")
+        np_a1 = (np.abs(np.random.randn(30, 40)) + 0.1).astype(np.float32)
+        np_a2 = np.random.randn(30, 40).astype(np.float32)
+        np_a3 = np.random.randn(30, 40).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        nx_a3 = from_numpy(np_a3)
+        nx_a4 = (nx_a1.pow(nx_a2) + nx_a1 ** 3 + nx_a3.abs() * nx_a2 + nx_a3.clamp(-0.5, 0.5) * nx_a1 + nx_a3.fmod(nx_a1)).sum()
+        nx_a4.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = torch.from_numpy(np_a2).requires_grad_(True)
+        t3 = torch.from_numpy(np_a3).requires_grad_(True)
+        t4 = (t1.pow(t2) + t1**3 + t3.abs() * t2 + t3.clamp(-0.5, 0.5) * t1 + torch.fmod(t3, t1)).sum()
+        t4.backward()
+        assert_array(nx_a1.grad, t1.grad)
+        assert_array(nx_a2.grad, t2.grad)
+        assert_array(nx_a3.grad, t3.grad)
+
+    def test_pow_zero_backprop(self):
+        print("\nTesting pow backprop at zero:")
+        np_a1 = np.abs(np.random.randn(4, 5)).astype(np.float32)
+        np_a1[:, :2] = 0
+        np_a2 = (np.abs(np.random.randn(4, 5)) + 1).astype(np.float32)
+        np_a2[::2] = 0
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        # Zero bases and zero exponents give finite gradients instead of 0 * inf
+        nx_a3 = (nx_a1.pow(nx_a2) + nx_a1 ** 0).sum()
+        nx_a3.backward()
+        t1 = torch.from_numpy(np_a1).requires_grad_(True)
+        t2 = torch.from_numpy(np_a2).requires_grad_(True)
+        t3 = (t1.pow(t2) + t1**0).sum()
+        t3.backward()
+        assert_array(nx_a1.grad, t1.grad)
+        assert_array(nx_a2.grad, t2.grad)
+
+    def test_rnn_backprop(self):
+        print("\nTesting lstm and gru backprop:")
+        steps, batch, input_size, hidden_size = 5, 3, 7, 11
+
+        for ngate, t_module in [(4, torch.nn.LSTM), (3, torch.nn.GRU)]:
+            np_x = np.random.randn(steps, batch, input_size).astype(np.float32)
+            np_h = np.random.randn(batch, hidden_size).astype(np.float32)
+            np_c = np.random.randn(batch, hidden_size).astype(np.float32)
+            np_y = np.random.randn(steps, batch, hidden_size).astype(np.float32)
+            np_params = [(0.3 * np.random.randn(*shape)).astype(np.float32) for shape in [(ngate * hidden_size, input_size), (ngate * hidden_size, hidden_size), (ngate * hidden_size,), (ngate * hidden_size,)]]
+            nx_x = from_numpy(np_x)
+            nx_h = from_numpy(np_h)
+            nx_c = from_numpy(np_c)
+            nx_params = [from_numpy(p) for p in np_params]
+            t_rnn = t_module(input_size, hidden_size)
+
+            with torch.no_grad():
+                for name, p in zip(["weight_ih_l0", "weight_hh_l0", "bias_ih_l0", "bias_hh_l0"], np_params):
+                    getattr(t_rnn, name).copy_(torch.from_numpy(p))
+
+            tx = torch.from_numpy(np_x).requires_grad_(True)
+            th = torch.from_numpy(np_h).requires_grad_(True)
+            tc = torch.from_numpy(np_c).requires_grad_(True)
+
+            if ngate == 4:
+                nx_y, nx_hn, nx_cn = nn.lstm(nx_x, nx_h, nx_c, *nx_params)
+                nx_loss = (nx_y * from_numpy(np_y)).sum() + nx_hn.sum() + nx_cn.sum()
+                t_y, (t_hn, t_cn) = t_rnn(tx, (th[None], tc[None]))
+                t_loss = (t_y * torch.from_numpy(np_y)).sum() + t_hn.sum() + t_cn.sum()
+            else:
+                nx_y, nx_hn = nn.gru(nx_x, nx_h, *nx_params)
+                nx_loss = (nx_y * from_numpy(np_y)).sum() + nx_hn.sum()
+                t_y, t_hn = t_rnn(tx, th[None])
+                t_loss = (t_y * torch.from_numpy(np_y)).sum() + t_hn.sum()
+
+            nx_loss.backward()
+            t_loss.backward()
+            assert_array(nx_x.grad, tx.grad)
+            assert_array(nx_h.grad, th.grad)
+
+            if ngate == 4:
+                assert_array(nx_c.grad, tc.grad)
+
+            for nx_p, name in zip(nx_params, ["weight_ih_l0", "weight_hh_l0", "bias_ih_l0", "bias_hh_l0"]):
+                assert_array(nx_p.grad, getattr(t_rnn, name).grad)
+
+    def test_rnn_cell_backprop(self):
+        print("\nTesting lstm_cell and gru_cell backprop:")
+        batch, input_size, hidden_size = 4, 6, 9
+        np_x = np.random.randn(batch, input_size).astype(np.float32)
+        np_h = np.random.randn(batch, hidden_size).astype(np.float32)
+        np_c = np.random.randn(batch, hidden_size).astype(np.float32)
+        np_g = np.random.randn(batch, hidden_size).astype(np.float32)
+
+        for ngate in [4, 3]:
+            np_params = [(0.3 * np.random.randn(*shape)).astype(np.float32) for shape in [(ngate * hidden_size, input_size), (ngate * hidden_size, hidden_size), (ngate * hidden_size,), (ngate * hidden_size,)]]
+            nx_x = from_numpy(np_x)
+            nx_h = from_numpy(np_h)
+            nx_c = from_numpy(np_c)
+            nx_params = [from_numpy(p) for p in np_params]
+            tx = torch.from_numpy(np_x).requires_grad_(True)
+            th = torch.from_numpy(np_h).requires_grad_(True)
+            tc = torch.from_numpy(np_c).requires_grad_(True)
+            t_params = [torch.from_numpy(p).requires_grad_(True) for p in np_params]
+
+            if ngate == 4:
+                nx_h1, nx_c1 = nn.lstm_cell(nx_x, nx_h, nx_c, *nx_params)
+                nx_loss = (nx_h1 * from_numpy(np_g)).sum() + nx_c1.sum()
+                t_h1, t_c1 = torch.lstm_cell(tx, (th, tc), *t_params)
+                t_loss = (t_h1 * torch.from_numpy(np_g)).sum() + t_c1.sum()
+            else:
+                nx_loss = (nn.gru_cell(nx_x, nx_h, *nx_params) * from_numpy(np_g)).sum()
+                t_loss = (torch.gru_cell(tx, th, *t_params) * torch.from_numpy(np_g)).sum()
+
+            nx_loss.backward()
+            t_loss.backward()
+            assert_array(nx_x.grad, tx.grad)
+            assert_array(nx_h.grad, th.grad)
+
+            if ngate == 4:
+                assert_array(nx_c.grad, tc.grad)
+
+            for nx_p, t_p in zip(nx_params, t_params):
+                assert_array(nx_p.grad, t_p.grad)
@@ -140,6 +140,28 @@ class TestBinary:
     def test_maximum(self):
         self.binary_no_broadcast("maximum", lambda x, y: x.maximum(y), lambda x, y: np.maximum(x, y))
 
+    def test_pow(self):
+        self.binary_no_broadcast("pow", lambda x, y: x.pow(y), np.power, gen_fn=positive_randn)
+        # Negative bases with integral exponents
+        np_a1 = randn([13, 17])
+        np_a2 = np.random.randint(-3, 4, [13, 17]).astype(np.float32)
+        assert np.allclose((from_numpy(np_a1) ** from_numpy(np_a2)).numpy(), np.power(np_a1, np_a2), atol=1e-3, rtol=1e-4, equal_nan=True)
+
+    def test_pow_scalar(self):
+        np_a1 = positive_randn([31, 7])
+
+        for exponent in [2, 0.5, -1, 3, 1.7]:
+            assert np.allclose((from_numpy(np_a1) ** exponent).numpy(), np.power(np_a1, exponent), atol=1e-3, rtol=1e-4)
+
+    def test_fmod(self):
+        self.binary_no_broadcast("fmod", lambda x, y: x.fmod(y), np.fmod, gen_fn=nonzero_randn)
+        np_a1 = np.random.randint(-50, 50, [9, 11]).astype(np.int32)
+        np_a2 = np.random.randint(1, 7, [9, 11]).astype(np.int32)
+        assert np.array_equal(from_numpy(np_a1).fmod(from_numpy(np_a2)).numpy(), np.fmod(np_a1, np_a2))
+
+    def test_pow_broadcast(self):
+        self.binary_with_broadcast("pow", lambda x, y: x.pow(y), np.power, gen_fn=positive_randn)
+
     def test_add_broadcast(self):
         self.binary_with_broadcast("add", operator.add, operator.add)
 
@@ -0,0 +1,73 @@
+import numpy as np
+import torch
+from numx.core import b8, eq_bits, from_numpy, geq_bits, gt_bits, leq_bits, lt_bits, neq_bits, pack_bits
+from numx.profiler import enable_memory_profile
+
+
+def unpack(words, ncol):
+    bits = np.unpackbits(words.view(np.uint8).reshape(*words.shape, 4), axis=-1, bitorder="little")
+    return bits.reshape(*words.shape[:-1], -1)[..., :ncol].astype(bool)
+
+
+class TestBitMask:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_cmp_bits(self):
+        print("cmp_bits:")
+
+        for shape in [(1,), (31,), (32,), (33,), (7, 100), (3, 4, 65)]:
+            np_x = np.random.randint(-3, 3, shape).astype(np.float32)
+            np_y = np.random.randint(-3, 3, shape[-1:]).astype(np.float32)
+
+            for bits_fn, np_fn in [(eq_bits, np.equal), (neq_bits, np.not_equal), (lt_bits, np.less), (gt_bits, np.greater), (leq_bits, np.less_equal), (geq_bits, np.greater_equal)]:
+                mask = bits_fn(from_numpy(np_x), from_numpy(np_y))
+                expected = np_fn(np_x, np_y)
+                words = mask.words.numpy()
+                assert mask.shape == list(shape)
+                assert words.shape == (*shape[:-1], (shape[-1] + 31) // 32)
+                # Padding bits past the end of every row stay zero
+                assert np.array_equal(unpack(words, words.shape[-1] * 32), np.pad(expected, [(0, 0)] * (len(shape) - 1) + [(0, words.shape[-1] * 32 - shape[-1])]))
+                assert np.array_equal(mask.to_bool().numpy(), expected)
+                assert mask.count().item() == expected.sum()
+                assert np.array_equal(mask.count_rows().numpy(), expected.sum(axis=-1))
+
+    def test_pack_bits(self):
+        print("pack_bits:")
+        np_x = np.random.rand(5, 300) < 0.3
+        mask = pack_bits(from_numpy(np_x))
+        # 300 elements take 10 words per row instead of 300 bytes
+        assert mask.nbytes == 5 * 10 * 4
+        assert np.array_equal(mask.to_bool().numpy(), np_x)
+        assert mask.to_bool().dtype == b8
+
+    def test_where_bits(self):
+        print("where_bits:")
+        np_x = np.random.randn(6, 70).astype(np.float32)
+        np_y = np.random.randn(70).astype(np.float32)
+        nx_x, nx_y = from_numpy(np_x), from_numpy(np_y)
+        mask = gt_bits(nx_x, nx_y)
+        nx_z = mask.where(nx_x, nx_y)
+        assert np.allclose(nx_z.numpy(), np.where(np_x > np_y, np_x, np_y))
+        assert np.allclose(mask.masked_fill(nx_x, -1.0).numpy(), np.where(np_x > np_y, -1.0, np_x))
+        nx_z.sum().backward()
+        t_x = torch.from_numpy(np_x).requires_grad_()
+        t_y = torch.from_numpy(np_y).requires_grad_()
+        torch.where(t_x > t_y, t_x, t_y).sum().backward()
+        assert torch.allclose(nx_x.grad.torch(), t_x.grad)
+        assert torch.allclose(nx_y.grad.torch(), t_y.grad)
+
+    def test_minimum_maximum_backward(self):
+        print("minimum and maximum backward with bit masks:")
+        np_x = np.random.randn(4, 45).astype(np.float32)
+        np_y = np.random.randn(4, 45).astype(np.float32)
+
+        for nx_fn, t_fn in [(lambda x, y: x.minimum(y), torch.minimum), (lambda x, y: x.maximum(y), torch.maximum)]:
+            nx_x, nx_y = from_numpy(np_x), from_numpy(np_y)
+            nx_fn(nx_x, nx_y).sum().backward()
+            t_x = torch.from_numpy(np_x).requires_grad_()
+            t_y = torch.from_numpy(np_y).requires_grad_()
+            t_fn(t_x, t_y).sum().backward()
+            assert torch.allclose(nx_x.grad.torch(), t_x.grad)
+            assert torch.allclose(nx_y.grad.torch(), t_y.grad)
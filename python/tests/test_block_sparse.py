@@ -0,0 +1,61 @@
+import numpy as np
+import torch
+import numx.nn as nn
+from numx.core import from_numpy
+from numx.profiler import enable_memory_profile
+
+
+def prune_blocks(w, block_rows, block_cols, threshold):
+    out_features, in_features = w.shape
+    blocks = w.reshape(out_features // block_rows, block_rows, in_features // block_cols, block_cols)
+    keep = np.abs(blocks).max(axis=(1, 3)) > threshold
+    return (blocks * keep[:, None, :, None]).reshape(out_features, in_features), keep
+
+
+class TestBlockSparse:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_block_sparsify(self):
+        print("block_sparsify:")
+        np_w = np.random.randn(64, 96).astype(np.float32)
+        # Magnitude pruning leaves about 15% of the 16x16 blocks
+        mask = np.random.rand(4, 6) < 0.15
+        mask[0, 0] = True
+        np_w *= np.kron(mask, np.ones((16, 16), dtype=np.float32))
+        _, keep = prune_blocks(np_w, 16, 16, 0.0)
+        block_ptr, block_col, block_values = nn.block_sparsify(from_numpy(np_w), 16, 16)
+        block_rows, block_cols = np.nonzero(keep)
+        assert np.array_equal(block_ptr.numpy(), np.concatenate([[0], np.cumsum(keep.sum(axis=1))]))
+        assert np.array_equal(block_col.numpy(), block_cols)
+
+        for i, (row, col) in enumerate(zip(block_rows, block_cols)):
+            assert np.array_equal(block_values.numpy()[i], np_w[row * 16:(row + 1) * 16, col * 16:(col + 1) * 16])
+
+        np_x = np.random.randn(10, 96).astype(np.float32)
+        nx_y = nn.block_sparse_linear(from_numpy(np_x), block_ptr, block_col, block_values, 96)
+        assert np.allclose(nx_y.numpy(), np_x @ np_w.T, atol=1e-4)
+
+    def test_block_sparse_linear(self):
+        print("block_sparse_linear:")
+
+        for batch, in_features, out_features, block_rows, block_cols in [(1, 16, 16, 16, 16), (33, 128, 96, 16, 16), (64, 784, 128, 32, 1), (7, 60, 24, 6, 4)]:
+            linear = nn.Linear(in_features, out_features)
+            np_w = linear.weight.numpy()
+            np_x = np.random.randn(batch, in_features).astype(np.float32)
+
+            for threshold in [0.0, np.quantile(np.abs(np_w), 0.995)]:
+                layer = nn.BlockSparseLinear(linear, block_rows, block_cols, threshold)
+                pruned, keep = prune_blocks(np_w, block_rows, block_cols, threshold)
+                assert layer.block_rows == block_rows and layer.block_cols == block_cols
+                assert np.isclose(layer.density, max(keep.mean(), block_rows * block_cols / np_w.size))
+                expected = torch.nn.functional.linear(torch.from_numpy(np_x), torch.from_numpy(pruned), linear.bias.torch())
+                assert torch.allclose(layer(from_numpy(np_x)).torch(), expected, atol=1e-4)
+
+    def test_fully_pruned(self):
+        print("fully pruned block_sparse_linear:")
+        linear = nn.Linear(32, 32, False)
+        layer = nn.BlockSparseLinear(linear, 16, 16, 1e9)
+        assert layer.block_values.numpy().shape == (1, 16, 16)
+        assert np.all(layer(from_numpy(np.random.randn(4, 32).astype(np.float32))).numpy() == 0)
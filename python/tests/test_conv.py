@@ -0,0 +1,57 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+import torch
+import torch.nn.functional as F
+
+
+class TestConv:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_conv2d(self):
+        print("conv2d:")
+        configs = [
+            ((2, 3, 16, 16), (8, 3, 3, 3), (1, 1), (0, 0), (1, 1)),
+            ((3, 4, 17, 13), (5, 4, 3, 5), (2, 1), (1, 2), (1, 1)),
+            ((1, 2, 20, 20), (4, 2, 3, 3), (1, 2), (2, 2), (2, 3)),
+            ((4, 1, 9, 9), (2, 1, 1, 1), (3, 3), (0, 0), (1, 1)),
+        ]
+
+        for in_shape, weight_shape, stride, padding, dilation in configs:
+            np_x = np.random.randn(*in_shape).astype(np.float32)
+            np_w = np.random.randn(*weight_shape).astype(np.float32)
+            np_b = np.random.randn(weight_shape[0]).astype(np.float32)
+            nx_out = nn.conv2d_with_bias(from_numpy(np_x), from_numpy(np_w), from_numpy(np_b), stride, padding, dilation)
+            t_out = F.conv2d(torch.from_numpy(np_x), torch.from_numpy(np_w), torch.from_numpy(np_b), stride, padding, dilation)
+            assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
+
+    def test_conv2d_nhwc(self):
+        print("conv2d NHWC:")
+        np_x = np.random.randn(2, 3, 15, 11).astype(np.float32)
+        np_w = np.random.randn(6, 3, 3, 3).astype(np.float32)
+        np_b = np.random.randn(6).astype(np.float32)
+        nx_x = from_numpy(np.ascontiguousarray(np_x.transpose(0, 2, 3, 1)))
+        nx_out = nn.conv2d_with_bias(nx_x, from_numpy(np_w), from_numpy(np_b), (2, 2), (1, 1), (1, 1), nn.ConvLayout.NHWC)
+        t_out = F.conv2d(torch.from_numpy(np_x), torch.from_numpy(np_w), torch.from_numpy(np_b), (2, 2), (1, 1), (1, 1))
+        assert torch.allclose(nx_out.torch(), t_out.permute(0, 2, 3, 1), atol=1e-3, rtol=0)
+
+    def test_conv2d_strided_input(self):
+        print("conv2d strided input:")
+        # A permuted view is read through its strides without a copy
+        np_x = np.random.randn(2, 10, 12, 3).astype(np.float32)
+        np_w = np.random.randn(4, 3, 3, 3).astype(np.float32)
+        nx_out = nn.conv2d(from_numpy(np_x).permute([0, 3, 1, 2]), from_numpy(np_w), padding=(1, 1))
+        t_out = F.conv2d(torch.from_numpy(np_x).permute(0, 3, 1, 2), torch.from_numpy(np_w), padding=(1, 1))
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
+
+    def test_conv2d_module(self):
+        print("Conv2d module:")
+        conv = nn.Conv2d(3, 8, (3, 3), padding=(1, 1))
+        np_x = np.random.randn(2, 3, 8, 8).astype(np.float32)
+        nx_out = conv(from_numpy(np_x))
+        t_out = F.conv2d(torch.from_numpy(np_x), conv.weight.torch(), conv.bias.torch(), padding=(1, 1))
+        assert nx_out.shape.view == [2, 8, 8, 8]
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
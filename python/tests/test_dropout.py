@@ -0,0 +1,40 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+
+
+class TestDropout:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_dropout(self):
+        print("dropout:")
+
+        for p in [0.1, 0.5, 0.9]:
+            np_x = (np.random.rand(256, 1024) + 1).astype(np.float32)
+            np_out = nn.dropout(from_numpy(np_x), p).numpy()
+            keep = np_out != 0
+            # Kept elements are scaled so the expectation is unchanged
+            assert np.allclose(np_out[keep], np_x[keep] / (1 - p), atol=1e-5)
+            assert abs(1 - keep.mean() - p) < 0.01
+
+    def test_dropout_edge_cases(self):
+        print("dropout edge cases:")
+        np_x = np.random.randn(7, 9).astype(np.float32)
+        assert np.array_equal(nn.dropout(from_numpy(np_x), 0.0).numpy(), np_x)
+        assert np.array_equal(nn.dropout(from_numpy(np_x), 0.7, False).numpy(), np_x)
+        assert np.array_equal(nn.dropout(from_numpy(np_x), 1.0).numpy(), np.zeros_like(np_x))
+        # Strided input is read in place
+        np_out = nn.dropout(from_numpy(np_x).transpose(0, 1), 0.5).numpy()
+        keep = np_out != 0
+        assert np.allclose(np_out[keep], 2 * np_x.T[keep], atol=1e-5)
+
+    def test_dropout_module(self):
+        print("Dropout module:")
+        np_x = np.random.randn(64, 64).astype(np.float32)
+        dropout = nn.Dropout(0.25)
+        assert (dropout(from_numpy(np_x)).numpy() == 0).any()
+        dropout.eval()
+        assert np.array_equal(dropout(from_numpy(np_x)).numpy(), np_x)
@@ -0,0 +1,66 @@
+import numpy as np
+import torch
+from numx.core import einsum, einsum_path, from_numpy
+from numx.profiler import enable_memory_profile
+
+
+class TestEinsum:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_einsum(self):
+        print("einsum:")
+        cases = [
+            ("ij,jk->ik", [(7, 5), (5, 9)]),
+            ("ij,kj->ik", [(7, 5), (9, 5)]),
+            ("ji,jk", [(5, 7), (5, 9)]),
+            ("bij,bjk->bik", [(3, 4, 5), (3, 5, 6)]),
+            ("bhqd,bhkd->bhqk", [(2, 3, 8, 16), (2, 3, 10, 16)]),
+            ("ijk,jkl->il", [(4, 5, 6), (5, 6, 7)]),
+            ("ikj,ljk->il", [(4, 6, 5), (7, 5, 6)]),
+            ("abc,cd->abd", [(3, 4, 5), (5, 6)]),
+            ("acb,cd->abd", [(3, 5, 4), (5, 6)]),
+            ("ab,cd,bc->ad", [(30, 4), (6, 20), (4, 6)]),
+            ("ab,bc,cd,de->ae", [(8, 3), (3, 9), (9, 2), (2, 11)]),
+            ("i,i->", [(17,), (17,)]),
+            ("i,j->ij", [(4,), (6,)]),
+            ("ij,ij->ij", [(4, 6), (4, 6)]),
+            ("ii->i", [(5, 5)]),
+            ("ii", [(5, 5)]),
+            ("iij,jk->ik", [(4, 4, 3), (3, 2)]),
+            ("ij->j", [(6, 8)]),
+            ("ijk->kji", [(2, 3, 4)]),
+            ("...ij,...jk->...ik", [(5, 1, 3, 4), (7, 4, 2)]),
+            ("...i,...i->...", [(4, 3, 2), (3, 2)]),
+        ]
+
+        for spec, shapes in cases:
+            np_operands = [np.random.randn(*shape).astype(np.float32) for shape in shapes]
+            expected = np.einsum(spec, *np_operands)
+            nx_out = einsum(spec, *[from_numpy(x) for x in np_operands]).numpy()
+            # Full contractions keep a single dimension like sums
+            assert np.allclose(nx_out.reshape(expected.shape), expected, atol=1e-4), spec
+
+    def test_einsum_backward(self):
+        print("einsum backward:")
+
+        for spec, shapes in [("bij,bjk->bik", [(3, 4, 5), (3, 5, 6)]), ("ab,bc,cd->ad", [(6, 2), (2, 7), (7, 3)]), ("ikj,ljk->il", [(4, 6, 5), (7, 5, 6)]), ("ii,i->i", [(4, 4), (4,)])]:
+            np_operands = [np.random.randn(*shape).astype(np.float32) for shape in shapes]
+            nx_operands = [from_numpy(x) for x in np_operands]
+            (einsum(spec, *nx_operands) * 2.0).sum().backward()
+            t_operands = [torch.from_numpy(x).requires_grad_() for x in np_operands]
+            (torch.einsum(spec, *t_operands) * 2.0).sum().backward()
+
+            for nx_x, t_x in zip(nx_operands, t_operands):
+                assert torch.allclose(nx_x.grad.torch(), t_x.grad, atol=1e-4), spec
+
+    def test_einsum_path(self):
+        print("einsum_path:")
+        # Contracting the two thin matrices first avoids a 1000x1000 intermediate
+        assert einsum_path("ab,bc,cd->ad", [[1000, 2], [2, 1000], [1000, 2]]) == [(1, 2), (0, 3)]
+        assert einsum_path("ab,bc,cd->ad", [[2, 1000], [1000, 2], [2, 1000]]) == [(0, 1), (2, 3)]
+        # Longer chains are planned greedily
+        shapes = [[i + 2, i + 3] for i in range(10)]
+        path = einsum_path("ab,bc,cd,de,ef,fg,gh,hi,ij,jk->ak", shapes)
+        assert sorted(id for step in path for id in step) == list(range(18))
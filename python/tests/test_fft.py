@@ -0,0 +1,86 @@
+import numpy as np
+import torch
+import torch.nn.functional as F
+import numx.nn as nn
+from numx.core import from_numpy, irfft, rfft
+from numx.profiler import enable_memory_profile
+
+
+class TestFFT:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_rfft(self):
+        print("rfft:")
+
+        # Powers of two, even sizes packed into Bluestein transforms and odd sizes
+        for n in [1, 2, 3, 8, 12, 32, 100, 127, 1000, 4096]:
+            np_x = np.random.randn(3, n).astype(np.float32)
+            expected = np.fft.rfft(np_x)
+            nx_out = rfft(from_numpy(np_x)).numpy()
+            assert nx_out.shape == (3, n // 2 + 1, 2)
+            assert np.allclose(nx_out[..., 0] + 1j * nx_out[..., 1], expected, atol=1e-3 * np.sqrt(n)), n
+
+        # Strided inputs, cropping and zero padding
+        np_x = np.random.randn(40, 6).astype(np.float32)
+        for n in [None, 30, 64]:
+            expected = np.fft.rfft(np_x.T, n)
+            nx_out = rfft(from_numpy(np_x).transpose(0, 1), n).numpy()
+            assert np.allclose(nx_out[..., 0] + 1j * nx_out[..., 1], expected, atol=1e-3)
+
+    def test_irfft(self):
+        print("irfft:")
+
+        for n in [1, 2, 5, 16, 18, 33, 256, 1000]:
+            np_spectrum = np.random.randn(4, n // 2 + 1, 2).astype(np.float32)
+            expected = np.fft.irfft(np_spectrum[..., 0] + 1j * np_spectrum[..., 1], n)
+            assert np.allclose(irfft(from_numpy(np_spectrum), n).numpy(), expected, atol=1e-4), n
+
+        np_x = np.random.randn(2, 3, 50).astype(np.float32)
+        assert np.allclose(irfft(rfft(from_numpy(np_x))).numpy(), np_x, atol=1e-4)
+
+    def test_fft_backward(self):
+        print("rfft and irfft backward:")
+
+        for n in [7, 16, 24]:
+            np_x = np.random.randn(3, n).astype(np.float32)
+            np_w = np.random.randn(3, n // 2 + 1, 2).astype(np.float32)
+            nx_x = from_numpy(np_x)
+            (rfft(nx_x) * from_numpy(np_w)).sum().backward()
+            t_x = torch.from_numpy(np_x).requires_grad_()
+            (torch.view_as_real(torch.fft.rfft(t_x)) * torch.from_numpy(np_w)).sum().backward()
+            assert torch.allclose(nx_x.grad.torch(), t_x.grad, atol=1e-4), n
+
+            np_spectrum = np.random.randn(3, n // 2 + 1, 2).astype(np.float32)
+            np_v = np.random.randn(3, n).astype(np.float32)
+            nx_spectrum = from_numpy(np_spectrum)
+            (irfft(nx_spectrum, n) * from_numpy(np_v)).sum().backward()
+            t_spectrum = torch.from_numpy(np_spectrum).requires_grad_()
+            (torch.fft.irfft(torch.view_as_complex(t_spectrum), n) * torch.from_numpy(np_v)).sum().backward()
+            assert torch.allclose(nx_spectrum.grad.torch(), t_spectrum.grad, atol=1e-4), n
+
+    def test_fft_conv1d(self):
+        print("fft_conv1d:")
+        configs = [((2, 3, 200), (4, 3, 5), 0), ((1, 2, 1000), (3, 2, 300), 10), ((2, 1, 333), (1, 1, 333), 0), ((3, 4, 64), (2, 4, 7), 3)]
+
+        for in_shape, weight_shape, padding in configs:
+            np_x = np.random.randn(*in_shape).astype(np.float32)
+            np_w = np.random.randn(*weight_shape).astype(np.float32)
+            t_out = F.conv1d(torch.from_numpy(np_x), torch.from_numpy(np_w), padding=padding)
+
+            for use_fft in [None, True, False]:
+                nx_out = nn.fft_conv1d(from_numpy(np_x), from_numpy(np_w), padding, use_fft)
+                assert torch.allclose(nx_out.torch(), t_out, atol=1e-2, rtol=1e-3), (in_shape, weight_shape, use_fft)
+
+    def test_fft_conv1d_backward(self):
+        print("fft_conv1d backward:")
+        np_x = np.random.randn(2, 3, 120).astype(np.float32)
+        np_w = np.random.randn(4, 3, 50).astype(np.float32)
+        nx_x, nx_w = from_numpy(np_x), from_numpy(np_w)
+        nn.fft_conv1d(nx_x, nx_w, 2, True).sum().backward()
+        t_x = torch.from_numpy(np_x).requires_grad_()
+        t_w = torch.from_numpy(np_w).requires_grad_()
+        F.conv1d(t_x, t_w, padding=2).sum().backward()
+        assert torch.allclose(nx_x.grad.torch(), t_x.grad, atol=1e-3, rtol=1e-3)
+        assert torch.allclose(nx_w.grad.torch(), t_w.grad, atol=1e-3, rtol=1e-3)
@@ -0,0 +1,87 @@
+import numpy as np
+import torch
+import numx.nn as nn
+from numx.core import bf16, f16, f32, from_numpy, full
+from numx.profiler import enable_memory_profile
+
+
+class TestHalf:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_conversion(self):
+        print("f16 and bf16 conversion:")
+        np_x = np.random.randn(37, 53).astype(np.float32)
+        np_x[0, :4] = [np.inf, -np.inf, 1e-6, 70000.0]
+        nx_x = from_numpy(np_x)
+        # Rounding matches torch, round to nearest even for both formats
+        assert np.array_equal(nx_x.astype(f16).numpy(), np_x.astype(np.float16))
+        assert torch.equal(nx_x.astype(bf16).torch(), torch.from_numpy(np_x).to(torch.bfloat16))
+        assert np.array_equal(from_numpy(np_x.astype(np.float16)).astype(f32).numpy(), np_x.astype(np.float16).astype(np.float32))
+        assert full([2, 2], 1.5, dtype=bf16).astype(f32).numpy().tolist() == [[1.5, 1.5], [1.5, 1.5]]
+        assert full([1], 0.1, dtype=f16).item() == float(np.float16(0.1))
+
+    def test_elementwise(self):
+        print("f16 and bf16 elementwise:")
+        np_a = np.random.randn(64, 65).astype(np.float32)
+        np_b = np.random.randn(64, 65).astype(np.float32)
+
+        for dtype, t_dtype in [(f16, torch.float16), (bf16, torch.bfloat16)]:
+            nx_a, nx_b = from_numpy(np_a).astype(dtype), from_numpy(np_b).astype(dtype)
+            t_a, t_b = torch.from_numpy(np_a).to(t_dtype), torch.from_numpy(np_b).to(t_dtype)
+            # Computed in f32 and rounded once, which is what torch does on the cpu
+            assert torch.equal((nx_a * nx_b + nx_a).torch(), (t_a.float() * t_b.float()).to(t_dtype).float().add(t_a.float()).to(t_dtype))
+            assert torch.allclose(nx_a.exp().torch().float(), t_a.float().exp().to(t_dtype).float(), atol=0, rtol=1e-2)
+            assert torch.equal((nx_a < nx_b).torch(), t_a < t_b)
+
+    def test_accumulation(self):
+        print("f16 and bf16 accumulate in f32:")
+        # A running 16-bit sum of 0.01 stalls long before 8192 elements
+        np_x = np.full([8192], 0.01, dtype=np.float32)
+
+        for dtype in [f16, bf16]:
+            nx_x = from_numpy(np_x).astype(dtype)
+            expected = float(nx_x.astype(f32).numpy().astype(np.float64).sum())
+            assert abs(nx_x.sum().item() - expected) / expected < 1e-2
+            assert abs(nx_x.mean().item() - expected / 8192) / (expected / 8192) < 1e-2
+            assert nx_x.sum().dtype == dtype
+
+    def test_scan_rounding(self):
+        print("f16 and bf16 scans round once:")
+        # Rows of several blocks carry the totals of the preceding blocks in f32
+        np_x = (np.random.rand(2, 5000) * 0.1).astype(np.float32)
+
+        for dtype, nmantissa in [(f16, 10), (bf16, 7)]:
+            nx_x = from_numpy(np_x).astype(dtype)
+            expected = np.cumsum(nx_x.astype(f32).numpy().astype(np.float64), 1)
+            nx_out = nx_x.cumsum(1).astype(f32).numpy().astype(np.float64)
+            ulp = 2.0 ** (np.floor(np.log2(expected)) - nmantissa)
+            assert (np.abs(nx_out - expected) <= 0.501 * ulp).all()
+
+    def test_matmul(self):
+        print("f16 and bf16 matmul:")
+
+        for shape1, shape2 in [([67, 99], [99, 35]), ([128, 512], [512, 64]), ([3, 31, 27], [3, 27, 75])]:
+            np_a = np.random.randn(*shape1).astype(np.float32)
+            np_b = np.random.randn(*shape2).astype(np.float32)
+
+            for dtype, t_dtype in [(f16, torch.float16), (bf16, torch.bfloat16)]:
+                t_a, t_b = torch.from_numpy(np_a).to(t_dtype).float(), torch.from_numpy(np_b).to(t_dtype).float()
+                nx_c = (from_numpy(np_a).astype(dtype) @ from_numpy(np_b).astype(dtype)).astype(f32).torch()
+                # Products of the rounded inputs summed in f32, only the store is rounded
+                t_c = (t_a @ t_b).to(t_dtype).float()
+                assert torch.allclose(nx_c, t_c, atol=0, rtol=1e-2)
+
+    def test_softmax_backward(self):
+        print("f16 softmax backward:")
+        np_x = np.random.randn(16, 100).astype(np.float32)
+        nx_x = from_numpy(np_x).astype(f16)
+        nx_y = nn.softmax(nx_x)
+        (nx_y * nx_y).sum().backward()
+        t_x = torch.from_numpy(np_x).to(torch.float16).float().requires_grad_()
+        t_y = torch.softmax(t_x, -1)
+        (t_y * t_y).sum().backward()
+        assert torch.allclose(nx_y.astype(f32).torch(), t_y.detach(), atol=1e-3, rtol=0)
+        assert nx_x.grad.dtype == f16
+        assert torch.allclose(nx_x.grad.astype(f32).torch(), t_x.grad, atol=1e-3, rtol=0)
@@ -0,0 +1,48 @@
+from numx.core import bincount, from_numpy, histogram
+from numx.profiler import enable_memory_profile
+import numpy as np
+
+
+class TestHistogram:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_bincount(self):
+        print("bincount:")
+
+        # Small bin counts use the threadgroup histograms, large ones go straight to the output
+        for num_bins in [10, 5000]:
+            np_x = np.random.randint(-3, num_bins + 3, (123, 457)).astype(np.int32)
+            expected = np.bincount(np_x[(np_x >= 0) & (np_x < num_bins)], minlength=num_bins)
+            assert np.array_equal(bincount(from_numpy(np_x), num_bins).numpy(), expected)
+
+    def test_bincount_weighted(self):
+        print("bincount with weight:")
+        np_x = np.random.randint(0, 17, (1000,)).astype(np.int32)
+        np_w = np.random.rand(1000).astype(np.float32)
+        np_out = bincount(from_numpy(np_x), 17, from_numpy(np_w)).numpy()
+        assert np.allclose(np_out, np.bincount(np_x, weights=np_w, minlength=17), atol=1e-3)
+
+    def test_bincount_strided(self):
+        print("bincount with strided input:")
+        np_x = np.random.randint(0, 8, (30, 40)).astype(np.int32)
+        np_out = bincount(from_numpy(np_x).transpose(0, 1)[::2], 8).numpy()
+        assert np.array_equal(np_out, np.bincount(np_x.T[::2].ravel(), minlength=8))
+
+    def test_histogram(self):
+        print("histogram:")
+        np_x = np.random.randn(100000).astype(np.float32)
+        np_out = histogram(from_numpy(np_x), 20, -2.0, 2.0).numpy()
+        expected, _ = np.histogram(np_x, bins=20, range=(-2.0, 2.0))
+        # Elements sitting exactly on inner bin edges may land on either side due to rounding
+        assert np.abs(np_out - expected).sum() <= 2
+        assert np_out.sum() == expected.sum()
+
+    def test_histogram_weighted(self):
+        print("histogram with weight:")
+        np_x = np.random.rand(5000).astype(np.float32)
+        np_w = np.random.rand(5000).astype(np.float32)
+        np_out = histogram(from_numpy(np_x), 10, 0.0, 1.0, from_numpy(np_w)).numpy()
+        expected, _ = np.histogram(np_x, bins=10, range=(0.0, 1.0), weights=np_w)
+        assert np.allclose(np_out, expected, atol=1e-2)
@@ -0,0 +1,59 @@
+from numx.core import from_numpy
+from numx.random import multinomial
+from numx.profiler import enable_memory_profile
+import numpy as np
+
+
+def softmax(x: np.ndarray) -> np.ndarray:
+    e = np.exp(x - x.max(axis=-1, keepdims=True))
+    return e / e.sum(axis=-1, keepdims=True)
+
+
+class TestMultinomial:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_multinomial_probs(self):
+        print("multinomial from probabilities:")
+        probs = np.array([[0.1, 0.0, 0.6, 0.3], [0.0, 0.0, 1.0, 0.0]], dtype=np.float32)
+        samples = multinomial(from_numpy(probs * 5), 20000).numpy()
+        assert samples.shape == (2, 20000)
+        assert (samples[1] == 2).all()
+        freqs = np.bincount(samples[0], minlength=4) / 20000
+        assert np.allclose(freqs, probs[0], atol=0.02)
+
+    def test_multinomial_logits(self):
+        print("multinomial from logits:")
+        np_logits = np.random.randn(3, 1000).astype(np.float32)
+
+        for temperature in [1.0, 0.5]:
+            samples = multinomial(from_numpy(np_logits), 50000, logits=True, temperature=temperature).numpy()
+            expected = softmax(np_logits / temperature)
+
+            for row in range(3):
+                freqs = np.bincount(samples[row], minlength=1000) / 50000
+                assert np.abs(freqs - expected[row]).sum() < 0.15
+
+    def test_multinomial_top_k_top_p(self):
+        print("multinomial with top-k and top-p:")
+        np_logits = np.random.randn(4, 300).astype(np.float32)
+        samples = multinomial(from_numpy(np_logits), 2000, logits=True, top_k=5).numpy()
+
+        for row in range(4):
+            assert set(samples[row]) <= set(np.argsort(-np_logits[row])[:5])
+
+        samples = multinomial(from_numpy(np_logits), 2000, logits=True, top_p=0.5).numpy()
+
+        for row in range(4):
+            order = np.argsort(-np_logits[row])
+            mass = np.cumsum(softmax(np_logits[row])[order])
+            nucleus = order[: np.searchsorted(mass, 0.5) + 1]
+            assert set(samples[row]) <= set(nucleus)
+
+    def test_multinomial_strided(self):
+        print("multinomial with strided input:")
+        probs = np.zeros((50, 3), dtype=np.float32)
+        probs[7] = 1
+        samples = multinomial(from_numpy(probs).transpose(0, 1), 100).numpy()
+        assert (samples == 7).all()
@@ -0,0 +1,123 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+import torch
+import torch.nn.functional as F
+
+
+def torch_rms_norm(x: torch.Tensor, weight: torch.Tensor, eps: float) -> torch.Tensor:
+    return x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + eps) * weight
+
+
+class TestNorm:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_layer_norm(self):
+        print("layer_norm:")
+
+        for shape in [(1, 1), (7, 5), (3, 17, 300), (2, 4096), (64, 1000)]:
+            np_x = (np.random.randn(*shape) * 3 + 5).astype(np.float32)
+            np_w = np.random.randn(shape[-1]).astype(np.float32)
+            np_b = np.random.randn(shape[-1]).astype(np.float32)
+            nx_out = nn.layer_norm(from_numpy(np_x), from_numpy(np_w), from_numpy(np_b))
+            t_out = F.layer_norm(torch.from_numpy(np_x), (shape[-1],), torch.from_numpy(np_w), torch.from_numpy(np_b))
+            assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
+
+    def test_rms_norm(self):
+        print("rms_norm:")
+
+        for shape in [(1, 1), (7, 5), (3, 17, 300), (2, 4096)]:
+            np_x = np.random.randn(*shape).astype(np.float32)
+            np_w = np.random.randn(shape[-1]).astype(np.float32)
+            nx_out = nn.rms_norm(from_numpy(np_x), from_numpy(np_w))
+            t_out = torch_rms_norm(torch.from_numpy(np_x), torch.from_numpy(np_w), 1e-6)
+            assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
+
+    def test_norm_strided(self):
+        print("norm strided:")
+        np_x = np.random.randn(30, 20).astype(np.float32)
+        np_w = np.random.randn(30).astype(np.float32)
+        np_b = np.random.randn(30).astype(np.float32)
+        nx_out = nn.layer_norm(from_numpy(np_x).transpose(0, 1), from_numpy(np_w), from_numpy(np_b))
+        t_out = F.layer_norm(torch.from_numpy(np_x).T, (30,), torch.from_numpy(np_w), torch.from_numpy(np_b))
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
+
+    def test_norm_modules(self):
+        print("LayerNorm and RMSNorm modules:")
+        np_x = np.random.randn(4, 8, 32).astype(np.float32)
+        nx_out = nn.LayerNorm(32)(from_numpy(np_x))
+        assert torch.allclose(nx_out.torch(), F.layer_norm(torch.from_numpy(np_x), (32,)), atol=1e-3, rtol=0)
+        nx_out = nn.RMSNorm(32)(from_numpy(np_x))
+        assert torch.allclose(nx_out.torch(), torch_rms_norm(torch.from_numpy(np_x), torch.ones(32), 1e-6), atol=1e-3, rtol=0)
+
+    def test_batch_norm(self):
+        print("batch_norm:")
+
+        for shape, layout in [((8, 5), nn.ConvLayout.NCHW), ((4, 3, 7, 9), nn.ConvLayout.NCHW), ((2, 300, 6), nn.ConvLayout.NCHW), ((4, 7, 9, 3), nn.ConvLayout.NHWC)]:
+            channel_dim = 1 if layout == nn.ConvLayout.NCHW else len(shape) - 1
+            nchannel = shape[channel_dim]
+            np_x = (np.random.randn(*shape) * 2 + 3).astype(np.float32)
+            np_w = np.random.randn(nchannel).astype(np.float32)
+            np_b = np.random.randn(nchannel).astype(np.float32)
+            np_mean = np.random.randn(nchannel).astype(np.float32)
+            np_var = np.random.rand(nchannel).astype(np.float32) + 0.5
+            t_x = torch.from_numpy(np_x)
+
+            if layout == nn.ConvLayout.NHWC:
+                t_x = t_x.movedim(-1, 1)
+
+            for training in [True, False]:
+                nx_out = nn.batch_norm(from_numpy(np_x), from_numpy(np_w), from_numpy(np_b), from_numpy(np_mean.copy()), from_numpy(np_var.copy()), training, layout=layout)
+                t_out = F.batch_norm(t_x, torch.from_numpy(np_mean.copy()), torch.from_numpy(np_var.copy()), torch.from_numpy(np_w), torch.from_numpy(np_b), training)
+
+                if layout == nn.ConvLayout.NHWC:
+                    t_out = t_out.movedim(1, -1)
+
+                assert torch.allclose(nx_out.torch(), t_out, atol=1e-3, rtol=0)
+
+    def test_batch_norm_module(self):
+        print("BatchNorm module:")
+        np_x = np.random.randn(6, 4, 5, 5).astype(np.float32)
+        nx_bn = nn.BatchNorm(4, momentum=0.2)
+        t_bn = torch.nn.BatchNorm2d(4, momentum=0.2)
+
+        # Running statistics are updated by every training forward pass
+        for _ in range(3):
+            nx_out = nx_bn(from_numpy(np_x))
+            t_out = t_bn(torch.from_numpy(np_x))
+            assert torch.allclose(nx_out.torch(), t_out.detach(), atol=1e-3, rtol=0)
+
+        assert torch.allclose(nx_bn.running_mean.torch(), t_bn.running_mean, atol=1e-4, rtol=0)
+        assert torch.allclose(nx_bn.running_var.torch(), t_bn.running_var, atol=1e-4, rtol=0)
+        nx_bn.eval()
+        t_bn.eval()
+        nx_out = nx_bn(from_numpy(np_x))
+        assert torch.allclose(nx_out.torch(), t_bn(torch.from_numpy(np_x)).detach(), atol=1e-3, rtol=0)
+        assert not nx_bn.training
+
+    def test_fold_batch_norm(self):
+        print("fold_batch_norm:")
+        np_x = np.random.randn(16, 8).astype(np.float32)
+        nx_linear = nn.Linear(8, 6)
+        nx_bn = nn.BatchNorm(6)
+        # One training pass so the running statistics are not the defaults
+        nx_bn(nx_linear(from_numpy(np_x))).eval()
+        nx_bn.eval()
+        expected = nx_bn(nx_linear(from_numpy(np_x))).torch()
+        nn.fold_batch_norm(nx_linear, nx_bn)
+        assert nx_bn.folded
+        assert torch.allclose(nx_bn(nx_linear(from_numpy(np_x))).torch(), expected, atol=1e-3, rtol=0)
+
+        np_x = np.random.randn(2, 3, 9, 9).astype(np.float32)
+        nx_conv = nn.Conv2d(3, 4, [3, 3], padding=[1, 1], bias=False)
+        nx_bn = nn.BatchNorm(4)
+        # One training pass so the running statistics are not the defaults
+        nx_bn(nx_conv(from_numpy(np_x))).eval()
+        nx_bn.eval()
+        expected = nx_bn(nx_conv(from_numpy(np_x))).torch()
+        nn.fold_batch_norm(nx_conv, nx_bn)
+        assert nx_conv.bias is not None
+        assert torch.allclose(nx_bn(nx_conv(from_numpy(np_x))).torch(), expected, atol=1e-3, rtol=0)
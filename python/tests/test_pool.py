@@ -0,0 +1,56 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+import torch
+import torch.nn.functional as F
+
+
+class TestPool:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_max_pool2d(self):
+        print("max_pool2d:")
+        configs = [((2, 3, 16, 16), (2, 2), (2, 2), (0, 0)), ((3, 4, 17, 13), (3, 3), (2, 1), (1, 1)), ((1, 2, 9, 11), (3, 2), (1, 1), (1, 0))]
+
+        for in_shape, kernel_size, stride, padding in configs:
+            np_x = np.random.randn(*in_shape).astype(np.float32)
+            nx_out = nn.max_pool2d(from_numpy(np_x), kernel_size, stride, padding)
+            t_out = F.max_pool2d(torch.from_numpy(np_x), kernel_size, stride, padding)
+            assert torch.allclose(nx_out.torch(), t_out, atol=1e-5, rtol=0)
+
+    def test_avg_pool2d(self):
+        print("avg_pool2d:")
+        configs = [((2, 3, 16, 16), (2, 2), (2, 2), (0, 0)), ((3, 4, 17, 13), (3, 3), (2, 1), (1, 1)), ((1, 2, 9, 11), (3, 2), (1, 1), (1, 0))]
+
+        for in_shape, kernel_size, stride, padding in configs:
+            np_x = np.random.randn(*in_shape).astype(np.float32)
+            nx_out = nn.avg_pool2d(from_numpy(np_x), kernel_size, stride, padding)
+            t_out = F.avg_pool2d(torch.from_numpy(np_x), kernel_size, stride, padding)
+            assert torch.allclose(nx_out.torch(), t_out, atol=1e-5, rtol=0)
+
+    def test_adaptive_avg_pool2d(self):
+        print("adaptive_avg_pool2d:")
+        np_x = np.random.randn(2, 3, 13, 10).astype(np.float32)
+
+        for output_size in [(1, 1), (4, 3), (13, 10), (7, 20)]:
+            nx_out = nn.adaptive_avg_pool2d(from_numpy(np_x), output_size)
+            t_out = F.adaptive_avg_pool2d(torch.from_numpy(np_x), output_size)
+            assert torch.allclose(nx_out.torch(), t_out, atol=1e-5, rtol=0)
+
+    def test_pool2d_nhwc(self):
+        print("pool2d NHWC:")
+        np_x = np.random.randn(2, 8, 15, 11).astype(np.float32)
+        nx_x = from_numpy(np.ascontiguousarray(np_x.transpose(0, 2, 3, 1)))
+        t_x = torch.from_numpy(np_x)
+        nx_out = nn.max_pool2d(nx_x, (3, 3), (2, 2), (1, 1), nn.ConvLayout.NHWC)
+        t_out = F.max_pool2d(t_x, (3, 3), (2, 2), (1, 1)).permute(0, 2, 3, 1)
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-5, rtol=0)
+        nx_out = nn.avg_pool2d(nx_x, (2, 2), layout=nn.ConvLayout.NHWC)
+        t_out = F.avg_pool2d(t_x, (2, 2)).permute(0, 2, 3, 1)
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-5, rtol=0)
+        nx_out = nn.AdaptiveAvgPool2d((3, 3), nn.ConvLayout.NHWC)(nx_x)
+        t_out = F.adaptive_avg_pool2d(t_x, (3, 3)).permute(0, 2, 3, 1)
+        assert torch.allclose(nx_out.torch(), t_out, atol=1e-5, rtol=0)
@@ -0,0 +1,74 @@
+import numpy as np
+import torch
+import numx.nn as nn
+from numx.core import f32, from_numpy, i8
+from numx.profiler import enable_memory_profile
+
+
+def reference_quantize(x, clip=0.0):
+    absmax = np.abs(x).max(axis=-1, keepdims=True)
+    if clip > 0:
+        absmax = np.minimum(absmax, clip)
+    scale = np.where(absmax > 0, absmax / 127, 1).astype(np.float32)
+    return np.clip(np.rint(x / scale), -127, 127).astype(np.int8), scale[..., 0]
+
+
+class TestQuantize:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_quantize(self):
+        print("quantize:")
+        np_x = np.random.randn(37, 300).astype(np.float32)
+        np_x[3] = 0
+
+        for clip in [0.0, 1.5]:
+            nx_q, nx_scale = nn.quantize(from_numpy(np_x), clip)
+            q = nx_q.numpy()
+            expected_q, expected_scale = reference_quantize(np_x, clip)
+            assert nx_q.dtype == i8
+            assert np.allclose(nx_scale.numpy(), expected_scale, rtol=1e-6, atol=0)
+            # Halfway cases may round differently after the division by the scale
+            assert np.abs(q.astype(np.int32) - expected_q).max() <= 1
+
+        # Scales depend on the quantization, so they are valid on their own and through their consumers
+        _, nx_scale = nn.quantize(from_numpy(np_x))
+        assert np.allclose(nx_scale.numpy(), reference_quantize(np_x)[1], rtol=1e-6, atol=0)
+        _, nx_scale = nn.quantize(from_numpy(np_x))
+        assert np.allclose((nx_scale * 2).numpy(), reference_quantize(np_x)[1] * 2, rtol=1e-6, atol=0)
+
+    def test_quantized_linear(self):
+        print("quantized_linear:")
+
+        for batch, in_features, out_features in [(1, 3, 5), (33, 129, 70), (64, 784, 128)]:
+            linear = nn.Linear(in_features, out_features)
+            np_x = np.random.randn(batch, in_features).astype(np.float32)
+            expected = torch.nn.functional.linear(torch.from_numpy(np_x), linear.weight.torch(), linear.bias.torch())
+
+            for activation, t_activation in [(nn.QuantizedActivation.NONE, lambda x: x), (nn.QuantizedActivation.RELU, torch.relu), (nn.QuantizedActivation.GELU, torch.nn.functional.gelu), (nn.QuantizedActivation.SILU, torch.nn.functional.silu)]:
+                layer = nn.QuantizedLinear(linear, activation)
+                nx_y = layer(from_numpy(np_x)).torch()
+                t_y = t_activation(expected)
+                assert nx_y.shape == t_y.shape
+                # Accuracy budget, the error is relative to the largest output of every row
+                tolerance = 2e-2 * expected.abs().amax(dim=-1, keepdim=True)
+                assert ((nx_y - t_y).abs() <= tolerance).all()
+
+    def test_calibration(self):
+        print("quantized_linear with calibrated clipping:")
+        linear = nn.Linear(64, 16)
+        observer = nn.AbsMaxObserver()
+
+        for _ in range(4):
+            observer.observe(from_numpy(np.random.randn(8, 64).astype(np.float32)))
+
+        assert observer.absmax > 0
+        layer = nn.QuantizedLinear(linear, nn.QuantizedActivation.RELU, observer.absmax)
+        assert layer.weight.dtype == i8 and layer.weight.torch().shape == (16, 64)
+        # Dequantized weights are within half a quantization step of the float weights
+        dequantized = layer.weight.astype(f32).torch() * layer.weight_scale.torch()[:, None]
+        assert torch.allclose(dequantized, linear.weight.torch(), atol=layer.weight_scale.torch().max().item() / 2 + 1e-6, rtol=0)
+        np_x = np.random.randn(8, 64).astype(np.float32)
+        expected = torch.relu(torch.nn.functional.linear(torch.from_numpy(np_x), linear.weight.torch(), linear.bias.torch()))
+        assert torch.allclose(layer(from_numpy(np_x)).torch(), expected, atol=5e-2, rtol=0)
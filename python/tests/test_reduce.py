@@ -1,7 +1,7 @@
 import torch
 import torch.testing
 import numpy as np
-from numx.core import Array, from_numpy
+from numx.core import Array, NormOrd, from_numpy
 from numx.profiler import enable_memory_profile
 
 
@@ -125,6 +125,63 @@ class TestReduce:
         print("\nTesting mean reduction along multiple dimensions:")
         self.reduce_multidim(lambda x, dim: x.mean(dim), lambda x, dim: x.mean(dim=dim).unsqueeze(dim=-1))
 
+    def test_precise_sum(self):
+        """Test compensated sum and mean reductions"""
+        print("\nTesting precise sum and mean reductions:")
+        self.reduce_basic(lambda x: x.sum(precise=True), lambda x: x.sum().unsqueeze(dim=-1))
+        self.reduce_2d(lambda x, dim: x.sum(dim, precise=True), lambda x, dim: x.sum(dim=dim).unsqueeze(dim=-1))
+        self.reduce_multidim(lambda x, dim: x.mean(dim, precise=True), lambda x, dim: x.mean(dim=dim).unsqueeze(dim=-1))
+
+        # Small values next to a large one are lost by an f32 accumulator but kept by the compensation term
+        np_x = np.ones(100002, dtype=np.float32)
+        np_x[0], np_x[-1] = 1e8, -1e8
+        assert from_numpy(np_x).sum(precise=True).item() == 100000.0
+
+        np_x = (np.random.randn(3, 1 << 20) + 1000).astype(np.float32)
+        expected = torch.from_numpy(np_x.astype(np.float64).sum(axis=1, keepdims=True))
+        TestReduce.elmwise_assert(from_numpy(np_x).sum([1], precise=True).torch().double(), expected, atol=0, rtol=1e-7)
+
+    def test_var_std(self):
+        """Test single-pass variance and standard deviation reductions"""
+        print("\nTesting var and std reductions:")
+        self.reduce_basic(lambda x: x.var(correction=0), lambda x: x.var(correction=0).unsqueeze(dim=-1))
+        self.reduce_2d(lambda x, dim: x.std(dim, correction=0), lambda x, dim: x.std(dim=dim, correction=0).unsqueeze(dim=-1))
+        self.reduce_multidim(lambda x, dim: x.var(dim), lambda x, dim: x.var(dim=dim).unsqueeze(dim=-1))
+        self.reduce_multidim(lambda x, dim: x.std(dim), lambda x, dim: x.std(dim=dim).unsqueeze(dim=-1))
+
+        # A large offset cancels catastrophically in the mean of squares minus the squared mean
+        np_x = (np.random.randn(4, 1 << 18) + 1e4).astype(np.float32)
+        expected = torch.from_numpy(np_x.astype(np.float64).var(axis=1, ddof=1, keepdims=True))
+        TestReduce.elmwise_assert(from_numpy(np_x).var([1]).torch().double(), expected, atol=0, rtol=1e-2)
+
+    def test_norm(self):
+        """Test L1, L2 and infinity norm reductions"""
+        print("\nTesting norm reductions:")
+
+        for nx_ord, t_ord in [(NormOrd.L1, 1), (NormOrd.L2, 2), (NormOrd.LINF, float("inf"))]:
+            self.reduce_basic(lambda x: x.norm(ord=nx_ord), lambda x: torch.linalg.vector_norm(x, t_ord).unsqueeze(dim=-1))
+            self.reduce_2d(lambda x, dim: x.norm(dim, nx_ord), lambda x, dim: torch.linalg.vector_norm(x, t_ord, dim=dim).unsqueeze(dim=-1))
+            self.reduce_multidim(lambda x, dim: x.norm(dim, nx_ord), lambda x, dim: torch.linalg.vector_norm(x, t_ord, dim=dim).unsqueeze(dim=-1))
+
+    def test_var_std_norm_backward(self):
+        """Test analytic gradients of variance, standard deviation and norm reductions"""
+        print("\nTesting var, std and norm backward:")
+        np_x = np.random.randn(6, 5, 7).astype(np.float32)
+        cases = [
+            (lambda x: x.var([0, 2]), lambda x: x.var(dim=[0, 2])),
+            (lambda x: x.std([1], correction=0), lambda x: x.std(dim=1, correction=0)),
+            (lambda x: x.norm([2], NormOrd.L1), lambda x: torch.linalg.vector_norm(x, 1, dim=2)),
+            (lambda x: x.norm([0, 1]), lambda x: torch.linalg.vector_norm(x, 2, dim=[0, 1])),
+            (lambda x: x.norm([2], NormOrd.LINF), lambda x: torch.linalg.vector_norm(x, float("inf"), dim=2)),
+        ]
+
+        for nx_fn, t_fn in cases:
+            nx_x = from_numpy(np_x)
+            (nx_fn(nx_x) * 3.0).sum().backward()
+            t_x = torch.from_numpy(np_x).requires_grad_()
+            (t_fn(t_x) * 3.0).sum().backward()
+            TestReduce.elmwise_assert(nx_x.grad.torch(), t_x.grad)
+
     def test_max_basic(self):
         """Test basic max reduction without specified dimensions"""
         print("\nTesting basic max reduction:")
@@ -0,0 +1,97 @@
+from numx.core import from_numpy
+import numx.nn as nn
+from numx.profiler import enable_memory_profile
+import numpy as np
+import torch
+
+
+def random_params(input_size, hidden_size, ngate):
+    shapes = [(ngate * hidden_size, input_size), (ngate * hidden_size, hidden_size), (ngate * hidden_size,), (ngate * hidden_size,)]
+    return [np.random.randn(*shape).astype(np.float32) * 0.3 for shape in shapes]
+
+
+class TestRNN:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_lstm_cell(self):
+        print("lstm_cell:")
+
+        for batch, input_size, hidden_size in [(1, 3, 4), (5, 17, 33), (8, 64, 300)]:
+            params = random_params(input_size, hidden_size, 4)
+            np_x = np.random.randn(batch, input_size).astype(np.float32)
+            np_h = np.random.randn(batch, hidden_size).astype(np.float32)
+            np_c = np.random.randn(batch, hidden_size).astype(np.float32)
+            nx_h, nx_c = nn.lstm_cell(from_numpy(np_x), from_numpy(np_h), from_numpy(np_c), *[from_numpy(p) for p in params])
+            t_h, t_c = torch.lstm_cell(torch.from_numpy(np_x), (torch.from_numpy(np_h), torch.from_numpy(np_c)), *[torch.from_numpy(p) for p in params])
+            assert torch.allclose(nx_h.torch(), t_h, atol=1e-4, rtol=0)
+            assert torch.allclose(nx_c.torch(), t_c, atol=1e-4, rtol=0)
+
+    def test_gru_cell(self):
+        print("gru_cell:")
+
+        for batch, input_size, hidden_size in [(1, 3, 4), (5, 17, 33), (8, 64, 300)]:
+            params = random_params(input_size, hidden_size, 3)
+            np_x = np.random.randn(batch, input_size).astype(np.float32)
+            np_h = np.random.randn(batch, hidden_size).astype(np.float32)
+            nx_h = nn.gru_cell(from_numpy(np_x), from_numpy(np_h), *[from_numpy(p) for p in params])
+            t_h = torch.gru_cell(torch.from_numpy(np_x), torch.from_numpy(np_h), *[torch.from_numpy(p) for p in params])
+            assert torch.allclose(nx_h.torch(), t_h, atol=1e-4, rtol=0)
+
+    def test_lstm(self):
+        print("lstm:")
+
+        for steps, batch, input_size, hidden_size in [(1, 1, 3, 4), (7, 5, 17, 33), (50, 3, 16, 300), (4, 2, 8, 1024)]:
+            params = random_params(input_size, hidden_size, 4)
+            np_x = np.random.randn(steps, batch, input_size).astype(np.float32)
+            np_h = np.random.randn(batch, hidden_size).astype(np.float32)
+            np_c = np.random.randn(batch, hidden_size).astype(np.float32)
+            nx_y, nx_h, nx_c = nn.lstm(from_numpy(np_x), from_numpy(np_h), from_numpy(np_c), *[from_numpy(p) for p in params])
+            t_lstm = torch.nn.LSTM(input_size, hidden_size)
+
+            with torch.no_grad():
+                for name, p in zip(["weight_ih_l0", "weight_hh_l0", "bias_ih_l0", "bias_hh_l0"], params):
+                    getattr(t_lstm, name).copy_(torch.from_numpy(p))
+
+                t_y, (t_h, t_c) = t_lstm(torch.from_numpy(np_x), (torch.from_numpy(np_h)[None], torch.from_numpy(np_c)[None]))
+
+            assert torch.allclose(nx_y.torch(), t_y, atol=1e-4, rtol=0)
+            assert torch.allclose(nx_h.torch(), t_h[0], atol=1e-4, rtol=0)
+            assert torch.allclose(nx_c.torch(), t_c[0], atol=1e-4, rtol=0)
+
+    def test_gru(self):
+        print("gru:")
+
+        for steps, batch, input_size, hidden_size in [(1, 1, 3, 4), (7, 5, 17, 33), (50, 3, 16, 300), (4, 2, 8, 1024)]:
+            params = random_params(input_size, hidden_size, 3)
+            np_x = np.random.randn(steps, batch, input_size).astype(np.float32)
+            np_h = np.random.randn(batch, hidden_size).astype(np.float32)
+            nx_y, nx_h = nn.gru(from_numpy(np_x), from_numpy(np_h), *[from_numpy(p) for p in params])
+            t_gru = torch.nn.GRU(input_size, hidden_size)
+
+            with torch.no_grad():
+                for name, p in zip(["weight_ih_l0", "weight_hh_l0", "bias_ih_l0", "bias_hh_l0"], params):
+                    getattr(t_gru, name).copy_(torch.from_numpy(p))
+
+                t_y, t_h = t_gru(torch.from_numpy(np_x), torch.from_numpy(np_h)[None])
+
+            assert torch.allclose(nx_y.torch(), t_y, atol=1e-4, rtol=0)
+            assert torch.allclose(nx_h.torch(), t_h[0], atol=1e-4, rtol=0)
+
+    def test_sequence_matches_cells(self):
+        print("lstm sequence matches unrolled cells:")
+        steps, batch, input_size, hidden_size = 6, 4, 10, 20
+        layer = nn.LSTM(input_size, hidden_size)
+        cell = nn.LSTMCell(input_size, hidden_size)
+        np_x = np.random.randn(steps, batch, input_size).astype(np.float32)
+        nx_y = layer(from_numpy(np_x)).torch()
+        params = [layer.weight_ih, layer.weight_hh, layer.bias_ih, layer.bias_hh]
+        h = from_numpy(np.zeros((batch, hidden_size), dtype=np.float32))
+        c = from_numpy(np.zeros((batch, hidden_size), dtype=np.float32))
+
+        for t in range(steps):
+            h, c = nn.lstm_cell(from_numpy(np_x[t]), h, c, *params)
+            assert torch.allclose(nx_y[t], h.torch(), atol=1e-4, rtol=0)
+
+        assert cell.forward(from_numpy(np_x[0])).torch().shape == (batch, hidden_size)
@@ -0,0 +1,54 @@
+from numx.core import from_numpy
+from numx.profiler import enable_memory_profile
+import numpy as np
+
+
+class TestScan:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_cumsum(self):
+        print("cumsum:")
+        shape = [np.random.randint(1, 30) for _ in range(3)]
+        np_a1 = np.random.randn(*shape).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+
+        for dim in range(-3, 3):
+            assert np.allclose(nx_a1.cumsum(dim).numpy(), np.cumsum(np_a1, dim), atol=1e-3, rtol=0)
+
+    def test_cumsum_multi_block(self):
+        print("cumsum multiple blocks:")
+        np_a1 = np.random.randint(-5, 5, (3, 5000)).astype(np.int32)
+        nx_a1 = from_numpy(np_a1)
+        assert np.array_equal(nx_a1.cumsum(1).numpy(), np.cumsum(np_a1, 1))
+
+    def test_cumsum_multi_level(self):
+        print("cumsum multiple levels:")
+        np_a1 = np.random.randint(-5, 5, (2, 300000)).astype(np.int32)
+        nx_a1 = from_numpy(np_a1)
+        assert np.array_equal(nx_a1.cumsum(-1).numpy(), np.cumsum(np_a1, -1))
+
+    def test_cumsum_strided(self):
+        print("cumsum strided:")
+        np_a1 = np.random.randn(40, 30, 20).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = nx_a1.permute([2, 0, 1])[::2, 1::3, ::-1]
+        np_a2 = np_a1.transpose(2, 0, 1)[::2, 1::3, ::-1]
+        assert np.allclose(nx_a2.cumsum(1).numpy(), np.cumsum(np_a2, 1), atol=1e-3, rtol=0)
+
+    def test_cumprod(self):
+        print("cumprod:")
+        shape = [np.random.randint(1, 20) for _ in range(3)]
+        np_a1 = np.random.uniform(0.9, 1.1, shape).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+
+        for dim in range(3):
+            assert np.allclose(nx_a1.cumprod(dim).numpy(), np.cumprod(np_a1, dim), atol=1e-3, rtol=0)
+
+    def test_cummax(self):
+        print("cummax:")
+        np_a1 = np.random.randn(7, 2500).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        assert np.array_equal(nx_a1.cummax(1).numpy(), np.maximum.accumulate(np_a1, 1))
+        assert np.array_equal(nx_a1.cummax(0).numpy(), np.maximum.accumulate(np_a1, 0))
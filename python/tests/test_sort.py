@@ -0,0 +1,61 @@
+from numx.core import from_numpy
+from numx.profiler import enable_memory_profile
+import numpy as np
+
+
+class TestSort:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_sort(self):
+        print("sort:")
+        shape = [np.random.randint(1, 40) for _ in range(3)]
+        np_a1 = np.random.randn(*shape).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+
+        for dim in range(-3, 3):
+            assert np.array_equal(nx_a1.sort(dim).numpy(), np.sort(np_a1, dim))
+            assert np.array_equal(nx_a1.sort(dim, descending=True).numpy(), -np.sort(-np_a1, dim))
+
+    def test_sort_merge(self):
+        print("sort with merge passes:")
+        np_a1 = np.random.randint(-1000, 1000, (3, 10000)).astype(np.int32)
+        nx_a1 = from_numpy(np_a1)
+        assert np.array_equal(nx_a1.sort(-1).numpy(), np.sort(np_a1, -1))
+
+    def test_argsort(self):
+        print("argsort:")
+        # Repeated values check that ties keep their original order
+        np_a1 = np.random.randint(0, 50, (5, 3000)).astype(np.int32)
+        nx_a1 = from_numpy(np_a1)
+        assert np.array_equal(nx_a1.argsort(1).numpy(), np.argsort(np_a1, 1, kind="stable"))
+        np_a2 = np.random.randn(40, 7).astype(np.float32)
+        nx_a2 = from_numpy(np_a2)
+        assert np.array_equal(nx_a2.argsort(0).numpy(), np.argsort(np_a2, 0, kind="stable"))
+
+    def test_sort_strided(self):
+        print("sort strided:")
+        np_a1 = np.random.randn(30, 20, 50).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = nx_a1.permute([2, 0, 1])[::3, 1::2, ::-1]
+        np_a2 = np_a1.transpose(2, 0, 1)[::3, 1::2, ::-1]
+        assert np.array_equal(nx_a2.sort(0).numpy(), np.sort(np_a2, 0))
+
+    def test_topk(self):
+        print("topk:")
+        np_a1 = np.random.randn(4, 100000).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_values, nx_indices = nx_a1.topk(100)
+        np_indices = np.argsort(-np_a1, -1, kind="stable")[:, :100]
+        assert np.array_equal(nx_indices.numpy(), np_indices)
+        assert np.array_equal(nx_values.numpy(), np.take_along_axis(np_a1, np_indices, -1))
+
+    def test_topk_smallest(self):
+        print("topk smallest:")
+        np_a1 = np.random.randn(3000, 6).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_values, nx_indices = nx_a1.topk(1500, 0, largest=False)
+        np_indices = np.argsort(np_a1, 0, kind="stable")[:1500]
+        assert np.array_equal(nx_indices.numpy(), np_indices)
+        assert np.array_equal(nx_values.numpy(), np.take_along_axis(np_a1, np_indices, 0))
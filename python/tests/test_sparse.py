@@ -0,0 +1,91 @@
+import numpy as np
+import pytest
+import torch
+from numx.core import SparseFormat, from_numpy, from_scipy, sparse_coo, sparse_csr
+from numx.profiler import enable_memory_profile
+
+
+def random_sparse(nrow, ncol, density):
+    mask = np.random.rand(nrow, ncol) < density
+    # Skewed rows check that chunks of nonzeros straddle rows of very different lengths
+    mask[0] = True
+    dense = np.where(mask, np.random.randn(nrow, ncol), 0).astype(np.float32)
+    rows, cols = np.nonzero(dense)
+    indptr = np.concatenate([[0], np.cumsum(mask.sum(axis=1))]).astype(np.int32)
+    return dense, indptr, rows.astype(np.int32), cols.astype(np.int32), dense[rows, cols]
+
+
+class TestSparse:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_spmm(self):
+        print("spmm:")
+
+        for nrow, ncol, n, density in [(1, 1, 1, 1.0), (37, 300, 5, 0.01), (500, 200, 64, 0.05), (64, 1000, 3, 0.005)]:
+            dense, indptr, rows, cols, values = random_sparse(nrow, ncol, density)
+            np_b = np.random.randn(ncol, n).astype(np.float32)
+            np_c = np.random.randn(nrow, n).astype(np.float32)
+            shuffle = np.random.permutation(len(values))
+
+            for sparse in [sparse_csr(from_numpy(indptr), from_numpy(cols), from_numpy(values), [nrow, ncol]), sparse_coo(from_numpy(rows[shuffle]), from_numpy(cols[shuffle]), from_numpy(values[shuffle]), [nrow, ncol])]:
+                assert sparse.nnz == len(values)
+                assert np.allclose(sparse.to_dense().numpy(), dense)
+                assert np.allclose((sparse @ from_numpy(np_b)).numpy(), dense @ np_b, atol=1e-4)
+                assert np.allclose(sparse.matmul(from_numpy(np_c), transposed=True).numpy(), dense.T @ np_c, atol=1e-4)
+
+    def test_spmm_empty(self):
+        print("spmm with empty operands:")
+        dense, indptr, rows, cols, values = random_sparse(6, 4, 0.5)
+        sparse = sparse_csr(from_numpy(indptr), from_numpy(cols), from_numpy(values), [6, 4])
+
+        # Dense operands without columns are rejected instead of launching an empty kernel
+        with pytest.raises(ValueError):
+            sparse @ from_numpy(np.zeros((4, 0), dtype=np.float32))
+
+        with pytest.raises(ValueError):
+            sparse.matmul(from_numpy(np.zeros((6, 0), dtype=np.float32)), transposed=True)
+
+    def test_spmm_backward(self):
+        print("spmm backward:")
+        dense, indptr, rows, cols, values = random_sparse(40, 30, 0.1)
+        np_b = np.random.randn(30, 8).astype(np.float32)
+        sparse = sparse_csr(from_numpy(indptr), from_numpy(cols), from_numpy(values), [40, 30])
+        nx_b = from_numpy(np_b)
+        (sparse @ nx_b).sum().backward()
+        t_a = torch.from_numpy(dense).to_sparse_csr()
+        t_b = torch.from_numpy(np_b).requires_grad_()
+        torch.sparse.mm(t_a, t_b).sum().backward()
+        assert torch.allclose(nx_b.grad.torch(), t_b.grad, atol=1e-4)
+
+    def test_mul(self):
+        print("sparse-dense mul:")
+        dense, indptr, rows, cols, values = random_sparse(20, 50, 0.1)
+        np_d = np.random.randn(20, 50).astype(np.float32)
+        sparse = sparse_coo(from_numpy(rows), from_numpy(cols), from_numpy(values), [20, 50])
+        nx_d = from_numpy(np_d)
+        product = sparse * nx_d
+        assert product.format == SparseFormat.COO
+        assert np.allclose(product.to_dense().numpy(), dense * np_d)
+        product.to_dense().sum().backward()
+        assert np.allclose(nx_d.grad.numpy(), dense)
+        assert np.allclose(sparse.values.grad.numpy(), np_d[rows, cols])
+
+    def test_scipy(self):
+        print("scipy conversion:")
+        scipy_sparse = pytest.importorskip("scipy.sparse")
+        matrix = scipy_sparse.random(30, 40, density=0.1, format="csr", dtype=np.float32)
+        matrix.indptr = matrix.indptr.astype(np.int32)
+        matrix.indices = matrix.indices.astype(np.int32)
+        sparse = from_scipy(matrix)
+        assert sparse.format == SparseFormat.CSR and sparse.shape == [30, 40]
+        assert np.allclose(sparse.to_dense().numpy(), matrix.toarray())
+        # Both directions share memory with the source buffers
+        assert np.shares_memory(sparse.values.numpy(), matrix.data)
+        converted = sparse.scipy()
+        assert np.shares_memory(converted.data, matrix.data)
+        assert np.allclose(converted.toarray(), matrix.toarray())
+        coo = matrix.tocoo()
+        coo.row, coo.col = coo.row.astype(np.int32), coo.col.astype(np.int32)
+        assert np.allclose(from_scipy(coo).to_dense().numpy(), matrix.toarray())
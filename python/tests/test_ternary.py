@@ -0,0 +1,59 @@
+from __future__ import annotations
+from numx.core import Array, from_numpy, where
+from numx.profiler import enable_memory_profile
+import numpy as np
+
+
+def randn(shape) -> np.ndarray:
+    return np.random.randn(*shape).astype(np.float32)
+
+
+def randbool(shape) -> np.ndarray:
+    return np.random.rand(*shape) > 0.5
+
+
+class TestTernary:
+    @classmethod
+    def setup_class(cls):
+        enable_memory_profile()
+
+    def test_where(self):
+        print("where:")
+        n = np.random.randint(1, 5)
+        shape = [np.random.randint(1, 100) for _ in range(n)]
+        np_cond = randbool(shape)
+        np_a1 = randn(shape)
+        np_a2 = randn(shape)
+        nx_a3: Array = where(from_numpy(np_cond), from_numpy(np_a1), from_numpy(np_a2))
+        np_a3: np.ndarray = np.where(np_cond, np_a1, np_a2)
+        assert tuple(nx_a3.view) == np_a3.shape
+        assert np.allclose(nx_a3.numpy(), np_a3, atol=1e-3, rtol=0)
+
+    def test_where_broadcast(self):
+        print("where with broadcast:")
+        test_cases = [
+            # [cond_shape, shape1, shape2]
+            ([2, 3, 4], [4], [3, 1]),
+            ([3, 1], [2, 1, 5], [1, 5]),
+            ([1], [2, 3, 4], [2, 3, 4]),
+            ([3, 1, 19, 1, 1], [1, 47, 19, 63, 1], [63, 1]),
+        ]
+        for cond_shape, shape1, shape2 in test_cases:
+            print(f"\nTesting shapes: {cond_shape}, {shape1}, {shape2}")
+            np_cond = randbool(cond_shape)
+            np_a1 = randn(shape1)
+            np_a2 = randn(shape2)
+            nx_a3: Array = where(from_numpy(np_cond), from_numpy(np_a1), from_numpy(np_a2))
+            np_a3: np.ndarray = np.where(np_cond, np_a1, np_a2)
+            assert tuple(nx_a3.view) == np_a3.shape
+            assert np.allclose(nx_a3.numpy(), np_a3, atol=1e-3, rtol=0)
+
+    def test_where_scalar(self):
+        print("where with scalar:")
+        shape = [5, 7, 3]
+        np_a1 = randn(shape)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2: Array = where(nx_a1 > 0, nx_a1, 0.0)
+        nx_a3: Array = where(nx_a1 > 0, 1.0, nx_a1)
+        assert np.allclose(nx_a2.numpy(), np.where(np_a1 > 0, np_a1, 0.0), atol=1e-3, rtol=0)
+        assert np.allclose(nx_a3.numpy(), np.where(np_a1 > 0, 1.0, np_a1), atol=1e-3, rtol=0)
@@ -1,4 +1,4 @@
-from numx.core import Array, from_numpy
+from numx.core import Array, concat, from_numpy, split, stack
 from numx.profiler import enable_memory_profile
 import numpy as np
 
@@ -130,3 +130,65 @@ class TestTransform:
             nx_a2 = nx_a1.flatten(start, end)
             np_a2 = np_a1.reshape(expected)
             assert np.allclose(nx_a2.numpy(), np_a2, atol=1e-3, rtol=0)
+
+    def test_concat(self):
+        print("\nTesting concat:")
+        np_a1 = np.random.randn(3, 4, 5).astype(np.float32)
+        np_a2 = np.random.randn(3, 2, 5).astype(np.float32)
+        np_a3 = np.random.randn(3, 7, 5).astype(np.float32)
+        nx_a4 = concat([from_numpy(np_a1), from_numpy(np_a2), from_numpy(np_a3)], 1)
+        np_a4 = np.concatenate([np_a1, np_a2, np_a3], 1)
+        assert np.allclose(nx_a4.numpy(), np_a4, atol=1e-3, rtol=0)
+
+    def test_concat_in_place_producers(self):
+        print("\nTesting concat of operands computed in the same graph:")
+        np_a1 = np.random.randn(4, 3).astype(np.float32)
+        np_a2 = np.random.randn(4, 6).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+        nx_a2 = from_numpy(np_a2)
+        # The producers of the first two operands write directly into the output buffer
+        nx_a3 = concat([nx_a1.exp(), nx_a2 * 2, nx_a1], -1)
+        np_a3 = np.concatenate([np.exp(np_a1), np_a2 * 2, np_a1], -1)
+        assert np.allclose(nx_a3.numpy(), np_a3, atol=1e-3, rtol=0)
+        nx_a4 = concat([concat([nx_a1.exp(), nx_a1.sin()], 1), nx_a2 + 1], 1)
+        np_a4 = np.concatenate([np.exp(np_a1), np.sin(np_a1), np_a2 + 1], 1)
+        assert np.allclose(nx_a4.numpy(), np_a4, atol=1e-3, rtol=0)
+        # Producers with other consumers or repeated in the operands keep their own buffers
+        nx_exp = nx_a1.exp()
+        nx_a5 = concat([nx_exp, nx_exp.sin(), nx_exp], 0)
+        np_a5 = np.concatenate([np.exp(np_a1), np.sin(np.exp(np_a1)), np.exp(np_a1)], 0)
+        assert np.allclose(nx_a5.numpy(), np_a5, atol=1e-3, rtol=0)
+
+    def test_concat_operand_outlives_concat(self):
+        print("\nTesting a concat operand read after the concat is destroyed:")
+        np_a1 = np.random.randn(4, 3).astype(np.float32)
+        np_a2 = np.random.randn(4, 5).astype(np.float32)
+        nx_a1 = from_numpy(np_a1).exp()
+        nx_a3 = concat([nx_a1, from_numpy(np_a2)], 1)
+        assert np.allclose(nx_a3.numpy(), np.concatenate([np.exp(np_a1), np_a2], 1), atol=1e-3, rtol=0)
+        del nx_a3
+        # The output buffer the operand was written into has been returned to the pool, so it is recomputed
+        nx_a4 = from_numpy(np.zeros([4, 8], dtype=np.float32)) + 1
+        assert np.allclose(nx_a4.numpy(), 1, atol=1e-3, rtol=0)
+        assert np.allclose(nx_a1.numpy(), np.exp(np_a1), atol=1e-3, rtol=0)
+
+    def test_stack(self):
+        print("\nTesting stack:")
+        shape = [np.random.randint(1, 10) for _ in range(3)]
+        np_arrays = [np.random.randn(*shape).astype(np.float32) for _ in range(4)]
+
+        for dim in range(-4, 4):
+            nx_a1 = stack([from_numpy(np_array) for np_array in np_arrays], dim)
+            np_a1 = np.stack(np_arrays, dim)
+            assert np.allclose(nx_a1.numpy(), np_a1, atol=1e-3, rtol=0)
+
+    def test_split(self):
+        print("\nTesting split:")
+        np_a1 = np.random.randn(5, 10, 3).astype(np.float32)
+        nx_a1 = from_numpy(np_a1)
+
+        for nx_section, np_section in zip(split(nx_a1, 4, 1), np.split(np_a1, [4, 8], 1)):
+            assert np.allclose(nx_section.numpy(), np_section, atol=1e-3, rtol=0)
+
+        for nx_section, np_section in zip(split(nx_a1, [1, 3, 1], 0), np.split(np_a1, [1, 4], 0)):
+            assert np.allclose(nx_section.numpy(), np_section, atol=1e-3, rtol=0)
@@ -139,3 +139,30 @@ class TestUnary:
             return x.log(in_place=True)
 
         self.unary_inplace("log", log_inplace, np.log, gen_fn=positive_randn)
+
+    def test_abs(self):
+        self.unary_no_broadcast("abs", Array.abs, np.abs)
+
+    def test_sign(self):
+        self.unary_no_broadcast("sign", Array.sign, np.sign)
+
+    def test_clamp(self):
+        self.unary_no_broadcast("clamp", lambda x: x.clamp(-0.5, 0.7), lambda x: np.clip(x, -0.5, 0.7))
+        self.unary_no_broadcast("clamp min", lambda x: x.clamp(min=0.1), lambda x: np.maximum(x, 0.1))
+        self.unary_no_broadcast("clamp max", lambda x: x.clamp(max=-0.2), lambda x: np.minimum(x, -0.2))
+
+    def test_clamp_int(self):
+        print("clamp i32:")
+        # Bounds above 2^24 are not representable in f32 and must be compared as integers
+        np_x = np.array([-(2**31), -5, 0, 16777216, 16777217, 16777218, 2**31 - 1], dtype=np.int32)
+        nx_out = from_numpy(np_x).clamp(-3, 16777217).numpy()
+        assert np.array_equal(nx_out, np.clip(np_x, -3, 16777217))
+        # Fractional bounds keep the integers within the range
+        assert np.array_equal(from_numpy(np_x).clamp(-2.5, 2.5).numpy(), np.clip(np_x, -2, 2))
+        assert np.array_equal(from_numpy(np_x).clamp(min=-1e12).numpy(), np_x)
+
+    def test_abs_with_slicing(self):
+        self.unary_with_slicing("abs", Array.abs, np.abs)
+
+    def test_clamp_with_slicing(self):
+        self.unary_with_slicing("clamp", lambda x: x.clamp(-1, 1), lambda x: np.clip(x, -1, 1))